@@ -48,6 +48,30 @@ option(PYMESH_USE_FastWindingNumber "Enable Fast Winding Number support"
     ${FAST_WINDING_NUMBER_FOUND})
 include(GenerateDependencyTargets)
 
+# Memory tracking hooks the allocation entry points of PyMesh binaries with
+# the GNU linker's --wrap option.  The flags are attached to the Mesh target
+# so that everything linking against it is hooked, hence it is opt-in and
+# only available on 64-bit Linux.  Counting only happens while MemoryTracker
+# is enabled.
+option(PYMESH_MEMORY_TRACKING "Enable allocation tracking" OFF)
+if (PYMESH_MEMORY_TRACKING AND NOT
+        (CMAKE_SYSTEM_NAME STREQUAL "Linux" AND CMAKE_SIZEOF_VOID_P EQUAL 8))
+    message(WARNING "Memory tracking requires 64-bit Linux, disabling it.")
+    set(PYMESH_MEMORY_TRACKING OFF)
+endif ()
+if (PYMESH_MEMORY_TRACKING)
+    add_definitions(-DPYMESH_MEMORY_TRACKING)
+    set(MEMORY_TRACKING_SYMBOLS
+        malloc calloc realloc free
+        _Znwm _Znam _ZnwmRKSt9nothrow_t _ZnamRKSt9nothrow_t
+        _ZdlPv _ZdaPv _ZdlPvm _ZdaPvm
+        _ZdlPvRKSt9nothrow_t _ZdaPvRKSt9nothrow_t)
+    set(MEMORY_TRACKING_LINKER_FLAGS)
+    foreach (symbol ${MEMORY_TRACKING_SYMBOLS})
+        list(APPEND MEMORY_TRACKING_LINKER_FLAGS "-Wl,--wrap=${symbol}")
+    endforeach ()
+endif ()
+
 # Need support for C++14.
 set(CMAKE_CXX_STANDARD 14)
 set(CMAKE_CXX_STANDARD_REQUIRED ON)
@@ -0,0 +1,385 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+using namespace PyMesh;
+using namespace PyMesh::Benchmark;
+
+namespace BenchmarkHelper {
+    struct Entry {
+        std::string name;
+        Function fn;
+    };
+
+    struct Result {
+        std::string name;
+        size_t repetition_index;
+        size_t iterations;
+        double real_time; // Milliseconds per iteration.
+        double cpu_time;  // Milliseconds per iteration.
+        double items_per_second;
+        bool has_error;
+        std::string error_message;
+    };
+
+    struct Options {
+        std::string filter = ".";
+        double min_time = 0.5;
+        size_t repetitions = 1;
+        std::string out;
+        bool list_only = false;
+    };
+
+    std::vector<Entry>& get_registry() {
+        static std::vector<Entry> registry;
+        return registry;
+    }
+
+    const size_t MAX_ITERATIONS = 1000000000;
+
+    bool parse_flag(const std::string& arg, const std::string& flag,
+            std::string& value) {
+        const std::string prefix = "--" + flag + "=";
+        if (arg.compare(0, prefix.size(), prefix) != 0) return false;
+        value = arg.substr(prefix.size());
+        return true;
+    }
+
+    Options parse_options(int argc, char** argv) {
+        Options options;
+        for (int i=1; i<argc; i++) {
+            const std::string arg(argv[i]);
+            std::string value;
+            if (parse_flag(arg, "benchmark_filter", value)) {
+                options.filter = value;
+            } else if (parse_flag(arg, "benchmark_min_time", value)) {
+                options.min_time = std::stod(value);
+            } else if (parse_flag(arg, "benchmark_repetitions", value)) {
+                options.repetitions = std::max(std::stoi(value), 1);
+            } else if (parse_flag(arg, "benchmark_out", value)) {
+                options.out = value;
+            } else if (arg == "--benchmark_list_tests") {
+                options.list_only = true;
+            } else {
+                std::cerr << "Usage: " << argv[0] << std::endl
+                    << "    [--benchmark_filter=<regex>]" << std::endl
+                    << "    [--benchmark_min_time=<seconds>]" << std::endl
+                    << "    [--benchmark_repetitions=<n>]" << std::endl
+                    << "    [--benchmark_out=<file.json>]" << std::endl
+                    << "    [--benchmark_list_tests]" << std::endl;
+                std::exit(arg == "--help" ? 0 : 1);
+            }
+        }
+        return options;
+    }
+
+    /**
+     * Grow the iteration count until a run lasts at least min_time.
+     */
+    Result run(const Entry& entry, const Options& options,
+            size_t repetition_index) {
+        Result result;
+        result.name = entry.name;
+        result.repetition_index = repetition_index;
+        size_t num_iterations = 1;
+        while (true) {
+            State state(num_iterations);
+            try {
+                entry.fn(state);
+            } catch (const std::exception& e) {
+                state.skip_with_error(e.what());
+            }
+
+            result.has_error = state.has_error();
+            result.error_message = state.get_error_message();
+            if (result.has_error) break;
+
+            const double real_time = state.get_real_time();
+            if (real_time >= options.min_time ||
+                    num_iterations >= MAX_ITERATIONS) {
+                const size_t n = std::max<size_t>(state.get_iterations(), 1);
+                result.iterations = n;
+                result.real_time = real_time * 1e3 / n;
+                result.cpu_time = state.get_cpu_time() * 1e3 / n;
+                result.items_per_second = real_time > 0.0 ?
+                    state.get_items_processed() * n / real_time : 0.0;
+                break;
+            }
+
+            const double multiplier = std::min(10.0,
+                    options.min_time * 1.4 / std::max(real_time, 1e-9));
+            num_iterations = std::min(MAX_ITERATIONS, std::max(
+                        num_iterations + 1,
+                        size_t(std::ceil(num_iterations * multiplier))));
+        }
+        return result;
+    }
+
+    std::string escape(const std::string& str) {
+        std::stringstream out;
+        for (char c : str) {
+            switch (c) {
+                case '"': out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\t': out << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out << "\\u" << std::hex << std::setw(4)
+                            << std::setfill('0') << int(c) << std::dec;
+                    } else {
+                        out << c;
+                    }
+            }
+        }
+        return out.str();
+    }
+
+    void write_result(std::ostream& out, const Result& result,
+            size_t repetitions, const std::string& aggregate_name="") {
+        const bool is_aggregate = !aggregate_name.empty();
+        out << "    {" << std::endl;
+        out << "      \"name\": \"" << escape(result.name)
+            << (is_aggregate ? "_" + aggregate_name : "") << "\"," << std::endl;
+        out << "      \"run_name\": \"" << escape(result.name) << "\","
+            << std::endl;
+        out << "      \"run_type\": \""
+            << (is_aggregate ? "aggregate" : "iteration") << "\"," << std::endl;
+        out << "      \"repetitions\": " << repetitions << "," << std::endl;
+        if (is_aggregate) {
+            out << "      \"aggregate_name\": \"" << aggregate_name << "\","
+                << std::endl;
+        } else {
+            out << "      \"repetition_index\": " << result.repetition_index
+                << "," << std::endl;
+        }
+        if (result.has_error) {
+            out << "      \"error_occurred\": true," << std::endl;
+            out << "      \"error_message\": \""
+                << escape(result.error_message) << "\"" << std::endl;
+        } else {
+            out << "      \"iterations\": " << result.iterations << ","
+                << std::endl;
+            out << "      \"real_time\": " << result.real_time << ","
+                << std::endl;
+            out << "      \"cpu_time\": " << result.cpu_time << ","
+                << std::endl;
+            if (result.items_per_second > 0.0) {
+                out << "      \"items_per_second\": "
+                    << result.items_per_second << "," << std::endl;
+            }
+            out << "      \"time_unit\": \"ms\"" << std::endl;
+        }
+        out << "    }";
+    }
+
+    std::vector<std::pair<std::string, Result> > compute_aggregates(
+            const std::vector<Result>& runs) {
+        std::vector<std::pair<std::string, Result> > aggregates;
+        const size_t n = runs.size();
+        if (n < 2) return aggregates;
+        for (const auto& run : runs) {
+            // Statistics over partial repetitions would be misleading.
+            if (run.has_error) return aggregates;
+        }
+
+        auto aggregate = [&](const std::string& name,
+                const std::function<double(std::vector<double>)>& fn) {
+            Result result = runs.front();
+            std::vector<double> real_times, cpu_times, items;
+            for (const auto& run : runs) {
+                real_times.push_back(run.real_time);
+                cpu_times.push_back(run.cpu_time);
+                items.push_back(run.items_per_second);
+            }
+            result.iterations = n;
+            result.real_time = fn(real_times);
+            result.cpu_time = fn(cpu_times);
+            result.items_per_second = fn(items);
+            aggregates.emplace_back(name, result);
+        };
+
+        auto mean = [](std::vector<double> values) {
+            double sum = 0.0;
+            for (double v : values) sum += v;
+            return sum / values.size();
+        };
+        aggregate("mean", mean);
+        aggregate("median", [](std::vector<double> values) {
+                std::sort(values.begin(), values.end());
+                const size_t m = values.size() / 2;
+                return values.size() % 2 == 1 ?
+                    values[m] : 0.5 * (values[m-1] + values[m]);
+            });
+        aggregate("stddev", [&](std::vector<double> values) {
+                const double mu = mean(values);
+                double sum = 0.0;
+                for (double v : values) sum += (v - mu) * (v - mu);
+                return std::sqrt(sum / (values.size() - 1));
+            });
+        return aggregates;
+    }
+
+    std::string get_date() {
+        const std::time_t now = std::time(nullptr);
+        char buffer[64];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S%z",
+                std::localtime(&now));
+        return buffer;
+    }
+}
+
+using namespace BenchmarkHelper;
+
+State::State(size_t max_iterations) :
+    m_max_iterations(max_iterations),
+    m_iterations(0),
+    m_items_processed(0),
+    m_started(false),
+    m_running(false),
+    m_cpu_start(0),
+    m_real_time(0.0),
+    m_cpu_time(0.0),
+    m_has_error(false) { }
+
+bool State::keep_running() {
+    if (!m_started) {
+        m_started = true;
+        start_timer();
+    } else if (m_iterations < m_max_iterations) {
+        m_iterations++;
+    }
+
+    if (m_has_error || m_iterations >= m_max_iterations) {
+        stop_timer();
+        return false;
+    }
+    return true;
+}
+
+void State::pause_timing() {
+    stop_timer();
+}
+
+void State::resume_timing() {
+    start_timer();
+}
+
+void State::skip_with_error(const std::string& message) {
+    stop_timer();
+    m_has_error = true;
+    m_error_message = message;
+}
+
+void State::start_timer() {
+    if (m_running) return;
+    m_running = true;
+    m_real_start = Clock::now();
+    m_cpu_start = std::clock();
+}
+
+void State::stop_timer() {
+    if (!m_running) return;
+    m_running = false;
+    const std::chrono::duration<double> elapsed = Clock::now() - m_real_start;
+    m_real_time += elapsed.count();
+    m_cpu_time += double(std::clock() - m_cpu_start) / CLOCKS_PER_SEC;
+}
+
+void Benchmark::register_benchmark(const std::string& name, Function fn) {
+    get_registry().push_back({name, fn});
+}
+
+int Benchmark::run_benchmarks(int argc, char** argv) {
+    const Options options = parse_options(argc, argv);
+    const std::regex filter(options.filter);
+
+    std::vector<Entry> selected;
+    for (const auto& entry : get_registry()) {
+        if (std::regex_search(entry.name, filter)) {
+            selected.push_back(entry);
+        }
+    }
+    std::sort(selected.begin(), selected.end(),
+            [](const Entry& a, const Entry& b) { return a.name < b.name; });
+
+    if (options.list_only) {
+        for (const auto& entry : selected) {
+            std::cout << entry.name << std::endl;
+        }
+        return 0;
+    }
+
+    std::ofstream fout;
+    if (!options.out.empty()) {
+        fout.open(options.out.c_str());
+        if (!fout.good()) {
+            std::cerr << "Cannot open " << options.out << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.out.empty() ? std::cout : fout;
+    out << std::setprecision(12);
+    out << "{" << std::endl;
+    out << "  \"context\": {" << std::endl;
+    out << "    \"date\": \"" << get_date() << "\"," << std::endl;
+    out << "    \"executable\": \"" << escape(argv[0]) << "\"," << std::endl;
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ","
+        << std::endl;
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"," << std::endl;
+#else
+    out << "    \"library_build_type\": \"debug\"," << std::endl;
+#endif
+    out << "    \"min_time\": " << options.min_time << "," << std::endl;
+    out << "    \"repetitions\": " << options.repetitions << std::endl;
+    out << "  }," << std::endl;
+    out << "  \"benchmarks\": [" << std::endl;
+
+    bool first = true;
+    size_t num_errors = 0;
+    for (const auto& entry : selected) {
+        std::vector<Result> runs;
+        for (size_t i=0; i<options.repetitions; i++) {
+            runs.push_back(run(entry, options, i));
+            const Result& result = runs.back();
+            std::cerr << std::left << std::setw(60) << entry.name;
+            if (result.has_error) {
+                std::cerr << "ERROR: " << result.error_message << std::endl;
+            } else {
+                std::cerr << std::right << std::setw(14) << std::fixed
+                    << std::setprecision(3) << result.real_time << " ms"
+                    << std::setw(12) << result.iterations << std::endl;
+            }
+            std::cerr.unsetf(std::ios_base::floatfield);
+
+            if (!first) out << "," << std::endl;
+            write_result(out, result, options.repetitions);
+            first = false;
+            if (result.has_error) {
+                num_errors++;
+                break;
+            }
+        }
+        for (const auto& aggregate : compute_aggregates(runs)) {
+            out << "," << std::endl;
+            write_result(out, aggregate.second, options.repetitions,
+                    aggregate.first);
+        }
+    }
+    out << std::endl << "  ]" << std::endl << "}" << std::endl;
+
+    if (num_errors > 0) {
+        std::cerr << num_errors << " benchmark(s) failed." << std::endl;
+        return 1;
+    }
+    return 0;
+}
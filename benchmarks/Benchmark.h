@@ -0,0 +1,101 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace PyMesh {
+namespace Benchmark {
+
+/**
+ * Per-run state handed to each benchmark.  Everything before the first call
+ * to keep_running() is setup and is not timed:
+ *
+ *   void bench(State& state) {
+ *       MeshPtr mesh = ...;
+ *       while (state.keep_running()) {
+ *           mesh->enable_connectivity();
+ *       }
+ *   }
+ */
+class State {
+    public:
+        State(size_t max_iterations);
+
+    public:
+        bool keep_running();
+
+        /**
+         * Exclude per-iteration setup or cleanup from the measurement.
+         */
+        void pause_timing();
+        void resume_timing();
+
+        /**
+         * Mark the run as failed.  The loop stops and the error is reported
+         * instead of timings.
+         */
+        void skip_with_error(const std::string& message);
+
+        /**
+         * Number of items handled per iteration, reported as throughput.
+         */
+        void set_items_processed(size_t num_items) {
+            m_items_processed = num_items;
+        }
+
+        size_t get_iterations() const { return m_iterations; }
+        size_t get_items_processed() const { return m_items_processed; }
+        double get_real_time() const { return m_real_time; }
+        double get_cpu_time() const { return m_cpu_time; }
+        bool has_error() const { return m_has_error; }
+        const std::string& get_error_message() const { return m_error_message; }
+
+    private:
+        void start_timer();
+        void stop_timer();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        size_t m_max_iterations;
+        size_t m_iterations;
+        size_t m_items_processed;
+        bool m_started;
+        bool m_running;
+        Clock::time_point m_real_start;
+        std::clock_t m_cpu_start;
+        double m_real_time;
+        double m_cpu_time;
+        bool m_has_error;
+        std::string m_error_message;
+};
+
+typedef std::function<void(State&)> Function;
+
+/**
+ * Register a benchmark.  Names follow "Group/operation/parameter" so that
+ * related runs can be selected with a single filter.
+ */
+void register_benchmark(const std::string& name, Function fn);
+
+/**
+ * Returns 1 if any benchmark reported an error, 0 otherwise.
+ */
+int run_benchmarks(int argc, char** argv);
+
+}
+}
+
+/**
+ * Run the given function at static initialization time.  Use it to register
+ * parameterized families of benchmarks from a source file.
+ */
+#define PYMESH_BENCHMARK_CONCAT_(a, b) a##b
+#define PYMESH_BENCHMARK_CONCAT(a, b) PYMESH_BENCHMARK_CONCAT_(a, b)
+#define PYMESH_BENCHMARK_GROUP(register_fn) \
+    static const bool PYMESH_BENCHMARK_CONCAT( \
+            pymesh_benchmark_group_, __LINE__) = (register_fn(), true);
@@ -0,0 +1,169 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include "BenchmarkInputs.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <MeshFactory.h>
+
+using namespace PyMesh;
+
+namespace BenchmarkInputsHelper {
+    std::mutex cache_mutex;
+
+    void subdivide(MatrixFr& vertices, MatrixIr& faces) {
+        const size_t num_vertices = vertices.rows();
+        const size_t num_faces = faces.rows();
+        std::map<std::pair<int, int>, int> midpoints;
+        std::vector<Vector3F> new_vertices;
+        auto get_midpoint = [&](int v0, int v1) {
+            const auto key = std::make_pair(std::min(v0, v1), std::max(v0, v1));
+            auto itr = midpoints.find(key);
+            if (itr != midpoints.end()) return itr->second;
+            const int index = num_vertices + new_vertices.size();
+            Vector3F p = 0.5 * (vertices.row(v0) + vertices.row(v1)).transpose();
+            new_vertices.push_back(p.normalized());
+            midpoints[key] = index;
+            return index;
+        };
+
+        MatrixIr subdivided(num_faces * 4, 3);
+        for (size_t i=0; i<num_faces; i++) {
+            const int v0 = faces(i, 0);
+            const int v1 = faces(i, 1);
+            const int v2 = faces(i, 2);
+            const int m01 = get_midpoint(v0, v1);
+            const int m12 = get_midpoint(v1, v2);
+            const int m20 = get_midpoint(v2, v0);
+            subdivided.row(i*4  ) << v0, m01, m20;
+            subdivided.row(i*4+1) << v1, m12, m01;
+            subdivided.row(i*4+2) << v2, m20, m12;
+            subdivided.row(i*4+3) << m01, m12, m20;
+        }
+
+        vertices.conservativeResize(num_vertices + new_vertices.size(), 3);
+        for (size_t i=0; i<new_vertices.size(); i++) {
+            vertices.row(num_vertices + i) = new_vertices[i];
+        }
+        faces.swap(subdivided);
+    }
+
+    Mesh::Ptr form_mesh(const MatrixFr& vertices, const MatrixIr& faces,
+            const MatrixIr& voxels) {
+        return MeshFactory().load_matrices(vertices, faces, voxels).create();
+    }
+}
+
+using namespace BenchmarkInputsHelper;
+
+Mesh::Ptr BenchmarkInputs::get_icosphere(size_t level) {
+    static std::map<size_t, Mesh::Ptr> cache;
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto itr = cache.find(level);
+    if (itr != cache.end()) return itr->second;
+
+    const Float t = (1.0 + std::sqrt(5.0)) / 2.0;
+    MatrixFr vertices(12, 3);
+    vertices <<
+        -1,  t,  0,    1,  t,  0,   -1, -t,  0,    1, -t,  0,
+         0, -1,  t,    0,  1,  t,    0, -1, -t,    0,  1, -t,
+         t,  0, -1,    t,  0,  1,   -t,  0, -1,   -t,  0,  1;
+    vertices.rowwise().normalize();
+    MatrixIr faces(20, 3);
+    faces <<
+        0, 11,  5,    0,  5,  1,    0,  1,  7,    0,  7, 10,    0, 10, 11,
+        1,  5,  9,    5, 11,  4,   11, 10,  2,   10,  7,  6,    7,  1,  8,
+        3,  9,  4,    3,  4,  2,    3,  2,  6,    3,  6,  8,    3,  8,  9,
+        4,  9,  5,    2,  4, 11,    6,  2, 10,    8,  6,  7,    9,  8,  1;
+    for (size_t i=0; i<level; i++) {
+        subdivide(vertices, faces);
+    }
+
+    Mesh::Ptr mesh = form_mesh(vertices, faces, MatrixIr(0, 4));
+    cache[level] = mesh;
+    return mesh;
+}
+
+Mesh::Ptr BenchmarkInputs::get_box_mesh(size_t num_cells) {
+    static std::map<size_t, Mesh::Ptr> cache;
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto itr = cache.find(num_cells);
+    if (itr != cache.end()) return itr->second;
+
+    const size_t n = num_cells + 1;
+    MatrixFr vertices(n*n*n, 3);
+    for (size_t i=0; i<n; i++) {
+        for (size_t j=0; j<n; j++) {
+            for (size_t k=0; k<n; k++) {
+                vertices.row((i*n+j)*n+k) <<
+                    Float(i) / num_cells,
+                    Float(j) / num_cells,
+                    Float(k) / num_cells;
+            }
+        }
+    }
+
+    // Kuhn subdivision: one tet per path from the min to the max corner of
+    // a cell.  Odd permutations are flipped to keep positive orientation.
+    const std::array<std::array<int, 3>, 6> paths = {{
+        {{0, 1, 2}}, {{1, 2, 0}}, {{2, 0, 1}},
+        {{0, 2, 1}}, {{2, 1, 0}}, {{1, 0, 2}}
+    }};
+    const std::array<size_t, 3> strides = {{n*n, n, 1}};
+    MatrixIr voxels(num_cells * num_cells * num_cells * 6, 4);
+    size_t count = 0;
+    for (size_t i=0; i<num_cells; i++) {
+        for (size_t j=0; j<num_cells; j++) {
+            for (size_t k=0; k<num_cells; k++) {
+                const int base = (i*n+j)*n+k;
+                for (size_t p=0; p<6; p++) {
+                    int v[4];
+                    v[0] = base;
+                    for (size_t q=0; q<3; q++) {
+                        v[q+1] = v[q] + strides[paths[p][q]];
+                    }
+                    if (p >= 3) std::swap(v[2], v[3]);
+                    voxels.row(count) << v[0], v[1], v[2], v[3];
+                    count++;
+                }
+            }
+        }
+    }
+
+    Mesh::Ptr mesh = form_mesh(vertices, MatrixIr(0, 3), voxels);
+    cache[num_cells] = mesh;
+    return mesh;
+}
+
+Mesh::Ptr BenchmarkInputs::copy_mesh(const Mesh::Ptr& mesh) {
+    return form_mesh(mesh->get_vertex_matrix(), mesh->get_face_matrix(),
+            mesh->get_voxel_matrix());
+}
+
+MatrixFr BenchmarkInputs::get_query_points(size_t num_points) {
+    // Only the raw mt19937 output is portable, so scale it by hand.
+    std::mt19937 generator(2015);
+    MatrixFr points(num_points, 3);
+    for (size_t i=0; i<num_points; i++) {
+        for (size_t j=0; j<3; j++) {
+            points(i, j) = 3.0 * Float(generator()) / Float(generator.max())
+                - 1.5;
+        }
+    }
+    return points;
+}
+
+std::string BenchmarkInputs::get_scratch_file(const std::string& name) {
+    const char* tmp_dir = std::getenv("TMPDIR");
+    std::string dir = (tmp_dir != nullptr) ? tmp_dir : "/tmp";
+    if (!dir.empty() && dir.back() != '/') dir += "/";
+    return dir + "pymesh_benchmark_" + name;
+}
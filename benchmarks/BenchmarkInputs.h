@@ -0,0 +1,45 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <string>
+
+#include <Core/EigenTypedef.h>
+#include <Mesh.h>
+
+namespace PyMesh {
+
+/**
+ * Deterministic synthetic inputs shared by all benchmarks.  Every generator
+ * caches its output, so repeated runs of a benchmark only pay for setup once.
+ */
+namespace BenchmarkInputs {
+    /**
+     * Unit sphere obtained by subdividing an icosahedron level times.  It has
+     * 10*4^level+2 vertices and 20*4^level triangles.
+     */
+    Mesh::Ptr get_icosphere(size_t level);
+
+    /**
+     * Unit cube split into num_cells^3 cells of 6 tets each.  Faces are the
+     * boundary triangles.
+     */
+    Mesh::Ptr get_box_mesh(size_t num_cells);
+
+    /**
+     * A fresh mesh with the same geometry, without connectivity or
+     * attributes.
+     */
+    Mesh::Ptr copy_mesh(const Mesh::Ptr& mesh);
+
+    /**
+     * num_points points in [-1.5, 1.5]^3 from a fixed-seed generator.
+     */
+    MatrixFr get_query_points(size_t num_points);
+
+    /**
+     * Path of a scratch file with the given name.  Uses $TMPDIR if set.
+     */
+    std::string get_scratch_file(const std::string& name);
+}
+
+}
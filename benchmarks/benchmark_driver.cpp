@@ -0,0 +1,6 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include "Benchmark.h"
+
+int main(int argc, char** argv) {
+    return PyMesh::Benchmark::run_benchmarks(argc, argv);
+}
@@ -0,0 +1,154 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <IO/MeshWriter.h>
+#include <Mesh.h>
+#include <MeshFactory.h>
+
+#include <Benchmark.h>
+#include <BenchmarkInputs.h>
+
+using namespace PyMesh;
+using namespace PyMesh::Benchmark;
+
+namespace MeshBenchmark {
+    const std::vector<size_t> icosphere_levels = {2, 4, 6};
+    const std::vector<size_t> box_sizes = {8, 16, 32};
+
+    /**
+     * Inputs are generated lazily, on the first run that needs them.
+     */
+    struct Input {
+        std::string name;
+        std::function<Mesh::Ptr()> get_mesh;
+        bool is_volume;
+    };
+
+    std::vector<Input> get_inputs() {
+        std::vector<Input> inputs;
+        for (size_t level : icosphere_levels) {
+            inputs.push_back({"icosphere:" + std::to_string(level),
+                    [=]() { return BenchmarkInputs::get_icosphere(level); },
+                    false});
+        }
+        for (size_t size : box_sizes) {
+            inputs.push_back({"box:" + std::to_string(size),
+                    [=]() { return BenchmarkInputs::get_box_mesh(size); },
+                    true});
+        }
+        return inputs;
+    }
+
+    void register_io_benchmarks() {
+        const std::vector<std::string> surface_formats = {
+            "obj", "off", "ply", "stl", "msh", "mesh"};
+        const std::vector<std::string> volume_formats = {"msh", "mesh"};
+
+        auto add = [](const std::string& format, const Input& input) {
+            std::string basename = input.name;
+            std::replace(basename.begin(), basename.end(), ':', '_');
+            const std::string filename = BenchmarkInputs::get_scratch_file(
+                    basename + "." + format);
+            const auto get_mesh = input.get_mesh;
+            register_benchmark("MeshIO/save/" + format + "/" + input.name,
+                    [=](State& state) {
+                        Mesh::Ptr mesh = get_mesh();
+                        while (state.keep_running()) {
+                            MeshWriter::Ptr writer = MeshWriter::create(filename);
+                            writer->write_mesh(*mesh);
+                        }
+                        std::remove(filename.c_str());
+                    });
+            register_benchmark("MeshIO/load/" + format + "/" + input.name,
+                    [=](State& state) {
+                        Mesh::Ptr mesh = get_mesh();
+                        MeshWriter::create(filename)->write_mesh(*mesh);
+                        while (state.keep_running()) {
+                            MeshFactory().load_file(filename).create();
+                        }
+                        state.set_items_processed(mesh->get_num_vertices());
+                        std::remove(filename.c_str());
+                    });
+        };
+
+        for (const auto& input : get_inputs()) {
+            const auto& formats = input.is_volume ?
+                volume_formats : surface_formats;
+            for (const auto& format : formats) {
+                add(format, input);
+            }
+        }
+    }
+
+    void register_connectivity_benchmarks() {
+        for (const auto& input : get_inputs()) {
+            const auto get_mesh = input.get_mesh;
+            register_benchmark("MeshConnectivity/init/" + input.name,
+                    [=](State& state) {
+                        Mesh::Ptr source = get_mesh();
+                        while (state.keep_running()) {
+                            state.pause_timing();
+                            Mesh::Ptr mesh = BenchmarkInputs::copy_mesh(source);
+                            state.resume_timing();
+                            mesh->enable_connectivity();
+                        }
+                        state.set_items_processed(source->get_num_vertices());
+                    });
+        }
+    }
+
+    void register_attribute_benchmarks() {
+        const std::vector<std::string> surface_attributes = {
+            "vertex_normal", "vertex_area", "vertex_laplacian",
+            "vertex_mean_curvature", "vertex_gaussian_curvature",
+            "vertex_index", "vertex_valance", "vertex_dihedral_angle",
+            "vertex_voronoi_area", "edge_length", "edge_squared_length",
+            "edge_dihedral_angle", "face_area", "face_aspect_ratio",
+            "face_centroid", "face_circumcenter", "face_circumradius",
+            "face_edge_ratio", "face_frame", "face_incircle_center",
+            "face_incircle_radius", "face_index", "face_normal",
+            "face_radius_edge_ratio", "face_voronoi_area"};
+        const std::vector<std::string> volume_attributes = {
+            "vertex_volume", "voxel_dihedral_angle", "voxel_edge_ratio",
+            "voxel_face_index", "voxel_centroid", "voxel_circumcenter",
+            "voxel_circumradius", "voxel_incenter", "voxel_inradius",
+            "voxel_index", "voxel_radius_edge_ratio", "voxel_volume"};
+
+        auto add = [](const std::string& attr_name, const Input& input) {
+            const auto get_mesh = input.get_mesh;
+            register_benchmark("MeshAttribute/" + attr_name + "/" + input.name,
+                    [=](State& state) {
+                        Mesh::Ptr mesh = BenchmarkInputs::copy_mesh(get_mesh());
+                        mesh->enable_connectivity();
+                        while (state.keep_running()) {
+                            mesh->add_attribute(attr_name);
+                            state.pause_timing();
+                            mesh->remove_attribute(attr_name);
+                            state.resume_timing();
+                        }
+                    });
+        };
+
+        for (const auto& input : get_inputs()) {
+            for (const auto& attr_name : surface_attributes) {
+                add(attr_name, input);
+            }
+            if (!input.is_volume) continue;
+            for (const auto& attr_name : volume_attributes) {
+                add(attr_name, input);
+            }
+        }
+    }
+
+    void register_benchmarks() {
+        register_io_benchmarks();
+        register_connectivity_benchmarks();
+        register_attribute_benchmarks();
+    }
+}
+
+PYMESH_BENCHMARK_GROUP(MeshBenchmark::register_benchmarks)
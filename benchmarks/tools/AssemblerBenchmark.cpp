@@ -0,0 +1,50 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include <string>
+#include <vector>
+
+#include <Assembler/FEAssembler.h>
+
+#include <Benchmark.h>
+#include <BenchmarkInputs.h>
+
+using namespace PyMesh;
+using namespace PyMesh::Benchmark;
+
+namespace AssemblerBenchmark {
+    const std::vector<size_t> box_sizes = {8, 16};
+    const std::vector<std::string> matrix_names = {
+        "stiffness", "mass", "lumped_mass", "laplacian"};
+
+    void register_benchmarks() {
+        for (size_t size : box_sizes) {
+            const std::string name = "box:" + std::to_string(size);
+            register_benchmark("FEAssembler/setup/" + name,
+                    [=](State& state) {
+                        Mesh::Ptr source = BenchmarkInputs::get_box_mesh(size);
+                        while (state.keep_running()) {
+                            state.pause_timing();
+                            Mesh::Ptr mesh = BenchmarkInputs::copy_mesh(source);
+                            state.resume_timing();
+                            FEAssembler::create_from_name(mesh, "test_material");
+                        }
+                        state.set_items_processed(source->get_num_voxels());
+                    });
+
+            for (const auto& matrix_name : matrix_names) {
+                register_benchmark("FEAssembler/" + matrix_name + "/" + name,
+                        [=](State& state) {
+                            Mesh::Ptr mesh = BenchmarkInputs::copy_mesh(
+                                    BenchmarkInputs::get_box_mesh(size));
+                            FEAssembler assembler = FEAssembler::create_from_name(
+                                    mesh, "test_material");
+                            while (state.keep_running()) {
+                                assembler.assemble(matrix_name);
+                            }
+                            state.set_items_processed(mesh->get_num_voxels());
+                        });
+            }
+        }
+    }
+}
+
+PYMESH_BENCHMARK_GROUP(AssemblerBenchmark::register_benchmarks)
@@ -0,0 +1,58 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include <string>
+#include <vector>
+
+#include <BVH/BVHEngine.h>
+
+#include <Benchmark.h>
+#include <BenchmarkInputs.h>
+
+using namespace PyMesh;
+using namespace PyMesh::Benchmark;
+
+namespace BVHBenchmark {
+    const std::vector<size_t> icosphere_levels = {4, 6};
+    const size_t num_queries = 100000;
+
+    void register_benchmarks() {
+        for (const auto& engine_name : BVHEngine::get_available_engines()) {
+            for (size_t level : icosphere_levels) {
+                const std::string name = engine_name + "/icosphere:" +
+                    std::to_string(level);
+                register_benchmark("BVHEngine/build/" + name,
+                        [=](State& state) {
+                            Mesh::Ptr mesh = BenchmarkInputs::get_icosphere(level);
+                            const MatrixFr vertices = mesh->get_vertex_matrix();
+                            const MatrixIr faces = mesh->get_face_matrix();
+                            while (state.keep_running()) {
+                                BVHEngine::Ptr bvh = BVHEngine::create(
+                                        engine_name, 3);
+                                bvh->set_mesh(vertices, faces);
+                                bvh->build();
+                            }
+                            state.set_items_processed(faces.rows());
+                        });
+                register_benchmark("BVHEngine/lookup/" + name,
+                        [=](State& state) {
+                            Mesh::Ptr mesh = BenchmarkInputs::get_icosphere(level);
+                            BVHEngine::Ptr bvh = BVHEngine::create(engine_name, 3);
+                            bvh->set_mesh(mesh->get_vertex_matrix(),
+                                    mesh->get_face_matrix());
+                            bvh->build();
+                            const MatrixFr points =
+                                BenchmarkInputs::get_query_points(num_queries);
+                            VectorF squared_distances;
+                            VectorI closest_faces;
+                            MatrixFr closest_points;
+                            while (state.keep_running()) {
+                                bvh->lookup(points, squared_distances,
+                                        closest_faces, closest_points);
+                            }
+                            state.set_items_processed(num_queries);
+                        });
+            }
+        }
+    }
+}
+
+PYMESH_BENCHMARK_GROUP(BVHBenchmark::register_benchmarks)
@@ -0,0 +1,58 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <Boolean/BooleanEngine.h>
+
+#include <Benchmark.h>
+#include <BenchmarkInputs.h>
+
+using namespace PyMesh;
+using namespace PyMesh::Benchmark;
+
+namespace BooleanBenchmark {
+    const std::vector<size_t> icosphere_levels = {3, 5};
+
+    typedef std::function<void(BooleanEngine&)> Operation;
+
+    void register_benchmarks() {
+        const std::vector<std::pair<std::string, Operation> > operations = {
+            {"union", [](BooleanEngine& e) { e.compute_union(); }},
+            {"intersection", [](BooleanEngine& e) { e.compute_intersection(); }},
+            {"difference", [](BooleanEngine& e) { e.compute_difference(); }}
+        };
+
+        for (const auto& engine_name : BooleanEngine::get_available_engines()) {
+            for (size_t level : icosphere_levels) {
+                for (const auto& op : operations) {
+                    const Operation compute = op.second;
+                    register_benchmark("BooleanEngine/" + op.first + "/" +
+                            engine_name + "/icosphere:" + std::to_string(level),
+                            [=](State& state) {
+                                Mesh::Ptr mesh =
+                                    BenchmarkInputs::get_icosphere(level);
+                                const MatrixFr vertices_1 =
+                                    mesh->get_vertex_matrix();
+                                const MatrixIr faces = mesh->get_face_matrix();
+                                // Shifted so that the two spheres overlap
+                                // without sharing any vertex.
+                                MatrixFr vertices_2 = vertices_1;
+                                vertices_2.rowwise() +=
+                                    Vector3F(0.5, 0.25, 0.125).transpose();
+                                while (state.keep_running()) {
+                                    BooleanEngine::Ptr engine =
+                                        BooleanEngine::create(engine_name);
+                                    engine->set_mesh_1(vertices_1, faces);
+                                    engine->set_mesh_2(vertices_2, faces);
+                                    compute(*engine);
+                                }
+                                state.set_items_processed(faces.rows() * 2);
+                            });
+                }
+            }
+        }
+    }
+}
+
+PYMESH_BENCHMARK_GROUP(BooleanBenchmark::register_benchmarks)
@@ -0,0 +1,90 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include <string>
+#include <vector>
+
+#include <MeshUtils/BoxMeshGenerator.h>
+#include <MeshUtils/DuplicatedVertexRemoval.h>
+#include <MeshUtils/ShortEdgeRemoval.h>
+
+#include <Benchmark.h>
+#include <BenchmarkInputs.h>
+
+using namespace PyMesh;
+using namespace PyMesh::Benchmark;
+
+namespace MeshUtilsBenchmark {
+    const std::vector<size_t> icosphere_levels = {4, 6};
+    const std::vector<size_t> box_resolutions = {32, 128};
+
+    Float get_average_edge_length(const MatrixFr& vertices,
+            const MatrixIr& faces) {
+        Float total = 0.0;
+        const size_t num_faces = faces.rows();
+        for (size_t i=0; i<num_faces; i++) {
+            for (size_t j=0; j<3; j++) {
+                total += (vertices.row(faces(i, j)) -
+                        vertices.row(faces(i, (j+1)%3))).norm();
+            }
+        }
+        return num_faces > 0 ? total / (num_faces * 3) : 0.0;
+    }
+
+    void register_benchmarks() {
+        for (size_t level : icosphere_levels) {
+            const std::string name = "icosphere:" + std::to_string(level);
+            register_benchmark("ShortEdgeRemoval/run/" + name,
+                    [=](State& state) {
+                        Mesh::Ptr mesh = BenchmarkInputs::get_icosphere(level);
+                        const MatrixFr vertices = mesh->get_vertex_matrix();
+                        const MatrixIr faces = mesh->get_face_matrix();
+                        const Float threshold =
+                            0.5 * get_average_edge_length(vertices, faces);
+                        while (state.keep_running()) {
+                            ShortEdgeRemoval remover(vertices, faces);
+                            remover.run(threshold);
+                        }
+                        state.set_items_processed(faces.rows());
+                    });
+
+            // Every face gets its own copy of its vertices, so each vertex is
+            // duplicated about 6 times.
+            register_benchmark("DuplicatedVertexRemoval/run/" + name,
+                    [=](State& state) {
+                        Mesh::Ptr mesh = BenchmarkInputs::get_icosphere(level);
+                        const MatrixFr ori_vertices = mesh->get_vertex_matrix();
+                        const MatrixIr ori_faces = mesh->get_face_matrix();
+                        const size_t num_faces = ori_faces.rows();
+                        MatrixFr vertices(num_faces * 3, 3);
+                        MatrixIr faces(num_faces, 3);
+                        for (size_t i=0; i<num_faces; i++) {
+                            for (size_t j=0; j<3; j++) {
+                                vertices.row(i*3+j) =
+                                    ori_vertices.row(ori_faces(i, j));
+                                faces(i, j) = i*3+j;
+                            }
+                        }
+                        while (state.keep_running()) {
+                            DuplicatedVertexRemoval remover(vertices, faces);
+                            remover.run(1e-6);
+                        }
+                        state.set_items_processed(vertices.rows());
+                    });
+        }
+
+        for (size_t n : box_resolutions) {
+            const std::string name = "box:" + std::to_string(n);
+            register_benchmark("BoxMeshGenerator/run/" + name,
+                    [=](State& state) {
+                        BoxMeshGenerator generator(Vector3F(0, 0, 0),
+                                Vector3F(1, 1, 1), Vector3I(n, n, n));
+                        while (state.keep_running()) {
+                            generator.run(BoxMeshGenerator::SYMMETRIC_SIMPLEX);
+                        }
+                        state.set_items_processed(
+                                generator.get_elements().rows());
+                    });
+        }
+    }
+}
+
+PYMESH_BENCHMARK_GROUP(MeshUtilsBenchmark::register_benchmarks)
@@ -0,0 +1,47 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include <string>
+#include <vector>
+
+#include <Tetrahedralization/TetrahedralizationEngine.h>
+
+#include <Benchmark.h>
+#include <BenchmarkInputs.h>
+
+using namespace PyMesh;
+using namespace PyMesh::Benchmark;
+
+namespace TetrahedralizationBenchmark {
+    /**
+     * Engines compiled out of this build report an error instead of timings.
+     */
+    const std::vector<std::string> engine_names = {
+        "cgal", "tetgen", "geogram", "quartet", "mmg", "tetwild"};
+    const std::vector<size_t> icosphere_levels = {2, 4};
+
+    void register_benchmarks() {
+        for (const auto& engine_name : engine_names) {
+            for (size_t level : icosphere_levels) {
+                register_benchmark("Tetrahedralization/" + engine_name +
+                        "/icosphere:" + std::to_string(level),
+                        [=](State& state) {
+                            Mesh::Ptr mesh = BenchmarkInputs::get_icosphere(level);
+                            const MatrixFr vertices = mesh->get_vertex_matrix();
+                            const MatrixIr faces = mesh->get_face_matrix();
+                            TetrahedralizationEngine::Ptr engine =
+                                TetrahedralizationEngine::create(engine_name);
+                            while (state.keep_running()) {
+                                engine->set_vertices(vertices);
+                                engine->set_faces(faces);
+                                engine->set_cell_radius_edge_ratio(2.0);
+                                engine->set_cell_size(0.1);
+                                engine->run();
+                            }
+                            state.set_items_processed(
+                                    engine->get_voxels().rows());
+                        });
+            }
+        }
+    }
+}
+
+PYMESH_BENCHMARK_GROUP(TetrahedralizationBenchmark::register_benchmarks)
@@ -0,0 +1,54 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include <string>
+#include <vector>
+
+#include <Wires/Tiler/WireTiler.h>
+#include <Wires/WireNetwork/WireNetwork.h>
+
+#include <Benchmark.h>
+#include <BenchmarkInputs.h>
+
+using namespace PyMesh;
+using namespace PyMesh::Benchmark;
+
+namespace WiresBenchmark {
+    const std::vector<size_t> repetitions = {4, 8, 16};
+
+    /**
+     * Body centered cubic unit cell: the center is connected to all 8
+     * corners of the unit cube.
+     */
+    WireNetwork::Ptr get_unit_lattice() {
+        MatrixFr vertices(9, 3);
+        vertices <<
+            0, 0, 0,   1, 0, 0,   1, 1, 0,   0, 1, 0,
+            0, 0, 1,   1, 0, 1,   1, 1, 1,   0, 1, 1,
+            0.5, 0.5, 0.5;
+        MatrixIr edges(8, 2);
+        edges << 8, 0,  8, 1,  8, 2,  8, 3,  8, 4,  8, 5,  8, 6,  8, 7;
+        return WireNetwork::create_raw(vertices, edges);
+    }
+
+    void register_benchmarks() {
+        for (size_t reps : repetitions) {
+            const std::string name = "bcc:" + std::to_string(reps);
+            register_benchmark("WireTiler/guide_bbox/" + name,
+                    [=](State& state) {
+                        WireNetwork::Ptr unit = get_unit_lattice();
+                        const VectorF bbox_min = VectorF::Zero(3);
+                        const VectorF bbox_max = VectorF::Constant(3, reps);
+                        const VectorI reps_per_axis = VectorI::Constant(3, reps);
+                        size_t num_edges = 0;
+                        while (state.keep_running()) {
+                            WireTiler tiler(unit);
+                            WireNetwork::Ptr tiled = tiler.tile_with_guide_bbox(
+                                    bbox_min, bbox_max, reps_per_axis);
+                            num_edges = tiled->get_num_edges();
+                        }
+                        state.set_items_processed(num_edges);
+                    });
+        }
+    }
+}
+
+PYMESH_BENCHMARK_GROUP(WiresBenchmark::register_benchmarks)
@@ -0,0 +1,23 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <memory>
+
+#include <pybind11/pybind11.h>
+
+namespace PyMesh {
+
+/**
+ * Hold a reference to a python object (typically the numpy arrays whose
+ * buffers are borrowed) for as long as the returned handle is alive.  The
+ * handle may be released from any thread.
+ */
+inline std::shared_ptr<const void> make_array_owner(pybind11::object obj) {
+    return std::shared_ptr<const void>(new pybind11::object(std::move(obj)),
+            [](const void* ptr) {
+                pybind11::gil_scoped_acquire gil;
+                delete static_cast<const pybind11::object*>(ptr);
+            });
+}
+
+}
@@ -26,6 +26,12 @@ void init_CGAL(py::module &m) {
         .def(py::init<const MatrixFr& , const MatrixIr&>())
         .def("detect_self_intersection",
                 &SelfIntersection::detect_self_intersection)
+        .def("update", static_cast<void (SelfIntersection::*)(
+                    const MatrixFr&, const MatrixIr&, const VectorI&,
+                    const VectorI&)>(&SelfIntersection::update))
+        .def("update", static_cast<void (SelfIntersection::*)(
+                    const MatrixFr&, const MatrixIr&, const VectorI&)>(
+                    &SelfIntersection::update))
         .def("clear", &SelfIntersection::clear)
         .def("get_self_intersecting_pairs",
                 &SelfIntersection::get_self_intersecting_pairs)
@@ -2,6 +2,7 @@
 
 #include <pybind11/pybind11.h>
 #include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
 #include <Compression/CompressionEngine.h>
@@ -9,7 +10,47 @@
 namespace py = pybind11;
 using namespace PyMesh;
 
+namespace PyCompressionHelper {
+    /**
+     * Compressed bytes exposed through the buffer protocol, so Python can
+     * read them without a copy.
+     */
+    struct CompressedBuffer {
+        CompressionEngine::Buffer data;
+    };
+
+    /**
+     * The view is only valid while info is alive, since releasing it may
+     * release the underlying buffer.
+     */
+    CompressionEngine::DataView get_view(const py::buffer_info& info) {
+        return {static_cast<const char*>(info.ptr),
+            size_t(info.size * info.itemsize)};
+    }
+}
+
+using namespace PyCompressionHelper;
+
 void init_Compression(py::module& m) {
+    py::class_<CompressedBuffer>(m, "CompressedBuffer", py::buffer_protocol())
+        .def_buffer([](CompressedBuffer& buffer) {
+                return py::buffer_info(buffer.data.data(), 1,
+                        py::format_descriptor<uint8_t>::format(), 1,
+                        {buffer.data.size()}, {1});
+                })
+        .def("__len__", [](const CompressedBuffer& buffer) {
+                return buffer.data.size(); });
+
+    py::class_<CompressionEngine::Options>(m, "CompressionOptions")
+        .def(py::init<>())
+        .def_readwrite("position_bits", &CompressionEngine::Options::position_bits)
+        .def_readwrite("normal_bits", &CompressionEngine::Options::normal_bits)
+        .def_readwrite("texture_bits", &CompressionEngine::Options::texture_bits)
+        .def_readwrite("generic_bits", &CompressionEngine::Options::generic_bits)
+        .def_readwrite("encoding_speed", &CompressionEngine::Options::encoding_speed)
+        .def_readwrite("decoding_speed", &CompressionEngine::Options::decoding_speed)
+        .def_readwrite("with_attributes", &CompressionEngine::Options::with_attributes);
+
     py::class_<CompressionEngine, std::shared_ptr<CompressionEngine> >(m, "CompressionEngine")
         .def_static("create", &CompressionEngine::create)
         .def_static("supports", &CompressionEngine::supports)
@@ -21,5 +62,79 @@ void init_Compression(py::module& m) {
                 const auto data = engine->compress(mesh);
                 return py::bytes(data);
                 })
-        .def("decompress", &CompressionEngine::decompress);
+        .def("compress",
+                [](const std::shared_ptr<CompressionEngine> engine,
+                    PyMesh::Mesh::Ptr mesh,
+                    const CompressionEngine::Options& options) {
+                CompressedBuffer buffer;
+                {
+                    py::gil_scoped_release release;
+                    buffer.data = engine->compress(mesh, options);
+                }
+                return buffer;
+                })
+        .def("compress_batch",
+                [](const std::shared_ptr<CompressionEngine> engine,
+                    const std::vector<PyMesh::Mesh::Ptr>& meshes,
+                    const CompressionEngine::Options& options) {
+                std::vector<CompressionEngine::Buffer> data;
+                {
+                    py::gil_scoped_release release;
+                    data = engine->compress_batch(meshes, options);
+                }
+                std::vector<CompressedBuffer> buffers(data.size());
+                for (size_t i=0; i<data.size(); i++) {
+                    buffers[i].data.swap(data[i]);
+                }
+                return buffers;
+                })
+        .def("decompress",
+                [](const std::shared_ptr<CompressionEngine> engine,
+                    py::buffer data) {
+                const py::buffer_info info = data.request();
+                const auto view = get_view(info);
+                py::gil_scoped_release release;
+                return engine->decompress(view.first, view.second);
+                })
+        .def("decompress_batch",
+                [](const std::shared_ptr<CompressionEngine> engine,
+                    const std::vector<py::buffer>& data) {
+                // Buffers must be resolved while holding the GIL, and kept
+                // until the GIL is acquired again.
+                std::vector<py::buffer_info> infos;
+                std::vector<CompressionEngine::DataView> views;
+                infos.reserve(data.size());
+                views.reserve(data.size());
+                for (const auto& item : data) {
+                    infos.push_back(item.request());
+                    views.push_back(get_view(infos.back()));
+                }
+                py::gil_scoped_release release;
+                return engine->decompress_batch(views);
+                })
+        .def("decompress_into",
+                [](const std::shared_ptr<CompressionEngine> engine,
+                    py::buffer data,
+                    py::array_t<Float, py::array::c_style> vertices,
+                    py::array_t<int, py::array::c_style> faces) {
+                const py::buffer_info info = data.request();
+                const auto view = get_view(info);
+                auto vertex_info = vertices.request(true);
+                auto face_info = faces.request(true);
+                CompressionEngine::DecodedSize size;
+                {
+                    py::gil_scoped_release release;
+                    size = engine->decompress_into(view.first, view.second,
+                            static_cast<Float*>(vertex_info.ptr),
+                            vertex_info.size,
+                            static_cast<int*>(face_info.ptr),
+                            face_info.size);
+                }
+                return py::make_tuple(size.dim, size.num_vertices,
+                        size.num_faces);
+                },
+                // Converting would decode into a temporary copy.
+                py::arg("data"),
+                py::arg("vertices").noconvert(),
+                py::arg("faces").noconvert());
 }
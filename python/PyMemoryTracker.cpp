@@ -0,0 +1,33 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <Misc/MemoryTracker.h>
+
+namespace py = pybind11;
+using namespace PyMesh;
+
+void init_MemoryTracker(py::module &m) {
+    py::class_<MemoryTracker::Usage>(m, "MemoryUsage")
+        .def_readonly("allocated", &MemoryTracker::Usage::allocated)
+        .def_readonly("freed", &MemoryTracker::Usage::freed)
+        .def_readonly("live", &MemoryTracker::Usage::live)
+        .def_readonly("peak", &MemoryTracker::Usage::peak)
+        .def_readonly("num_allocations",
+                &MemoryTracker::Usage::num_allocations);
+
+    py::class_<MemoryTracker::StageSummary>(m, "MemoryStageSummary")
+        .def_readonly("name", &MemoryTracker::StageSummary::name)
+        .def_readonly("count", &MemoryTracker::StageSummary::count)
+        .def_readonly("allocated", &MemoryTracker::StageSummary::allocated)
+        .def_readonly("freed", &MemoryTracker::StageSummary::freed)
+        .def_readonly("peak", &MemoryTracker::StageSummary::peak);
+
+    py::class_<MemoryTracker>(m, "MemoryTracker")
+        .def_static("is_supported", &MemoryTracker::is_supported)
+        .def_static("start", &MemoryTracker::start)
+        .def_static("stop", &MemoryTracker::stop)
+        .def_static("is_enabled", &MemoryTracker::is_enabled)
+        .def_static("get_usage", &MemoryTracker::get_usage)
+        .def_static("reset_peak", &MemoryTracker::reset_peak)
+        .def_static("get_summary", &MemoryTracker::get_summary);
+}
@@ -1,9 +1,12 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
 #include <Mesh.h>
 
+#include "PyArrayOwner.h"
+
 namespace py = pybind11;
 using namespace PyMesh;
 
@@ -21,6 +24,18 @@ void init_Mesh(py::module &m) {
                 py::return_value_policy::reference_internal)
         .def("get_voxels", py::overload_cast<>(&Mesh::get_voxels, py::const_),
                 py::return_value_policy::reference_internal)
+        .def("get_vertex_matrix", &Mesh::get_vertex_matrix,
+                py::return_value_policy::reference_internal)
+        .def("get_face_matrix", &Mesh::get_face_matrix,
+                py::return_value_policy::reference_internal)
+        .def("get_voxel_matrix", &Mesh::get_voxel_matrix,
+                py::return_value_policy::reference_internal)
+        .def("has_single_precision_vertices",
+                &Mesh::has_single_precision_vertices)
+        .def("get_vertex_matrix_f32", &Mesh::get_vertex_matrix_f32,
+                py::return_value_policy::reference_internal)
+        .def("convert_vertices_to_single_precision",
+                &Mesh::convert_vertices_to_single_precision)
         .def("enable_connectivity", &Mesh::enable_connectivity)
         .def("enable_vertex_connectivity", &Mesh::enable_vertex_connectivity)
         .def("enable_face_connectivity", &Mesh::enable_face_connectivity)
@@ -44,6 +59,33 @@ void init_Mesh(py::module &m) {
         .def("remove_attribute", &Mesh::remove_attribute)
         .def("get_attribute", py::overload_cast<const std::string&>(&Mesh::get_attribute, py::const_),
                 py::return_value_policy::reference_internal)
-        .def("set_attribute", &Mesh::set_attribute)
+        .def("get_attribute_view", &Mesh::get_attribute_view,
+                py::return_value_policy::reference_internal)
+        .def("set_attribute",
+                [](Mesh& self, const std::string& name, VectorF value) {
+                    self.adopt_attribute(name, value);
+                })
+        .def("borrow_attribute",
+                [](Mesh& self, const std::string& name,
+                    py::array_t<Float, py::array::c_style | py::array::forcecast> value) {
+                    self.borrow_attribute(name, value.data(), value.size(),
+                            make_array_owner(value));
+                })
+        .def("is_single_precision_attribute",
+                &Mesh::is_single_precision_attribute)
+        .def("get_attribute_view_f32", &Mesh::get_attribute_view_f32,
+                py::return_value_policy::reference_internal)
+        .def("set_attribute_f32",
+                [](Mesh& self, const std::string& name, VectorF32 value) {
+                    self.adopt_attribute_f32(name, value);
+                })
+        .def("borrow_attribute_f32",
+                [](Mesh& self, const std::string& name,
+                    py::array_t<float, py::array::c_style | py::array::forcecast> value) {
+                    self.borrow_attribute_f32(name, value.data(), value.size(),
+                            make_array_owner(value));
+                })
+        .def("convert_attribute_to_single_precision",
+                &Mesh::convert_attribute_to_single_precision)
         .def("get_attribute_names", &Mesh::get_attribute_names);
 }
@@ -1,10 +1,14 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
+#include <Core/Exception.h>
 #include <Mesh.h>
 #include <MeshFactory.h>
 
+#include "PyArrayOwner.h"
+
 namespace py = pybind11;
 using namespace PyMesh;
 
@@ -19,11 +23,59 @@ void init_MeshFactory(py::module &m) {
                 py::return_value_policy::reference_internal)
         .def("load_matrices", &MeshFactory::load_matrices,
                 py::return_value_policy::reference_internal)
+        .def("borrow_matrices",
+                [](MeshFactory& self,
+                    py::array_t<Float, py::array::c_style | py::array::forcecast> vertices,
+                    py::array_t<int, py::array::c_style | py::array::forcecast> faces,
+                    py::array_t<int, py::array::c_style | py::array::forcecast> voxels)
+                -> MeshFactory& {
+                    if (vertices.ndim() != 2 || faces.ndim() != 2 ||
+                            voxels.ndim() != 2) {
+                        throw RuntimeError("Expect 2D arrays.");
+                    }
+                    // forcecast may have made copies, so keep the converted
+                    // arrays alive rather than the arguments.
+                    return self.borrow_matrices(
+                            Eigen::Map<const MatrixFr>(vertices.data(),
+                                vertices.shape(0), vertices.shape(1)),
+                            Eigen::Map<const MatrixIr>(faces.data(),
+                                faces.shape(0), faces.shape(1)),
+                            Eigen::Map<const MatrixIr>(voxels.data(),
+                                voxels.shape(0), voxels.shape(1)),
+                            make_array_owner(py::make_tuple(
+                                    vertices, faces, voxels)));
+                },
+                py::arg("vertices"), py::arg("faces"), py::arg("voxels"),
+                py::return_value_policy::reference_internal)
+        .def("borrow_matrices_f32",
+                [](MeshFactory& self,
+                    py::array_t<float, py::array::c_style | py::array::forcecast> vertices,
+                    py::array_t<int, py::array::c_style | py::array::forcecast> faces,
+                    py::array_t<int, py::array::c_style | py::array::forcecast> voxels)
+                -> MeshFactory& {
+                    if (vertices.ndim() != 2 || faces.ndim() != 2 ||
+                            voxels.ndim() != 2) {
+                        throw RuntimeError("Expect 2D arrays.");
+                    }
+                    return self.borrow_matrices(
+                            Eigen::Map<const MatrixF32r>(vertices.data(),
+                                vertices.shape(0), vertices.shape(1)),
+                            Eigen::Map<const MatrixIr>(faces.data(),
+                                faces.shape(0), faces.shape(1)),
+                            Eigen::Map<const MatrixIr>(voxels.data(),
+                                voxels.shape(0), voxels.shape(1)),
+                            make_array_owner(py::make_tuple(
+                                    vertices, faces, voxels)));
+                },
+                py::arg("vertices"), py::arg("faces"), py::arg("voxels"),
+                py::return_value_policy::reference_internal)
         .def("with_connectivity", &MeshFactory::with_connectivity,
                 py::return_value_policy::reference_internal)
         .def("with_attribute", &MeshFactory::with_attribute,
                 py::return_value_policy::reference_internal)
         .def("drop_zero_dim", &MeshFactory::drop_zero_dim,
                 py::return_value_policy::reference_internal)
+        .def("with_single_precision", &MeshFactory::with_single_precision,
+                py::return_value_policy::reference_internal)
         .def("create", &MeshFactory::create);
 }
@@ -3,8 +3,10 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/eigen.h>
 #include <pybind11/stl.h>
+#include <pybind11/functional.h>
 
 #include <Mesh.h>
+#include <MeshUtils/AttributeTransfer.h>
 #include <MeshUtils/AttributeUtils.h>
 #include <MeshUtils/EdgeUtils.h>
 #include <MeshUtils/ObtuseTriangleRemoval.h>
@@ -13,8 +15,11 @@
 #include <MeshUtils/MeshCutter.h>
 #include <MeshUtils/MeshUtils.h>
 #include <MeshUtils/MeshSeparator.h>
+#include <MeshUtils/MeshSlicer.h>
 #include <MeshUtils/MeshChecker.h>
+#include <MeshUtils/OutOfCoreMesh.h>
 #include <MeshUtils/Boundary.h>
+#include <MeshUtils/BoxMeshGenerator.h>
 #include <MeshUtils/PointLocator.h>
 #include <MeshUtils/Subdivision.h>
 #include <MeshUtils/DuplicatedVertexRemoval.h>
@@ -75,6 +80,12 @@ void init_MeshUtils(py::module& m) {
         .def("separate", &MeshSeparator::separate)
         .def("get_component", &MeshSeparator::get_component)
         .def("get_sources", &MeshSeparator::get_sources)
+        .def("get_labels", &MeshSeparator::get_labels,
+                py::return_value_policy::reference_internal)
+        .def("get_component_offsets", &MeshSeparator::get_component_offsets,
+                py::return_value_policy::reference_internal)
+        .def("get_component_elements", &MeshSeparator::get_component_elements,
+                py::return_value_policy::reference_internal)
         .def("clear", &MeshSeparator::clear);
 
     py::enum_<MeshSeparator::ConnectivityType>(separator, "ConnectivityType")
@@ -83,8 +94,37 @@ void init_MeshUtils(py::module& m) {
         .value("VOXEL", MeshSeparator::ConnectivityType::VOXEL)
         .export_values();
 
-    py::class_<MeshChecker>(m, "MeshChecker")
-        .def(py::init<const MatrixFr&, const MatrixIr&, const MatrixIr&>())
+    py::class_<MeshChecker> checker(m, "MeshChecker");
+    py::class_<MeshChecker::Report>(checker, "Report")
+        .def_readonly("vertex_manifold", &MeshChecker::Report::vertex_manifold)
+        .def_readonly("edge_manifold", &MeshChecker::Report::edge_manifold)
+        .def_readonly("closed", &MeshChecker::Report::closed)
+        .def_readonly("edge_with_odd_adj_faces",
+                &MeshChecker::Report::edge_with_odd_adj_faces)
+        .def_readonly("oriented", &MeshChecker::Report::oriented)
+        .def_readonly("complex_boundary",
+                &MeshChecker::Report::complex_boundary)
+        .def_readonly("num_boundary_edges",
+                &MeshChecker::Report::num_boundary_edges)
+        .def_readonly("num_boundary_loops",
+                &MeshChecker::Report::num_boundary_loops)
+        .def_readonly("euler_characteristic",
+                &MeshChecker::Report::euler_characteristic)
+        .def_readonly("genus", &MeshChecker::Report::genus)
+        .def_readonly("num_connected_components",
+                &MeshChecker::Report::num_connected_components)
+        .def_readonly("num_connected_surface_components",
+                &MeshChecker::Report::num_connected_surface_components)
+        .def_readonly("num_connected_volume_components",
+                &MeshChecker::Report::num_connected_volume_components)
+        .def_readonly("num_isolated_vertices",
+                &MeshChecker::Report::num_isolated_vertices)
+        .def_readonly("num_duplicated_faces",
+                &MeshChecker::Report::num_duplicated_faces)
+        .def_readonly("signed_volume", &MeshChecker::Report::signed_volume);
+
+    checker.def(py::init<const MatrixFr&, const MatrixIr&, const MatrixIr&>())
+        .def("check_all", &MeshChecker::check_all)
         .def("is_vertex_manifold", &MeshChecker::is_vertex_manifold)
         .def("is_edge_manifold", &MeshChecker::is_edge_manifold)
         .def("is_closed", &MeshChecker::is_closed)
@@ -112,6 +152,35 @@ void init_MeshUtils(py::module& m) {
         .def("compute_signed_volume_from_surface",
                 &MeshChecker::compute_signed_volume_from_surface);
 
+    py::class_<MeshSlicer>(m, "MeshSlicer")
+        .def(py::init<const MatrixFr&, const MatrixIr&>())
+        .def("slice", &MeshSlicer::slice)
+        .def("get_num_slices", &MeshSlicer::get_num_slices)
+        .def("get_slice_vertices", &MeshSlicer::get_slice_vertices)
+        .def("get_slice_edges", &MeshSlicer::get_slice_edges)
+        .def("get_slice_loops", &MeshSlicer::get_slice_loops);
+
+    py::class_<AttributeTransfer, std::shared_ptr<AttributeTransfer> >
+        transfer(m, "AttributeTransfer");
+    // Enum must be registered before it is used as default argument.
+    py::enum_<AttributeTransfer::Mode>(transfer, "Mode")
+        .value("NEAREST", AttributeTransfer::NEAREST)
+        .value("BARYCENTRIC", AttributeTransfer::BARYCENTRIC)
+        .value("AREA_WEIGHTED", AttributeTransfer::AREA_WEIGHTED)
+        .export_values();
+    transfer.def(py::init<Mesh::Ptr, Mesh::Ptr>())
+        .def("set_area_sampling_level",
+                &AttributeTransfer::set_area_sampling_level)
+        .def("transfer_vertex_attribute",
+                &AttributeTransfer::transfer_vertex_attribute,
+                "name"_a, "mode"_a=AttributeTransfer::BARYCENTRIC)
+        .def("transfer_face_attribute",
+                &AttributeTransfer::transfer_face_attribute,
+                "name"_a, "mode"_a=AttributeTransfer::NEAREST)
+        .def("transfer_corner_attribute",
+                &AttributeTransfer::transfer_corner_attribute,
+                "name"_a, "mode"_a=AttributeTransfer::BARYCENTRIC);
+
     py::class_<PointLocator>(m, "PointLocator")
         .def(py::init<Mesh::Ptr>())
         .def("locate", &PointLocator::locate)
@@ -119,17 +188,103 @@ void init_MeshUtils(py::module& m) {
         .def("get_barycentric_coords", &PointLocator::get_barycentric_coords)
         .def("clear", &PointLocator::clear);
 
-    py::class_<Subdivision, std::shared_ptr<Subdivision> >(m, "Subdivision")
-        .def_static("create", &Subdivision::create)
+    py::class_<Subdivision, std::shared_ptr<Subdivision> >
+        subdivision(m, "Subdivision");
+    subdivision.def_static("create", &Subdivision::create)
         .def("subdivide", &Subdivision::subdivide)
         .def("get_subdivision_matrices()",
                 &Subdivision::get_subdivision_matrices)
+        .def("set_matrix_mode", &Subdivision::set_matrix_mode)
+        .def("get_matrix_mode", &Subdivision::get_matrix_mode)
         .def("get_vertices", &Subdivision::get_vertices)
         .def("get_faces", &Subdivision::get_faces)
         .def("get_face_indices", &Subdivision::get_face_indices)
         .def("get_num_vertices", &Subdivision::get_num_vertices)
         .def("get_num_faces", &Subdivision::get_num_faces);
 
+    py::enum_<Subdivision::MatrixMode>(subdivision, "MatrixMode")
+        .value("PER_LEVEL_MATRICES", Subdivision::PER_LEVEL_MATRICES)
+        .value("COMPOSED_MATRIX", Subdivision::COMPOSED_MATRIX)
+        .value("MATRIX_FREE", Subdivision::MATRIX_FREE)
+        .export_values();
+
+    py::class_<BoxMeshGenerator> box_generator(m, "BoxMeshGenerator");
+    box_generator
+        .def(py::init<const VectorF&, const VectorF&, const VectorI&>())
+        .def("set_subdiv_order", &BoxMeshGenerator::set_subdiv_order)
+        .def("run", &BoxMeshGenerator::run)
+        .def("get_vertices", &BoxMeshGenerator::get_vertices,
+                py::return_value_policy::reference_internal)
+        .def("get_elements", &BoxMeshGenerator::get_elements,
+                py::return_value_policy::reference_internal)
+        .def("get_cell_index", &BoxMeshGenerator::get_cell_index,
+                py::return_value_policy::reference_internal);
+
+    py::enum_<BoxMeshGenerator::ElementType>(box_generator, "ElementType")
+        .value("SIMPLEX", BoxMeshGenerator::SIMPLEX)
+        .value("SYMMETRIC_SIMPLEX", BoxMeshGenerator::SYMMETRIC_SIMPLEX)
+        .value("CUBE", BoxMeshGenerator::CUBE)
+        .export_values();
+
+    py::class_<OutOfCoreMesh> out_of_core(m, "OutOfCoreMesh");
+    out_of_core
+        .def(py::init<const std::string&, Float, Float>(),
+                "work_dir"_a, "brick_size"_a, "halo_width"_a)
+        .def("import_ply", &OutOfCoreMesh::import_ply,
+                py::call_guard<py::gil_scoped_release>())
+        .def("import_mesh", &OutOfCoreMesh::import_mesh)
+        .def("export_ply", &OutOfCoreMesh::export_ply,
+                "filename"_a, "in_ascii"_a=false,
+                py::call_guard<py::gil_scoped_release>())
+        .def("export_mesh", [](const OutOfCoreMesh& self) {
+                MatrixFr vertices;
+                MatrixIr faces;
+                self.export_mesh(vertices, faces);
+                return std::make_tuple(vertices, faces);
+                })
+        .def_property_readonly("num_vertices", &OutOfCoreMesh::get_num_vertices)
+        .def_property_readonly("num_faces", &OutOfCoreMesh::get_num_faces)
+        .def_property_readonly("num_bricks", &OutOfCoreMesh::get_num_bricks)
+        .def_property_readonly("grid_size", &OutOfCoreMesh::get_grid_size)
+        .def("get_active_bricks", &OutOfCoreMesh::get_active_bricks)
+        .def("load_brick", &OutOfCoreMesh::load_brick)
+        .def("store_brick", &OutOfCoreMesh::store_brick)
+        .def("process", [](OutOfCoreMesh& self, py::function op) {
+                // Bricks are processed on TBB threads, which must hold the
+                // GIL while running Python code.
+                py::gil_scoped_release release;
+                self.process([&](OutOfCoreMesh::Brick& brick) {
+                    py::gil_scoped_acquire acquire;
+                    op(&brick);
+                    });
+                })
+        .def("remove_duplicated_vertices",
+                &OutOfCoreMesh::remove_duplicated_vertices,
+                py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly_static("INVALID",
+                [](py::object) { return OutOfCoreMesh::INVALID; });
+
+    py::class_<OutOfCoreMesh::Brick>(out_of_core, "Brick")
+        .def_readonly("index", &OutOfCoreMesh::Brick::index)
+        .def_readwrite("vertices", &OutOfCoreMesh::Brick::vertices)
+        .def_readwrite("faces", &OutOfCoreMesh::Brick::faces)
+        .def_readwrite("vertex_ids", &OutOfCoreMesh::Brick::vertex_ids)
+        .def_readwrite("vertex_bricks", &OutOfCoreMesh::Brick::vertex_bricks)
+        .def_readwrite("vertex_on_seam", &OutOfCoreMesh::Brick::vertex_on_seam)
+        .def_readwrite("face_owned", &OutOfCoreMesh::Brick::face_owned)
+        .def_readwrite("forwarded_vertices",
+                &OutOfCoreMesh::Brick::forwarded_vertices);
+
+    py::class_<HexToTet>(m, "HexToTet")
+        .def(py::init<const MatrixFr&, const MatrixIr&>())
+        .def("run", &HexToTet::run, "keep_symmetry"_a, "subdiv_order"_a=0)
+        .def("get_vertices", &HexToTet::get_vertices,
+                py::return_value_policy::reference_internal)
+        .def("get_voxels", &HexToTet::get_voxels,
+                py::return_value_policy::reference_internal)
+        .def("get_cell_index", &HexToTet::get_cell_index,
+                py::return_value_policy::reference_internal);
+
     py::class_<DuplicatedVertexRemoval>(m, "DuplicatedVertexRemoval")
         .def(py::init<const MatrixFr&, const MatrixIr&>())
         .def("run", &DuplicatedVertexRemoval::run)
@@ -8,8 +8,10 @@ extern "C"
 {
 #include <Predicates/predicates.h>
 }
+#include <Predicates/BatchPredicates.h>
 
 namespace py = pybind11;
+using namespace PyMesh;
 using Arr2D = Eigen::Matrix<double, 2, 1>;
 using Arr3D = Eigen::Matrix<double, 3, 1>;
 
@@ -47,4 +49,12 @@ void init_predicates(py::module& m) {
             [](Arr3D& pa, Arr3D& pb, Arr3D& pc, Arr3D& pd, Arr3D& pe) {
             return insphereexact(pa.data(), pb.data(), pc.data(), pd.data(), pe.data());
             });
+    m.def("orient2d_batch", &BatchPredicates::orient2d,
+            py::arg("points"), py::arg("queries"));
+    m.def("orient3d_batch", &BatchPredicates::orient3d,
+            py::arg("points"), py::arg("queries"));
+    m.def("incircle_batch", &BatchPredicates::incircle,
+            py::arg("points"), py::arg("queries"));
+    m.def("insphere_batch", &BatchPredicates::insphere,
+            py::arg("points"), py::arg("queries"));
 }
@@ -0,0 +1,53 @@
+#include <memory>
+#include <string>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <Misc/Profiler.h>
+
+namespace py = pybind11;
+using namespace PyMesh;
+
+namespace {
+    class ZoneGuard {
+        public:
+            ZoneGuard(const std::string& name)
+                : m_name(Profiler::intern(name)) {}
+
+            void open() { m_zone.reset(new ProfileZone(m_name)); }
+            void close() { m_zone.reset(); }
+
+        private:
+            const char* m_name;
+            std::unique_ptr<ProfileZone> m_zone;
+    };
+}
+
+void init_Profiler(py::module &m) {
+    py::class_<Profiler::ZoneSummary>(m, "ProfileZoneSummary")
+        .def_readonly("name", &Profiler::ZoneSummary::name)
+        .def_readonly("count", &Profiler::ZoneSummary::count)
+        .def_readonly("total_time", &Profiler::ZoneSummary::total_time)
+        .def_readonly("self_time", &Profiler::ZoneSummary::self_time)
+        .def_readonly("min_time", &Profiler::ZoneSummary::min_time)
+        .def_readonly("max_time", &Profiler::ZoneSummary::max_time);
+
+    py::class_<Profiler>(m, "Profiler")
+        .def_static("start", &Profiler::start,
+                py::arg("capacity")=size_t(1<<16))
+        .def_static("stop", &Profiler::stop)
+        .def_static("clear", &Profiler::clear)
+        .def_static("is_enabled", &Profiler::is_enabled)
+        .def_static("get_num_dropped_events",
+                &Profiler::get_num_dropped_events)
+        .def_static("get_summary", &Profiler::get_summary)
+        .def_static("get_chrome_trace", &Profiler::get_chrome_trace)
+        .def_static("dump_chrome_trace", &Profiler::dump_chrome_trace);
+
+    // Zones opened from Python may use any name, so names are interned.
+    py::class_<ZoneGuard>(m, "ProfileZone")
+        .def(py::init<const std::string&>())
+        .def("__enter__", [](ZoneGuard& self) { self.open(); })
+        .def("__exit__", [](ZoneGuard& self, py::args) { self.close(); });
+}
@@ -10,6 +10,7 @@
 #include <Wires/Tiler/WireTiler.h>
 #include <Wires/Inflator/WireProfile.h>
 #include <Wires/Inflator/InflatorEngine.h>
+#include <Wires/Inflator/TiledInflator.h>
 #include <Wires/Misc/SymmetryChecker.h>
 
 namespace py = pybind11;
@@ -85,6 +86,8 @@ void init_Wires(py::module &m) {
         .def("set_dofs", &ParameterManager::set_dofs)
         .def("compute_shape_velocity",
                 &ParameterManager::compute_shape_velocity)
+        .def("compute_sparse_shape_velocity",
+                &ParameterManager::compute_sparse_shape_velocity)
         .def("compute_wire_gradient", &ParameterManager::compute_wire_gradient)
         .def("get_thickness_dof_map", &ParameterManager::get_thickness_dof_map)
         .def("get_offset_dof_map", &ParameterManager::get_offset_dof_map)
@@ -123,6 +126,20 @@ void init_Wires(py::module &m) {
         .def("tile_with_guide_mesh", &WireTiler::tile_with_guide_mesh)
         .def("tile_with_mixed_patterns", &WireTiler::tile_with_mixed_patterns);
 
+    py::class_<TiledInflator, std::shared_ptr<TiledInflator> >(
+            m, "TiledInflator")
+        .def(py::init<WireNetwork::Ptr, ParameterManager::Ptr>())
+        .def("with_refinement", &TiledInflator::with_refinement)
+        .def("set_profile", &TiledInflator::set_profile)
+        .def("set_weld_tolerance", &TiledInflator::set_weld_tolerance)
+        .def("inflate_with_guide_bbox", &TiledInflator::inflate_with_guide_bbox)
+        .def("inflate_with_guide_mesh", &TiledInflator::inflate_with_guide_mesh)
+        .def("get_vertices", &TiledInflator::get_vertices)
+        .def("get_faces", &TiledInflator::get_faces)
+        .def("get_face_sources", &TiledInflator::get_face_sources)
+        .def("get_num_cached_cells", &TiledInflator::get_num_cached_cells)
+        .def("clear_cache", &TiledInflator::clear_cache);
+
     py::class_<WireProfile, std::shared_ptr<WireProfile> >(m, "WireProfile")
         .def_static("create", &WireProfile::create)
         .def_static("create_isotropic", &WireProfile::create_isotropic)
@@ -141,6 +158,7 @@ void init_Wires(py::module &m) {
         .def_static("create_isotropic_parametric",
                 &InflatorEngine::create_isotropic_parametric)
         .def("with_shape_velocities", &InflatorEngine::with_shape_velocities)
+        .def("with_partitions", &InflatorEngine::with_partitions)
         .def("inflate", &InflatorEngine::inflate)
         .def("get_shape_velocities", &InflatorEngine::get_shape_velocities)
         .def("set_uniform_thickness", &InflatorEngine::set_uniform_thickness)
@@ -34,6 +34,8 @@ void init_HashGrid(py::module&);
 void init_BVH(py::module&);
 void init_Geogram(py::module&);
 void init_Compression(py::module&);
+void init_Profiler(py::module&);
+void init_MemoryTracker(py::module&);
 
 PYBIND11_MODULE(PyMesh, m) {
     m.doc() = "Geometry Processing for Python.";
@@ -67,4 +69,6 @@ PYBIND11_MODULE(PyMesh, m) {
     init_BVH(m);
     init_Geogram(m);
     init_Compression(m);
+    init_Profiler(m);
+    init_MemoryTracker(m);
 }
@@ -73,16 +73,16 @@ class Mesh(object):
     def get_attribute(self, name):
         """ Return attribute values in a flattened array.
         """
-        return self.__mesh.get_attribute(name).ravel()
+        return self.__get_attribute_view(name).ravel()
 
     def get_vertex_attribute(self, name):
         """ Same as :py:meth:`.get_attribute` but reshaped to have
         :py:attr:`num_vertices` rows.
         """
         if self.num_vertices == 0:
-            return self.__mesh.get_attribute(name)
+            return self.__get_attribute_view(name)
         else:
-            return self.__mesh.get_attribute(name).reshape(
+            return self.__get_attribute_view(name).reshape(
                     (self.num_vertices, -1), order="C")
 
     def get_face_attribute(self, name):
@@ -90,9 +90,9 @@ class Mesh(object):
         :py:attr:`num_faces` rows.
         """
         if self.num_faces == 0:
-            return self.__mesh.get_attribute(name)
+            return self.__get_attribute_view(name)
         else:
-            return self.__mesh.get_attribute(name).reshape(
+            return self.__get_attribute_view(name).reshape(
                     (self.num_faces, -1), order="C")
 
     def get_voxel_attribute(self, name):
@@ -100,15 +100,41 @@ class Mesh(object):
         :py:attr:`num_voxels` rows.
         """
         if self.num_voxels == 0:
-            return self.__mesh.get_attribute(name)
+            return self.__get_attribute_view(name)
         else:
-            return self.__mesh.get_attribute(name).reshape(
+            return self.__get_attribute_view(name).reshape(
                     (self.num_voxels, -1), order="C")
 
-    def set_attribute(self, name, val):
+    def set_attribute(self, name, val, copy=True, single_precision=False):
         """ Set attribute to the given value.
+
+        Args:
+            name (``str``): Attribute name.
+            val (``numpy.ndarray``): Attribute values.
+            copy (``bool``): If False, the mesh refers to ``val`` directly
+                instead of copying it (unless ``val`` is not a C-contiguous
+                float array).  Later changes to ``val`` are then visible
+                through the mesh.  Default is True.
+            single_precision (``bool``): If True, store values as float32.
+                The attribute is then returned as a float32 array, and is
+                converted back to float64 when used by any computation.
+                Default is False.
         """
-        self.__mesh.set_attribute(name, val.ravel(order="C"))
+        if single_precision:
+            if copy:
+                self.__mesh.set_attribute_f32(name, val.ravel(order="C"))
+            else:
+                self.__mesh.borrow_attribute_f32(name, val)
+        elif copy:
+            self.__mesh.set_attribute(name, val.ravel(order="C"))
+        else:
+            self.__mesh.borrow_attribute(name, val)
+
+    def __get_attribute_view(self, name):
+        if self.__mesh.is_single_precision_attribute(name):
+            return self.__mesh.get_attribute_view_f32(name)
+        else:
+            return self.__mesh.get_attribute_view(name)
 
     def remove_attribute(self, name):
         """ Remove attribute from mesh.
@@ -182,23 +208,40 @@ class Mesh(object):
         """
         return self._extra_info.is_oriented()
 
+    def convert_to_single_precision(self):
+        """ Store vertices and vertex attributes (i.e. attributes whose name
+        starts with ``vertex_``) as float32.  This halves their memory
+        footprint.  Computations that need double precision convert the data
+        back on entry.
+        """
+        self.__mesh.convert_vertices_to_single_precision()
+        for name in self.get_attribute_names():
+            if name.startswith("vertex_"):
+                self.__mesh.convert_attribute_to_single_precision(name)
+
     @property
     def vertices(self):
-        return self.__mesh.get_vertices().reshape(
-                (-1,self.dim), order="C")
+        if self.__mesh.has_single_precision_vertices():
+            return self.__mesh.get_vertex_matrix_f32()
+        else:
+            return self.__mesh.get_vertex_matrix()
+
+    @property
+    def single_precision(self):
+        """ Whether vertices are stored as float32.
+        """
+        return self.__mesh.has_single_precision_vertices()
 
     @property
     def faces(self):
-        return self.__mesh.get_faces().reshape(
-                (-1, self.vertex_per_face), order="C")
+        return self.__mesh.get_face_matrix()
 
     @property
     def voxels(self):
         if self.num_voxels == 0:
             return self.__mesh.get_voxels()
         else:
-            return self.__mesh.get_voxels().reshape(
-                    (-1, self.vertex_per_voxel), order="C")
+            return self.__mesh.get_voxel_matrix()
 
     @property
     def num_vertices(self):
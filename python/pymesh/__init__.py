@@ -1,6 +1,8 @@
 from .version import __version__
 from . import PyMeshSetting
 from .timethis import timethis
+from . import profile
+from . import memory
 
 from numpy.testing import Tester
 test = Tester().test
@@ -19,7 +21,8 @@ from .Mesh import Mesh
 from .meshio import load_mesh, form_mesh, save_mesh, save_mesh_raw
 from .Assembler import Assembler
 from .boolean import boolean
-from .compression import compress, decompress
+from .compression import compress, decompress, compress_batch, \
+        decompress_batch, decompress_into
 from .convex_hull import convex_hull
 from .CSGTree import CSGTree
 from .cut_to_disk import cut_to_disk
@@ -77,6 +80,8 @@ __all__ = [
         "slice_mesh",
         "submesh",
         "timethis",
+        "profile",
+        "memory",
         "orient_3D",
         "orient_2D",
         "in_circle",
@@ -100,6 +105,9 @@ __all__ = [
         "HashGrid",
         "compress",
         "decompress",
+        "compress_batch",
+        "decompress_batch",
+        "decompress_into",
         "map_vertex_attribute",
         "map_face_attribute",
         "map_corner_attribute",
@@ -3,7 +3,16 @@ import numpy as np
 
 from .Mesh import Mesh
 
-def compress(mesh, engine_name="draco"):
+def _create_options(options):
+    result = PyMesh.CompressionOptions()
+    for name, value in options.items():
+        if not hasattr(result, name):
+            raise NotImplementedError(
+                    "Unknown compression option: {}".format(name))
+        setattr(result, name, value)
+    return result
+
+def compress(mesh, engine_name="draco", **options):
     """ Compress mesh data.
 
     Args:
@@ -12,6 +21,14 @@ def compress(mesh, engine_name="draco"):
 
             * ``draco``: `Google's Draco engine <https://google.github.io/draco/>`_
               [#]_
+        **options: Optional engine settings:
+
+            * ``position_bits``, ``normal_bits``, ``texture_bits``,
+              ``generic_bits`` (``int``): Quantization bits per attribute kind.
+            * ``encoding_speed``, ``decoding_speed`` (``int``): 0 (best
+              compression) to 10 (fastest).
+            * ``with_attributes`` (``bool``): Whether to encode vertex
+              attributes (default ``True``).
 
     Returns:
         A binary string representing the compressed mesh data.
@@ -29,8 +46,27 @@ def compress(mesh, engine_name="draco"):
 
     """
     engine = PyMesh.CompressionEngine.create(engine_name)
-    data = engine.compress(mesh.raw_mesh)
-    return data
+    if len(options) == 0:
+        return engine.compress(mesh.raw_mesh)
+    data = engine.compress(mesh.raw_mesh, _create_options(options))
+    return bytes(memoryview(data))
+
+def compress_batch(meshes, engine_name="draco", **options):
+    """ Compress a list of meshes concurrently.
+
+    Args:
+        meshes (``list`` of :class:`Mesh`): Input meshes.
+        engine_name (``string``): Compression engine name.
+        **options: Same as :func:`compress`.
+
+    Returns:
+        A list of ``memoryview`` objects holding the compressed data, in input
+        order.  The data is not copied into Python.
+    """
+    engine = PyMesh.CompressionEngine.create(engine_name)
+    raw_meshes = [mesh.raw_mesh for mesh in meshes]
+    data = engine.compress_batch(raw_meshes, _create_options(options))
+    return [memoryview(d) for d in data]
 
 def decompress(data, engine_name="draco"):
     """ Decompress mesh data.
@@ -52,3 +88,41 @@ def decompress(data, engine_name="draco"):
     """
     engine = PyMesh.CompressionEngine.create(engine_name)
     return Mesh(engine.decompress(data))
+
+def decompress_batch(data, engine_name="draco"):
+    """ Decompress a list of compressed meshes concurrently.
+
+    Args:
+        data (``list``): Compressed meshes, each being any object supporting
+            the buffer protocol (e.g. ``bytes`` or ``memoryview``).
+        engine_name (``string``): Decompression engine name.
+
+    Returns:
+        A list of mesh objects, in input order.
+    """
+    engine = PyMesh.CompressionEngine.create(engine_name)
+    return [Mesh(raw_mesh) for raw_mesh in engine.decompress_batch(data)]
+
+def decompress_into(data, vertices, faces, engine_name="draco"):
+    """ Decompress mesh geometry into preallocated arrays.
+
+    Args:
+        data: Compressed mesh supporting the buffer protocol.
+        vertices (``numpy.ndarray``): Contiguous float array receiving the
+            vertex coordinates.
+        faces (``numpy.ndarray``): Contiguous int32 array receiving the face
+            indices.
+        engine_name (``string``): Decompression engine name.
+
+    Returns:
+        A tuple ``(dim, num_vertices, num_faces)``.  If ``vertices`` or
+        ``faces`` is too small, nothing is written and the tuple gives the
+        required size.  Attributes are not decoded.
+
+    Raises:
+        TypeError: If ``vertices`` or ``faces`` has the wrong dtype or is not
+            C contiguous.  Arrays are never converted, since the result would
+            be written to a temporary copy.
+    """
+    engine = PyMesh.CompressionEngine.create(engine_name)
+    return engine.decompress_into(data, vertices, faces)
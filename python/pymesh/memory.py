@@ -0,0 +1,102 @@
+""" Heap accounting for the C++ core.
+
+When PyMesh is built with ``PYMESH_MEMORY_TRACKING=ON`` (64-bit Linux only),
+allocations made by PyMesh, including Eigen matrices and STL containers, are
+counted while tracking is enabled.  The instrumented stages of
+:py:mod:`pymesh.profile` double as memory stages.
+
+A simple usage example:
+
+>>> pymesh.memory.start()
+>>> tet_mesh = pymesh.tetrahedralize(mesh, 0.1)
+>>> pymesh.memory.usage()["peak"]
+>>> pymesh.memory.summarize()
+>>> pymesh.memory.stop()
+
+Allocations made outside of PyMesh (e.g. numpy) are not counted.
+"""
+
+import PyMesh
+
+def is_supported():
+    """ Whether this build of PyMesh can track allocations.
+    """
+    return PyMesh.MemoryTracker.is_supported()
+
+def start():
+    """ Reset all counters and start counting.
+    """
+    PyMesh.MemoryTracker.start()
+
+def stop():
+    """ Stop counting.  Counters are kept until the next start().
+    """
+    PyMesh.MemoryTracker.stop()
+
+def is_enabled():
+    return PyMesh.MemoryTracker.is_enabled()
+
+def reset_peak():
+    """ Restart peak tracking from the current live bytes, e.g. before each
+    call of a batch job.
+    """
+    PyMesh.MemoryTracker.reset_peak()
+
+def usage():
+    """ Counters since start().
+
+    Returns:
+        A dictionary with keys ``allocated``, ``freed``, ``live``, ``peak``
+        (all in bytes) and ``num_allocations``.  ``live`` may be negative if
+        memory allocated before start() has been freed.
+    """
+    usage = PyMesh.MemoryTracker.get_usage()
+    return {
+            "allocated": usage.allocated,
+            "freed": usage.freed,
+            "live": usage.live,
+            "peak": usage.peak,
+            "num_allocations": usage.num_allocations,
+            }
+
+def summary():
+    """ Counters aggregated by stage.
+
+    Returns:
+        A list of dictionaries with keys ``name``, ``count``, ``allocated``,
+        ``freed`` and ``peak``, sorted by decreasing peak.  ``peak`` is the
+        largest increase of live bytes above the level at stage entry over
+        all calls of the stage.
+    """
+    return [{
+        "name": stage.name,
+        "count": stage.count,
+        "allocated": stage.allocated,
+        "freed": stage.freed,
+        "peak": stage.peak,
+        } for stage in PyMesh.MemoryTracker.get_summary()]
+
+def summarize():
+    """ Print the stage summary.
+    """
+    def format_bytes(num_bytes):
+        for unit in ["B", "KiB", "MiB", "GiB"]:
+            if abs(num_bytes) < 1024.0:
+                return "{:.2f} {}".format(num_bytes, unit)
+            num_bytes /= 1024.0
+        return "{:.2f} TiB".format(num_bytes)
+
+    separator = "-"*93
+    format_string = "| {0:40.39} | {1:8} | {2:>10} | {3:>10} | {4:>10} |"
+    print(separator)
+    print(format_string.format("Stage", "Count", "Allocated", "Freed", "Peak"))
+    print(separator)
+    for entry in summary():
+        print(format_string.format(entry["name"], entry["count"],
+            format_bytes(entry["allocated"]), format_bytes(entry["freed"]),
+            format_bytes(entry["peak"])))
+    print(separator)
+    total = usage()
+    print("Total allocated: {}, live: {}, peak: {}".format(
+        format_bytes(total["allocated"]), format_bytes(total["live"]),
+        format_bytes(total["peak"])))
@@ -6,13 +6,17 @@ import PyMesh
 
 from .save_svg import save_svg
 
-def load_mesh(filename, extension_hint=None, drop_zero_dim=False):
+def load_mesh(filename, extension_hint=None, drop_zero_dim=False,
+        single_precision=False):
     """ Load mesh from a file.
 
     Args:
         filename: Input filename.  File format is auto detected based on
             extension.
         drop_zero_dim (bool): If true, convert flat 3D mesh into 2D mesh.
+        single_precision (bool): If true, store vertices and vertex
+            attributes as float32.  See
+            :py:meth:`Mesh.convert_to_single_precision`.
 
     Returns:
         A :py:class:`Mesh` object representing the loaded mesh.
@@ -31,6 +35,8 @@ def load_mesh(filename, extension_hint=None, drop_zero_dim=False):
         factory.load_file_with_hint(filename, extension_hint)
     if drop_zero_dim:
         factory.drop_zero_dim()
+    if single_precision:
+        factory.with_single_precision()
     return Mesh(factory.create())
 
 def deduce_face_type(faces, voxels):
@@ -59,7 +65,7 @@ def deduce_voxel_type(faces, voxels):
             raise NotImplementedError("Voxel type cannot be deduced from face.")
     return voxels
 
-def form_mesh(vertices, faces, voxels=None):
+def form_mesh(vertices, faces, voxels=None, copy=True, single_precision=False):
     """ Convert raw mesh data into a Mesh object.
 
     Args:
@@ -68,6 +74,14 @@ def form_mesh(vertices, faces, voxels=None):
         faces: ndarray of ints with size (num_faces, vertex_per_face).
         voxels: optional ndarray of ints with size (num_voxels,
             vertex_per_voxel).  Use ``None`` for forming surface meshes.
+        copy (bool): If False, the mesh refers to the input arrays directly
+            whenever they are C-contiguous with matching dtypes (float64
+            vertices, int32 faces and voxels), and keeps them alive.  Later
+            changes to the arrays are then visible through the mesh.
+            Default is True.
+        single_precision (bool): If True, store vertices as float32.  With
+            ``copy=False``, float32 vertices are then used without any copy.
+            Default is False.
 
     Returns:
         A :py:class:`Mesh` object formed by the inputs.
@@ -89,8 +103,17 @@ def form_mesh(vertices, faces, voxels=None):
     voxels = deduce_voxel_type(faces, voxels)
     faces = deduce_face_type(faces, voxels)
 
+    vertex_type = np.float32 if single_precision else float
+    if copy:
+        vertices = np.array(vertices, dtype=vertex_type, order="C")
+        faces = np.array(faces, dtype=np.int32, order="C")
+        voxels = np.array(voxels, dtype=np.int32, order="C")
+
     factory = PyMesh.MeshFactory()
-    factory.load_matrices(vertices, faces, voxels)
+    if single_precision:
+        factory.borrow_matrices_f32(vertices, faces, voxels)
+    else:
+        factory.borrow_matrices(vertices, faces, voxels)
     return Mesh(factory.create())
 
 def save_mesh_raw(filename, vertices, faces, voxels=None, **setting):
@@ -3,9 +3,8 @@ import os
 import os.path
 import logging
 
+import PyMesh
 from ..meshio import form_mesh, save_mesh, load_mesh
-from .remove_isolated_vertices import remove_isolated_vertices_raw
-from .remove_duplicated_vertices import remove_duplicated_vertices_raw
 
 def generate_box_mesh(box_min, box_max,
         num_samples=1, keep_symmetry=False, subdiv_order=0, using_simplex=True):
@@ -50,52 +49,35 @@ def generate_box_mesh(box_min, box_max,
 
 def generate_2D_box_mesh(box_min, box_max, num_samples, keep_symmetry,
         subdiv_order, using_simplex):
-    if isinstance(num_samples, int):
-        num_samples = [num_samples, num_samples]
-    step_size = np.divide((box_max - box_min), num_samples)
-
-    num_vertices = 0
-    vertices = []
-    faces = []
-    quad_indices = []
-    quad_index = 0
-    for i in range(num_samples[0]):
-        for j in range(num_samples[1]):
-            p = np.multiply([i, j], step_size) + box_min
-            corners = np.array([
-                    [p[0]             , p[1]             ],
-                    [p[0]+step_size[0], p[1]             ],
-                    [p[0]+step_size[0], p[1]+step_size[1]],
-                    [p[0]             , p[1]+step_size[1]] ])
-            subcell_corners = subdivide_quad(corners, subdiv_order)
-            for corners in subcell_corners:
-                if using_simplex:
-                    if keep_symmetry:
-                        cell_vertices, cell_faces =\
-                                split_quad_into_tris_symmetrically(corners)
-                    else:
-                        cell_vertices, cell_faces =\
-                                split_quad_into_tris(corners)
-                else:
-                    cell_vertices = corners
-                    cell_faces = np.array([[0, 1, 2, 3]])
-                vertices.append(cell_vertices)
-                faces.append(cell_faces + num_vertices)
-                num_vertices += len(cell_vertices)
-                quad_indices.append(np.ones(len(cell_faces)) * quad_index)
-
-            quad_index +=1
-
-    vertices = np.vstack(vertices)
-    faces = np.vstack(faces)
-    quad_indices = np.vstack(quad_indices).ravel(order="C")
-
-    vertices, faces, __ = remove_duplicated_vertices_raw(vertices, faces)
-    vertices, faces, __ = remove_isolated_vertices_raw(vertices, faces)
-
+    vertices, faces, cell_index = _generate_box_mesh_raw(box_min, box_max,
+            num_samples, keep_symmetry, subdiv_order, using_simplex)
     tets = np.array([], dtype=int)
     mesh = form_mesh(vertices, faces, tets)
-    return mesh, quad_indices
+    return mesh, cell_index
+
+def _generate_box_mesh_raw(box_min, box_max, num_samples, keep_symmetry,
+        subdiv_order, using_simplex):
+    dim = len(box_min)
+    if isinstance(num_samples, int):
+        num_samples = [num_samples] * dim
+    if using_simplex:
+        if keep_symmetry:
+            element_type = PyMesh.BoxMeshGenerator.SYMMETRIC_SIMPLEX
+        else:
+            element_type = PyMesh.BoxMeshGenerator.SIMPLEX
+    else:
+        element_type = PyMesh.BoxMeshGenerator.CUBE
+
+    generator = PyMesh.BoxMeshGenerator(
+            np.asarray(box_min, dtype=float),
+            np.asarray(box_max, dtype=float),
+            np.asarray(num_samples, dtype=int))
+    generator.set_subdiv_order(subdiv_order)
+    generator.run(element_type)
+    vertices = np.array(generator.get_vertices())
+    elements = np.array(generator.get_elements())
+    cell_index = np.array(generator.get_cell_index(), dtype=float).ravel()
+    return vertices, elements, cell_index
 
 def subdivide_quad(corners, subdiv_order):
     """
@@ -170,58 +152,11 @@ def reorientate_tets(vertices, tets):
 
 def generate_3D_box_mesh(bbox_min, bbox_max, num_samples, keep_symmetry=False,
         subdiv_order=0, using_simplex=True):
-    if isinstance(num_samples, int):
-        num_samples = [num_samples, num_samples, num_samples]
-    step_size = np.divide((bbox_max - bbox_min), num_samples)
-
-    num_vertices = 0
-    vertices = []
-    tets = []
-    hex_indices = []
-    hex_index = 0
-    for i in range(num_samples[0]):
-        for j in range(num_samples[1]):
-            for k in range(num_samples[2]):
-                p = np.multiply([i,j,k], step_size) + bbox_min
-                corners = [
-                        [p[0]             , p[1]             , p[2]             ],
-                        [p[0]+step_size[0], p[1]             , p[2]             ],
-                        [p[0]+step_size[0], p[1]+step_size[1], p[2]             ],
-                        [p[0]             , p[1]+step_size[1], p[2]             ],
-                        [p[0]             , p[1]             , p[2]+step_size[2]],
-                        [p[0]+step_size[0], p[1]             , p[2]+step_size[2]],
-                        [p[0]+step_size[0], p[1]+step_size[1], p[2]+step_size[2]],
-                        [p[0]             , p[1]+step_size[1], p[2]+step_size[2]],
-                        ]
-                subcell_corners = subdivide_hex(corners, subdiv_order)
-                for corners in subcell_corners:
-                    if using_simplex:
-                        if keep_symmetry:
-                            cell_vertices, cell_elems =\
-                                    split_hex_into_tets_symmetrically(corners)
-                        else:
-                            cell_vertices, cell_elems =\
-                                    split_hex_into_tets(corners)
-                    else:
-                        cell_vertices = corners
-                        cell_elems = np.array([[0, 1, 2, 3, 4, 5, 6, 7]])
-                    vertices.append(cell_vertices)
-                    tets.append(cell_elems + num_vertices)
-                    num_vertices += len(cell_vertices)
-                    hex_indices.append(np.ones(len(cell_elems)) * hex_index)
-
-                hex_index +=1
-
-    vertices = np.vstack(vertices)
-    tets = np.vstack(tets)
-    hex_indices = np.vstack(hex_indices).ravel(order="C")
-
-    vertices, tets, __ = remove_duplicated_vertices_raw(vertices, tets)
-    vertices, tets, __ = remove_isolated_vertices_raw(vertices, tets)
-
+    vertices, voxels, cell_index = _generate_box_mesh_raw(bbox_min, bbox_max,
+            num_samples, keep_symmetry, subdiv_order, using_simplex)
     faces = np.array([], dtype=int)
-    mesh = form_mesh(vertices, faces, tets)
-    return mesh, hex_indices
+    mesh = form_mesh(vertices, faces, voxels)
+    return mesh, cell_index
 
 def subdivide_hex(corners, order):
     """ Subdivide hex into 8**order sub-cells.
@@ -51,45 +51,82 @@ def separate_mesh(mesh, connectivity_type="auto"):
             connectivity_type))
 
     num_comps = separator.separate()
+    elements = mesh.voxels if is_voxel_mesh else mesh.faces
+    comp_elements, vertex_offsets, ori_vertices, local_elements = \
+            _remap_components(separator, elements, mesh.num_vertices)
+    elem_offsets = separator.get_component_offsets().ravel()
+
+    # Reshape attributes once, sliced per component below.
+    num_elements = len(elements)
+    vertex_attributes = {}
+    element_attributes = {}
+    for name in mesh.attribute_names:
+        attr = mesh.get_attribute(name)
+        if len(attr) % mesh.num_vertices == 0:
+            vertex_attributes[name] = attr.reshape(
+                    (mesh.num_vertices, -1), order="C")
+        elif num_elements > 0 and len(attr) % num_elements == 0:
+            element_attributes[name] = attr.reshape(
+                    (num_elements, -1), order="C")
 
     comp_meshes = []
     for i in range(num_comps):
-        comp = separator.get_component(i)
-        elem_sources = separator.get_sources(i).ravel()
-        vertices, comp, info = remove_isolated_vertices_raw(
-                mesh.vertices, comp)
+        elem_sources = comp_elements[elem_offsets[i]:elem_offsets[i+1]]
+        vertex_sources = ori_vertices[vertex_offsets[i]:vertex_offsets[i+1]]
+        vertices = mesh.vertices[vertex_sources]
+        comp = local_elements[elem_offsets[i]:elem_offsets[i+1]]
         if is_voxel_mesh:
             comp_mesh = form_mesh(vertices, np.zeros((0, 3)), comp)
         else:
             comp_mesh = form_mesh(vertices, comp)
         comp_mesh.add_attribute("ori_vertex_index")
-        comp_mesh.set_attribute("ori_vertex_index", info["ori_vertex_index"])
+        comp_mesh.set_attribute("ori_vertex_index", vertex_sources)
         comp_mesh.add_attribute("ori_elem_index")
         comp_mesh.set_attribute("ori_elem_index", elem_sources)
 
-        for name in mesh.attribute_names:
-            attr = mesh.get_attribute(name)
-            if len(attr) % mesh.num_vertices == 0:
-                attr = attr.reshape((mesh.num_vertices, -1), order="C")
-                attr = attr[info["ori_vertex_index"]]
-                comp_mesh.add_attribute(name)
-                comp_mesh.set_attribute(name, attr)
-            elif not is_voxel_mesh and len(attr) % mesh.num_faces == 0:
-                attr = attr.reshape((mesh.num_faces, -1), order="C")
-                attr = attr[elem_sources]
-                comp_mesh.add_attribute(name)
-                comp_mesh.set_attribute(name, attr)
-            elif is_voxel_mesh and len(attr) % mesh.num_voxels == 0:
-                attr = attr.reshape((mesh.num_voxels, -1), order="C")
-                attr = attr[elem_sources]
-                comp_mesh.add_attribute(name)
-                comp_mesh.set_attribute(name, attr)
-
+        for name, attr in vertex_attributes.items():
+            comp_mesh.add_attribute(name)
+            comp_mesh.set_attribute(name, attr[vertex_sources])
+        for name, attr in element_attributes.items():
+            comp_mesh.add_attribute(name)
+            comp_mesh.set_attribute(name, attr[elem_sources])
 
         comp_meshes.append(comp_mesh)
 
     return comp_meshes
 
+def _remap_components(separator, elements, num_vertices):
+    """ Compute per-component vertex indices for all components at once.
+
+    Returns:
+        4 values are returned.
+
+            * ``comp_elements``: Element indices grouped by component.
+            * ``vertex_offsets``: Component ``i`` uses vertices
+              ``ori_vertices[vertex_offsets[i]:vertex_offsets[i+1]]``.
+            * ``ori_vertices``: Input vertex indices grouped by component in
+              ascending order.
+            * ``local_elements``: ``elements[comp_elements]`` with vertex
+              indices local to their component.
+    """
+    comp_elements = separator.get_component_elements().ravel()
+    labels = separator.get_labels().ravel()
+    num_comps = len(separator.get_component_offsets()) - 1
+    comp_elem_array = elements[comp_elements]
+
+    # A vertex used by several components is duplicated in each of them.
+    keys = labels[comp_elements][:, np.newaxis].astype(np.int64) * \
+            num_vertices + comp_elem_array
+    unique_keys, inverse = np.unique(keys.ravel(), return_inverse=True)
+    unique_comps = unique_keys // num_vertices
+    ori_vertices = unique_keys % num_vertices
+    vertex_offsets = np.searchsorted(unique_comps, np.arange(num_comps+1))
+
+    comp_of_row = labels[comp_elements][:, np.newaxis]
+    local_elements = inverse.reshape(comp_elem_array.shape) - \
+            vertex_offsets[comp_of_row]
+    return comp_elements, vertex_offsets, ori_vertices, local_elements
+
 def separate_graph(edges):
     """ Split graph into disconnected components.
 
@@ -98,14 +135,9 @@ def separate_graph(edges):
 
     Returns:
         An array of indices indicating the component each edge belongs to.
+        Components are ordered by their smallest edge index.
     """
     separator = MeshSeparator(edges)
     separator.set_connectivity_type(MeshSeparator.VERTEX)
-    num_comps = separator.separate()
-
-    comp_indices = np.zeros(len(edges))
-    for i in range(num_comps):
-        src_idx = separator.get_sources(i).ravel()
-        comp_indices[src_idx] = i
-    return comp_indices
-
+    separator.separate()
+    return separator.get_labels().ravel()
@@ -15,6 +15,7 @@ def subdivide(mesh, order=1, method="simple"):
 
     """
     subdiv = PyMesh.Subdivision.create(method)
+    subdiv.set_matrix_mode(PyMesh.Subdivision.MATRIX_FREE)
     subdiv.subdivide(mesh.vertices, mesh.faces, order)
 
     vertices = subdiv.get_vertices()
@@ -1,62 +1,89 @@
 import PyMesh
+import numpy as np
 
 """
 This module wraps the exact predicates Jonathan Richard Shewchuk.
+
+Each predicate also accepts arrays with one point per row, in which case all
+queries are evaluated in a single batched call.
 """
 
 # The init function would be called when predicates module is imported.
 PyMesh.exactinit()
 
+def _batch(batch_fn, *points):
+    """ Evaluate a batched predicate on arrays of points, one query per row.
+    """
+    points = [np.asarray(p, dtype=float) for p in points]
+    num_queries = len(points[0])
+    stacked = np.vstack(points)
+    queries = np.arange(len(stacked), dtype=np.int32).reshape(
+            (len(points), num_queries)).T
+    return batch_fn(stacked, np.ascontiguousarray(queries)).ravel()
+
+def _is_batch(p):
+    return np.ndim(p) == 2
+
 def orient_2D(p1, p2, p3):
     """ Determine the orientation 2D points p1, p2, p3
 
     Args:
-        p1,p2,p3: 2D points.
+        p1,p2,p3: 2D points, or ``(N, 2)`` arrays of points.
 
     Returns:
         positive if (p1, p2, p3) is in counterclockwise order.
         negative if (p1, p2, p3) is in clockwise order.
         0.0 if they are collinear.
     """
+    if _is_batch(p1):
+        return _batch(PyMesh.orient2d_batch, p1, p2, p3)
     return PyMesh.orient2d(p1, p2, p3)
 
 def orient_3D(p1, p2, p3, p4):
     """ Determine the orientation 3D points p1, p2, p3, p4.
 
     Args:
-        p1,p2,p3,p4: 3D points.
+        p1,p2,p3,p4: 3D points, or ``(N, 3)`` arrays of points.
 
     Returns:
         positive if p4 is below the plane formed by (p1, p2, p3).
         negative if p4 is above the plane formed by (p1, p2, p3).
         0.0 if they are coplanar.
     """
+    if _is_batch(p1):
+        return _batch(PyMesh.orient3d_batch, p1, p2, p3, p4)
     return PyMesh.orient3d(p1, p2, p3, p4)
 
 def in_circle(p1, p2, p3, p4):
     """ Determine if p4 is in the circle formed by p1, p2, p3.
 
     Args:
-        p1,p2,p3,p4: 2D points.  ``orient_2D(p1, p2, p3)`` must be postive,
-            otherwise the result will be flipped.
+        p1,p2,p3,p4: 2D points, or ``(N, 2)`` arrays of points.
+            ``orient_2D(p1, p2, p3)`` must be postive, otherwise the result
+            will be flipped.
 
     Returns:
         positive p4 is inside of the circle.
         negative p4 is outside of the circle.
         0.0 if they are cocircular.
     """
+    if _is_batch(p1):
+        return _batch(PyMesh.incircle_batch, p1, p2, p3, p4)
     return PyMesh.incircle(p1, p2, p3, p4)
 
 def in_sphere(p1, p2, p3, p4, p5):
     """ Determine if p5 is in the sphere formed by p1, p2, p3, p4.
 
     Args:
-        p1,p2,p3,p4,p5: 3D points.  ``orient_3D(p1, p2, p3, p4)`` must be
-            positive, otherwise the result will be flipped.
+        p1,p2,p3,p4,p5: 3D points, or ``(N, 3)`` arrays of points.
+            ``orient_3D(p1, p2, p3, p4)`` must be positive, otherwise the
+            result will be flipped.
 
     Returns:
         positive p5 is inside of the sphere.
         negative p5 is outside of the sphere.
         0.0 if they are cospherical.
     """
+    if _is_batch(p1):
+        return _batch(PyMesh.insphere_batch, p1, p2, p3, p4, p5)
     return PyMesh.insphere(p1, p2, p3, p4, p5)
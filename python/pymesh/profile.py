@@ -0,0 +1,107 @@
+""" Scoped profiler for the C++ core.
+
+Major stages of mesh loading, boolean, tetrahedralization, inflation and
+assembly are instrumented.  Recording is off by default.
+
+A simple usage example:
+
+>>> pymesh.profile.start()
+>>> mesh = pymesh.load_mesh("input.obj")
+>>> with pymesh.profile.zone("my_stage"):
+...     tet_mesh = pymesh.tetrahedralize(mesh, 0.1)
+>>> pymesh.profile.stop()
+>>> pymesh.profile.dump("trace.json")
+>>> pymesh.profile.summarize()
+
+The dumped file is in Chrome trace event format and can be viewed with
+``chrome://tracing`` or https://ui.perfetto.dev.
+"""
+
+import PyMesh
+from contextlib import contextmanager
+import functools
+
+def start(capacity=65536):
+    """ Clear previously recorded events and start recording.
+
+    Args:
+        capacity (``int``): Number of events kept per thread.  Once a thread's
+            buffer is full, its oldest events are overwritten.
+    """
+    PyMesh.Profiler.start(capacity)
+
+def stop():
+    """ Stop recording.  Recorded events are kept until the next start().
+    """
+    PyMesh.Profiler.stop()
+
+def is_enabled():
+    return PyMesh.Profiler.is_enabled()
+
+def dump(filename=None):
+    """ Export recorded events in Chrome trace event format.
+
+    Args:
+        filename (``str``): Output file.  If ``None``, the trace is returned as
+            a string instead.
+    """
+    if filename is None:
+        return PyMesh.Profiler.get_chrome_trace()
+    PyMesh.Profiler.dump_chrome_trace(filename)
+
+def summary():
+    """ Recorded events aggregated by zone.
+
+    Returns:
+        A list of dictionaries with keys ``name``, ``count``, ``total_time``,
+        ``self_time``, ``min_time`` and ``max_time``, sorted by decreasing
+        total time.  Times are in seconds, and ``self_time`` excludes nested
+        zones.
+    """
+    return [{
+        "name": zone.name,
+        "count": zone.count,
+        "total_time": zone.total_time,
+        "self_time": zone.self_time,
+        "min_time": zone.min_time,
+        "max_time": zone.max_time,
+        } for zone in PyMesh.Profiler.get_summary()]
+
+def summarize():
+    """ Print the zone summary.
+    """
+    separator = "-"*79
+    format_string = "| {0:40.39} | {1:8} | {2:10.6} | {3:10.6} |"
+    print(separator)
+    print(format_string.format("Zone", "Count", "Total (s)", "Self (s)"))
+    print(separator)
+    for entry in summary():
+        print(format_string.format(entry["name"], entry["count"],
+            entry["total_time"], entry["self_time"]))
+    print(separator)
+    num_dropped = PyMesh.Profiler.get_num_dropped_events()
+    if num_dropped > 0:
+        print("{} event(s) were dropped because a buffer was full.".format(
+            num_dropped))
+
+@contextmanager
+def zone(name):
+    """ Record the enclosed block as a zone named ``name``.  The zone is also
+    a stage for :py:mod:`pymesh.memory`.
+    """
+    if not (PyMesh.Profiler.is_enabled() or
+            PyMesh.MemoryTracker.is_enabled()):
+        yield
+        return
+    with PyMesh.ProfileZone(name):
+        yield
+
+def profiled(f):
+    """ Decorator that records each call of ``f`` as a zone.
+    """
+    name = "{}.{}".format(f.__module__, f.__name__)
+    @functools.wraps(f)
+    def wrapper(*args, **kwargs):
+        with zone(name):
+            return f(*args, **kwargs)
+    return wrapper
@@ -1,78 +1,79 @@
-from .boolean import boolean
-from .misc import Quaternion
-from .meshutils import generate_box_mesh, separate_mesh, remove_isolated_vertices, merge_meshes
-from .meshio import form_mesh, save_mesh
+import PyMesh
+from .meshio import form_mesh
+from .triangle import triangle
 
 import numpy as np
 from numpy.linalg import norm
 
-def slice_mesh(mesh, direction, N):
+def _get_plane_frame(direction):
+    """ Return orthonormal u, v such that u x v = direction.
+    """
+    axis = np.zeros(3)
+    axis[np.argmin(np.absolute(direction))] = 1.0
+    u = np.cross(axis, direction)
+    u = u / norm(u)
+    v = np.cross(direction, u)
+    return u, v
+
+def _cap(vertices, edges, u, v, origin):
+    if len(edges) == 0:
+        return form_mesh(np.zeros((0, 3)), np.zeros((0, 3), dtype=int))
+
+    points = np.vstack([np.dot(vertices, u), np.dot(vertices, v)]).T
+    tri = triangle()
+    tri.points = points
+    tri.segments = edges
+    tri.split_boundary = False
+    tri.max_num_steiner_points = 0
+    tri.auto_hole_detection = True
+    tri.verbosity = 0
+    tri.run()
+
+    uv = tri.vertices
+    cap_vertices = origin + np.outer(uv[:,0], u) + np.outer(uv[:,1], v)
+    return form_mesh(cap_vertices, tri.faces)
+
+def slice_mesh(mesh, direction, N, cap=True):
     """ Slice a given 3D mesh N times along certain direciton.
 
     Args:
         mesh (:class:`Mesh`): The mesh to be sliced.
         direction (:class:`numpy.ndaray`): Direction orthogonal to the slices.
         N (int): Number of slices.
+        cap (bool): Whether to triangulate the cross sections.  Default is
+            True.
 
     Returns:
-        A list of `N` :class:`Mesh` objects, each representing a single slice.
+        If ``cap`` is True, a list of `N` :class:`Mesh` objects, each
+        representing a single slice with face normals pointing along
+        ``direction``.  Otherwise, a list of `N` ``(vertices, loops)``
+        tuples, where ``loops`` are closed polylines oriented counterclockwise
+        around the interior when viewed from ``direction``.
     """
     if mesh.dim != 3:
         raise NotImplementedError("Only slicing 3D mesh is supported.")
 
-    bbox_min, bbox_max = mesh.bbox
-    center = 0.5 * (bbox_min + bbox_max)
-    radius = norm(bbox_max - center)
-    direction = np.array(direction)
+    direction = np.array(direction, dtype=float)
     direction = direction / norm(direction)
 
     proj_len = np.dot(mesh.vertices, direction)
     min_val = np.amin(proj_len)
     max_val = np.amax(proj_len)
-    mid_val = 0.5 * (min_val + max_val)
-    intercepts = np.linspace(min_val - mid_val, max_val - mid_val, N+2)[1:-1]
+    intercepts = np.linspace(min_val, max_val, N+2)[1:-1]
     assert(len(intercepts) == N)
-    if N%2 == 1:
-        intercepts = np.append(intercepts, intercepts[-1]+radius)
 
-    boxes = []
-    for low, high in intercepts.reshape((-1, 2), order="C"):
-        min_corner = -np.ones(3) * (radius+1)
-        max_corner =  np.ones(3) * (radius+1)
-        min_corner[2] = low
-        max_corner[2] = high
-        box = generate_box_mesh(min_corner, max_corner)
-        boxes.append(box)
+    slicer = PyMesh.MeshSlicer(mesh.vertices, mesh.faces)
+    slicer.slice(direction, intercepts)
 
-    num_boxes = len(boxes)
-    boxes = merge_meshes(boxes)
-    rot = Quaternion.fromData(
-            np.array([0.0, 0.0, 1.0]), np.array(direction)).to_matrix()
-    boxes = form_mesh(np.dot(rot, boxes.vertices.T).T + center, boxes.faces)
-
-    slabs = boolean(boxes, mesh, "intersection")
+    if not cap:
+        return [(slicer.get_slice_vertices(i), slicer.get_slice_loops(i))
+                for i in range(N)]
 
+    u, v = _get_plane_frame(direction)
     cross_secs = []
-    source = slabs.get_attribute("source").ravel()
-    selected = source == 1
-    cross_section_faces = slabs.faces[selected]
-    cross_section = form_mesh(slabs.vertices, cross_section_faces)
-
-    intersects = np.dot(slabs.vertices, direction).ravel() - \
-            np.dot(center, direction)
-    eps = (max_val - min_val) / (2 * N)
-
-    for i,val in enumerate(intercepts[:N]):
-        selected_vertices = np.logical_and(
-                intersects > val - eps,
-                intersects < val + eps)
-        selected_faces = np.all(selected_vertices[cross_section_faces], axis=1).ravel()
-        faces = cross_section_faces[selected_faces]
-        if i%2 == 0:
-            faces = faces[:,[0, 2, 1]]
-        m = form_mesh(slabs.vertices, faces)
-        m = remove_isolated_vertices(m)[0]
-        cross_secs.append(m)
+    for i, val in enumerate(intercepts):
+        vertices = slicer.get_slice_vertices(i)
+        edges = slicer.get_slice_edges(i)
+        cross_secs.append(_cap(vertices, edges, u, v, direction * val))
 
     return cross_secs
-
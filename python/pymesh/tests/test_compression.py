@@ -94,3 +94,41 @@ class TestCompression(TestCase):
         #face_index_map = mesh2.get_attribute("face_index").ravel().astype(int)
         #self.assertEqual(mesh.num_faces, len(face_index_map))
 
+    def test_batch(self):
+        meshes = [
+                pymesh.generate_icosphere(1.0, np.zeros(3), i)
+                for i in range(3) ]
+        data = pymesh.compress_batch(meshes, position_bits=16,
+                encoding_speed=10, decoding_speed=10)
+        self.assertEqual(len(meshes), len(data))
+        meshes2 = pymesh.decompress_batch(data)
+        for mesh, mesh2 in zip(meshes, meshes2):
+            self.assertEqual(mesh.num_vertices, mesh2.num_vertices)
+            self.assertEqual(mesh.num_faces, mesh2.num_faces)
+            self.assert_array_almost_equal(mesh.bbox, mesh2.bbox, 4)
+
+    def test_decompress_into(self):
+        mesh = pymesh.generate_icosphere(1.0, np.zeros(3), 2)
+        data = pymesh.compress(mesh)
+        dim, num_vertices, num_faces = pymesh.decompress_into(data,
+                np.zeros(0), np.zeros(0, dtype=np.int32))
+        self.assertEqual(mesh.num_vertices, num_vertices)
+        self.assertEqual(mesh.num_faces, num_faces)
+
+        vertices = np.zeros((num_vertices, dim))
+        faces = np.zeros((num_faces, 3), dtype=np.int32)
+        pymesh.decompress_into(data, vertices, faces)
+        mesh2 = pymesh.decompress(data)
+        self.assert_array_equal(mesh2.vertices, vertices)
+        self.assert_array_equal(mesh2.faces, faces)
+
+    def test_decompress_into_wrong_dtype(self):
+        mesh = pymesh.generate_icosphere(1.0, np.zeros(3), 2)
+        data = pymesh.compress(mesh)
+        vertices = np.zeros((mesh.num_vertices, mesh.dim))
+        faces = np.zeros((mesh.num_faces, 3), dtype=np.int64)
+        with self.assertRaises(TypeError):
+            pymesh.decompress_into(data, vertices, faces)
+        with self.assertRaises(TypeError):
+            pymesh.decompress_into(data, vertices.T,
+                    faces.astype(np.int32))
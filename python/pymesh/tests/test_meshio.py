@@ -73,3 +73,18 @@ class MeshIOTest(TestCase):
                     anonymous=True)
             self.assert_mesh_equal(mesh, mesh2)
 
+
+    def test_single_precision(self):
+        vertices = np.array([
+            [0.0, 0.0, 0.0],
+            [1.0, 0.0, 0.0],
+            [0.0, 1.0, 0.1],
+            ], dtype=np.float32)
+        faces = np.array([[0, 1, 2]], dtype=np.int32)
+        mesh = form_mesh(vertices, faces, copy=False, single_precision=True)
+        self.assertTrue(mesh.single_precision)
+        self.assertEqual(np.float32, mesh.vertices.dtype)
+        self.assert_array_equal(vertices, mesh.vertices)
+
+        mesh2 = self.write_and_load(mesh, "single_precision.msh")
+        self.assert_mesh_equal(mesh, mesh2)
@@ -24,6 +24,9 @@ class Inflator(object):
         self.subdivide_order = 1
         self.subdivide_method="simple"
 
+        # Spatial partition for parallel inflation.
+        self.num_partition_cells = 0
+
     def set_geometry_correction(self,
             rel_geometry_correction=None,
             abs_geometry_correction=None,
@@ -60,6 +63,19 @@ class Inflator(object):
         self.subdivide_order = order
         self.subdivide_method = method
 
+    def set_partitions(self, num_cells):
+        """ Inflate the wire network in num_cells^dim spatial partitions in
+        parallel.  Only used by :py:meth:`inflate`.
+
+        Arguments:
+            num_cells: number of partitions along each axis.  0 or 1 disables
+                partitioning.
+        """
+        if not isinstance(num_cells, int) or num_cells < 0:
+            raise RuntimeError("Invalid number of partitions: {}".format(
+                num_cells))
+        self.num_partition_cells = num_cells
+
     def inflate(self, thickness, per_vertex_thickness=True,
             allow_self_intersection=False):
         wires = self.wire_network.raw_wires
@@ -82,6 +98,8 @@ class Inflator(object):
         self.__setup_geometry_correction(inflator)
         self.__setup_subdivision(inflator)
         self.__setup_profile(inflator)
+        if self.num_partition_cells > 1:
+            inflator.with_partitions(self.num_partition_cells)
 
         inflator.inflate()
 
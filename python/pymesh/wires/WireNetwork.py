@@ -115,6 +115,8 @@ class WireNetwork(object):
             l i j
             ...
 
+        Files with the ``.wireb`` extension use a binary format that also
+        stores vertex and edge attributes, and loads much faster.
         """
         self.raw_wires = PyMesh.WireNetwork.create(wire_file)
         self.__initialize_wires()
@@ -127,6 +129,9 @@ class WireNetwork(object):
 
     def write_to_file(self, filename):
         """ Save the current wire network into a file.
+
+        The binary format is used if ``filename`` ends with ``.wireb``.
+        Only the binary format keeps attributes.
         """
         self.raw_wires.write_to_file(filename)
 
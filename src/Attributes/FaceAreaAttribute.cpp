@@ -17,7 +17,7 @@ void FaceAreaAttribute::compute_from_mesh(Mesh& mesh) {
 
     VectorF& areas = m_values;
     areas = VectorF::Zero(num_faces);
-    const auto& vertices = mesh.get_vertices();
+    const auto vertices = static_cast<const Mesh&>(mesh).get_vertices();
     const auto& faces = mesh.get_faces();
 
     auto compute_2D_triangle_area = [&vertices,&faces](size_t i) {
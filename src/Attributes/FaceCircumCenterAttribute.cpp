@@ -25,7 +25,7 @@ void FaceCircumCenterAttribute::compute_from_mesh(Mesh& mesh) {
     VectorF& circum_centers = m_values;
     circum_centers.resize(num_faces * dim);
 
-    const VectorF& vertices = mesh.get_vertices();
+    const auto vertices = static_cast<const Mesh&>(mesh).get_vertices();
 
     for (size_t i=0; i<num_faces; i++) {
         VectorI face = mesh.get_face(i);
@@ -24,7 +24,7 @@ void FaceIncircleCenterAttribute::compute_from_mesh(Mesh& mesh) {
     VectorF& centers = m_values;
     centers = VectorF::Zero(num_faces*dim);
 
-    const VectorF& vertices = mesh.get_vertices();
+    const auto vertices = static_cast<const Mesh&>(mesh).get_vertices();
     const VectorI& faces = mesh.get_faces();
 
     for (size_t i=0; i<num_faces; i++) {
@@ -1,9 +1,13 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #pragma once
+#include <atomic>
 #include <string>
 #include <memory>
+#include <mutex>
 
+#include <Core/ArrayBuffer.h>
 #include <Core/EigenTypedef.h>
+#include <Core/Exception.h>
 
 namespace PyMesh {
 class Mesh;
@@ -12,6 +16,11 @@ class Mesh;
  * MeshAttribute provides functionality to compute and store information
  * associated with each of the mesh internal structure.  For example, vertex
  * normal, face area, voxel volumes, etc.
+ *
+ * Values may be stored in single precision to save memory.  Read-only double
+ * precision access then reads a cached converted copy and keeps the single
+ * precision storage.  Mutable access converts the storage back to double
+ * precision.
  */
 class MeshAttribute {
     public:
@@ -22,10 +31,166 @@ class MeshAttribute {
 
     public:
         virtual void compute_from_mesh(Mesh& mesh) {}
-        virtual VectorF& get_values() { return m_values; }
-        virtual void set_values(VectorF& values) { m_values = values; }
+        /**
+         * Single precision values are switched back to double precision, so
+         * that changes are kept.
+         */
+        virtual VectorF& get_values() {
+            if (m_single_precision) promote_to_double_precision();
+            if (m_borrowed) detach();
+            return m_values;
+        }
+
+        virtual void set_values(VectorF& values) {
+            release();
+            m_values = values;
+        }
+
+        /**
+         * Take over the storage of values without copying.
+         */
+        void adopt_values(VectorF& values) {
+            release();
+            m_values.swap(values);
+        }
+
+        /**
+         * Use an externally owned buffer without copying.  Read-only access
+         * goes through get_values_view(), so changes made by the owner stay
+         * visible.  It is copied on the first call to get_values(), and owner
+         * is held until the values
+         * are replaced so that views handed out earlier stay valid.
+         */
+        void borrow_values(const Float* data, size_t size,
+                std::shared_ptr<const void> owner) {
+            release();
+            m_values.resize(0);
+            m_borrowed_data = data;
+            m_borrowed_size = size;
+            m_owner = owner;
+            m_borrowed = true;
+        }
+
+        Eigen::Map<const VectorF> get_values_view() const {
+            if (m_single_precision) {
+                const VectorF& values = get_double_precision_cache();
+                return Eigen::Map<const VectorF>(values.data(), values.size());
+            }
+            if (m_borrowed) {
+                return Eigen::Map<const VectorF>(
+                        m_borrowed_data, m_borrowed_size);
+            }
+            return Eigen::Map<const VectorF>(m_values.data(), m_values.size());
+        }
+
+    public:
+        /**
+         * Single precision storage.  Setting, adopting or borrowing single
+         * precision values releases the double precision ones.
+         */
+        bool is_single_precision() const { return m_single_precision; }
+
+        void set_values_f32(const VectorF32& values) {
+            release();
+            m_values.resize(0);
+            m_values_f32.assign(values);
+            m_single_precision = true;
+        }
+
+        void adopt_values_f32(VectorF32& values) {
+            release();
+            m_values.resize(0);
+            m_values_f32.adopt(values);
+            m_single_precision = true;
+        }
+
+        void borrow_values_f32(const float* data, size_t size,
+                std::shared_ptr<const void> owner) {
+            release();
+            m_values.resize(0);
+            m_values_f32.borrow(data, size, owner);
+            m_single_precision = true;
+        }
+
+        Eigen::Map<const VectorF32> get_values_view_f32() const {
+            if (!m_single_precision) {
+                throw RuntimeError("Attribute is not stored in single precision.");
+            }
+            return m_values_f32.view();
+        }
+
+        /**
+         * Round values to single precision and release the double precision
+         * storage.
+         */
+        void convert_to_single_precision() {
+            if (m_single_precision) return;
+            VectorF32 values = get_values_view().cast<float>();
+            adopt_values_f32(values);
+        }
+
+    private:
+        /**
+         * The owner and borrowed pointer are kept, so readers racing with
+         * the switch still see valid data.
+         */
+        void detach() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_borrowed) return;
+            m_values = Eigen::Map<const VectorF>(
+                    m_borrowed_data, m_borrowed_size);
+            m_borrowed = false;
+        }
+
+        void release() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_borrowed = false;
+            m_borrowed_data = nullptr;
+            m_borrowed_size = 0;
+            m_owner.reset();
+            if (m_single_precision) {
+                m_values_f32.assign(VectorF32());
+                m_values.resize(0);
+                m_values_cached = false;
+                m_single_precision = false;
+            }
+        }
+
+        const VectorF& get_double_precision_cache() const {
+            if (m_values_cached) return m_values;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_values_cached) {
+                m_values = m_values_f32.view().cast<Float>();
+                m_values_cached = true;
+            }
+            return m_values;
+        }
+
+        /**
+         * The cache already lives in m_values, so views of it stay valid.
+         */
+        void promote_to_double_precision() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_single_precision) return;
+            if (!m_values_cached) {
+                m_values = m_values_f32.view().cast<Float>();
+            }
+            m_values_f32.assign(VectorF32());
+            m_values_cached = false;
+            m_single_precision = false;
+        }
 
     protected:
-        VectorF m_values;
+        mutable VectorF m_values;
+
+    private:
+        const Float* m_borrowed_data = nullptr;
+        size_t m_borrowed_size = 0;
+        std::shared_ptr<const void> m_owner;
+        std::atomic<bool> m_borrowed{false};
+        mutable std::mutex m_mutex;
+        ArrayBuffer<VectorF32> m_values_f32;
+        std::atomic<bool> m_single_precision{false};
+        mutable std::atomic<bool> m_values_cached{false};
 };
 }
@@ -47,6 +47,11 @@ VectorF& PyMesh::MeshAttributes::get_attribute(const std::string& name) {
     return itr->second->get_values();
 }
 
+Eigen::Map<const VectorF> PyMesh::MeshAttributes::get_attribute(
+        const std::string& name) const {
+    return find_attribute(name)->get_values_view();
+}
+
 void PyMesh::MeshAttributes::set_attribute(const std::string& name, VectorF& value) {
     MeshAttribute::Ptr attr;
     AttributeMap::iterator itr = m_attributes.find(name);
@@ -60,6 +65,56 @@ void PyMesh::MeshAttributes::set_attribute(const std::string& name, VectorF& val
     attr->set_values(value);
 }
 
+void PyMesh::MeshAttributes::adopt_attribute(const std::string& name, VectorF& value) {
+    find_attribute(name)->adopt_values(value);
+}
+
+void PyMesh::MeshAttributes::borrow_attribute(const std::string& name,
+        const Float* data, size_t size, std::shared_ptr<const void> owner) {
+    find_attribute(name)->borrow_values(data, size, owner);
+}
+
+Eigen::Map<const VectorF> PyMesh::MeshAttributes::get_attribute_view(
+        const std::string& name) const {
+    return find_attribute(name)->get_values_view();
+}
+
+bool PyMesh::MeshAttributes::is_single_precision(
+        const std::string& name) const {
+    return find_attribute(name)->is_single_precision();
+}
+
+void PyMesh::MeshAttributes::adopt_attribute_f32(const std::string& name,
+        VectorF32& value) {
+    find_attribute(name)->adopt_values_f32(value);
+}
+
+void PyMesh::MeshAttributes::borrow_attribute_f32(const std::string& name,
+        const float* data, size_t size, std::shared_ptr<const void> owner) {
+    find_attribute(name)->borrow_values_f32(data, size, owner);
+}
+
+Eigen::Map<const VectorF32> PyMesh::MeshAttributes::get_attribute_view_f32(
+        const std::string& name) const {
+    return find_attribute(name)->get_values_view_f32();
+}
+
+void PyMesh::MeshAttributes::convert_to_single_precision(
+        const std::string& name) {
+    find_attribute(name)->convert_to_single_precision();
+}
+
+MeshAttribute::Ptr PyMesh::MeshAttributes::find_attribute(
+        const std::string& name) const {
+    AttributeMap::const_iterator itr = m_attributes.find(name);
+    if (itr == m_attributes.end()) {
+        std::stringstream err_msg;
+        err_msg << "Attribute \"" << name << "\" does not exist.";
+        throw RuntimeError(err_msg.str());
+    }
+    return itr->second;
+}
+
 MeshAttributes::AttributeNames PyMesh::MeshAttributes::get_attribute_names() const {
     AttributeNames names;
     for (AttributeMap::const_iterator itr = m_attributes.begin();
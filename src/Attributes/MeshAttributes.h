@@ -25,12 +25,35 @@ class MeshAttributes {
         virtual void add_attribute(const std::string& name, Mesh& mesh);
         virtual void remove_attribute(const std::string& name);
         virtual VectorF& get_attribute(const std::string& name);
+        virtual Eigen::Map<const VectorF> get_attribute(
+                const std::string& name) const;
         virtual void set_attribute(const std::string& name, VectorF& value);
+        virtual void adopt_attribute(const std::string& name, VectorF& value);
+        virtual void borrow_attribute(const std::string& name,
+                const Float* data, size_t size,
+                std::shared_ptr<const void> owner);
+        virtual Eigen::Map<const VectorF> get_attribute_view(
+                const std::string& name) const;
+
+        // Single precision storage
+        virtual bool is_single_precision(const std::string& name) const;
+        virtual void adopt_attribute_f32(const std::string& name,
+                VectorF32& value);
+        virtual void borrow_attribute_f32(const std::string& name,
+                const float* data, size_t size,
+                std::shared_ptr<const void> owner);
+        virtual Eigen::Map<const VectorF32> get_attribute_view_f32(
+                const std::string& name) const;
+        virtual void convert_to_single_precision(const std::string& name);
+
         virtual AttributeNames get_attribute_names() const;
 
     protected:
         typedef std::map<std::string, MeshAttribute::Ptr> AttributeMap;
         typedef std::pair<std::string, MeshAttribute::Ptr> AttributeMapEntry;
+        MeshAttribute::Ptr find_attribute(const std::string& name) const;
+
+    protected:
         AttributeMap m_attributes;
 };
 }
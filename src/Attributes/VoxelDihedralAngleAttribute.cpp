@@ -37,7 +37,7 @@ void VoxelDihedralAngleAttribute::compute_from_mesh(Mesh& mesh) {
                 "Voxel dihedral angle computation only support tet for now.");
     }
 
-    const auto& vertices = mesh.get_vertices();
+    const auto vertices = static_cast<const Mesh&>(mesh).get_vertices();
     const auto& voxels = mesh.get_voxels();
     VectorF& dihedral_angles = m_values;
     dihedral_angles.resize(num_voxels * 6);
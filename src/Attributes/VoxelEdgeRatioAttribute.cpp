@@ -19,7 +19,7 @@ void VoxelEdgeRatioAttribute::compute_from_mesh(Mesh& mesh) {
                 "Voxel edge ratio computation only support tet for now.");
     }
 
-    const auto& vertices = mesh.get_vertices();
+    const auto vertices = static_cast<const Mesh&>(mesh).get_vertices();
     const auto& voxels = mesh.get_voxels();
     VectorF& edge_ratio = m_values;
     edge_ratio.resize(num_voxels);
@@ -22,7 +22,7 @@ void VoxelIncenterAttribute::compute_from_mesh(Mesh& mesh) {
     VectorF& incenters = m_values;
     incenters.resize(num_voxels * 3);
     const auto& voxels = mesh.get_voxels();
-    const auto& vertices = mesh.get_vertices();
+    const auto vertices = static_cast<const Mesh&>(mesh).get_vertices();
 
     for (size_t i=0; i<num_voxels; i++) {
         Vector4I voxel = voxels.segment<4>(i*4);
@@ -23,7 +23,7 @@ void VoxelInradiusAttribute::compute_from_mesh(Mesh& mesh) {
     inradius.resize(num_voxels);
 
     const auto& voxels = mesh.get_voxels();
-    const auto& vertices = mesh.get_vertices();
+    const auto vertices = static_cast<const Mesh&>(mesh).get_vertices();
     if (!mesh.has_attribute("voxel_volume")) {
         mesh.add_attribute("voxel_volume");
     }
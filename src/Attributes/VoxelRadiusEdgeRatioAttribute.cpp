@@ -25,7 +25,7 @@ void VoxelRadiusEdgeRatioAttribute::compute_from_mesh(Mesh& mesh) {
     }
     const auto& circum_radii = mesh.get_attribute("voxel_circumradius");
     assert(circum_radii.size() == num_voxels);
-    const auto& vertices = mesh.get_vertices();
+    const auto vertices = static_cast<const Mesh&>(mesh).get_vertices();
     const auto& voxels = mesh.get_voxels();
     VectorF& re_ratio = m_values;
     re_ratio.resize(num_voxels);
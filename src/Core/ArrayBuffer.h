@@ -0,0 +1,121 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include <Core/EigenTypedef.h>
+
+namespace PyMesh {
+
+/**
+ * A flat array that either owns its storage or borrows a buffer owned by
+ * someone else (e.g. a numpy array).  A borrowed buffer is never written to
+ * and its owner is held until the buffer is replaced by assign(), adopt() or
+ * borrow(), so views handed out earlier stay valid after a copy is made.
+ * The first mutable get() copies it into owned storage.  Read-only access
+ * goes through data() and view(), which never copy, so changes made to a
+ * borrowed buffer by its owner stay visible.
+ */
+template<typename VectorType>
+class ArrayBuffer {
+    public:
+        typedef typename VectorType::Scalar Scalar;
+        typedef std::shared_ptr<const void> Owner;
+        typedef Eigen::Map<const VectorType> ConstView;
+        typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic,
+                Eigen::RowMajor> MatrixType;
+        typedef Eigen::Map<const MatrixType> ConstMatrixView;
+
+    public:
+        ArrayBuffer() : m_data(nullptr), m_size(0), m_borrowed(false) {}
+        ArrayBuffer(const ArrayBuffer& other) = delete;
+        ArrayBuffer& operator=(const ArrayBuffer& other) = delete;
+
+        /**
+         * Copy values into owned storage.
+         */
+        void assign(const VectorType& values) {
+            release();
+            m_storage = values;
+        }
+
+        /**
+         * Take over the storage of values without copying.  values is left
+         * holding the previous owned storage.
+         */
+        void adopt(VectorType& values) {
+            release();
+            m_storage.swap(values);
+        }
+
+        /**
+         * Use size entries starting at data without copying.  owner must keep
+         * data valid for as long as it is held.
+         */
+        void borrow(const Scalar* data, size_t size, Owner owner) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_storage.resize(0);
+            m_owner = owner;
+            m_data = data;
+            m_size = size;
+            m_borrowed = true;
+        }
+
+        bool is_borrowed() const { return m_borrowed; }
+
+        const Scalar* data() const {
+            return m_borrowed ? m_data : m_storage.data();
+        }
+
+        size_t size() const {
+            return m_borrowed ? m_size : m_storage.size();
+        }
+
+        ConstView view() const {
+            return ConstView(data(), size());
+        }
+
+        ConstMatrixView view(size_t cols) const {
+            return ConstMatrixView(data(), cols == 0 ? 0 : size() / cols, cols);
+        }
+
+        /**
+         * Mutable access.  Detaches from a borrowed buffer first.
+         */
+        VectorType& get() {
+            if (m_borrowed) detach();
+            return m_storage;
+        }
+
+    private:
+        /**
+         * The owner and borrowed pointer are left untouched so that readers
+         * racing with the switch still see valid data.
+         */
+        void detach() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_borrowed) return;
+            m_storage = ConstView(m_data, m_size);
+            m_borrowed = false;
+        }
+
+        void release() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_borrowed = false;
+            m_data = nullptr;
+            m_size = 0;
+            m_owner.reset();
+        }
+
+    private:
+        VectorType m_storage;
+        const Scalar* m_data;
+        size_t m_size;
+        Owner m_owner;
+        std::atomic<bool> m_borrowed;
+        std::mutex m_mutex;
+};
+
+}
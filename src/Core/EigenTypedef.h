@@ -34,4 +34,8 @@ typedef Eigen::Matrix<int  , Eigen::Dynamic, 3, Eigen::RowMajor> Matrix3Ir;
 typedef Eigen::Matrix<Float, Eigen::Dynamic, 3, Eigen::RowMajor> Matrix3Fr;
 typedef Eigen::Matrix<int  , Eigen::Dynamic, 4, Eigen::RowMajor> Matrix4Ir;
 typedef Eigen::Matrix<Float, Eigen::Dynamic, 4, Eigen::RowMajor> Matrix4Fr;
+
+// Single precision storage types.
+typedef Eigen::VectorXf VectorF32;
+typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> MatrixF32r;
 }
@@ -0,0 +1,144 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include "ElementBoundary.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <sstream>
+#include <vector>
+
+#include <tbb/tbb.h>
+
+#include <Core/Exception.h>
+
+using namespace PyMesh;
+
+namespace ElementBoundaryHelper {
+    const size_t MAX_FACET_SIZE = 4;
+    typedef std::array<int, MAX_FACET_SIZE> FacetKey;
+
+    struct Facet {
+        FacetKey key;
+        int index;
+
+        bool operator<(const Facet& other) const {
+            if (key != other.key) return key < other.key;
+            return index < other.index;
+        }
+    };
+}
+
+using namespace ElementBoundaryHelper;
+
+MatrixIr ElementBoundary::get_face_facets(size_t vertex_per_face) {
+    if (vertex_per_face < 2) {
+        std::stringstream err_msg;
+        err_msg << "Unsupported face type with " << vertex_per_face
+            << " vertices per face";
+        throw NotImplementedError(err_msg.str());
+    }
+    MatrixIr facets(vertex_per_face, 2);
+    for (size_t i=0; i<vertex_per_face; i++) {
+        facets.row(i) << i, (i+1) % vertex_per_face;
+    }
+    return facets;
+}
+
+MatrixIr ElementBoundary::get_voxel_facets(size_t vertex_per_voxel) {
+    MatrixIr facets;
+    if (vertex_per_voxel == 4) {
+        facets.resize(4, 3);
+        facets << 0, 2, 1,
+                  0, 1, 3,
+                  0, 3, 2,
+                  1, 2, 3;
+    } else if (vertex_per_voxel == 8) {
+        facets.resize(6, 4);
+        facets << 0, 1, 5, 4, // Bottom
+                  2, 3, 7, 6, // Top
+                  0, 4, 7, 3, // Left
+                  1, 2, 6, 5, // Right
+                  4, 5, 6, 7, // Front
+                  0, 3, 2, 1; // Back
+    } else {
+        std::stringstream err_msg;
+        err_msg << "Unsupported voxel type with " << vertex_per_voxel
+            << " vertices per voxel";
+        throw NotImplementedError(err_msg.str());
+    }
+    return facets;
+}
+
+void ElementBoundary::extract_boundary(const MatrixIr& elements,
+        const MatrixIr& local_facets, bool check_manifold,
+        MatrixIr& boundary_facets, VectorI& boundary_elements) {
+    const size_t num_elements = elements.rows();
+    const size_t facets_per_element = local_facets.rows();
+    const size_t facet_size = local_facets.cols();
+    if (facet_size > MAX_FACET_SIZE) {
+        throw NotImplementedError("Facets with more than 4 vertices are not supported");
+    }
+
+    const size_t num_facets = num_elements * facets_per_element;
+    std::vector<Facet> facets(num_facets);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_elements),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    for (size_t j=0; j<facets_per_element; j++) {
+                        Facet& facet = facets[i*facets_per_element+j];
+                        facet.key.fill(-1);
+                        for (size_t k=0; k<facet_size; k++) {
+                            facet.key[k] = elements(i, local_facets(j, k));
+                        }
+                        std::sort(facet.key.begin(),
+                                facet.key.begin() + facet_size,
+                                std::greater<int>());
+                        facet.index = i*facets_per_element+j;
+                    }
+                }
+            });
+    tbb::parallel_sort(facets.begin(), facets.end());
+
+    // A facet is on the boundary iff it differs from both neighbors.
+    std::vector<char> is_boundary(num_facets, 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_facets),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const bool same_as_prev =
+                        i > 0 && facets[i-1].key == facets[i].key;
+                    const bool same_as_next =
+                        i+1 < num_facets && facets[i+1].key == facets[i].key;
+                    is_boundary[i] = !same_as_prev && !same_as_next;
+
+                    if (check_manifold && same_as_prev &&
+                            i > 1 && facets[i-2].key == facets[i].key) {
+                        std::stringstream err_msg;
+                        err_msg << "Non-manifold mesh detected!" << std::endl;
+                        err_msg << "Facet <";
+                        for (size_t k=0; k<facet_size; k++) {
+                            if (k > 0) err_msg << ", ";
+                            err_msg << facets[i].key[k];
+                        }
+                        err_msg << "> has more than 2 adjacent elements";
+                        throw RuntimeError(err_msg.str());
+                    }
+                }
+            });
+
+    const size_t num_boundaries =
+        std::count(is_boundary.begin(), is_boundary.end(), 1);
+    boundary_facets.resize(num_boundaries, facet_size);
+    boundary_elements.resize(num_boundaries);
+    size_t count = 0;
+    for (size_t i=0; i<num_facets; i++) {
+        if (!is_boundary[i]) continue;
+        const size_t element = facets[i].index / facets_per_element;
+        const size_t local_index = facets[i].index % facets_per_element;
+        for (size_t k=0; k<facet_size; k++) {
+            boundary_facets(count, k) =
+                elements(element, local_facets(local_index, k));
+        }
+        boundary_elements[count] = element;
+        count++;
+    }
+}
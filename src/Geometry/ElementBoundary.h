@@ -0,0 +1,41 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <Core/EigenTypedef.h>
+
+namespace PyMesh {
+
+/**
+ * Boundary extraction shared by surface and volume meshes.
+ *
+ * Every element contributes its facets (edges of a face, faces of a voxel).
+ * Facets are canonicalized, sorted in parallel and counted; facets used by
+ * exactly one element form the boundary.
+ */
+namespace ElementBoundary {
+    /**
+     * Local vertex indices of the facets of a face, one edge per row,
+     * following the face orientation.
+     */
+    MatrixIr get_face_facets(size_t vertex_per_face);
+
+    /**
+     * Local vertex indices of the facets of a voxel, one face per row, with
+     * normals pointing outward for MSH ordered tets and hexes.
+     */
+    MatrixIr get_voxel_facets(size_t vertex_per_voxel);
+
+    /**
+     * Extract facets adjacent to exactly one element.  Boundary facets keep
+     * the orientation of their element and are ordered by their sorted
+     * vertex indices (largest first).
+     *
+     * If check_manifold is true, a RuntimeError is thrown when a facet is
+     * shared by more than 2 elements.
+     */
+    void extract_boundary(const MatrixIr& elements,
+            const MatrixIr& local_facets, bool check_manifold,
+            MatrixIr& boundary_facets, VectorI& boundary_elements);
+}
+
+}
@@ -1,35 +1,45 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #include "MeshGeometry.h"
 
-#include <map>
+#include <algorithm>
+#include <cassert>
 #include <sstream>
 #include <vector>
 #include <iostream>
 
 #include <Core/Exception.h>
-#include <Misc/Multiplet.h>
+
+#include "ElementBoundary.h"
 
 using namespace PyMesh;
 
 void MeshGeometry::extract_faces_from_voxels() {
-    if (m_vertex_per_voxel == 4) {
-        extract_faces_from_tets();
-    } else if (m_vertex_per_voxel == 8) {
-        extract_faces_from_hexes();
-    } else {
-        std::stringstream err_msg;
-        err_msg << "Unsupported voxel type with " << m_vertex_per_voxel << " vertices per voxel";
-        throw NotImplementedError(err_msg.str());
-    }
+    const MatrixIr local_facets =
+        ElementBoundary::get_voxel_facets(m_vertex_per_voxel);
+    const Eigen::Map<const MatrixIr> voxels(
+            m_voxels.data(), get_num_voxels(), m_vertex_per_voxel);
+
+    // The extracted faces are exactly the volume boundary, so keep them
+    // cached along with their voxels.
+    std::lock_guard<std::mutex> lock(m_boundary_mutex);
+    ElementBoundary::extract_boundary(voxels, local_facets, true,
+            m_boundary_faces, m_boundary_face_voxels);
+    m_volume_boundary_valid = true;
+    m_surface_boundary_valid = false;
+
+    m_vertex_per_face = m_boundary_faces.cols();
+    VectorI faces(m_boundary_faces.size());
+    std::copy(m_boundary_faces.data(),
+            m_boundary_faces.data() + m_boundary_faces.size(),
+            faces.data());
+    m_faces.adopt(faces);
 }
 
 int MeshGeometry::project_out_zero_dim() {
     if (m_dim == 2) return -1;
     assert(m_dim == 3);
-    const size_t num_vertices = get_num_vertices();
-    MatrixFr vertices(num_vertices, m_dim);
-    std::copy(m_vertices.data(), m_vertices.data() + m_vertices.size(),
-            vertices.data());
+    const MatrixFr vertices = get_vertex_matrix();
+    const size_t num_vertices = vertices.rows();
     Vector3F max_coord = vertices.colwise().maxCoeff();
     Vector3F min_coord = vertices.colwise().minCoeff();
 
@@ -43,139 +53,195 @@ int MeshGeometry::project_out_zero_dim() {
 
     if (zero_dim == -1) return -1;
     m_dim = 2;
-    m_vertices.resize(num_vertices * 2);
+    VectorF projected(num_vertices * 2);
     if (zero_dim == 0) {
         // Drop X
         //std::cout << "Removing X component" << std::endl;
         for (size_t i=0; i<num_vertices; i++) {
-            m_vertices[i*2  ] = vertices.row(i)[1];
-            m_vertices[i*2+1] = vertices.row(i)[2];
+            projected[i*2  ] = vertices.row(i)[1];
+            projected[i*2+1] = vertices.row(i)[2];
         }
     } else if (zero_dim == 2) {
         // Drop Z
         //std::cout << "Removing Z component" << std::endl;
         for (size_t i=0; i<num_vertices; i++) {
-            m_vertices[i*2  ] = vertices.row(i)[0];
-            m_vertices[i*2+1] = vertices.row(i)[1];
+            projected[i*2  ] = vertices.row(i)[0];
+            projected[i*2+1] = vertices.row(i)[1];
         }
     } else {
         // Drop Y
         //std::cout << "Removing Y component" << std::endl;
         for (size_t i=0; i<num_vertices; i++) {
-            m_vertices[i*2  ] = vertices.row(i)[0];
-            m_vertices[i*2+1] = vertices.row(i)[2];
+            projected[i*2  ] = vertices.row(i)[0];
+            projected[i*2+1] = vertices.row(i)[2];
         }
     }
+    const bool single_precision = m_single_precision;
+    drop_single_precision_vertices();
+    m_vertices.adopt(projected);
+    if (single_precision) convert_vertices_to_single_precision();
     return zero_dim;
 }
 
-void MeshGeometry::extract_faces_from_tets() {
-    const VectorI& voxels = m_voxels;
-    typedef std::map<Triplet, unsigned short> FaceCounter;
-    FaceCounter face_counter;
-
-    for (size_t i=0; i<voxels.size(); i+= m_vertex_per_voxel) {
-        VectorI voxel = voxels.segment(i, m_vertex_per_voxel);
-        // Note that the order of vertices below are predefined by MSH format,
-        // each face should have normal pointing outward.
-        assert(voxel.size() == 4);
-        Triplet voxel_faces[4] = {
-            {voxel[0], voxel[2], voxel[1]},
-            {voxel[0], voxel[1], voxel[3]},
-            {voxel[0], voxel[3], voxel[2]},
-            {voxel[1], voxel[2], voxel[3]}
-        };
-        for (size_t j=0; j<4; j++) {
-            if (face_counter.find(voxel_faces[j]) == face_counter.end()) {
-                face_counter[voxel_faces[j]] = 1;
-            } else {
-                face_counter[voxel_faces[j]] += 1;
-            }
-        }
+Eigen::Map<const VectorF> MeshGeometry::get_vertices() const {
+    if (m_single_precision) {
+        const VectorF& vertices = get_double_precision_cache();
+        return Eigen::Map<const VectorF>(vertices.data(), vertices.size());
     }
+    return m_vertices.view();
+}
 
-    std::vector<int> vertex_buffer;
-    for (FaceCounter::const_iterator itr = face_counter.begin();
-            itr!=face_counter.end(); itr++) {
-        if (itr->second != 1 && itr->second != 2) {
-            const Vector3I& triplet = itr->first.get_ori_data();
-            std::stringstream err_msg;
-            err_msg << "Non-manifold mesh detected!" << std::endl;
-            err_msg << "Face <"
-                << triplet[0] << ", "
-                << triplet[1] << ", "
-                << triplet[2] << "> has "
-                << itr->second << " adjacent volume elements";
-            throw RuntimeError(err_msg.str());
-        }
-        if (itr->second == 1) {
-            const VectorI& f = itr->first.get_ori_data();
-            assert(f.size() == 3);
-            vertex_buffer.push_back(f[0]);
-            vertex_buffer.push_back(f[1]);
-            vertex_buffer.push_back(f[2]);
-        }
+MeshGeometry::VertexView MeshGeometry::get_vertex_matrix() const {
+    if (m_single_precision) {
+        const VectorF& vertices = get_double_precision_cache();
+        return VertexView(vertices.data(), vertices.size() / m_dim, m_dim);
     }
+    return m_vertices.view(m_dim);
+}
 
-    m_faces.resize(vertex_buffer.size());
-    std::copy(vertex_buffer.begin(), vertex_buffer.end(), m_faces.data());
-    m_vertex_per_face = 3;
-}
-
-void MeshGeometry::extract_faces_from_hexes() {
-    const VectorI& voxels = m_voxels;
-    typedef std::map<Quadruplet, int> FaceCounter;
-    FaceCounter face_counter;
-
-    for (size_t i=0; i<voxels.size(); i+= m_vertex_per_voxel) {
-        VectorI voxel = voxels.segment(i, m_vertex_per_voxel);
-        // Note that the order of vertices below are predefined by MSH format,
-        // each face should have normal pointing outward.
-        assert(voxel.size() == 8);
-        Quadruplet voxel_faces[6] = {
-            {voxel[0], voxel[1], voxel[5], voxel[4]}, // Bottom
-            {voxel[2], voxel[3], voxel[7], voxel[6]}, // Top
-            {voxel[0], voxel[4], voxel[7], voxel[3]}, // Left
-            {voxel[1], voxel[2], voxel[6], voxel[5]}, // Right
-            {voxel[4], voxel[5], voxel[6], voxel[7]}, // Front
-            {voxel[0], voxel[3], voxel[2], voxel[1]}  // Back
-        };
-
-        for (size_t j=0; j<6; j++) {
-            if (face_counter.find(voxel_faces[j]) == face_counter.end()) {
-                face_counter[voxel_faces[j]] = 1;
-            } else {
-                face_counter[voxel_faces[j]] += 1;
-            }
-        }
+void MeshGeometry::set_vertices_f32(const VectorF32& vertices) {
+    std::lock_guard<std::mutex> lock(m_precision_mutex);
+    m_vertices_f32.assign(vertices);
+    m_vertices.assign(VectorF());
+    m_vertex_cache_valid = false;
+    m_vertex_cache.resize(0);
+    m_single_precision = true;
+}
+
+void MeshGeometry::adopt_vertices_f32(VectorF32& vertices) {
+    std::lock_guard<std::mutex> lock(m_precision_mutex);
+    m_vertices_f32.adopt(vertices);
+    m_vertices.assign(VectorF());
+    m_vertex_cache_valid = false;
+    m_vertex_cache.resize(0);
+    m_single_precision = true;
+}
+
+void MeshGeometry::borrow_vertices_f32(const float* data, size_t size,
+        BufferOwner owner) {
+    std::lock_guard<std::mutex> lock(m_precision_mutex);
+    m_vertices_f32.borrow(data, size, owner);
+    m_vertices.assign(VectorF());
+    m_vertex_cache_valid = false;
+    m_vertex_cache.resize(0);
+    m_single_precision = true;
+}
+
+MeshGeometry::VertexViewF32 MeshGeometry::get_vertex_matrix_f32() const {
+    if (!m_single_precision) {
+        throw RuntimeError("Vertices are not stored in single precision.");
     }
+    return m_vertices_f32.view(m_dim);
+}
 
-    std::vector<int> vertex_buffer;
-    for (FaceCounter::const_iterator itr = face_counter.begin();
-            itr!=face_counter.end(); itr++) {
-        if (itr->second != 1 && itr->second != 2) {
-            const Vector4I& face = itr->first.get_ori_data();
-            std::stringstream err_msg;
-            err_msg << "Non-manifold mesh detected!" << std::endl;
-            err_msg << "Face <"
-                << face[0] << ", "
-                << face[1] << ", "
-                << face[2] << ", "
-                << face[3] << "> has "
-                << itr->second << " adjacent volume elements";
-            throw RuntimeError(err_msg.str());
-        }
-        if (itr->second == 1) {
-            const VectorI& f = itr->first.get_ori_data();
-            assert(f.size() == 4);
-            vertex_buffer.push_back(f[0]);
-            vertex_buffer.push_back(f[1]);
-            vertex_buffer.push_back(f[2]);
-            vertex_buffer.push_back(f[3]);
-        }
+void MeshGeometry::convert_vertices_to_single_precision() {
+    std::lock_guard<std::mutex> lock(m_precision_mutex);
+    if (m_single_precision) return;
+    VectorF32 vertices = m_vertices.view().cast<float>();
+    m_vertices_f32.adopt(vertices);
+    m_vertices.assign(VectorF());
+    m_vertex_cache_valid = false;
+    m_vertex_cache.resize(0);
+    m_single_precision = true;
+}
+
+void MeshGeometry::release_double_precision_cache() {
+    std::lock_guard<std::mutex> lock(m_precision_mutex);
+    m_vertex_cache_valid = false;
+    m_vertex_cache.resize(0);
+}
+
+VectorF& MeshGeometry::get_double_precision_cache() const {
+    if (m_vertex_cache_valid) return m_vertex_cache;
+    std::lock_guard<std::mutex> lock(m_precision_mutex);
+    if (!m_vertex_cache_valid) {
+        m_vertex_cache = m_vertices_f32.view().cast<Float>();
+        m_vertex_cache_valid = true;
+    }
+    return m_vertex_cache;
+}
+
+void MeshGeometry::promote_vertices_to_double_precision() {
+    std::lock_guard<std::mutex> lock(m_precision_mutex);
+    if (!m_single_precision) return;
+    if (!m_vertex_cache_valid) {
+        m_vertex_cache = m_vertices_f32.view().cast<Float>();
     }
+    // Swapping keeps views of the cache valid.
+    m_vertices.adopt(m_vertex_cache);
+    m_vertices_f32.assign(VectorF32());
+    m_vertex_cache_valid = false;
+    m_vertex_cache.resize(0);
+    m_single_precision = false;
+}
+
+void MeshGeometry::drop_single_precision_vertices() {
+    if (!m_single_precision) return;
+    std::lock_guard<std::mutex> lock(m_precision_mutex);
+    m_vertices_f32.assign(VectorF32());
+    m_vertex_cache_valid = false;
+    m_vertex_cache.resize(0);
+    m_single_precision = false;
+}
+
+const MatrixIr& MeshGeometry::get_boundary_edges() {
+    compute_surface_boundary();
+    return m_boundary_edges;
+}
+
+const VectorI& MeshGeometry::get_boundary_edge_faces() {
+    compute_surface_boundary();
+    return m_boundary_edge_faces;
+}
 
-    m_faces.resize(vertex_buffer.size());
-    std::copy(vertex_buffer.begin(), vertex_buffer.end(), m_faces.data());
-    m_vertex_per_face = 4;
+const MatrixIr& MeshGeometry::get_boundary_faces() {
+    compute_volume_boundary();
+    return m_boundary_faces;
+}
+
+const VectorI& MeshGeometry::get_boundary_face_voxels() {
+    compute_volume_boundary();
+    return m_boundary_face_voxels;
+}
+
+void MeshGeometry::clear_boundary_cache() {
+    std::lock_guard<std::mutex> lock(m_boundary_mutex);
+    m_surface_boundary_valid = false;
+    m_volume_boundary_valid = false;
+}
+
+void MeshGeometry::compute_surface_boundary() {
+    std::lock_guard<std::mutex> lock(m_boundary_mutex);
+    if (m_surface_boundary_valid) return;
+
+    if (m_faces.size() == 0) {
+        m_boundary_edges.resize(0, 2);
+        m_boundary_edge_faces.resize(0);
+    } else {
+        const size_t num_faces = get_num_faces();
+        const Eigen::Map<const MatrixIr> faces(
+                m_faces.data(), num_faces, m_vertex_per_face);
+        ElementBoundary::extract_boundary(faces,
+                ElementBoundary::get_face_facets(m_vertex_per_face), false,
+                m_boundary_edges, m_boundary_edge_faces);
+    }
+    m_surface_boundary_valid = true;
+}
+
+void MeshGeometry::compute_volume_boundary() {
+    std::lock_guard<std::mutex> lock(m_boundary_mutex);
+    if (m_volume_boundary_valid) return;
+
+    const size_t num_voxels = get_num_voxels();
+    if (num_voxels == 0) {
+        m_boundary_faces.resize(0, 3);
+        m_boundary_face_voxels.resize(0);
+    } else {
+        const Eigen::Map<const MatrixIr> voxels(
+                m_voxels.data(), num_voxels, m_vertex_per_voxel);
+        ElementBoundary::extract_boundary(voxels,
+                ElementBoundary::get_voxel_facets(m_vertex_per_voxel), false,
+                m_boundary_faces, m_boundary_face_voxels);
+    }
+    m_volume_boundary_valid = true;
 }
@@ -1,7 +1,10 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <Core/ArrayBuffer.h>
 #include <Core/EigenTypedef.h>
 
 namespace PyMesh {
@@ -10,21 +13,105 @@ namespace PyMesh {
  * MeshGeometry class stores the geometry and geometry only.
  * Explicitly, it keeps an array of vertices, faces and voxels.
  * The public method is left intentionally minimal.
+ *
+ * Vertices are stored in double precision by default.  They can be stored in
+ * single precision instead to halve their memory footprint.  Read-only double
+ * precision access then converts them into a cached copy, so computations
+ * always see double coordinates while the single precision storage stays in
+ * place.  The copy is dropped by release_double_precision_cache().  Mutable
+ * access converts the storage back to double precision.
  */
 class MeshGeometry {
     public:
-        MeshGeometry() : m_dim(3) {}
+        MeshGeometry() : m_dim(3), m_single_precision(false) {}
         virtual ~MeshGeometry() {}
 
     public:
-        VectorF& get_vertices() { return m_vertices; }
-        void set_vertices(const VectorF& vertices)  { m_vertices = vertices; }
+        typedef ArrayBuffer<VectorF>::Owner BufferOwner;
+        typedef ArrayBuffer<VectorF>::ConstMatrixView VertexView;
+        typedef ArrayBuffer<VectorI>::ConstMatrixView ElementView;
+        typedef ArrayBuffer<VectorF32>::ConstMatrixView VertexViewF32;
 
-        VectorI& get_faces() { return m_faces; }
-        void set_faces(const VectorI& faces) { m_faces = faces; }
+    public:
+        /**
+         * Mutable access switches single precision storage back to double
+         * precision, so that changes are kept.
+         */
+        VectorF& get_vertices() {
+            if (m_single_precision) promote_vertices_to_double_precision();
+            return m_vertices.get();
+        }
+        void set_vertices(const VectorF& vertices)  {
+            drop_single_precision_vertices();
+            m_vertices.assign(vertices);
+        }
+
+        /**
+         * Read-only flat views that never copy, see get_vertex_matrix().
+         */
+        Eigen::Map<const VectorF> get_vertices() const;
+        Eigen::Map<const VectorI> get_faces() const { return m_faces.view(); }
+        Eigen::Map<const VectorI> get_voxels() const { return m_voxels.view(); }
+
+        VectorI& get_faces() { return m_faces.get(); }
+        void set_faces(const VectorI& faces) {
+            m_faces.assign(faces);
+            clear_boundary_cache();
+        }
+
+        VectorI& get_voxels() { return m_voxels.get(); }
+        void set_voxels(const VectorI& voxels) {
+            m_voxels.assign(voxels);
+            clear_boundary_cache();
+        }
+
+        /**
+         * Take over the storage of the given array without copying.
+         */
+        void adopt_vertices(VectorF& vertices) {
+            drop_single_precision_vertices();
+            m_vertices.adopt(vertices);
+        }
+        void adopt_faces(VectorI& faces) {
+            m_faces.adopt(faces);
+            clear_boundary_cache();
+        }
+        void adopt_voxels(VectorI& voxels) {
+            m_voxels.adopt(voxels);
+            clear_boundary_cache();
+        }
 
-        VectorI& get_voxels() { return m_voxels; }
-        void set_voxels(const VectorI& voxels) { m_voxels = voxels; }
+        /**
+         * Use an externally owned buffer without copying.  The buffer is kept
+         * alive by owner and is never written to; mutable access through
+         * get_vertices() and friends copies it first.  Changes made to the
+         * buffer by its owner are visible to this geometry, but the boundary
+         * cache is not invalidated by them.
+         */
+        void borrow_vertices(const Float* data, size_t size, BufferOwner owner) {
+            drop_single_precision_vertices();
+            m_vertices.borrow(data, size, owner);
+        }
+        void borrow_faces(const int* data, size_t size, BufferOwner owner) {
+            m_faces.borrow(data, size, owner);
+            clear_boundary_cache();
+        }
+        void borrow_voxels(const int* data, size_t size, BufferOwner owner) {
+            m_voxels.borrow(data, size, owner);
+            clear_boundary_cache();
+        }
+
+        /**
+         * Read-only (num_elements, stride) views that never copy, except that
+         * single precision vertices are read from the double precision cache.
+         */
+        VertexView get_vertex_matrix() const;
+        ElementView get_face_matrix() const {
+            return m_faces.view(m_vertex_per_face);
+        }
+        ElementView get_voxel_matrix() const {
+            return m_voxels.view(m_vertex_per_voxel);
+        }
 
         size_t get_vertex_per_face() const { return m_vertex_per_face; }
         void set_vertex_per_face(int v) { m_vertex_per_face = v; }
@@ -36,7 +123,11 @@ class MeshGeometry {
         void set_dim(int v) { m_dim = v; }
 
         size_t get_num_vertices() const {
-            return m_vertices.size() / m_dim;
+            if (m_single_precision) {
+                return m_vertices_f32.size() / m_dim;
+            } else {
+                return m_vertices.size() / m_dim;
+            }
         }
 
         size_t get_num_faces() const {
@@ -52,18 +143,79 @@ class MeshGeometry {
 
         void extract_faces_from_voxels();
         int project_out_zero_dim();
+
+    public:
+        /**
+         * Single precision vertex storage.  Setting, adopting or borrowing
+         * single precision vertices releases the double precision ones, and
+         * vice versa.
+         */
+        bool has_single_precision_vertices() const { return m_single_precision; }
+        void set_vertices_f32(const VectorF32& vertices);
+        void adopt_vertices_f32(VectorF32& vertices);
+        void borrow_vertices_f32(const float* data, size_t size,
+                BufferOwner owner);
+
+        /**
+         * Read-only view of single precision vertices.  Throws if vertices
+         * are stored in double precision.
+         */
+        VertexViewF32 get_vertex_matrix_f32() const;
+
+        /**
+         * Round vertices to single precision and release the double
+         * precision storage.
+         */
+        void convert_vertices_to_single_precision();
+
+        /**
+         * Free the double precision copy of single precision vertices.
+         * Double precision views obtained earlier become invalid.
+         */
+        void release_double_precision_cache();
+
+    public:
+        /**
+         * Boundary edges of the faces and boundary faces of the voxels,
+         * together with the element each one belongs to.  They are computed
+         * on first access and cached; call clear_boundary_cache() after
+         * modifying faces or voxels in place.
+         */
+        const MatrixIr& get_boundary_edges();
+        const VectorI& get_boundary_edge_faces();
+        const MatrixIr& get_boundary_faces();
+        const VectorI& get_boundary_face_voxels();
+        void clear_boundary_cache();
+
     protected:
-        void extract_faces_from_tets();
-        void extract_faces_from_hexes();
+        void compute_surface_boundary();
+        void compute_volume_boundary();
+        VectorF& get_double_precision_cache() const;
+        void drop_single_precision_vertices();
+        void promote_vertices_to_double_precision();
 
     protected:
         size_t m_dim;
         size_t m_vertex_per_face;
         size_t m_vertex_per_voxel;
 
-        VectorF m_vertices;
-        VectorI m_faces;
-        VectorI m_voxels;
+        ArrayBuffer<VectorF> m_vertices;
+        ArrayBuffer<VectorI> m_faces;
+        ArrayBuffer<VectorI> m_voxels;
+
+        ArrayBuffer<VectorF32> m_vertices_f32;
+        std::atomic<bool> m_single_precision;
+        mutable VectorF m_vertex_cache;
+        mutable std::atomic<bool> m_vertex_cache_valid{false};
+        mutable std::mutex m_precision_mutex;
+
+        std::mutex m_boundary_mutex;
+        bool m_surface_boundary_valid = false;
+        bool m_volume_boundary_valid = false;
+        MatrixIr m_boundary_edges;
+        VectorI m_boundary_edge_faces;
+        MatrixIr m_boundary_faces;
+        VectorI m_boundary_face_voxels;
 };
 
 }
@@ -0,0 +1,109 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include "PLYStreamReader.h"
+
+#include <exception>
+#include <vector>
+
+#include <Core/Exception.h>
+
+#include "rply.h"
+
+using namespace PyMesh;
+
+namespace PLYStreamReaderHelper {
+    /**
+     * rply is a C library, so exceptions raised in callbacks are stored and
+     * rethrown once ply_read() returns.
+     */
+    struct ReadState {
+        Float coordinates[3] = {0.0, 0.0, 0.0};
+        long last_axis = 0;
+        std::vector<int> indices;
+        const PLYStreamReader::VertexCallback* on_vertex;
+        const PLYStreamReader::FaceCallback* on_face;
+        std::exception_ptr error;
+    };
+
+    int vertex_call_back(p_ply_argument argument) {
+        ReadState* state;
+        long axis;
+        ply_get_argument_user_data(argument, (void**)&state, &axis);
+        state->coordinates[axis] = ply_get_argument_value(argument);
+        if (axis != state->last_axis) return 1;
+        try {
+            (*state->on_vertex)(state->coordinates);
+        } catch (...) {
+            state->error = std::current_exception();
+            return 0;
+        }
+        return 1;
+    }
+
+    int face_call_back(p_ply_argument argument) {
+        ReadState* state;
+        long length, value_index;
+        ply_get_argument_user_data(argument, (void**)&state, NULL);
+        ply_get_argument_property(argument, NULL, &length, &value_index);
+        if (value_index < 0) {
+            state->indices.clear();
+            if (length > 0) return 1;
+        } else {
+            state->indices.push_back(int(ply_get_argument_value(argument)));
+            if (value_index != length - 1) return 1;
+        }
+        try {
+            (*state->on_face)(state->indices.data(), state->indices.size());
+        } catch (...) {
+            state->error = std::current_exception();
+            return 0;
+        }
+        return 1;
+    }
+}
+
+using namespace PLYStreamReaderHelper;
+
+void PLYStreamReader::read(const VertexCallback& on_vertex,
+        const FaceCallback& on_face) {
+    p_ply ply = ply_open(m_filename.c_str(), NULL, 0, NULL);
+    if (ply == NULL) {
+        throw IOError("Cannot open PLY file " + m_filename);
+    }
+    if (!ply_read_header(ply)) {
+        ply_close(ply);
+        throw IOError("Failed to parse PLY header of " + m_filename);
+    }
+
+    ReadState state;
+    state.on_vertex = &on_vertex;
+    state.on_face = &on_face;
+    if (on_vertex) {
+        const char* axes[] = {"x", "y", "z"};
+        for (long i=0; i<3; i++) {
+            if (ply_set_read_cb(ply, "vertex", axes[i],
+                        vertex_call_back, &state, i) > 0) {
+                state.last_axis = i;
+            } else if (i < 2) {
+                ply_close(ply);
+                throw IOError("PLY vertices have no " +
+                        std::string(axes[i]) + " coordinate");
+            }
+        }
+    }
+    if (on_face) {
+        if (ply_set_read_cb(ply, "face", "vertex_indices",
+                    face_call_back, &state, 0) == 0) {
+            ply_set_read_cb(ply, "face", "vertex_index",
+                    face_call_back, &state, 0);
+        }
+    }
+
+    const bool success = ply_read(ply);
+    ply_close(ply);
+    if (state.error) {
+        std::rethrow_exception(state.error);
+    }
+    if (!success) {
+        throw IOError("Failed to read PLY file " + m_filename);
+    }
+}
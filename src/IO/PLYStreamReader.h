@@ -0,0 +1,38 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include <Core/EigenTypedef.h>
+
+namespace PyMesh {
+
+/**
+ * Reads the vertices and faces of a PLY file one element at a time through
+ * callbacks, without keeping them in memory.  Only vertex coordinates and
+ * face indices are read.
+ */
+class PLYStreamReader {
+    public:
+        using VertexCallback = std::function<void(const Float* coordinates)>;
+        using FaceCallback = std::function<void(const int* indices, size_t size)>;
+
+    public:
+        PLYStreamReader(const std::string& filename) : m_filename(filename) {}
+
+    public:
+        /**
+         * Read the file once.  Either callback may be empty, in which case
+         * the corresponding elements are skipped.  Exceptions thrown by the
+         * callbacks abort the read and are rethrown.  Vertices are 3D; a
+         * missing z coordinate is read as 0.
+         */
+        void read(const VertexCallback& on_vertex,
+                const FaceCallback& on_face);
+
+    private:
+        std::string m_filename;
+};
+
+}
@@ -0,0 +1,70 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include "PLYStreamWriter.h"
+
+#include <cstdint>
+#include <limits>
+
+#include <Core/Exception.h>
+
+#include "rply.h"
+
+using namespace PyMesh;
+
+namespace PLYStreamWriterHelper {
+    void assert_success(bool val, const std::string& message) {
+        if (!val) {
+            throw IOError(message);
+        }
+    }
+}
+
+using namespace PLYStreamWriterHelper;
+
+PLYStreamWriter::PLYStreamWriter(const std::string& filename,
+        size_t num_vertices, size_t num_faces, bool in_ascii) {
+    if (num_vertices > std::numeric_limits<uint32_t>::max()) {
+        throw NotImplementedError("PLY output supports at most 2^32 vertices");
+    }
+    m_ply = ply_create(filename.c_str(),
+            in_ascii ? PLY_ASCII : PLY_LITTLE_ENDIAN, NULL, 0, NULL);
+    assert_success(m_ply != NULL, "ply_create_failed");
+    assert_success(ply_add_element(m_ply, "vertex", num_vertices),
+            "Add vertex failed");
+    assert_success(ply_add_scalar_property(m_ply, "x", PLY_DOUBLE),
+            "Add x failed");
+    assert_success(ply_add_scalar_property(m_ply, "y", PLY_DOUBLE),
+            "Add y failed");
+    assert_success(ply_add_scalar_property(m_ply, "z", PLY_DOUBLE),
+            "Add z failed");
+    assert_success(ply_add_element(m_ply, "face", num_faces),
+            "Add face failed");
+    assert_success(ply_add_list_property(m_ply, "vertex_indices", PLY_UCHAR,
+                PLY_UINT), "Add face indices failed");
+    assert_success(ply_write_header(m_ply), "Writting header failed");
+}
+
+PLYStreamWriter::~PLYStreamWriter() {
+    if (m_ply != NULL) {
+        ply_close(m_ply);
+    }
+}
+
+void PLYStreamWriter::write_vertex(const Float* coordinates) {
+    ply_write(m_ply, coordinates[0]);
+    ply_write(m_ply, coordinates[1]);
+    ply_write(m_ply, coordinates[2]);
+}
+
+void PLYStreamWriter::write_face(size_t v0, size_t v1, size_t v2) {
+    ply_write(m_ply, 3);
+    ply_write(m_ply, v0);
+    ply_write(m_ply, v1);
+    ply_write(m_ply, v2);
+}
+
+void PLYStreamWriter::close() {
+    if (m_ply != NULL) {
+        assert_success(ply_close(m_ply), "Closing PLY file failed");
+        m_ply = NULL;
+    }
+}
@@ -0,0 +1,32 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <string>
+
+#include <Core/EigenTypedef.h>
+
+struct t_ply_;
+
+namespace PyMesh {
+
+/**
+ * Writes a 3D triangle mesh to a PLY file one element at a time.  Element
+ * counts are part of the header, so they must be known upfront, and all
+ * vertices must be written before the faces.
+ */
+class PLYStreamWriter {
+    public:
+        PLYStreamWriter(const std::string& filename,
+                size_t num_vertices, size_t num_faces, bool in_ascii=false);
+        ~PLYStreamWriter();
+
+    public:
+        void write_vertex(const Float* coordinates);
+        void write_face(size_t v0, size_t v1, size_t v2);
+        void close();
+
+    private:
+        struct t_ply_* m_ply;
+};
+
+}
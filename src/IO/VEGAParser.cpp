@@ -9,7 +9,7 @@
 
 #include <Core/EigenTypedef.h>
 #include <Core/Exception.h>
-#include <Misc/Multiplet.h>
+#include <Geometry/ElementBoundary.h>
 
 using namespace PyMesh;
 
@@ -224,34 +224,21 @@ void VEGAParser::extract_faces_from_voxels() {
     }
     m_faces.clear();
 
-    typedef std::map<Triplet, unsigned short> FaceCounter;
-    FaceCounter face_counter;
+    MatrixIr voxels(m_voxels.size(), 4);
+    size_t count = 0;
     for (const auto& voxel : m_voxels) {
         assert(voxel.size() == 4);
-        Triplet voxel_faces[4] = {
-            Triplet(voxel[0], voxel[2], voxel[1]),
-            Triplet(voxel[0], voxel[1], voxel[3]),
-            Triplet(voxel[0], voxel[3], voxel[2]),
-            Triplet(voxel[1], voxel[2], voxel[3])
-        };
-
-        for (size_t j=0; j<4; j++) {
-            if (face_counter.find(voxel_faces[j]) == face_counter.end()) {
-                face_counter[voxel_faces[j]] = 1;
-            } else {
-                face_counter[voxel_faces[j]] += 1;
-            }
-        }
+        voxels.row(count) = voxel.transpose();
+        count++;
     }
 
-    std::vector<int> vertex_buffer;
-    for (FaceCounter::const_iterator itr = face_counter.begin();
-            itr!=face_counter.end(); itr++) {
-        assert(itr->second == 1 || itr->second == 2);
-        if (itr->second == 1) {
-            const VectorI& f = itr->first.get_ori_data();
-            m_faces.push_back(f);
-        }
+    MatrixIr faces;
+    VectorI face_voxels;
+    ElementBoundary::extract_boundary(voxels,
+            ElementBoundary::get_voxel_facets(4), false,
+            faces, face_voxels);
+    for (size_t i=0; i<faces.rows(); i++) {
+        m_faces.push_back(faces.row(i).transpose());
     }
     m_num_faces = m_faces.size();
     m_vertex_per_face = 3;
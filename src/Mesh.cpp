@@ -31,33 +31,35 @@ size_t Mesh::get_num_voxels() const {
 }
 
 VectorF Mesh::get_vertex(size_t i) {
-    const size_t dim = get_dim();
-    return get_vertices().segment(i*dim, dim);
+    return static_cast<const Mesh*>(this)->get_vertex(i);
 }
 
 VectorI Mesh::get_face(size_t i) {
-    size_t stride = get_vertex_per_face();
-    return get_faces().segment(i*stride, stride);
+    return static_cast<const Mesh*>(this)->get_face(i);
 }
 
 VectorI Mesh::get_voxel(size_t i) {
-    size_t stride = get_vertex_per_voxel();
-    return get_voxels().segment(i*stride, stride);
+    return static_cast<const Mesh*>(this)->get_voxel(i);
 }
 
 VectorF Mesh::get_vertex(size_t i) const {
-    const size_t dim = get_dim();
-    return get_vertices().segment(i*dim, dim);
+    if (m_geometry->has_single_precision_vertices()) {
+        return m_geometry->get_vertex_matrix_f32().row(i)
+            .transpose().cast<Float>();
+    }
+    return get_vertex_matrix().row(i).transpose();
 }
 
 VectorI Mesh::get_face(size_t i) const {
     size_t stride = get_vertex_per_face();
-    return get_faces().segment(i*stride, stride);
+    return Eigen::Map<const VectorI>(
+            get_face_matrix().data() + i*stride, stride);
 }
 
 VectorI Mesh::get_voxel(size_t i) const {
     size_t stride = get_vertex_per_voxel();
-    return get_voxels().segment(i*stride, stride);
+    return Eigen::Map<const VectorI>(
+            get_voxel_matrix().data() + i*stride, stride);
 }
 
 VectorF& Mesh::get_vertices() {
@@ -72,16 +74,19 @@ VectorI& Mesh::get_voxels() {
     return m_geometry->get_voxels();
 }
 
-const VectorF& Mesh::get_vertices() const {
-    return m_geometry->get_vertices();
+Eigen::Map<const VectorF> Mesh::get_vertices() const {
+    const MeshGeometry& geometry = *m_geometry;
+    return geometry.get_vertices();
 }
 
-const VectorI& Mesh::get_faces() const {
-    return m_geometry->get_faces();
+Eigen::Map<const VectorI> Mesh::get_faces() const {
+    const MeshGeometry& geometry = *m_geometry;
+    return geometry.get_faces();
 }
 
-const VectorI& Mesh::get_voxels() const {
-    return m_geometry->get_voxels();
+Eigen::Map<const VectorI> Mesh::get_voxels() const {
+    const MeshGeometry& geometry = *m_geometry;
+    return geometry.get_voxels();
 }
 
 int Mesh::get_vertex_per_face() const {
@@ -92,6 +97,46 @@ int Mesh::get_vertex_per_voxel() const {
     return m_geometry->get_vertex_per_voxel();
 }
 
+Eigen::Map<const MatrixFr> Mesh::get_vertex_matrix() const {
+    return m_geometry->get_vertex_matrix();
+}
+
+Eigen::Map<const MatrixIr> Mesh::get_face_matrix() const {
+    return m_geometry->get_face_matrix();
+}
+
+Eigen::Map<const MatrixIr> Mesh::get_voxel_matrix() const {
+    return m_geometry->get_voxel_matrix();
+}
+
+bool Mesh::has_single_precision_vertices() const {
+    return m_geometry->has_single_precision_vertices();
+}
+
+Eigen::Map<const MatrixF32r> Mesh::get_vertex_matrix_f32() const {
+    return m_geometry->get_vertex_matrix_f32();
+}
+
+void Mesh::convert_vertices_to_single_precision() {
+    m_geometry->convert_vertices_to_single_precision();
+}
+
+const MatrixIr& Mesh::get_boundary_edges() const {
+    return m_geometry->get_boundary_edges();
+}
+
+const VectorI& Mesh::get_boundary_edge_faces() const {
+    return m_geometry->get_boundary_edge_faces();
+}
+
+const MatrixIr& Mesh::get_boundary_faces() const {
+    return m_geometry->get_boundary_faces();
+}
+
+const VectorI& Mesh::get_boundary_face_voxels() const {
+    return m_geometry->get_boundary_face_voxels();
+}
+
 void Mesh::enable_connectivity() {
     enable_vertex_connectivity();
     enable_face_connectivity();
@@ -158,18 +203,56 @@ VectorF& Mesh::get_attribute(const std::string& attr_name) {
     return m_attributes->get_attribute(attr_name);
 }
 
-const VectorF& Mesh::get_attribute(const std::string& attr_name) const {
-    return m_attributes->get_attribute(attr_name);
+Eigen::Map<const VectorF> Mesh::get_attribute(
+        const std::string& attr_name) const {
+    return m_attributes->get_attribute_view(attr_name);
 }
 
 void Mesh::set_attribute(const std::string& attr_name, VectorF& attr_value) {
     return m_attributes->set_attribute(attr_name, attr_value);
 }
 
+void Mesh::adopt_attribute(const std::string& attr_name, VectorF& attr_value) {
+    m_attributes->adopt_attribute(attr_name, attr_value);
+}
+
+void Mesh::borrow_attribute(const std::string& attr_name,
+        const Float* data, size_t size, std::shared_ptr<const void> owner) {
+    m_attributes->borrow_attribute(attr_name, data, size, owner);
+}
+
+Eigen::Map<const VectorF> Mesh::get_attribute_view(
+        const std::string& attr_name) const {
+    return m_attributes->get_attribute_view(attr_name);
+}
+
 std::vector<std::string> Mesh::get_attribute_names() const {
     return m_attributes->get_attribute_names();
 }
 
+bool Mesh::is_single_precision_attribute(const std::string& attr_name) const {
+    return m_attributes->is_single_precision(attr_name);
+}
+
+void Mesh::adopt_attribute_f32(const std::string& attr_name,
+        VectorF32& attr_value) {
+    m_attributes->adopt_attribute_f32(attr_name, attr_value);
+}
+
+void Mesh::borrow_attribute_f32(const std::string& attr_name,
+        const float* data, size_t size, std::shared_ptr<const void> owner) {
+    m_attributes->borrow_attribute_f32(attr_name, data, size, owner);
+}
+
+Eigen::Map<const VectorF32> Mesh::get_attribute_view_f32(
+        const std::string& attr_name) const {
+    return m_attributes->get_attribute_view_f32(attr_name);
+}
+
+void Mesh::convert_attribute_to_single_precision(const std::string& attr_name) {
+    m_attributes->convert_to_single_precision(attr_name);
+}
+
 void Mesh::set_geometry(GeometryPtr geometry) {
     m_geometry = geometry;
 }
@@ -58,13 +58,32 @@ class Mesh {
         VectorI& get_faces();
         VectorI& get_voxels();
 
-        const VectorF& get_vertices() const;
-        const VectorI& get_faces() const;
-        const VectorI& get_voxels() const;
+        Eigen::Map<const VectorF> get_vertices() const;
+        Eigen::Map<const VectorI> get_faces() const;
+        Eigen::Map<const VectorI> get_voxels() const;
 
         int get_vertex_per_face() const;
         int get_vertex_per_voxel() const;
 
+        // Read-only (num_elements, stride) views that never copy, even when
+        // the geometry borrows external buffers.  Single precision vertices
+        // are read through a cached double precision copy.
+        Eigen::Map<const MatrixFr> get_vertex_matrix() const;
+        Eigen::Map<const MatrixIr> get_face_matrix() const;
+        Eigen::Map<const MatrixIr> get_voxel_matrix() const;
+
+        // Single precision vertex storage.  It is kept as is by the double
+        // precision access above; use set_vertices() to store new values.
+        bool has_single_precision_vertices() const;
+        Eigen::Map<const MatrixF32r> get_vertex_matrix_f32() const;
+        void convert_vertices_to_single_precision();
+
+        // Boundary access, computed once and cached.
+        const MatrixIr& get_boundary_edges() const;
+        const VectorI& get_boundary_edge_faces() const;
+        const MatrixIr& get_boundary_faces() const;
+        const VectorI& get_boundary_face_voxels() const;
+
         // Connectivity access
         void enable_connectivity();
         void enable_vertex_connectivity();
@@ -87,10 +106,25 @@ class Mesh {
         void add_empty_attribute(const std::string& attr_name);
         void remove_attribute(const std::string& attr_name);
         VectorF& get_attribute(const std::string& attr_name);
-        const VectorF& get_attribute(const std::string& attr_name) const;
+        Eigen::Map<const VectorF> get_attribute(const std::string& attr_name) const;
         void set_attribute(const std::string& attr_name, VectorF& attr_value);
+        void adopt_attribute(const std::string& attr_name, VectorF& attr_value);
+        void borrow_attribute(const std::string& attr_name,
+                const Float* data, size_t size, std::shared_ptr<const void> owner);
+        Eigen::Map<const VectorF> get_attribute_view(
+                const std::string& attr_name) const;
         std::vector<std::string> get_attribute_names() const;
 
+        // Single precision attribute storage.
+        bool is_single_precision_attribute(const std::string& attr_name) const;
+        void adopt_attribute_f32(const std::string& attr_name,
+                VectorF32& attr_value);
+        void borrow_attribute_f32(const std::string& attr_name,
+                const float* data, size_t size, std::shared_ptr<const void> owner);
+        Eigen::Map<const VectorF32> get_attribute_view_f32(
+                const std::string& attr_name) const;
+        void convert_attribute_to_single_precision(const std::string& attr_name);
+
     public:
         typedef std::shared_ptr<MeshGeometry>     GeometryPtr;
         typedef std::shared_ptr<MeshConnectivity> ConnectivityPtr;
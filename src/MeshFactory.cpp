@@ -8,8 +8,8 @@
 #include <Core/Exception.h>
 #include <Geometry/MeshGeometry.h>
 #include <IO/MeshParser.h>
-#include <Math/MatrixUtils.h>
 #include <Mesh.h>
+#include <Misc/Profiler.h>
 
 using namespace PyMesh;
 
@@ -18,15 +18,21 @@ MeshFactory::MeshFactory() {
 }
 
 MeshFactory& MeshFactory::load_file(const std::string& filename) {
+    PYMESH_PROFILE_ZONE("MeshFactory::load_file");
     MeshParser::Ptr parser = MeshParser::create_parser(filename);
     assert(parser != NULL);
-    bool success = parser->parse(filename);
+    bool success;
+    {
+        PYMESH_PROFILE_ZONE("MeshFactory::load_file/parse");
+        success = parser->parse(filename);
+    }
     if (!success) {
         std::stringstream err_msg;
         err_msg << "Parsing " << filename << " has failed.";
         throw RuntimeError(err_msg.str());
     }
 
+    PYMESH_PROFILE_ZONE("MeshFactory::load_file/export");
     m_mesh->set_geometry(std::make_shared<MeshGeometry>());
     initialize_vertices(parser);
     initialize_faces(parser);
@@ -37,15 +43,21 @@ MeshFactory& MeshFactory::load_file(const std::string& filename) {
 }
 
 MeshFactory& MeshFactory::load_file_with_hint(const std::string& filename, const std::string& extension_hint) {
+    PYMESH_PROFILE_ZONE("MeshFactory::load_file");
     MeshParser::Ptr parser = MeshParser::create_parser_for_extension(filename, extension_hint);
     assert(parser != NULL);
-    bool success = parser->parse(filename);
+    bool success;
+    {
+        PYMESH_PROFILE_ZONE("MeshFactory::load_file/parse");
+        success = parser->parse(filename);
+    }
     if (!success) {
         std::stringstream err_msg;
         err_msg << "Parsing " << filename << "with hint '" << extension_hint  << "' has failed.";
         throw RuntimeError(err_msg.str());
     }
 
+    PYMESH_PROFILE_ZONE("MeshFactory::load_file/export");
     m_mesh->set_geometry(std::make_shared<MeshGeometry>());
     initialize_vertices(parser);
     initialize_faces(parser);
@@ -58,6 +70,7 @@ MeshFactory& MeshFactory::load_file_with_hint(const std::string& filename, const
 MeshFactory& MeshFactory::load_data(
         const VectorF& vertices, const VectorI& faces, const VectorI& voxels,
         size_t dim, size_t num_vertex_per_face, size_t num_vertex_per_voxel) {
+    PYMESH_PROFILE_ZONE("MeshFactory::load_data");
     m_mesh->set_geometry(std::make_shared<MeshGeometry>());
     Mesh::GeometryPtr geometry = m_mesh->get_geometry();
     geometry->set_vertices(vertices);
@@ -68,6 +81,29 @@ MeshFactory& MeshFactory::load_data(
     geometry->set_vertex_per_voxel(num_vertex_per_voxel);
 
     if (faces.size() == 0 && voxels.size() > 0) {
+        PYMESH_PROFILE_ZONE("MeshFactory::extract_faces_from_voxels");
+        geometry->extract_faces_from_voxels();
+    }
+
+    return *this;
+}
+
+MeshFactory& MeshFactory::adopt_data(
+        VectorF& vertices, VectorI& faces, VectorI& voxels,
+        size_t dim, size_t num_vertex_per_face, size_t num_vertex_per_voxel) {
+    PYMESH_PROFILE_ZONE("MeshFactory::adopt_data");
+    const bool extract_faces = faces.size() == 0 && voxels.size() > 0;
+    m_mesh->set_geometry(std::make_shared<MeshGeometry>());
+    Mesh::GeometryPtr geometry = m_mesh->get_geometry();
+    geometry->adopt_vertices(vertices);
+    geometry->adopt_faces(faces);
+    geometry->adopt_voxels(voxels);
+    geometry->set_dim(dim);
+    geometry->set_vertex_per_face(num_vertex_per_face);
+    geometry->set_vertex_per_voxel(num_vertex_per_voxel);
+
+    if (extract_faces) {
+        PYMESH_PROFILE_ZONE("MeshFactory::extract_faces_from_voxels");
         geometry->extract_faces_from_voxels();
     }
 
@@ -76,18 +112,63 @@ MeshFactory& MeshFactory::load_data(
 
 MeshFactory& MeshFactory::load_matrices(
         const MatrixFr& vertices, const MatrixIr& faces, const MatrixIr& voxels) {
-    const size_t dim = vertices.cols();
-    const size_t num_vertex_per_face = faces.cols();
-    const size_t num_vertex_per_voxel = voxels.cols();
-    return load_data(
-            MatrixUtils::flatten<VectorF>(vertices),
-            MatrixUtils::flatten<VectorI>(faces),
-            MatrixUtils::flatten<VectorI>(voxels),
-            dim, num_vertex_per_face, num_vertex_per_voxel);
+    PYMESH_PROFILE_ZONE("MeshFactory::load_matrices");
+    // Row major matrices are already laid out as flattened arrays, so copy
+    // each of them once and hand the storage over to the geometry.
+    VectorF flat_vertices = Eigen::Map<const VectorF>(
+            vertices.data(), vertices.size());
+    VectorI flat_faces = Eigen::Map<const VectorI>(faces.data(), faces.size());
+    VectorI flat_voxels = Eigen::Map<const VectorI>(
+            voxels.data(), voxels.size());
+
+    m_mesh->set_geometry(std::make_shared<MeshGeometry>());
+    Mesh::GeometryPtr geometry = m_mesh->get_geometry();
+    geometry->adopt_vertices(flat_vertices);
+    geometry->adopt_faces(flat_faces);
+    geometry->adopt_voxels(flat_voxels);
+    geometry->set_dim(vertices.cols());
+    geometry->set_vertex_per_face(faces.cols());
+    geometry->set_vertex_per_voxel(voxels.cols());
+
+    if (faces.size() == 0 && voxels.size() > 0) {
+        PYMESH_PROFILE_ZONE("MeshFactory::extract_faces_from_voxels");
+        geometry->extract_faces_from_voxels();
+    }
+
+    return *this;
+}
+
+MeshFactory& MeshFactory::borrow_matrices(
+        const Eigen::Map<const MatrixFr>& vertices,
+        const Eigen::Map<const MatrixIr>& faces,
+        const Eigen::Map<const MatrixIr>& voxels,
+        std::shared_ptr<const void> owner) {
+    PYMESH_PROFILE_ZONE("MeshFactory::borrow_matrices");
+    m_mesh->set_geometry(std::make_shared<MeshGeometry>());
+    Mesh::GeometryPtr geometry = m_mesh->get_geometry();
+    geometry->borrow_vertices(vertices.data(), vertices.size(), owner);
+    geometry->set_dim(vertices.cols());
+    initialize_borrowed_elements(faces, voxels, owner);
+    return *this;
+}
+
+MeshFactory& MeshFactory::borrow_matrices(
+        const Eigen::Map<const MatrixF32r>& vertices,
+        const Eigen::Map<const MatrixIr>& faces,
+        const Eigen::Map<const MatrixIr>& voxels,
+        std::shared_ptr<const void> owner) {
+    PYMESH_PROFILE_ZONE("MeshFactory::borrow_matrices");
+    m_mesh->set_geometry(std::make_shared<MeshGeometry>());
+    Mesh::GeometryPtr geometry = m_mesh->get_geometry();
+    geometry->borrow_vertices_f32(vertices.data(), vertices.size(), owner);
+    geometry->set_dim(vertices.cols());
+    initialize_borrowed_elements(faces, voxels, owner);
+    return *this;
 }
 
 MeshFactory& MeshFactory::with_connectivity(
         const std::string& conn_type) {
+    PYMESH_PROFILE_ZONE("MeshFactory::with_connectivity");
     // Valid conn_type are: vertex, face, voxel, all
     // Using minimal prefix to distinguish them.
     const size_t l = conn_type.size();
@@ -111,16 +192,29 @@ MeshFactory& MeshFactory::with_connectivity(
 
 MeshFactory& MeshFactory::with_attribute(
         const std::string& attr_name) {
+    PYMESH_PROFILE_ZONE("MeshFactory::with_attribute");
     Mesh::AttributesPtr attributes = m_mesh->get_attributes();
     attributes->add_attribute(attr_name, *m_mesh);
     return *this;
 }
 
 MeshFactory& MeshFactory::drop_zero_dim() {
+    PYMESH_PROFILE_ZONE("MeshFactory::drop_zero_dim");
     compute_and_drop_zero_dim();
     return *this;
 }
 
+MeshFactory& MeshFactory::with_single_precision() {
+    PYMESH_PROFILE_ZONE("MeshFactory::with_single_precision");
+    m_mesh->convert_vertices_to_single_precision();
+    for (const auto& name : m_mesh->get_attribute_names()) {
+        if (name.compare(0, 7, "vertex_") == 0) {
+            m_mesh->convert_attribute_to_single_precision(name);
+        }
+    }
+    return *this;
+}
+
 void MeshFactory::initialize_vertices(MeshParser::Ptr parser) {
     Mesh::GeometryPtr geometry = m_mesh->get_geometry();
 
@@ -167,6 +261,22 @@ void MeshFactory::initialize_attributes(MeshParser::Ptr parser) {
     }
 }
 
+void MeshFactory::initialize_borrowed_elements(
+        const Eigen::Map<const MatrixIr>& faces,
+        const Eigen::Map<const MatrixIr>& voxels,
+        std::shared_ptr<const void> owner) {
+    Mesh::GeometryPtr geometry = m_mesh->get_geometry();
+    geometry->borrow_faces(faces.data(), faces.size(), owner);
+    geometry->borrow_voxels(voxels.data(), voxels.size(), owner);
+    geometry->set_vertex_per_face(faces.cols());
+    geometry->set_vertex_per_voxel(voxels.cols());
+
+    if (faces.size() == 0 && voxels.size() > 0) {
+        PYMESH_PROFILE_ZONE("MeshFactory::extract_faces_from_voxels");
+        geometry->extract_faces_from_voxels();
+    }
+}
+
 void MeshFactory::compute_and_drop_zero_dim() {
     const size_t num_vertices = m_mesh->get_num_vertices();
     if (num_vertices == 0) return;
@@ -177,7 +287,7 @@ void MeshFactory::compute_and_drop_zero_dim() {
         << " coordinate because flat geometry." << std::endl;
     std::vector<std::string> attr_names = m_mesh->get_attribute_names();
     for (auto itr = attr_names.begin(); itr != attr_names.end(); itr++) {
-        VectorF& attr = m_mesh->get_attribute(*itr);
+        const auto attr = m_mesh->get_attribute_view(*itr);
         if (attr.size() == num_vertices * 3) {
             VectorF reduced_attr(num_vertices * 2);
             for (size_t i=0; i<num_vertices; i++) {
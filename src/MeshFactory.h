@@ -24,11 +24,43 @@ class MeshFactory {
         MeshFactory& load_data(
                 const VectorF& vertices, const VectorI& faces, const VectorI& voxels,
                 size_t dim, size_t num_vertex_per_face, size_t num_vertex_per_voxel);
+        /**
+         * Same as load_data() but takes over the storage of the given arrays
+         * without copying.  The arrays are left empty.
+         */
+        MeshFactory& adopt_data(
+                VectorF& vertices, VectorI& faces, VectorI& voxels,
+                size_t dim, size_t num_vertex_per_face, size_t num_vertex_per_voxel);
         MeshFactory& load_matrices(
                 const MatrixFr& vertices, const MatrixIr& faces, const MatrixIr& voxels);
+        /**
+         * Same as load_matrices() but without copying.  The mesh reads from
+         * the given buffers for as long as it lives; owner must keep them
+         * valid until it is released.  Faces are still extracted (and owned)
+         * when only voxels are given.
+         */
+        MeshFactory& borrow_matrices(
+                const Eigen::Map<const MatrixFr>& vertices,
+                const Eigen::Map<const MatrixIr>& faces,
+                const Eigen::Map<const MatrixIr>& voxels,
+                std::shared_ptr<const void> owner);
+        /**
+         * Same as above but with single precision vertices, which are stored
+         * as is.
+         */
+        MeshFactory& borrow_matrices(
+                const Eigen::Map<const MatrixF32r>& vertices,
+                const Eigen::Map<const MatrixIr>& faces,
+                const Eigen::Map<const MatrixIr>& voxels,
+                std::shared_ptr<const void> owner);
         MeshFactory& with_connectivity(const std::string& conn_type);
         MeshFactory& with_attribute(const std::string& attr_name);
         MeshFactory& drop_zero_dim();
+        /**
+         * Store vertices and vertex attributes (i.e. attributes named
+         * "vertex_*") added so far in single precision.
+         */
+        MeshFactory& with_single_precision();
         Mesh::Ptr create() { return m_mesh; }
 
     private:
@@ -39,6 +71,10 @@ class MeshFactory {
         void initialize_faces(MeshParser::Ptr parser);
         void initialize_voxels(MeshParser::Ptr parser);
         void initialize_attributes(MeshParser::Ptr parser);
+        void initialize_borrowed_elements(
+                const Eigen::Map<const MatrixIr>& faces,
+                const Eigen::Map<const MatrixIr>& voxels,
+                std::shared_ptr<const void> owner);
         void compute_and_drop_zero_dim();
 
     private:
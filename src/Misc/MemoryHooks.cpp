@@ -0,0 +1,128 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#ifdef PYMESH_MEMORY_TRACKING
+
+/**
+ * Allocation hooks for MemoryTracker.  Every PyMesh binary is linked with
+ * -Wl,--wrap=<symbol> for the symbols below (see Settings.cmake), so calls
+ * made from PyMesh code land here and are forwarded to the real allocator
+ * through __real_<symbol>.  Allocations made by other libraries, e.g. numpy,
+ * are not affected.
+ *
+ * Sizes are taken from malloc_usable_size() so that frees can be accounted
+ * without a header.  libstdc++'s operator new is built on malloc, so the same
+ * applies to it.
+ */
+
+#include <cstddef>
+#include <new>
+
+#include <malloc.h>
+
+#include "MemoryTracker.h"
+
+using PyMesh::MemoryTracker;
+
+namespace MemoryHooksHelper {
+    inline void* track_allocation(void* ptr) {
+        if (ptr != nullptr && MemoryTracker::is_enabled()) {
+            MemoryTracker::record_allocation(malloc_usable_size(ptr));
+        }
+        return ptr;
+    }
+
+    inline void track_deallocation(void* ptr) {
+        if (ptr != nullptr && MemoryTracker::is_enabled()) {
+            MemoryTracker::record_deallocation(malloc_usable_size(ptr));
+        }
+    }
+}
+
+using namespace MemoryHooksHelper;
+
+extern "C" {
+    void* __real_malloc(size_t size);
+    void* __real_calloc(size_t num, size_t size);
+    void* __real_realloc(void* ptr, size_t size);
+    void __real_free(void* ptr);
+
+    void* __real__Znwm(size_t size);
+    void* __real__Znam(size_t size);
+    void* __real__ZnwmRKSt9nothrow_t(size_t size, const std::nothrow_t&);
+    void* __real__ZnamRKSt9nothrow_t(size_t size, const std::nothrow_t&);
+    void __real__ZdlPv(void* ptr);
+    void __real__ZdaPv(void* ptr);
+    void __real__ZdlPvm(void* ptr, size_t size);
+    void __real__ZdaPvm(void* ptr, size_t size);
+    void __real__ZdlPvRKSt9nothrow_t(void* ptr, const std::nothrow_t&);
+    void __real__ZdaPvRKSt9nothrow_t(void* ptr, const std::nothrow_t&);
+
+    void* __wrap_malloc(size_t size) {
+        return track_allocation(__real_malloc(size));
+    }
+
+    void* __wrap_calloc(size_t num, size_t size) {
+        return track_allocation(__real_calloc(num, size));
+    }
+
+    void* __wrap_realloc(void* ptr, size_t size) {
+        track_deallocation(ptr);
+        return track_allocation(__real_realloc(ptr, size));
+    }
+
+    void __wrap_free(void* ptr) {
+        track_deallocation(ptr);
+        __real_free(ptr);
+    }
+
+    // operator new(size_t) and operator new[](size_t).
+    void* __wrap__Znwm(size_t size) {
+        return track_allocation(__real__Znwm(size));
+    }
+
+    void* __wrap__Znam(size_t size) {
+        return track_allocation(__real__Znam(size));
+    }
+
+    // Non-throwing operator new and operator new[].
+    void* __wrap__ZnwmRKSt9nothrow_t(size_t size, const std::nothrow_t& tag) {
+        return track_allocation(__real__ZnwmRKSt9nothrow_t(size, tag));
+    }
+
+    void* __wrap__ZnamRKSt9nothrow_t(size_t size, const std::nothrow_t& tag) {
+        return track_allocation(__real__ZnamRKSt9nothrow_t(size, tag));
+    }
+
+    // operator delete and operator delete[], unsized, sized and
+    // non-throwing.
+    void __wrap__ZdlPv(void* ptr) {
+        track_deallocation(ptr);
+        __real__ZdlPv(ptr);
+    }
+
+    void __wrap__ZdaPv(void* ptr) {
+        track_deallocation(ptr);
+        __real__ZdaPv(ptr);
+    }
+
+    void __wrap__ZdlPvm(void* ptr, size_t size) {
+        track_deallocation(ptr);
+        __real__ZdlPvm(ptr, size);
+    }
+
+    void __wrap__ZdaPvm(void* ptr, size_t size) {
+        track_deallocation(ptr);
+        __real__ZdaPvm(ptr, size);
+    }
+
+    void __wrap__ZdlPvRKSt9nothrow_t(void* ptr, const std::nothrow_t& tag) {
+        track_deallocation(ptr);
+        __real__ZdlPvRKSt9nothrow_t(ptr, tag);
+    }
+
+    void __wrap__ZdaPvRKSt9nothrow_t(void* ptr, const std::nothrow_t& tag) {
+        track_deallocation(ptr);
+        __real__ZdaPvRKSt9nothrow_t(ptr, tag);
+    }
+}
+
+#endif
@@ -0,0 +1,184 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include "MemoryTracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#include <Core/Exception.h>
+
+using namespace PyMesh;
+
+namespace MemoryTrackerHelper {
+    struct StageRegistry {
+        std::mutex mutex;
+        std::map<std::string, MemoryTracker::StageSummary> stages;
+    };
+
+    StageRegistry& get_stage_registry() {
+        static StageRegistry* registry = new StageRegistry();
+        return *registry;
+    }
+
+    void update_max(std::atomic<int64_t>& value, int64_t candidate) {
+        int64_t current = value.load(std::memory_order_relaxed);
+        while (candidate > current && !value.compare_exchange_weak(
+                    current, candidate, std::memory_order_relaxed)) {}
+    }
+
+    std::string format_bytes(int64_t num_bytes) {
+        const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+        double value = num_bytes;
+        size_t i = 0;
+        while (std::abs(value) >= 1024.0 && i < 4) {
+            value /= 1024.0;
+            i++;
+        }
+        std::stringstream out;
+        out << std::fixed << std::setprecision(i == 0 ? 0 : 2) << value
+            << " " << units[i];
+        return out.str();
+    }
+}
+
+using namespace MemoryTrackerHelper;
+
+std::atomic<bool> MemoryTracker::s_enabled(false);
+std::atomic<int64_t> MemoryTracker::s_allocated(0);
+std::atomic<int64_t> MemoryTracker::s_freed(0);
+std::atomic<int64_t> MemoryTracker::s_live(0);
+std::atomic<int64_t> MemoryTracker::s_high_water(0);
+std::atomic<int64_t> MemoryTracker::s_peak(0);
+std::atomic<int64_t> MemoryTracker::s_num_allocations(0);
+
+bool MemoryTracker::is_supported() {
+#ifdef PYMESH_MEMORY_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MemoryTracker::start() {
+    if (!is_supported()) {
+        throw NotImplementedError(
+                "PyMesh is built without PYMESH_MEMORY_TRACKING");
+    }
+    stop();
+    {
+        StageRegistry& registry = get_stage_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.stages.clear();
+    }
+    s_allocated = 0;
+    s_freed = 0;
+    s_live = 0;
+    s_high_water = 0;
+    s_peak = 0;
+    s_num_allocations = 0;
+    s_enabled.store(true, std::memory_order_release);
+}
+
+void MemoryTracker::stop() {
+    s_enabled.store(false, std::memory_order_release);
+}
+
+MemoryTracker::Usage MemoryTracker::get_usage() {
+    Usage usage;
+    usage.allocated = s_allocated.load();
+    usage.freed = s_freed.load();
+    usage.live = s_live.load();
+    usage.peak = std::max(s_peak.load(), s_high_water.load());
+    usage.num_allocations = s_num_allocations.load();
+    return usage;
+}
+
+void MemoryTracker::reset_peak() {
+    const int64_t live = s_live.load();
+    s_peak = live;
+    s_high_water = live;
+}
+
+MemoryTracker::Snapshot MemoryTracker::enter_stage() {
+    // The high water mark is restarted from the current live bytes so that
+    // the stage sees its own peak.  The previous mark is folded into the
+    // global peak and restored when the stage ends.
+    Snapshot snapshot;
+    snapshot.allocated = s_allocated.load(std::memory_order_relaxed);
+    snapshot.freed = s_freed.load(std::memory_order_relaxed);
+    snapshot.live = s_live.load(std::memory_order_relaxed);
+    snapshot.high_water = s_high_water.exchange(snapshot.live);
+    update_max(s_peak, snapshot.high_water);
+    return snapshot;
+}
+
+void MemoryTracker::leave_stage(const char* name, const Snapshot& snapshot) {
+    const int64_t high_water = s_high_water.load(std::memory_order_relaxed);
+    update_max(s_high_water, snapshot.high_water);
+
+    const int64_t allocated =
+        s_allocated.load(std::memory_order_relaxed) - snapshot.allocated;
+    const int64_t freed =
+        s_freed.load(std::memory_order_relaxed) - snapshot.freed;
+    const int64_t peak = std::max<int64_t>(high_water - snapshot.live, 0);
+
+    StageRegistry& registry = get_stage_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto itr = registry.stages.find(name);
+    if (itr == registry.stages.end()) {
+        registry.stages[name] = {name, 1, allocated, freed, peak};
+    } else {
+        StageSummary& stage = itr->second;
+        stage.count++;
+        stage.allocated += allocated;
+        stage.freed += freed;
+        stage.peak = std::max(stage.peak, peak);
+    }
+}
+
+std::vector<MemoryTracker::StageSummary> MemoryTracker::get_summary() {
+    std::vector<StageSummary> summary;
+    {
+        StageRegistry& registry = get_stage_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto& entry : registry.stages) {
+            summary.push_back(entry.second);
+        }
+    }
+    std::sort(summary.begin(), summary.end(),
+            [](const StageSummary& a, const StageSummary& b) {
+                return a.peak > b.peak;
+            });
+    return summary;
+}
+
+void MemoryTracker::print_summary(std::ostream& out) {
+    const auto summary = get_summary();
+    const std::string separator(106, '-');
+    out << separator << std::endl;
+    out << "| " << std::left << std::setw(46) << "Stage" << std::right
+        << " | " << std::setw(8) << "Count"
+        << " | " << std::setw(12) << "Allocated"
+        << " | " << std::setw(12) << "Freed"
+        << " | " << std::setw(12) << "Peak" << " |" << std::endl;
+    out << separator << std::endl;
+    for (const auto& stage : summary) {
+        out << "| " << std::left << std::setw(46) << stage.name.substr(0, 46)
+            << std::right
+            << " | " << std::setw(8) << stage.count
+            << " | " << std::setw(12) << format_bytes(stage.allocated)
+            << " | " << std::setw(12) << format_bytes(stage.freed)
+            << " | " << std::setw(12) << format_bytes(stage.peak)
+            << " |" << std::endl;
+    }
+    out << separator << std::endl;
+
+    const Usage usage = get_usage();
+    out << "Total allocated: " << format_bytes(usage.allocated)
+        << " in " << usage.num_allocations << " allocation(s), live: "
+        << format_bytes(usage.live) << ", peak: " << format_bytes(usage.peak)
+        << std::endl;
+}
@@ -0,0 +1,119 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace PyMesh {
+
+/**
+ * Process wide heap accounting.  When PyMesh is built with
+ * PYMESH_MEMORY_TRACKING, every malloc/free and operator new/delete issued
+ * from PyMesh binaries (including Eigen and STL containers instantiated in
+ * them) is counted while tracking is enabled.
+ *
+ * Profiler zones double as memory stages: each stage records the bytes
+ * allocated and freed while it was open and its peak usage above the live
+ * bytes at entry.  Stages are not attributed per thread, so allocations made
+ * by worker threads count towards every open stage.  Peaks are exact for
+ * stages that do not overlap with stages on other threads.
+ *
+ *   MemoryTracker::start();
+ *   {
+ *       PYMESH_PROFILE_ZONE("stage");
+ *       ...
+ *   }
+ *   MemoryTracker::stop();
+ *   MemoryTracker::print_summary();
+ */
+class MemoryTracker {
+    public:
+        struct Usage {
+            int64_t allocated; // Bytes allocated since start().
+            int64_t freed;     // Bytes freed since start().
+            int64_t live;      // allocated - freed.
+            int64_t peak;      // Max live since start() or reset_peak().
+            int64_t num_allocations;
+        };
+
+        struct StageSummary {
+            std::string name;
+            size_t count;
+            int64_t allocated;
+            int64_t freed;
+            int64_t peak; // Max over all calls of the peak above entry.
+        };
+
+        struct Snapshot {
+            int64_t allocated;
+            int64_t freed;
+            int64_t live;
+            int64_t high_water;
+        };
+
+    public:
+        /**
+         * Whether allocations are hooked in this build.
+         */
+        static bool is_supported();
+
+        /**
+         * Reset all counters and stage statistics and start counting.
+         * Memory allocated before start() and freed afterwards is counted as
+         * freed, so live may become negative.
+         */
+        static void start();
+        static void stop();
+
+        static bool is_enabled() {
+            return s_enabled.load(std::memory_order_relaxed);
+        }
+
+        static Usage get_usage();
+        static void reset_peak();
+
+        /**
+         * Stage statistics sorted by decreasing peak.
+         */
+        static std::vector<StageSummary> get_summary();
+        static void print_summary(std::ostream& out=std::cout);
+
+    public:
+        /**
+         * Called by the allocation hooks.
+         */
+        static void record_allocation(size_t num_bytes) {
+            const int64_t live = s_live.fetch_add(num_bytes,
+                    std::memory_order_relaxed) + num_bytes;
+            s_allocated.fetch_add(num_bytes, std::memory_order_relaxed);
+            s_num_allocations.fetch_add(1, std::memory_order_relaxed);
+            int64_t high_water = s_high_water.load(std::memory_order_relaxed);
+            while (live > high_water && !s_high_water.compare_exchange_weak(
+                        high_water, live, std::memory_order_relaxed)) {}
+        }
+
+        static void record_deallocation(size_t num_bytes) {
+            s_live.fetch_sub(num_bytes, std::memory_order_relaxed);
+            s_freed.fetch_add(num_bytes, std::memory_order_relaxed);
+        }
+
+        /**
+         * Called by ProfileZone.
+         */
+        static Snapshot enter_stage();
+        static void leave_stage(const char* name, const Snapshot& snapshot);
+
+    private:
+        static std::atomic<bool> s_enabled;
+        static std::atomic<int64_t> s_allocated;
+        static std::atomic<int64_t> s_freed;
+        static std::atomic<int64_t> s_live;
+        static std::atomic<int64_t> s_high_water;
+        static std::atomic<int64_t> s_peak;
+        static std::atomic<int64_t> s_num_allocations;
+};
+
+}
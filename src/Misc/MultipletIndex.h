@@ -0,0 +1,253 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <tbb/tbb.h>
+
+#include <Core/Exception.h>
+#include <Misc/Multiplet.h>
+
+namespace PyMesh {
+
+namespace MultipletIndexHelper {
+    /**
+     * Stable LSD radix sort of entries by their key, one byte at a time.
+     * Each pass builds per-block histograms in parallel and scatters every
+     * block independently.  Passes where all entries share the same digit
+     * are skipped, so small indices only cost a few passes.
+     */
+    template<typename Entry>
+    void radix_sort(std::vector<Entry>& entries) {
+        constexpr size_t NUM_BUCKETS = 256;
+        constexpr size_t BLOCK_SIZE = 1 << 14;
+        const size_t num_entries = entries.size();
+        const size_t num_blocks = (num_entries + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const size_t num_components = std::tuple_size<
+            decltype(Entry::key)>::value;
+
+        std::vector<Entry> buffer(num_entries);
+        std::vector<size_t> histograms(num_blocks * NUM_BUCKETS);
+        for (size_t c=num_components; c>0; c--) {
+            for (size_t shift=0; shift<32; shift+=8) {
+                auto digit = [&](const Entry& entry) {
+                    return (entry.key[c-1] >> shift) & 0xFF;
+                };
+
+                std::fill(histograms.begin(), histograms.end(), 0);
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks),
+                        [&](const tbb::blocked_range<size_t>& r) {
+                            for (size_t i=r.begin(); i!=r.end(); i++) {
+                                size_t* hist = &histograms[i*NUM_BUCKETS];
+                                const size_t begin = i*BLOCK_SIZE;
+                                const size_t end = std::min(
+                                        begin + BLOCK_SIZE, num_entries);
+                                for (size_t j=begin; j<end; j++) {
+                                    hist[digit(entries[j])]++;
+                                }
+                            }
+                        });
+
+                // Offsets are digit-major, block-minor to keep it stable.
+                bool trivial = false;
+                size_t offset = 0;
+                for (size_t d=0; d<NUM_BUCKETS; d++) {
+                    const size_t digit_begin = offset;
+                    for (size_t i=0; i<num_blocks; i++) {
+                        const size_t count = histograms[i*NUM_BUCKETS+d];
+                        histograms[i*NUM_BUCKETS+d] = offset;
+                        offset += count;
+                    }
+                    if (offset - digit_begin == num_entries) trivial = true;
+                }
+                if (trivial) continue;
+
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks),
+                        [&](const tbb::blocked_range<size_t>& r) {
+                            for (size_t i=r.begin(); i!=r.end(); i++) {
+                                size_t* cursor = &histograms[i*NUM_BUCKETS];
+                                const size_t begin = i*BLOCK_SIZE;
+                                const size_t end = std::min(
+                                        begin + BLOCK_SIZE, num_entries);
+                                for (size_t j=begin; j<end; j++) {
+                                    buffer[cursor[digit(entries[j])]++] =
+                                        entries[j];
+                                }
+                            }
+                        });
+                entries.swap(buffer);
+            }
+        }
+    }
+}
+
+/**
+ * Build-once, query-many alternative to MultipletMap.
+ *
+ * Keys are canonicalized (order independent, as Multiplet::operator==) and
+ * radix sorted together with their values.  Values sharing a key are stored
+ * contiguously in insertion order, and keys are looked up by binary search.
+ * The first inserted key of each group is kept as its representative, so
+ * get_ori_data() still reflects the original ordering.
+ */
+template <typename KeyType, typename T>
+class MultipletIndex {
+    public:
+        static constexpr int DIM = KeyType::Data::SizeAtCompileTime;
+        typedef std::array<uint32_t, DIM> CanonicalKey;
+
+        class ValueRange {
+            public:
+                ValueRange(const T* begin, const T* end)
+                    : m_begin(begin), m_end(end) {}
+
+                const T* begin() const { return m_begin; }
+                const T* end() const { return m_end; }
+                size_t size() const { return m_end - m_begin; }
+                bool empty() const { return m_begin == m_end; }
+                const T& operator[](size_t i) const { return m_begin[i]; }
+
+            private:
+                const T* m_begin;
+                const T* m_end;
+        };
+
+    public:
+        MultipletIndex() = default;
+
+        MultipletIndex(const std::vector<KeyType>& keys,
+                const std::vector<T>& values) :
+            m_staged_keys(keys), m_staged_values(values) {
+                build();
+            }
+
+        /**
+         * Stage an entry.  Entries become searchable after build().
+         */
+        void insert(const KeyType& key, T val) {
+            m_staged_keys.push_back(key);
+            m_staged_values.push_back(val);
+        }
+
+        void build() {
+            if (m_staged_keys.size() != m_staged_values.size()) {
+                throw RuntimeError("Number of keys and values mismatch.");
+            }
+
+            struct Entry {
+                CanonicalKey key;
+                uint32_t index;
+            };
+            const size_t num_entries = m_staged_keys.size();
+            std::vector<Entry> entries(num_entries);
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, num_entries),
+                    [&](const tbb::blocked_range<size_t>& r) {
+                        for (size_t i=r.begin(); i!=r.end(); i++) {
+                            entries[i].key = canonicalize(m_staged_keys[i]);
+                            entries[i].index = i;
+                        }
+                    });
+            MultipletIndexHelper::radix_sort(entries);
+
+            m_keys.clear();
+            m_canonical_keys.clear();
+            m_offsets.clear();
+            m_values.resize(num_entries);
+            for (size_t i=0; i<num_entries; i++) {
+                const Entry& entry = entries[i];
+                if (i == 0 || entry.key != entries[i-1].key) {
+                    m_keys.push_back(m_staged_keys[entry.index]);
+                    m_canonical_keys.push_back(entry.key);
+                    m_offsets.push_back(i);
+                }
+                m_values[i] = m_staged_values[entry.index];
+            }
+            m_offsets.push_back(num_entries);
+
+            m_staged_keys.clear();
+            m_staged_values.clear();
+        }
+
+        /**
+         * Number of unique keys.
+         */
+        size_t size() const { return m_keys.size(); }
+        bool empty() const { return m_keys.empty(); }
+
+        const KeyType& get_key(size_t i) const { return m_keys[i]; }
+
+        ValueRange get_values(size_t i) const {
+            return ValueRange(
+                    m_values.data() + m_offsets[i],
+                    m_values.data() + m_offsets[i+1]);
+        }
+
+        /**
+         * Return the index of the given key, or size() if not found.
+         */
+        size_t find(const KeyType& key) const {
+            const CanonicalKey target = canonicalize(key);
+            auto itr = std::lower_bound(m_canonical_keys.begin(),
+                    m_canonical_keys.end(), target);
+            if (itr == m_canonical_keys.end() || *itr != target) {
+                return size();
+            }
+            return itr - m_canonical_keys.begin();
+        }
+
+        bool contains(const KeyType& key) const {
+            return find(key) != size();
+        }
+
+        ValueRange get(const KeyType& key) const {
+            const size_t i = find(key);
+            if (i == size())
+                throw RuntimeError("Key not found");
+            return get_values(i);
+        }
+
+        void clear() {
+            m_staged_keys.clear();
+            m_staged_values.clear();
+            m_keys.clear();
+            m_canonical_keys.clear();
+            m_offsets.clear();
+            m_values.clear();
+        }
+
+    private:
+        /**
+         * Flip the sign bit so that unsigned order matches signed order.
+         */
+        static CanonicalKey canonicalize(const KeyType& key) {
+            const auto& data = key.get_data();
+            CanonicalKey result;
+            for (int i=0; i<DIM; i++) {
+                result[i] = uint32_t(data[i]) ^ 0x80000000u;
+            }
+            return result;
+        }
+
+    private:
+        std::vector<KeyType> m_staged_keys;
+        std::vector<T> m_staged_values;
+
+        std::vector<KeyType> m_keys;
+        std::vector<CanonicalKey> m_canonical_keys;
+        std::vector<size_t> m_offsets;
+        std::vector<T> m_values;
+};
+
+template<typename T>
+using SingletonIndex = MultipletIndex<Singleton, T>;
+template<typename T>
+using DupletIndex = MultipletIndex<Duplet, T>;
+template<typename T>
+using TripletIndex = MultipletIndex<Triplet, T>;
+template<typename T>
+using QuadrupletIndex = MultipletIndex<Quadruplet, T>;
+
+}
@@ -0,0 +1,355 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+#include <Core/Exception.h>
+
+using namespace PyMesh;
+
+namespace ProfilerHelper {
+    typedef Profiler::Event Event;
+
+    /**
+     * Events of one thread.  Only the owning thread pushes, so the lock is
+     * contended only while start(), clear() or a query reads the buffer.
+     */
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::vector<Event> events;
+        size_t next = 0;
+        size_t dropped = 0;
+
+        void reset(size_t capacity) {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.clear();
+            events.shrink_to_fit();
+            events.reserve(capacity);
+            next = 0;
+            dropped = 0;
+        }
+
+        void push(const Event& event, size_t capacity) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (capacity == 0) {
+                dropped++;
+            } else if (events.size() < capacity) {
+                events.push_back(event);
+                next = events.size() % capacity;
+            } else {
+                events[next] = event;
+                next = (next + 1) % events.size();
+                dropped++;
+            }
+        }
+
+        std::vector<Event> get_events(uint64_t epoch) {
+            std::lock_guard<std::mutex> lock(mutex);
+            // Until the buffer wraps around, next is one past the last event
+            // and the oldest event is at 0.  Either way the oldest event is
+            // at next modulo the buffer size.
+            std::vector<Event> result;
+            result.reserve(events.size());
+            for (size_t i=0; i<events.size(); i++) {
+                const Event& event = events[(next + i) % events.size()];
+                if (event.begin < epoch) continue;
+                result.push_back(event);
+            }
+            return result;
+        }
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer> > buffers;
+        // Events of exited threads, moved out of their buffers.
+        std::vector<std::vector<Event> > retired_events;
+        size_t retired_dropped = 0;
+        std::atomic<size_t> capacity{0};
+        std::atomic<uint64_t> epoch{0};
+    };
+
+    Registry& get_registry() {
+        // Leaked on purpose: threads may record events during static
+        // destruction.
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    thread_local std::shared_ptr<ThreadBuffer> local_buffer;
+    thread_local int local_depth = 0;
+
+    /**
+     * Free the buffers of exited threads, i.e. those only the registry
+     * still references.  Their events are kept in retired_events unless
+     * keep_events is false.  registry.mutex must be held.
+     */
+    void retire_exited_buffers(Registry& registry, bool keep_events) {
+        auto& buffers = registry.buffers;
+        auto itr = buffers.begin();
+        while (itr != buffers.end()) {
+            if (itr->use_count() > 1) {
+                itr++;
+                continue;
+            }
+            if (keep_events) {
+                auto events = (*itr)->get_events(registry.epoch);
+                if (!events.empty()) {
+                    registry.retired_events.push_back(std::move(events));
+                }
+                registry.retired_dropped += (*itr)->dropped;
+            }
+            itr = buffers.erase(itr);
+        }
+        if (!keep_events) {
+            registry.retired_events.clear();
+            registry.retired_dropped = 0;
+        }
+    }
+
+    ThreadBuffer& get_local_buffer() {
+        if (!local_buffer) {
+            Registry& registry = get_registry();
+            auto buffer = std::make_shared<ThreadBuffer>();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            buffer->events.reserve(registry.capacity);
+            registry.buffers.push_back(buffer);
+            local_buffer = buffer;
+        }
+        return *local_buffer;
+    }
+
+    std::string escape(const char* str) {
+        std::stringstream out;
+        for (const char* c = str; *c != '\0'; c++) {
+            switch (*c) {
+                case '"': out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\t': out << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(*c) < 0x20) {
+                        out << "\\u" << std::hex << std::setw(4)
+                            << std::setfill('0') << int(*c) << std::dec;
+                    } else {
+                        out << *c;
+                    }
+            }
+        }
+        return out.str();
+    }
+}
+
+using namespace ProfilerHelper;
+
+std::atomic<bool> Profiler::s_enabled(false);
+
+void Profiler::start(size_t capacity) {
+    Registry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.capacity = capacity;
+    registry.epoch = now();
+    retire_exited_buffers(registry, false);
+    for (auto& buffer : registry.buffers) {
+        buffer->reset(capacity);
+    }
+    s_enabled.store(true, std::memory_order_release);
+}
+
+void Profiler::stop() {
+    s_enabled.store(false, std::memory_order_release);
+}
+
+void Profiler::clear() {
+    Registry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.epoch = now();
+    retire_exited_buffers(registry, false);
+    for (auto& buffer : registry.buffers) {
+        buffer->reset(registry.capacity);
+    }
+}
+
+const char* Profiler::intern(const std::string& name) {
+    static std::mutex mutex;
+    static std::set<std::string>* names = new std::set<std::string>();
+    std::lock_guard<std::mutex> lock(mutex);
+    return names->insert(name).first->c_str();
+}
+
+int Profiler::enter() {
+    return local_depth++;
+}
+
+void Profiler::leave(const char* name, uint64_t begin, int depth) {
+    local_depth = depth;
+    const uint64_t end = now();
+    Registry& registry = get_registry();
+    if (begin < registry.epoch) return;
+    get_local_buffer().push({name, begin, end, uint32_t(depth)},
+            registry.capacity);
+}
+
+uint64_t Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::vector<std::vector<Profiler::Event> > Profiler::get_events() {
+    Registry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    retire_exited_buffers(registry, true);
+    std::vector<std::vector<Event> > events = registry.retired_events;
+    for (auto& buffer : registry.buffers) {
+        events.push_back(buffer->get_events(registry.epoch));
+    }
+    for (auto& thread_events : events) {
+        for (auto& event : thread_events) {
+            event.begin -= registry.epoch;
+            event.end -= registry.epoch;
+        }
+    }
+    return events;
+}
+
+size_t Profiler::get_num_dropped_events() {
+    Registry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    retire_exited_buffers(registry, true);
+    size_t num_dropped = registry.retired_dropped;
+    for (auto& buffer : registry.buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        num_dropped += buffer->dropped;
+    }
+    return num_dropped;
+}
+
+std::vector<Profiler::ZoneSummary> Profiler::get_summary() {
+    std::map<std::string, ZoneSummary> zones;
+    for (auto& events : get_events()) {
+        // Events are recorded when a zone closes.  Sorting by start time
+        // (outer zones first on ties) restores the nesting, so each event's
+        // parent is the innermost open zone that contains it.
+        std::sort(events.begin(), events.end(),
+                [](const Event& a, const Event& b) {
+                    return a.begin < b.begin ||
+                        (a.begin == b.begin && a.depth < b.depth);
+                });
+        std::vector<uint64_t> child_time(events.size(), 0);
+        std::vector<size_t> stack;
+        for (size_t i=0; i<events.size(); i++) {
+            const Event& event = events[i];
+            while (!stack.empty() && (events[stack.back()].end <= event.begin
+                        || events[stack.back()].depth >= event.depth)) {
+                stack.pop_back();
+            }
+            if (!stack.empty()) {
+                child_time[stack.back()] += event.end - event.begin;
+            }
+            stack.push_back(i);
+        }
+
+        for (size_t i=0; i<events.size(); i++) {
+            const Event& event = events[i];
+            const double duration = (event.end - event.begin) * 1e-9;
+            const double self_time = duration - child_time[i] * 1e-9;
+            auto itr = zones.find(event.name);
+            if (itr == zones.end()) {
+                zones[event.name] = {event.name, 1, duration, self_time,
+                    duration, duration};
+            } else {
+                ZoneSummary& zone = itr->second;
+                zone.count++;
+                zone.total_time += duration;
+                zone.self_time += self_time;
+                zone.min_time = std::min(zone.min_time, duration);
+                zone.max_time = std::max(zone.max_time, duration);
+            }
+        }
+    }
+
+    std::vector<ZoneSummary> summary;
+    for (const auto& entry : zones) {
+        summary.push_back(entry.second);
+    }
+    std::sort(summary.begin(), summary.end(),
+            [](const ZoneSummary& a, const ZoneSummary& b) {
+                return a.total_time > b.total_time;
+            });
+    return summary;
+}
+
+void Profiler::print_summary(std::ostream& out) {
+    const auto summary = get_summary();
+    const std::string separator(100, '-');
+    out << separator << std::endl;
+    out << "| " << std::left << std::setw(46) << "Zone" << std::right
+        << " | " << std::setw(8) << "Count"
+        << " | " << std::setw(12) << "Total (s)"
+        << " | " << std::setw(12) << "Self (s)"
+        << " | " << std::setw(6) << "Self %" << " |" << std::endl;
+    out << separator << std::endl;
+
+    double total_self_time = 0.0;
+    for (const auto& zone : summary) total_self_time += zone.self_time;
+    for (const auto& zone : summary) {
+        out << "| " << std::left << std::setw(46) << zone.name.substr(0, 46)
+            << std::right
+            << " | " << std::setw(8) << zone.count
+            << " | " << std::setw(12) << std::fixed << std::setprecision(6)
+            << zone.total_time
+            << " | " << std::setw(12) << zone.self_time
+            << " | " << std::setw(6) << std::setprecision(1)
+            << (total_self_time > 0.0 ?
+                    100.0 * zone.self_time / total_self_time : 0.0)
+            << " |" << std::endl;
+        out.unsetf(std::ios_base::floatfield);
+    }
+    out << separator << std::endl;
+
+    const size_t num_dropped = get_num_dropped_events();
+    if (num_dropped > 0) {
+        out << num_dropped << " event(s) were dropped because a per-thread "
+            << "buffer was full." << std::endl;
+    }
+}
+
+std::string Profiler::get_chrome_trace() {
+    const auto events = get_events();
+    std::stringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    for (size_t tid=0; tid<events.size(); tid++) {
+        if (!first) out << ",";
+        first = false;
+        out << std::endl << "{\"name\": \"thread_name\", \"ph\": \"M\", "
+            << "\"pid\": 1, \"tid\": " << tid << ", "
+            << "\"args\": {\"name\": \"thread " << tid << "\"}}";
+        for (const auto& event : events[tid]) {
+            out << "," << std::endl
+                << "{\"name\": \"" << escape(event.name) << "\", "
+                << "\"cat\": \"pymesh\", \"ph\": \"X\", "
+                << "\"ts\": " << event.begin * 1e-3 << ", "
+                << "\"dur\": " << (event.end - event.begin) * 1e-3 << ", "
+                << "\"pid\": 1, \"tid\": " << tid << "}";
+        }
+    }
+    out << std::endl << "]}" << std::endl;
+    return out.str();
+}
+
+void Profiler::dump_chrome_trace(const std::string& filename) {
+    std::ofstream fout(filename.c_str());
+    if (!fout.good()) {
+        throw RuntimeError("Cannot open " + filename + " for writing.");
+    }
+    fout << get_chrome_trace();
+}
@@ -0,0 +1,153 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "MemoryTracker.h"
+
+namespace PyMesh {
+
+/**
+ * Process wide scoped profiler.  Zones are opened with PYMESH_PROFILE_ZONE
+ * and closed at the end of the enclosing scope; zones nest naturally.  Each
+ * thread records completed zones into its own fixed size ring buffer.  The
+ * buffer's lock is otherwise only taken by start(), clear() and the queries
+ * below, so recording threads never wait on each other.  When a buffer is
+ * full the oldest events are overwritten.  The buffer of an exited thread is
+ * freed once its events have been collected by a query.
+ *
+ * Recording is off by default and a disabled zone costs two relaxed atomic
+ * loads, one for the profiler and one for MemoryTracker.
+ *
+ *   Profiler::start();
+ *   {
+ *       PYMESH_PROFILE_ZONE("MeshFactory::load_file");
+ *       ...
+ *   }
+ *   Profiler::stop();
+ *   Profiler::dump_chrome_trace("trace.json");
+ */
+class Profiler {
+    public:
+        struct Event {
+            const char* name;
+            uint64_t begin; // Nanoseconds since start().
+            uint64_t end;
+            uint32_t depth;
+        };
+
+        struct ZoneSummary {
+            std::string name;
+            size_t count;
+            double total_time; // Seconds, including nested zones.
+            double self_time;  // Seconds, excluding nested zones.
+            double min_time;
+            double max_time;
+        };
+
+    public:
+        /**
+         * Clear previous events and start recording.  capacity is the number
+         * of events kept per thread.
+         */
+        static void start(size_t capacity=1<<16);
+        static void stop();
+        static void clear();
+
+        static bool is_enabled() {
+            return s_enabled.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Return a pointer to a copy of name that stays valid for the
+         * lifetime of the process.  Zone names must outlive the profiler, so
+         * use this for names that are not string literals.
+         */
+        static const char* intern(const std::string& name);
+
+        /**
+         * Recorded events of each thread, oldest first.
+         */
+        static std::vector<std::vector<Event> > get_events();
+
+        /**
+         * Number of events overwritten because a ring buffer was full.
+         */
+        static size_t get_num_dropped_events();
+
+        /**
+         * Events aggregated by zone name, sorted by decreasing total time.
+         */
+        static std::vector<ZoneSummary> get_summary();
+        static void print_summary(std::ostream& out=std::cout);
+
+        /**
+         * Events in Chrome trace event format, which can be loaded in
+         * chrome://tracing or https://ui.perfetto.dev.
+         */
+        static std::string get_chrome_trace();
+        static void dump_chrome_trace(const std::string& filename);
+
+    public:
+        /**
+         * Called by ProfileZone.  Returns the depth of the new zone, or -1 if
+         * the profiler is not recording.
+         */
+        static int enter();
+        static void leave(const char* name, uint64_t begin, int depth);
+        static uint64_t now();
+
+    private:
+        static std::atomic<bool> s_enabled;
+};
+
+/**
+ * RAII zone.  Use through PYMESH_PROFILE_ZONE.  A zone is also a
+ * MemoryTracker stage.
+ */
+class ProfileZone {
+    public:
+        explicit ProfileZone(const char* name)
+            : m_name(name), m_depth(-1), m_track_memory(false) {
+            if (MemoryTracker::is_enabled()) {
+                m_track_memory = true;
+                m_memory = MemoryTracker::enter_stage();
+            }
+            if (Profiler::is_enabled()) {
+                m_depth = Profiler::enter();
+                m_begin = Profiler::now();
+            }
+        }
+
+        ~ProfileZone() {
+            if (m_depth >= 0) {
+                Profiler::leave(m_name, m_begin, m_depth);
+            }
+            if (m_track_memory) {
+                MemoryTracker::leave_stage(m_name, m_memory);
+            }
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+    private:
+        const char* m_name;
+        uint64_t m_begin;
+        int m_depth;
+        bool m_track_memory;
+        MemoryTracker::Snapshot m_memory;
+};
+
+}
+
+#define PYMESH_PROFILE_CONCAT_(a, b) a##b
+#define PYMESH_PROFILE_CONCAT(a, b) PYMESH_PROFILE_CONCAT_(a, b)
+#define PYMESH_PROFILE_ZONE(name) \
+    ::PyMesh::ProfileZone PYMESH_PROFILE_CONCAT( \
+            pymesh_profile_zone_, __LINE__)(name)
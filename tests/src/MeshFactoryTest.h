@@ -1,6 +1,8 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #pragma once
+#include <memory>
 #include <string>
+#include <tuple>
 
 #include <Mesh.h>
 #include <MeshFactory.h>
@@ -80,3 +82,186 @@ TEST_F(MeshFactoryTest, LoadData) {
     ASSERT_MESH_EQ(square  , square_cp);
 }
 
+
+TEST_F(MeshFactoryTest, LoadMatrices) {
+    MeshPtr cube_tet = load_mesh("cube.msh");
+    const MatrixFr vertices = cube_tet->get_vertex_matrix();
+    const MatrixIr voxels = cube_tet->get_voxel_matrix();
+    const MatrixIr faces(0, 3);
+
+    MeshPtr mesh = MeshFactory().load_matrices(vertices, faces, voxels).create();
+    ASSERT_MESH_EQ(cube_tet, mesh);
+    ASSERT_TRUE(vertices == mesh->get_vertex_matrix());
+    ASSERT_TRUE(voxels == mesh->get_voxel_matrix());
+}
+
+TEST_F(MeshFactoryTest, BorrowMatrices) {
+    MeshPtr cube_tri = load_mesh("cube.obj");
+    auto vertices = std::make_shared<MatrixFr>(cube_tri->get_vertex_matrix());
+    auto faces = std::make_shared<MatrixIr>(cube_tri->get_face_matrix());
+    auto voxels = std::make_shared<MatrixIr>(0, 4);
+    std::weak_ptr<MatrixFr> vertices_alive = vertices;
+
+    MeshPtr mesh = MeshFactory().borrow_matrices(
+            Eigen::Map<const MatrixFr>(vertices->data(),
+                vertices->rows(), vertices->cols()),
+            Eigen::Map<const MatrixIr>(faces->data(),
+                faces->rows(), faces->cols()),
+            Eigen::Map<const MatrixIr>(voxels->data(), 0, 4),
+            std::make_shared<std::tuple<std::shared_ptr<MatrixFr>,
+                std::shared_ptr<MatrixIr>, std::shared_ptr<MatrixIr> > >(
+                    vertices, faces, voxels)).create();
+    const Float* data = vertices->data();
+    vertices.reset();
+    faces.reset();
+    voxels.reset();
+
+    // Views alias the borrowed buffers, which the mesh keeps alive.
+    ASSERT_FALSE(vertices_alive.expired());
+    ASSERT_EQ(data, mesh->get_vertex_matrix().data());
+
+    // Const access reads the borrowed buffers, so the owner's changes stay
+    // visible.
+    const Mesh& const_mesh = *mesh;
+    ASSERT_EQ(data, const_mesh.get_vertices().data());
+    ASSERT_EQ(cube_tri->get_vertices(), const_mesh.get_vertices());
+    const_cast<Float*>(data)[0] += 0.5;
+    ASSERT_EQ(data[0], const_mesh.get_vertices()[0]);
+    const_cast<Float*>(data)[0] -= 0.5;
+    ASSERT_EQ(data, mesh->get_vertex_matrix().data());
+    ASSERT_MESH_EQ(cube_tri, mesh);
+
+    // Mutable access detaches into owned storage, but the buffers are kept
+    // alive for views handed out earlier.
+    mesh->get_vertices()[0] += 1.0;
+    ASSERT_FALSE(vertices_alive.expired());
+    ASSERT_NE(data, mesh->get_vertex_matrix().data());
+    ASSERT_EQ(cube_tri->get_vertices()[0], data[0]);
+    ASSERT_EQ(cube_tri->get_vertices()[0] + 1.0, mesh->get_vertices()[0]);
+
+    mesh.reset();
+    ASSERT_TRUE(vertices_alive.expired());
+}
+
+TEST_F(MeshFactoryTest, BorrowAttribute) {
+    MeshPtr cube_tri = load_mesh("cube.obj");
+    const size_t num_vertices = cube_tri->get_num_vertices();
+    auto values = std::make_shared<VectorF>(VectorF::LinSpaced(
+                num_vertices, 0.0, 1.0));
+
+    cube_tri->add_empty_attribute("test");
+    cube_tri->borrow_attribute("test", values->data(), values->size(), values);
+    ASSERT_EQ(values->data(), cube_tri->get_attribute_view("test").data());
+    ASSERT_EQ(*values, cube_tri->get_attribute("test"));
+    ASSERT_NE(values->data(), cube_tri->get_attribute_view("test").data());
+
+    VectorF adopted = VectorF::Ones(num_vertices);
+    const Float* data = adopted.data();
+    cube_tri->adopt_attribute("test", adopted);
+    ASSERT_EQ(data, cube_tri->get_attribute_view("test").data());
+    ASSERT_THROW(cube_tri->get_attribute_view("missing"), RuntimeError);
+}
+
+TEST_F(MeshFactoryTest, SinglePrecision) {
+    MeshPtr cube_tri = load_mesh("cube.obj");
+    MeshPtr mesh = MeshFactory()
+        .load_file(m_data_dir + "cube.obj")
+        .with_attribute("vertex_normal")
+        .with_attribute("face_area")
+        .with_single_precision()
+        .create();
+    ASSERT_TRUE(mesh->has_single_precision_vertices());
+    ASSERT_TRUE(mesh->is_single_precision_attribute("vertex_normal"));
+    ASSERT_FALSE(mesh->is_single_precision_attribute("face_area"));
+    ASSERT_EQ(cube_tri->get_num_vertices(), mesh->get_num_vertices());
+
+    const MatrixF32r expected = cube_tri->get_vertex_matrix().cast<float>();
+    ASSERT_TRUE(expected == mesh->get_vertex_matrix_f32());
+    ASSERT_TRUE(cube_tri->get_vertex(3) == mesh->get_vertex(3));
+    ASSERT_TRUE(mesh->has_single_precision_vertices());
+
+    // Read-only double precision access keeps the single precision storage.
+    const Mesh& const_mesh = *mesh;
+    const float* data = mesh->get_vertex_matrix_f32().data();
+    ASSERT_TRUE(cube_tri->get_vertex_matrix() == mesh->get_vertex_matrix());
+    ASSERT_TRUE(cube_tri->get_vertices() == const_mesh.get_vertices());
+    ASSERT_TRUE(mesh->has_single_precision_vertices());
+    ASSERT_EQ(data, mesh->get_vertex_matrix_f32().data());
+
+    const float* normal_data =
+        mesh->get_attribute_view_f32("vertex_normal").data();
+    ASSERT_EQ(cube_tri->get_num_vertices() * 3,
+            const_mesh.get_attribute("vertex_normal").size());
+    ASSERT_EQ(const_mesh.get_attribute("vertex_normal").size(),
+            mesh->get_attribute_view("vertex_normal").size());
+    ASSERT_TRUE(mesh->is_single_precision_attribute("vertex_normal"));
+    ASSERT_EQ(normal_data,
+            mesh->get_attribute_view_f32("vertex_normal").data());
+
+    // Mutable access switches back to double precision and keeps changes.
+    mesh->get_vertices()[0] += 0.25;
+    ASSERT_FALSE(mesh->has_single_precision_vertices());
+    ASSERT_FLOAT_EQ(cube_tri->get_vertices()[0] + 0.25,
+            mesh->get_vertex_matrix()(0, 0));
+
+    mesh->get_attribute("vertex_normal")[0] = 2.0;
+    ASSERT_FALSE(mesh->is_single_precision_attribute("vertex_normal"));
+    ASSERT_EQ(2.0, mesh->get_attribute_view("vertex_normal")[0]);
+    ASSERT_EQ(cube_tri->get_num_vertices() * 3,
+            mesh->get_attribute_view("vertex_normal").size());
+}
+
+TEST_F(MeshFactoryTest, BorrowSinglePrecision) {
+    MeshPtr cube_tri = load_mesh("cube.obj");
+    auto vertices = std::make_shared<MatrixF32r>(
+            cube_tri->get_vertex_matrix().cast<float>());
+    MatrixIr faces = cube_tri->get_face_matrix();
+    MatrixIr voxels(0, 4);
+
+    MeshPtr mesh = MeshFactory().borrow_matrices(
+            Eigen::Map<const MatrixF32r>(vertices->data(),
+                vertices->rows(), vertices->cols()),
+            Eigen::Map<const MatrixIr>(faces.data(),
+                faces.rows(), faces.cols()),
+            Eigen::Map<const MatrixIr>(voxels.data(), 0, 4),
+            vertices).create();
+    ASSERT_TRUE(mesh->has_single_precision_vertices());
+    ASSERT_EQ(vertices->data(), mesh->get_vertex_matrix_f32().data());
+    ASSERT_EQ(cube_tri->get_num_faces(), mesh->get_num_faces());
+
+    const size_t num_vertices = mesh->get_num_vertices();
+    VectorF32 values = VectorF32::LinSpaced(num_vertices, 0.0, 1.0);
+    const float* data = values.data();
+    mesh->add_empty_attribute("vertex_value");
+    mesh->adopt_attribute_f32("vertex_value", values);
+    ASSERT_EQ(data, mesh->get_attribute_view_f32("vertex_value").data());
+    ASSERT_FLOAT_EQ(1.0, mesh->get_attribute_view("vertex_value")[
+            num_vertices-1]);
+    ASSERT_TRUE(mesh->is_single_precision_attribute("vertex_value"));
+    ASSERT_EQ(data, mesh->get_attribute_view_f32("vertex_value").data());
+
+    VectorF updated = VectorF::Zero(num_vertices);
+    mesh->set_attribute("vertex_value", updated);
+    ASSERT_FALSE(mesh->is_single_precision_attribute("vertex_value"));
+    mesh->convert_attribute_to_single_precision("vertex_value");
+    ASSERT_TRUE(mesh->is_single_precision_attribute("vertex_value"));
+}
+
+TEST_F(MeshFactoryTest, AdoptData) {
+    MeshPtr cube_tri = load_mesh("cube.obj");
+    VectorF vertices = cube_tri->get_vertices();
+    VectorI faces = cube_tri->get_faces();
+    VectorI voxels;
+    const Float* vertex_data = vertices.data();
+    const int* face_data = faces.data();
+
+    MeshPtr mesh = MeshFactory().adopt_data(vertices, faces, voxels,
+            3, 3, 4).create();
+    ASSERT_EQ(0, vertices.size());
+    ASSERT_EQ(0, faces.size());
+    ASSERT_EQ(vertex_data, mesh->get_vertices().data());
+    ASSERT_EQ(face_data, mesh->get_faces().data());
+    ASSERT_EQ(cube_tri->get_num_vertices(), mesh->get_num_vertices());
+    ASSERT_EQ(cube_tri->get_num_faces(), mesh->get_num_faces());
+    ASSERT_TRUE(cube_tri->get_vertex_matrix() == mesh->get_vertex_matrix());
+}
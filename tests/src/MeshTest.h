@@ -296,3 +296,29 @@ TEST_F(MeshTest, ConnectivityWithIsolatedVertices) {
     ASSERT_EQ(1, mesh->get_face_adjacent_voxels(3).size());
 }
 
+
+TEST_F(MeshTest, Boundary) {
+    ASSERT_EQ(0, m_cube_tri->get_boundary_edges().rows());
+    ASSERT_EQ(4, m_square_tri->get_boundary_edges().rows());
+    ASSERT_EQ(4, m_quad->get_boundary_edges().rows());
+    ASSERT_EQ(0, m_cube_tri->get_boundary_faces().rows());
+
+    // Boundary faces of a voxel mesh are its extracted faces.
+    const MatrixIr& bd_faces = m_cube_hex->get_boundary_faces();
+    const VectorI& bd_voxels = m_cube_hex->get_boundary_face_voxels();
+    ASSERT_EQ(m_cube_hex->get_num_faces(), bd_faces.rows());
+    ASSERT_EQ(bd_faces.rows(), bd_voxels.size());
+    for (size_t i=0; i<bd_faces.rows(); i++) {
+        VectorI face = m_cube_hex->get_face(i);
+        ASSERT_EQ(face, bd_faces.row(i).transpose());
+        VectorI voxel = m_cube_hex->get_voxel(bd_voxels[i]);
+        for (size_t j=0; j<face.size(); j++) {
+            ASSERT_THAT(to_vector(voxel.size(), voxel.data()),
+                    Contains(face[j]));
+        }
+    }
+
+    // Cached results are returned by reference.
+    ASSERT_EQ(&m_cube_tet->get_boundary_faces(),
+            &m_cube_tet->get_boundary_faces());
+}
@@ -0,0 +1,102 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+#include <memory>
+#include <vector>
+
+#include <Core/EigenTypedef.h>
+#include <Core/Exception.h>
+#include <Misc/MemoryTracker.h>
+#include <Misc/Profiler.h>
+
+class MemoryTrackerTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            if (!MemoryTracker::is_supported()) {
+                ASSERT_THROW(MemoryTracker::start(), NotImplementedError);
+            }
+        }
+
+        virtual void TearDown() {
+            MemoryTracker::stop();
+        }
+
+        const MemoryTracker::StageSummary* find(
+                const std::vector<MemoryTracker::StageSummary>& summary,
+                const std::string& name) {
+            for (const auto& stage : summary) {
+                if (stage.name == name) return &stage;
+            }
+            return nullptr;
+        }
+};
+
+TEST_F(MemoryTrackerTest, Eigen) {
+    if (!MemoryTracker::is_supported()) return;
+    const size_t num_bytes = 1000 * 3 * sizeof(Float);
+    MemoryTracker::start();
+    {
+        MatrixFr vertices = MatrixFr::Zero(1000, 3);
+        MatrixFr copy = vertices;
+        ASSERT_TRUE(vertices == copy);
+    }
+    MemoryTracker::stop();
+
+    const auto usage = MemoryTracker::get_usage();
+    ASSERT_GE(usage.allocated, 2 * num_bytes);
+    ASSERT_GE(usage.peak, 2 * num_bytes);
+    ASSERT_EQ(usage.allocated, usage.freed);
+    ASSERT_EQ(0, usage.live);
+}
+
+TEST_F(MemoryTrackerTest, STL) {
+    if (!MemoryTracker::is_supported()) return;
+    MemoryTracker::start();
+    std::vector<int> values(1000);
+    auto ptr = std::make_shared<VectorF>(VectorF::Zero(100));
+    MemoryTracker::stop();
+
+    const auto usage = MemoryTracker::get_usage();
+    ASSERT_GE(usage.live, 1000 * sizeof(int) + 100 * sizeof(Float));
+    ASSERT_GE(usage.num_allocations, 3);
+}
+
+TEST_F(MemoryTrackerTest, Disabled) {
+    if (!MemoryTracker::is_supported()) return;
+    MemoryTracker::start();
+    MemoryTracker::stop();
+    VectorF values = VectorF::Zero(1000);
+    const auto usage = MemoryTracker::get_usage();
+    ASSERT_EQ(0, usage.allocated);
+    ASSERT_EQ(0, usage.num_allocations);
+}
+
+TEST_F(MemoryTrackerTest, Stages) {
+    if (!MemoryTracker::is_supported()) return;
+    const size_t num_bytes = 1 << 20;
+    MemoryTracker::start();
+    {
+        PYMESH_PROFILE_ZONE("outer");
+        VectorF small = VectorF::Zero(num_bytes / sizeof(Float) / 4);
+        for (size_t i=0; i<2; i++) {
+            PYMESH_PROFILE_ZONE("inner");
+            VectorF large = VectorF::Zero(num_bytes / sizeof(Float));
+        }
+    }
+    MemoryTracker::stop();
+
+    const auto summary = MemoryTracker::get_summary();
+    const auto* outer = find(summary, "outer");
+    const auto* inner = find(summary, "inner");
+    ASSERT_TRUE(outer != nullptr);
+    ASSERT_TRUE(inner != nullptr);
+    ASSERT_EQ(1, outer->count);
+    ASSERT_EQ(2, inner->count);
+    ASSERT_GE(inner->allocated, 2 * num_bytes);
+    ASSERT_GE(inner->peak, num_bytes);
+    ASSERT_LT(inner->peak, num_bytes + num_bytes / 8);
+    ASSERT_GE(outer->allocated, inner->allocated + num_bytes / 4);
+    ASSERT_GE(outer->peak, num_bytes + num_bytes / 4);
+    // Recording the inner stage allocates a little within outer.
+    ASSERT_LT(outer->allocated - outer->freed, 4096);
+    ASSERT_GE(MemoryTracker::get_usage().peak, outer->peak);
+}
@@ -0,0 +1,105 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+#include <algorithm>
+#include <vector>
+
+#include <Core/Exception.h>
+#include <Misc/Multiplet.h>
+#include <Misc/MultipletIndex.h>
+
+class MultipletIndexTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            for (size_t i=0; i<10; i++) {
+                m_multiplets.push_back(Quadruplet(i, i, i, i));
+            }
+        }
+
+    protected:
+        std::vector<Quadruplet> m_multiplets;
+};
+
+TEST_F(MultipletIndexTest, Empty) {
+    MultipletIndex<Quadruplet, int> empty;
+    empty.build();
+    ASSERT_TRUE(empty.empty());
+    ASSERT_FALSE(empty.contains(m_multiplets[0]));
+}
+
+TEST_F(MultipletIndexTest, UniqueKey) {
+    MultipletIndex<Quadruplet, int> index;
+    const size_t num_entries = m_multiplets.size();
+    for (size_t i=0; i<num_entries; i++) {
+        index.insert(m_multiplets[i], i);
+    }
+    index.build();
+
+    ASSERT_EQ(num_entries, index.size());
+    for (size_t i=0; i<num_entries; i++) {
+        const auto items = index.get(m_multiplets[i]);
+        ASSERT_EQ(1, items.size());
+        ASSERT_EQ(i, items[0]);
+    }
+}
+
+TEST_F(MultipletIndexTest, KeyCollision) {
+    const size_t N=5;
+    MultipletIndex<Quadruplet, int> index;
+    auto key = m_multiplets[0];
+    for (size_t i=0; i<N; i++) {
+        index.insert(key, i);
+    }
+    index.build();
+
+    // Values sharing a key keep their insertion order.
+    ASSERT_EQ(1, index.size());
+    const auto items = index.get(key);
+    ASSERT_EQ(N, items.size());
+    for (size_t i=0; i<N; i++) {
+        ASSERT_EQ(i, items[i]);
+    }
+}
+
+TEST_F(MultipletIndexTest, OrderIndependent) {
+    std::vector<Duplet> keys = {{3, -1}, {70000, 2}, {-1, 3}, {2, 70000}};
+    std::vector<int> values = {0, 1, 2, 3};
+    DupletIndex<int> index(keys, values);
+
+    ASSERT_EQ(2, index.size());
+    const auto items = index.get(Duplet(3, -1));
+    ASSERT_EQ(2, items.size());
+    ASSERT_EQ(0, items[0]);
+    ASSERT_EQ(2, items[1]);
+
+    // The first inserted key is kept as representative.
+    const size_t i = index.find(Duplet(70000, 2));
+    ASSERT_LT(i, index.size());
+    ASSERT_EQ(70000, index.get_key(i).get_ori_data()[0]);
+    ASSERT_FALSE(index.contains(Duplet(2, 3)));
+    ASSERT_THROW(index.get(Duplet(2, 3)), RuntimeError);
+}
+
+TEST_F(MultipletIndexTest, LargeIndex) {
+    const int N = 100000;
+    std::vector<Duplet> keys;
+    std::vector<int> values;
+    for (int i=0; i<N; i++) {
+        keys.emplace_back((i * 7919) % N, i % 1000);
+        values.push_back(i);
+    }
+    DupletIndex<int> index(keys, values);
+
+    size_t num_entries = 0;
+    for (size_t i=0; i<index.size(); i++) {
+        const auto items = index.get_values(i);
+        num_entries += items.size();
+        if (i > 0) {
+            ASSERT_TRUE(index.get_key(i-1) < index.get_key(i));
+        }
+    }
+    ASSERT_EQ(N, num_entries);
+    for (int i=0; i<N; i+=997) {
+        const auto items = index.get(keys[i]);
+        ASSERT_NE(items.end(), std::find(items.begin(), items.end(), i));
+    }
+}
@@ -0,0 +1,159 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Misc/Profiler.h>
+
+class ProfilerTest : public ::testing::Test {
+    protected:
+        virtual void TearDown() {
+            Profiler::stop();
+            Profiler::clear();
+        }
+
+        void busy_wait(uint64_t duration) {
+            const uint64_t begin = Profiler::now();
+            while (Profiler::now() - begin < duration) {}
+        }
+
+        const Profiler::ZoneSummary* find(
+                const std::vector<Profiler::ZoneSummary>& summary,
+                const std::string& name) {
+            for (const auto& zone : summary) {
+                if (zone.name == name) return &zone;
+            }
+            return nullptr;
+        }
+};
+
+TEST_F(ProfilerTest, Disabled) {
+    Profiler::start();
+    Profiler::stop();
+    {
+        PYMESH_PROFILE_ZONE("disabled");
+    }
+    ASSERT_TRUE(Profiler::get_summary().empty());
+}
+
+TEST_F(ProfilerTest, Nesting) {
+    Profiler::start();
+    for (size_t i=0; i<3; i++) {
+        PYMESH_PROFILE_ZONE("outer");
+        busy_wait(100000);
+        {
+            PYMESH_PROFILE_ZONE("inner");
+            busy_wait(200000);
+        }
+    }
+    Profiler::stop();
+
+    const auto summary = Profiler::get_summary();
+    ASSERT_EQ(2, summary.size());
+    const auto* outer = find(summary, "outer");
+    const auto* inner = find(summary, "inner");
+    ASSERT_TRUE(outer != nullptr);
+    ASSERT_TRUE(inner != nullptr);
+    ASSERT_EQ(3, outer->count);
+    ASSERT_EQ(3, inner->count);
+    ASSERT_GE(inner->total_time, 6e-4);
+    ASSERT_DOUBLE_EQ(inner->total_time, inner->self_time);
+    ASSERT_NEAR(outer->total_time, outer->self_time + inner->total_time,
+            1e-12);
+    ASSERT_GE(outer->self_time, 3e-4);
+    ASSERT_LE(inner->min_time, inner->max_time);
+}
+
+TEST_F(ProfilerTest, Threads) {
+    Profiler::start();
+    std::vector<std::thread> threads;
+    for (size_t i=0; i<4; i++) {
+        threads.emplace_back([]() {
+            for (size_t j=0; j<100; j++) {
+                PYMESH_PROFILE_ZONE("worker");
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    Profiler::stop();
+
+    const auto summary = Profiler::get_summary();
+    ASSERT_EQ(1, summary.size());
+    ASSERT_EQ(400, summary[0].count);
+
+    size_t num_threads_with_events = 0;
+    for (const auto& events : Profiler::get_events()) {
+        if (!events.empty()) num_threads_with_events++;
+    }
+    ASSERT_EQ(4, num_threads_with_events);
+}
+
+TEST_F(ProfilerTest, RingBuffer) {
+    Profiler::start(16);
+    for (size_t i=0; i<20; i++) {
+        PYMESH_PROFILE_ZONE("zone");
+    }
+    Profiler::stop();
+
+    ASSERT_EQ(4, Profiler::get_num_dropped_events());
+    size_t num_events = 0;
+    for (const auto& events : Profiler::get_events()) {
+        for (size_t i=1; i<events.size(); i++) {
+            ASSERT_LE(events[i-1].end, events[i].end);
+        }
+        num_events += events.size();
+    }
+    ASSERT_EQ(16, num_events);
+}
+
+TEST_F(ProfilerTest, ExitedThread) {
+    Profiler::start(16);
+    std::thread thread([]() {
+        for (size_t i=0; i<20; i++) {
+            PYMESH_PROFILE_ZONE("zone");
+        }
+    });
+    thread.join();
+    Profiler::stop();
+
+    // The first query frees the exited thread's buffer; its events must
+    // still be reported afterwards.
+    for (size_t i=0; i<2; i++) {
+        ASSERT_EQ(4, Profiler::get_num_dropped_events());
+        size_t num_events = 0;
+        for (const auto& events : Profiler::get_events()) {
+            num_events += events.size();
+        }
+        ASSERT_EQ(16, num_events);
+    }
+}
+
+TEST_F(ProfilerTest, ChromeTrace) {
+    Profiler::start();
+    {
+        PYMESH_PROFILE_ZONE(Profiler::intern("quoted \"name\""));
+    }
+    Profiler::stop();
+
+    const std::string trace = Profiler::get_chrome_trace();
+    ASSERT_NE(std::string::npos, trace.find("\"traceEvents\""));
+    ASSERT_NE(std::string::npos, trace.find("\"ph\": \"X\""));
+    ASSERT_NE(std::string::npos, trace.find("quoted \\\"name\\\""));
+}
+
+TEST_F(ProfilerTest, Restart) {
+    Profiler::start();
+    {
+        PYMESH_PROFILE_ZONE("first");
+    }
+    Profiler::start();
+    {
+        PYMESH_PROFILE_ZONE("second");
+    }
+    Profiler::stop();
+
+    const auto summary = Profiler::get_summary();
+    ASSERT_EQ(1, summary.size());
+    ASSERT_EQ("second", summary[0].name);
+}
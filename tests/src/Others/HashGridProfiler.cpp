@@ -1,7 +1,7 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #include <iostream>
 #include <Misc/HashGrid.h>
-#include <Misc/Timer.h>
+#include <Misc/Profiler.h>
 #include <Core/EigenTypedef.h>
 
 using namespace PyMesh;
@@ -24,51 +24,63 @@ MatrixFr generate_evenly_spaced(size_t resolution) {
 void test_std_hash(const MatrixFr& points, Float cell_size) {
     const size_t num_pts = points.rows();
 
-    Timer timer("Standard hash");
-    HashGrid::Ptr grid = HashGrid::create(cell_size, 3, HashGrid::STL_HASH);
-    timer.tik("creation");
-    for (size_t i=0; i<num_pts; i++) {
-        grid->insert(i, points.row(i));
+    PYMESH_PROFILE_ZONE("Standard hash");
+    HashGrid::Ptr grid;
+    {
+        PYMESH_PROFILE_ZONE("Standard hash/creation");
+        grid = HashGrid::create(cell_size, 3, HashGrid::STL_HASH);
+    }
+    {
+        PYMESH_PROFILE_ZONE("Standard hash/insertion");
+        for (size_t i=0; i<num_pts; i++) {
+            grid->insert(i, points.row(i));
+        }
     }
-    timer.tik("insertion");
-
-    timer.summary();
 }
 
 void test_dense_hash(const MatrixFr& points, Float cell_size) {
     const size_t num_pts = points.rows();
 
-    Timer timer("Google dense hash");
-    HashGrid::Ptr grid = HashGrid::create(cell_size, 3, HashGrid::DENSE_HASH);
-    timer.tik("creation");
-    for (size_t i=0; i<num_pts; i++) {
-        grid->insert(i, points.row(i));
+    PYMESH_PROFILE_ZONE("Google dense hash");
+    HashGrid::Ptr grid;
+    {
+        PYMESH_PROFILE_ZONE("Google dense hash/creation");
+        grid = HashGrid::create(cell_size, 3, HashGrid::DENSE_HASH);
+    }
+    {
+        PYMESH_PROFILE_ZONE("Google dense hash/insertion");
+        for (size_t i=0; i<num_pts; i++) {
+            grid->insert(i, points.row(i));
+        }
     }
-    timer.tik("insertion");
-
-    timer.summary();
 }
 
 void test_sparse_hash(const MatrixFr& points, Float cell_size) {
     const size_t num_pts = points.rows();
 
-    Timer timer("Google sparse hash");
-    HashGrid::Ptr grid = HashGrid::create(cell_size, 3, HashGrid::SPARSE_HASH);
-    timer.tik("creation");
-    for (size_t i=0; i<num_pts; i++) {
-        grid->insert(i, points.row(i));
+    PYMESH_PROFILE_ZONE("Google sparse hash");
+    HashGrid::Ptr grid;
+    {
+        PYMESH_PROFILE_ZONE("Google sparse hash/creation");
+        grid = HashGrid::create(cell_size, 3, HashGrid::SPARSE_HASH);
+    }
+    {
+        PYMESH_PROFILE_ZONE("Google sparse hash/insertion");
+        for (size_t i=0; i<num_pts; i++) {
+            grid->insert(i, points.row(i));
+        }
     }
-    timer.tik("insertion");
-
-    timer.summary();
 }
 
 int main() {
     const size_t resolution = 200;
     Float cell_size = 0.1;
     MatrixFr points = generate_evenly_spaced(resolution);
+    Profiler::start();
     test_std_hash(points, cell_size);
     test_sparse_hash(points, cell_size);
     test_dense_hash(points, cell_size);
+    Profiler::stop();
+    Profiler::print_summary();
     return 0;
 }
@@ -18,6 +18,9 @@
 #include "Math/ZSparseMatrixTest.h"
 #include "Math/MatrixUtilsTest.h"
 #include "Misc/MultipletMapTest.h"
+#include "Misc/MultipletIndexTest.h"
+#include "Misc/ProfilerTest.h"
+#include "Misc/MemoryTrackerTest.h"
 #include "Misc/TriBox2DTest.h"
 #include "Misc/MultipletTest.h"
 #include "Misc/HashGridTest.h"
@@ -110,4 +110,83 @@ TEST_F(SelfIntersectionTest, PointLikeTriangles) {
     ASSERT_EQ(0, result.rows());
 }
 
+TEST_F(SelfIntersectionTest, StackedTriangles) {
+    // Parallel triangles are separated by the floating point filter, only
+    // the single crossing triangle is reported against each of them.
+    const size_t num_layers = 100;
+    MatrixFr vertices(num_layers * 3 + 3, 3);
+    MatrixIr faces(num_layers + 1, 3);
+    for (size_t i=0; i<num_layers; i++) {
+        const Float z = 1e3 + i * 1e-6;
+        vertices.row(i*3  ) << 0, 0, z;
+        vertices.row(i*3+1) << 1, 0, z;
+        vertices.row(i*3+2) << 0, 1, z;
+        faces.row(i) << i*3, i*3+1, i*3+2;
+    }
+    vertices.row(num_layers*3  ) << 0.1, 0.1, 1e3 - 1;
+    vertices.row(num_layers*3+1) << 0.2, 0.1, 1e3 + 1;
+    vertices.row(num_layers*3+2) << 0.1, 0.2, 1e3 + 1;
+    faces.row(num_layers) << num_layers*3, num_layers*3+1, num_layers*3+2;
+
+    MatrixIr result = check_self_intersection(vertices, faces);
+    ASSERT_EQ(num_layers, result.rows());
+    for (size_t i=0; i<num_layers; i++) {
+        ASSERT_TRUE(result(i, 0) == int(num_layers) ||
+                result(i, 1) == int(num_layers));
+    }
+}
+
+TEST_F(SelfIntersectionTest, IncrementalUpdate) {
+    MatrixFr vertices(9, 3);
+    vertices << 0, 0, 0,
+                1, 0, 0,
+                0, 1, 0,
+                0, 0, 2,
+                1, 0, 2,
+                0, 1, 2,
+                5, 5, 5,
+                6, 5, 5,
+                5, 6, 5;
+    MatrixIr faces(3, 3);
+    faces << 0, 1, 2,
+             3, 4, 5,
+             6, 7, 8;
+
+    SelfIntersection detector(vertices, faces);
+    detector.detect_self_intersection();
+    ASSERT_EQ(0, detector.get_self_intersecting_pairs().rows());
+
+    // Tilt face 1 so that it cuts through face 0.
+    vertices.row(3) << 0.1, 0.1, -1;
+    VectorI changed_faces(1);
+    changed_faces << 1;
+    detector.update(vertices, faces, changed_faces);
+    MatrixIr result = detector.get_self_intersecting_pairs();
+    ASSERT_EQ(1, result.rows());
+    ASSERT_EQ(1, result(0, 0));
+    ASSERT_EQ(0, result(0, 1));
+
+    // Move face 2 away, the existing pair is kept.
+    vertices.row(6) << 7, 7, 7;
+    changed_faces << 2;
+    detector.update(vertices, faces, changed_faces);
+    ASSERT_EQ(1, detector.get_self_intersecting_pairs().rows());
+
+    // Remove face 0 and renumber the remaining faces.
+    MatrixIr remaining_faces(2, 3);
+    remaining_faces << 3, 4, 5,
+                       6, 7, 8;
+    VectorI source_faces(2);
+    source_faces << 1, 2;
+    detector.update(vertices, remaining_faces, source_faces, VectorI(0));
+    ASSERT_EQ(0, detector.get_self_intersecting_pairs().rows());
+
+    // Add face 0 back as a new face.
+    detector.update(vertices, faces, Vector3I(-1, 0, 1), VectorI(0));
+    result = detector.get_self_intersecting_pairs();
+    ASSERT_EQ(1, result.rows());
+    ASSERT_EQ(0, std::min(result(0, 0), result(0, 1)));
+    ASSERT_EQ(1, std::max(result(0, 0), result(0, 1)));
+}
+
 #endif
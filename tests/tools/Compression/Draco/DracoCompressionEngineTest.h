@@ -28,3 +28,44 @@ TEST_F(DracoCompressionEngineTest, Simple) {
         //ASSERT_MATRIX_EQ(faces, faces2); 
     }
 }
+
+TEST_F(DracoCompressionEngineTest, Batch) {
+    if (CompressionEngine::supports("draco")) {
+        auto engine = CompressionEngine::create("draco");
+        std::vector<Mesh::Ptr> meshes = {
+            load_mesh("ball.msh"), load_mesh("cube.obj") };
+        CompressionEngine::Options options;
+        options.position_bits = 16;
+        options.encoding_speed = 10;
+        options.decoding_speed = 10;
+        const auto data = engine->compress_batch(meshes, options);
+        ASSERT_EQ(meshes.size(), data.size());
+
+        std::vector<CompressionEngine::DataView> views;
+        for (const auto& d : data) {
+            views.emplace_back(d.data(), d.size());
+        }
+        const auto results = engine->decompress_batch(views);
+        ASSERT_EQ(meshes.size(), results.size());
+        for (size_t i=0; i<meshes.size(); i++) {
+            ASSERT_EQ(meshes[i]->get_num_vertices(),
+                    results[i]->get_num_vertices());
+            ASSERT_EQ(meshes[i]->get_num_faces(),
+                    results[i]->get_num_faces());
+        }
+
+        // Query the size first, then decode into caller buffers.
+        const auto size = engine->decompress_into(views[1].first,
+                views[1].second, nullptr, 0, nullptr, 0);
+        ASSERT_EQ(3, size.dim);
+        ASSERT_EQ(meshes[1]->get_num_vertices(), size.num_vertices);
+        ASSERT_EQ(meshes[1]->get_num_faces(), size.num_faces);
+        VectorF vertices(size.num_vertices * size.dim);
+        VectorI faces(size.num_faces * 3);
+        engine->decompress_into(views[1].first, views[1].second,
+                vertices.data(), vertices.size(),
+                faces.data(), faces.size());
+        ASSERT_TRUE(results[1]->get_vertices().isApprox(vertices));
+        ASSERT_TRUE(results[1]->get_faces() == faces);
+    }
+}
@@ -0,0 +1,149 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <string>
+
+#include <Core/Exception.h>
+
+#include <MeshUtils/AttributeTransfer.h>
+
+#include <TestBase.h>
+
+class AttributeTransferTest : public TestBase {
+    protected:
+        MeshPtr generate_grid(size_t num_cells) {
+            const size_t n = num_cells + 1;
+            MatrixFr vertices(n*n, 2);
+            MatrixIr faces(num_cells*num_cells*2, 3);
+            for (size_t i=0; i<n; i++) {
+                for (size_t j=0; j<n; j++) {
+                    vertices.row(i*n+j) << Float(j) / num_cells,
+                                           Float(i) / num_cells;
+                }
+            }
+            for (size_t i=0; i<num_cells; i++) {
+                for (size_t j=0; j<num_cells; j++) {
+                    const int v0 = i*n+j;
+                    const int v1 = v0+1;
+                    const int v2 = v0+n+1;
+                    const int v3 = v0+n;
+                    faces.row((i*num_cells+j)*2  ) << v0, v1, v2;
+                    faces.row((i*num_cells+j)*2+1) << v0, v2, v3;
+                }
+            }
+            return load_data(vertices, faces);
+        }
+};
+
+TEST_F(AttributeTransferTest, VertexBarycentric) {
+    MeshPtr source = generate_grid(3);
+    MeshPtr target = generate_grid(7);
+
+    const size_t num_source_vertices = source->get_num_vertices();
+    VectorF values(num_source_vertices * 2);
+    for (size_t i=0; i<num_source_vertices; i++) {
+        const VectorF v = source->get_vertex(i);
+        values[i*2  ] = v[0] + 2 * v[1];
+        values[i*2+1] = 1.0 - v[0];
+    }
+    source->add_attribute("value");
+    source->set_attribute("value", values);
+
+    AttributeTransfer transfer(source, target);
+    transfer.transfer_vertex_attribute("value");
+
+    ASSERT_TRUE(target->has_attribute("value"));
+    const VectorF& result = target->get_attribute("value");
+    const size_t num_target_vertices = target->get_num_vertices();
+    ASSERT_EQ(num_target_vertices * 2, result.size());
+    for (size_t i=0; i<num_target_vertices; i++) {
+        const VectorF v = target->get_vertex(i);
+        ASSERT_NEAR(v[0] + 2 * v[1], result[i*2  ], 1e-12);
+        ASSERT_NEAR(1.0 - v[0],      result[i*2+1], 1e-12);
+    }
+}
+
+TEST_F(AttributeTransferTest, SinglePrecisionTarget) {
+    MeshPtr source = generate_grid(3);
+    MeshPtr target = generate_grid(5);
+    const size_t num_target_vertices = target->get_num_vertices();
+
+    VectorF values = source->get_vertices();
+    source->add_attribute("value");
+    source->set_attribute("value", values);
+    VectorF32 old_values = VectorF32::Zero(num_target_vertices * 2);
+    target->add_empty_attribute("value");
+    target->adopt_attribute_f32("value", old_values);
+
+    AttributeTransfer transfer(source, target);
+    transfer.transfer_vertex_attribute("value");
+    ASSERT_FALSE(target->is_single_precision_attribute("value"));
+    ASSERT_NEAR(0.0, (MatrixFr(target->get_vertex_matrix()) -
+                Eigen::Map<const MatrixFr>(
+                    target->get_attribute_view("value").data(),
+                    num_target_vertices, 2)).norm(), 1e-12);
+}
+
+TEST_F(AttributeTransferTest, SelfTransfer) {
+    MeshPtr mesh = load_mesh("cube.obj");
+    MeshPtr target = load_mesh("cube.obj");
+    const size_t num_vertices = mesh->get_num_vertices();
+    const size_t num_faces = mesh->get_num_faces();
+
+    VectorF vertex_values = VectorF::Random(num_vertices);
+    VectorF face_values = VectorF::Random(num_faces * 3);
+    VectorF corner_values = VectorF::Random(num_faces * 3);
+    mesh->add_attribute("vertex_value");
+    mesh->set_attribute("vertex_value", vertex_values);
+    mesh->add_attribute("face_value");
+    mesh->set_attribute("face_value", face_values);
+    mesh->add_attribute("corner_value");
+    mesh->set_attribute("corner_value", corner_values);
+
+    AttributeTransfer transfer(mesh, target);
+    transfer.transfer_vertex_attribute("vertex_value",
+            AttributeTransfer::NEAREST);
+    transfer.transfer_face_attribute("face_value");
+    transfer.transfer_corner_attribute("corner_value");
+
+    ASSERT_FLOAT_EQ(0.0,
+            (vertex_values - target->get_attribute("vertex_value")).norm());
+    ASSERT_FLOAT_EQ(0.0,
+            (face_values - target->get_attribute("face_value")).norm());
+    ASSERT_NEAR(0.0,
+            (corner_values - target->get_attribute("corner_value")).norm(),
+            1e-12);
+}
+
+TEST_F(AttributeTransferTest, AreaWeighted) {
+    MeshPtr source = generate_grid(2);
+    const size_t num_source_faces = source->get_num_faces();
+    VectorF face_values(num_source_faces);
+    for (size_t i=0; i<num_source_faces; i++) {
+        // Left half is 0, right half is 1.
+        face_values[i] = (i / 2) % 2;
+    }
+    source->add_attribute("value");
+    source->set_attribute("value", face_values);
+
+    MatrixFr vertices(3, 2);
+    vertices << 0.0, 0.0,
+                1.0, 0.0,
+                0.0, 1.0;
+    MatrixIr faces(1, 3);
+    faces << 0, 1, 2;
+    MeshPtr target = load_data(vertices, faces);
+
+    AttributeTransfer transfer(source, target);
+    transfer.transfer_face_attribute("value", AttributeTransfer::NEAREST);
+    ASSERT_FLOAT_EQ(0.0, target->get_attribute("value")[0]);
+
+    // 1/4 of the target face lies in the right half.
+    transfer.set_area_sampling_level(4);
+    transfer.transfer_face_attribute("value",
+            AttributeTransfer::AREA_WEIGHTED);
+    ASSERT_NEAR(0.25, target->get_attribute("value")[0], 1e-2);
+
+    ASSERT_THROW(transfer.transfer_vertex_attribute("value",
+                AttributeTransfer::AREA_WEIGHTED), NotImplementedError);
+}
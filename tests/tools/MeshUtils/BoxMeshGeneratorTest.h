@@ -0,0 +1,158 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <MeshUtils/BoxMeshGenerator.h>
+#include <MeshUtils/DuplicatedVertexRemoval.h>
+#include <MeshUtils/VoxelUtils.h>
+
+#include <TestBase.h>
+
+class BoxMeshGeneratorTest : public TestBase {
+    protected:
+        void assert_no_duplicated_vertices(
+                const MatrixFr& vertices, const MatrixIr& elements) {
+            DuplicatedVertexRemoval remover(vertices, elements);
+            ASSERT_EQ(0, remover.run(1e-9));
+        }
+
+        void assert_positive_tets(const MatrixFr& vertices,
+                const MatrixIr& tets, Float total_volume) {
+            VectorF orientations =
+                VoxelUtils::get_tet_orientations(vertices, tets);
+            ASSERT_LT(0.0, orientations.minCoeff());
+
+            Float volume = 0.0;
+            const size_t num_tets = tets.rows();
+            for (size_t i=0; i<num_tets; i++) {
+                Vector3F v0 = vertices.row(tets(i,0));
+                Vector3F v1 = vertices.row(tets(i,1));
+                Vector3F v2 = vertices.row(tets(i,2));
+                Vector3F v3 = vertices.row(tets(i,3));
+                volume += (v1-v0).cross(v2-v0).dot(v3-v0) / 6.0;
+            }
+            ASSERT_NEAR(total_volume, volume, 1e-9);
+        }
+};
+
+TEST_F(BoxMeshGeneratorTest, 2D) {
+    BoxMeshGenerator generator(Vector2F(0, 0), Vector2F(1, 2),
+            Vector2I(1, 1));
+    generator.run(BoxMeshGenerator::SIMPLEX);
+    ASSERT_EQ(4, generator.get_vertices().rows());
+    ASSERT_EQ(2, generator.get_elements().rows());
+    ASSERT_EQ(3, generator.get_elements().cols());
+
+    generator.run(BoxMeshGenerator::SYMMETRIC_SIMPLEX);
+    ASSERT_EQ(5, generator.get_vertices().rows());
+    ASSERT_EQ(4, generator.get_elements().rows());
+    ASSERT_TRUE(generator.get_vertices().row(4) == Vector2F(0.5, 1.0).transpose());
+
+    generator.run(BoxMeshGenerator::CUBE);
+    ASSERT_EQ(4, generator.get_vertices().rows());
+    ASSERT_EQ(1, generator.get_elements().rows());
+    ASSERT_EQ(4, generator.get_elements().cols());
+}
+
+TEST_F(BoxMeshGeneratorTest, 2DSubdiv) {
+    BoxMeshGenerator generator(Vector2F(0, 0), Vector2F(1, 1),
+            Vector2I(2, 3));
+    generator.set_subdiv_order(1);
+    generator.run(BoxMeshGenerator::SYMMETRIC_SIMPLEX);
+    const MatrixFr& vertices = generator.get_vertices();
+    const MatrixIr& faces = generator.get_elements();
+    const VectorI& cell_index = generator.get_cell_index();
+    ASSERT_EQ(5*7 + 4*6, vertices.rows());
+    ASSERT_EQ(4*6*4, faces.rows());
+    ASSERT_EQ(faces.rows(), cell_index.size());
+    ASSERT_EQ(0, cell_index.minCoeff());
+    ASSERT_EQ(5, cell_index.maxCoeff());
+    assert_no_duplicated_vertices(vertices, faces);
+
+    Float area = 0.0;
+    for (size_t i=0; i<size_t(faces.rows()); i++) {
+        Vector2F e1 = vertices.row(faces(i,1)) - vertices.row(faces(i,0));
+        Vector2F e2 = vertices.row(faces(i,2)) - vertices.row(faces(i,0));
+        const Float a = 0.5 * (e1[0]*e2[1] - e1[1]*e2[0]);
+        ASSERT_LT(0.0, a);
+        area += a;
+    }
+    ASSERT_NEAR(1.0, area, 1e-12);
+}
+
+TEST_F(BoxMeshGeneratorTest, 3D) {
+    BoxMeshGenerator generator(Vector3F(0, 0, 0), Vector3F(1, 1, 1),
+            Vector3I(1, 1, 1));
+    generator.run(BoxMeshGenerator::SIMPLEX);
+    ASSERT_EQ(8, generator.get_vertices().rows());
+    ASSERT_EQ(6, generator.get_elements().rows());
+    assert_positive_tets(generator.get_vertices(),
+            generator.get_elements(), 1.0);
+
+    generator.run(BoxMeshGenerator::SYMMETRIC_SIMPLEX);
+    ASSERT_EQ(15, generator.get_vertices().rows());
+    ASSERT_EQ(24, generator.get_elements().rows());
+    assert_positive_tets(generator.get_vertices(),
+            generator.get_elements(), 1.0);
+
+    generator.run(BoxMeshGenerator::CUBE);
+    ASSERT_EQ(8, generator.get_vertices().rows());
+    ASSERT_EQ(1, generator.get_elements().rows());
+    ASSERT_EQ(8, generator.get_elements().cols());
+}
+
+TEST_F(BoxMeshGeneratorTest, 3DGrid) {
+    const Vector3F box_min(-1.0, 0.0, 0.5);
+    const Vector3F box_max( 1.0, 3.0, 1.5);
+    BoxMeshGenerator generator(box_min, box_max, Vector3I(2, 3, 4));
+    generator.run(BoxMeshGenerator::SYMMETRIC_SIMPLEX);
+    const MatrixFr& vertices = generator.get_vertices();
+    const MatrixIr& tets = generator.get_elements();
+    const size_t num_cells = 2*3*4;
+    ASSERT_EQ(3*4*5 + 3*3*4 + 2*4*4 + 2*3*5 + num_cells, vertices.rows());
+    ASSERT_EQ(num_cells * 24, tets.rows());
+    ASSERT_TRUE(vertices.colwise().minCoeff() == box_min.transpose());
+    ASSERT_TRUE(vertices.colwise().maxCoeff() == box_max.transpose());
+    assert_no_duplicated_vertices(vertices, tets);
+    assert_positive_tets(vertices, tets, 6.0);
+
+    const VectorI& cell_index = generator.get_cell_index();
+    for (size_t i=0; i<num_cells; i++) {
+        ASSERT_TRUE((cell_index.segment(i*24, 24).array() == int(i)).all());
+    }
+}
+
+TEST_F(BoxMeshGeneratorTest, 3DSubdiv) {
+    BoxMeshGenerator generator(Vector3F(0, 0, 0), Vector3F(1, 1, 1),
+            Vector3I(1, 1, 1));
+    generator.set_subdiv_order(1);
+    generator.run(BoxMeshGenerator::SIMPLEX);
+    ASSERT_EQ(27, generator.get_vertices().rows());
+    ASSERT_EQ(48, generator.get_elements().rows());
+    ASSERT_EQ(0, generator.get_cell_index().maxCoeff());
+    assert_positive_tets(generator.get_vertices(),
+            generator.get_elements(), 1.0);
+}
+
+TEST_F(BoxMeshGeneratorTest, HexToTet) {
+    BoxMeshGenerator generator(Vector3F(0, 0, 0), Vector3F(2, 1, 1),
+            Vector3I(2, 1, 1));
+    generator.run(BoxMeshGenerator::CUBE);
+
+    HexToTet converter(generator.get_vertices(), generator.get_elements());
+    converter.run(false);
+    ASSERT_EQ(12, converter.get_vertices().rows());
+    ASSERT_EQ(12, converter.get_voxels().rows());
+    assert_positive_tets(converter.get_vertices(),
+            converter.get_voxels(), 2.0);
+
+    converter.run(true, 1);
+    const VectorI& cell_index = converter.get_cell_index();
+    ASSERT_EQ(2*8*24, converter.get_voxels().rows());
+    ASSERT_EQ(2*8*24, cell_index.size());
+    ASSERT_EQ(0, cell_index[0]);
+    ASSERT_EQ(1, cell_index[cell_index.size()-1]);
+    assert_no_duplicated_vertices(
+            converter.get_vertices(), converter.get_voxels());
+    assert_positive_tets(converter.get_vertices(),
+            converter.get_voxels(), 2.0);
+}
@@ -65,3 +65,56 @@ TEST_F(LoopSubdivisionTest, face_index) {
     ASSERT_EQ(0, face_indices.minCoeff());
     ASSERT_EQ(faces.rows()-1, face_indices.maxCoeff());
 }
+
+TEST_F(LoopSubdivisionTest, matrix_modes) {
+    MeshPtr cube = load_mesh("cube.obj");
+    MatrixFr vertices = extract_vertices(cube);
+    MatrixIr faces = extract_faces(cube);
+
+    SubDivPtr sub = create_subdivision();
+    sub->subdivide(vertices, faces, 3);
+    const MatrixFr sub_vertices = sub->get_vertices();
+    const auto& matrices = sub->get_subdivision_matrices();
+    ASSERT_EQ(3, matrices.size());
+    MatrixFr result = vertices;
+    for (const auto& mat : matrices) {
+        result = mat * result;
+    }
+    ASSERT_NEAR(0.0, (result - sub_vertices).norm(), 1e-12);
+
+    sub->set_matrix_mode(Subdivision::COMPOSED_MATRIX);
+    sub->subdivide(vertices, faces, 3);
+    ASSERT_EQ(1, sub->get_subdivision_matrices().size());
+    result = sub->get_subdivision_matrices()[0] * vertices;
+    ASSERT_NEAR(0.0, (result - sub_vertices).norm(), 1e-12);
+
+    sub->set_matrix_mode(Subdivision::MATRIX_FREE);
+    sub->subdivide(vertices, faces, 3);
+    ASSERT_EQ(0, sub->get_subdivision_matrices().size());
+    ASSERT_NEAR(0.0, (sub->get_vertices() - sub_vertices).norm(), 1e-12);
+    ASSERT_EQ(768, sub->get_num_faces());
+}
+
+TEST_F(LoopSubdivisionTest, unreferenced_vertex) {
+    MeshPtr cube = load_mesh("cube.obj");
+    MatrixFr vertices(9, 3);
+    vertices.topRows(8) = extract_vertices(cube);
+    vertices.row(8) << 5.0, 5.0, 5.0;
+    MatrixIr faces = extract_faces(cube);
+
+    SubDivPtr sub = create_subdivision();
+    sub->subdivide(vertices, faces, 1);
+
+    MatrixFr sub_vertices = sub->get_vertices();
+    ASSERT_EQ(27, sub_vertices.rows());
+    ASSERT_EQ(48, sub->get_num_faces());
+    ASSERT_FLOAT_EQ(0.0, sub_vertices.row(8).norm());
+
+    const auto& matrices = sub->get_subdivision_matrices();
+    ASSERT_EQ(1, matrices.size());
+    ASSERT_NEAR(0.0, (matrices[0] * vertices - sub_vertices).norm(), 1e-12);
+
+    sub->set_matrix_mode(Subdivision::MATRIX_FREE);
+    sub->subdivide(vertices, faces, 1);
+    ASSERT_NEAR(0.0, (sub->get_vertices() - sub_vertices).norm(), 1e-12);
+}
@@ -119,3 +119,49 @@ TEST_F(MeshCheckerTest, hex) {
     ASSERT_TRUE(checker.is_oriented());
 }
 
+TEST_F(MeshCheckerTest, check_all) {
+    Mesh::Ptr mesh = load_mesh("cube.obj");
+    MeshChecker checker = create(mesh);
+    MeshChecker::Report report = checker.check_all();
+    ASSERT_EQ(checker.is_vertex_manifold(), report.vertex_manifold);
+    ASSERT_EQ(checker.is_edge_manifold(), report.edge_manifold);
+    ASSERT_EQ(checker.is_closed(), report.closed);
+    ASSERT_EQ(checker.is_oriented(), report.oriented);
+    ASSERT_EQ(checker.get_euler_characteristic(),
+            report.euler_characteristic);
+    ASSERT_EQ(checker.get_genus(), report.genus);
+    ASSERT_EQ(checker.get_num_boundary_loops(), report.num_boundary_loops);
+    ASSERT_EQ(checker.get_num_connected_components(),
+            report.num_connected_components);
+    ASSERT_EQ(checker.get_num_connected_surface_components(),
+            report.num_connected_surface_components);
+    ASSERT_EQ(0, report.num_connected_volume_components);
+    ASSERT_EQ(checker.get_num_isolated_vertices(),
+            report.num_isolated_vertices);
+    ASSERT_EQ(checker.get_num_duplicated_faces(),
+            report.num_duplicated_faces);
+    ASSERT_NEAR(8.0, report.signed_volume, 1e-12);
+}
+
+TEST_F(MeshCheckerTest, boundary_orientation) {
+    Mesh::Ptr mesh = load_mesh("square_2D.obj");
+    MeshChecker checker = create(mesh);
+    MatrixIr faces = MatrixUtils::reshape<MatrixIr>(
+            mesh->get_faces(), mesh->get_num_faces(),
+            mesh->get_vertex_per_face());
+    MatrixIr bd_edges = checker.get_boundary_edges();
+    const size_t num_faces = faces.rows();
+    const size_t vertex_per_face = faces.cols();
+    for (size_t i=0; i<bd_edges.rows(); i++) {
+        bool found = false;
+        for (size_t j=0; j<num_faces; j++) {
+            for (size_t k=0; k<vertex_per_face; k++) {
+                if (faces(j, k) == bd_edges(i, 0) &&
+                        faces(j, (k+1)%vertex_per_face) == bd_edges(i, 1)) {
+                    found = true;
+                }
+            }
+        }
+        ASSERT_TRUE(found);
+    }
+}
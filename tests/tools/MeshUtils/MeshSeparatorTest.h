@@ -109,3 +109,42 @@ TEST_F(MeshSeparatorTest, voxel_connected) {
     assert_sources_are_correct(elements,
             separator.get_component(1), separator.get_sources(1));
 }
+
+TEST_F(MeshSeparatorTest, labels_and_offsets) {
+    MatrixIr elements(5, 3);
+    elements << 4, 5, 6,
+                0, 1, 2,
+                5, 6, 7,
+                1, 2, 3,
+                8, 9, 10;
+
+    MeshSeparator separator(elements);
+    separator.set_connectivity_type(MeshSeparator::FACE);
+    size_t num_comps = separator.separate();
+    ASSERT_EQ(3, num_comps);
+
+    // Components are ordered by their smallest element.
+    const VectorI& labels = separator.get_labels();
+    ASSERT_EQ(5, labels.size());
+    ASSERT_EQ(0, labels[0]);
+    ASSERT_EQ(1, labels[1]);
+    ASSERT_EQ(0, labels[2]);
+    ASSERT_EQ(1, labels[3]);
+    ASSERT_EQ(2, labels[4]);
+
+    const VectorI& offsets = separator.get_component_offsets();
+    const VectorI& comp_elements = separator.get_component_elements();
+    ASSERT_EQ(num_comps+1, offsets.size());
+    ASSERT_EQ(0, offsets[0]);
+    ASSERT_EQ(5, offsets[num_comps]);
+    for (size_t i=0; i<num_comps; i++) {
+        for (int j=offsets[i]; j<offsets[i+1]; j++) {
+            ASSERT_EQ(i, labels[comp_elements[j]]);
+            if (j > offsets[i]) {
+                ASSERT_LT(comp_elements[j-1], comp_elements[j]);
+            }
+        }
+        assert_sources_are_correct(elements,
+                separator.get_component(i), separator.get_sources(i));
+    }
+}
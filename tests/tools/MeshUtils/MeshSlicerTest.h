@@ -0,0 +1,85 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <Core/Exception.h>
+
+#include <MeshUtils/MeshSlicer.h>
+
+#include <TestBase.h>
+
+class MeshSlicerTest : public TestBase {
+    protected:
+        Float compute_signed_area(const MatrixFr& vertices,
+                const VectorI& loop, const Vector3F& direction) {
+            const size_t loop_size = loop.size();
+            Vector3F area = Vector3F::Zero();
+            for (size_t i=0; i<loop_size; i++) {
+                const Vector3F p = vertices.row(loop[i]);
+                const Vector3F q = vertices.row(loop[(i+1)%loop_size]);
+                area += p.cross(q);
+            }
+            return 0.5 * area.dot(direction.normalized());
+        }
+};
+
+TEST_F(MeshSlicerTest, Cube) {
+    MeshPtr mesh = load_mesh("cube.obj");
+    MeshSlicer slicer(extract_vertices(mesh), extract_faces(mesh));
+
+    Vector3F direction(0.0, 0.0, 1.0);
+    Vector3F intercepts(-0.5, 0.0, 0.5);
+    slicer.slice(direction, intercepts);
+    ASSERT_EQ(3, slicer.get_num_slices());
+
+    for (size_t i=0; i<3; i++) {
+        const MatrixFr vertices = slicer.get_slice_vertices(i);
+        const MatrixIr edges = slicer.get_slice_edges(i);
+        const auto loops = slicer.get_slice_loops(i);
+        ASSERT_EQ(edges.rows(), vertices.rows());
+        ASSERT_EQ(1, loops.size());
+        ASSERT_EQ(vertices.rows(), loops[0].size());
+        ASSERT_NEAR(intercepts[i], vertices.col(2).minCoeff(), 1e-12);
+        ASSERT_NEAR(intercepts[i], vertices.col(2).maxCoeff(), 1e-12);
+        ASSERT_NEAR(4.0, compute_signed_area(vertices, loops[0], direction),
+                1e-12);
+    }
+}
+
+TEST_F(MeshSlicerTest, DiagonalCube) {
+    MeshPtr mesh = load_mesh("cube.obj");
+    MeshSlicer slicer(extract_vertices(mesh), extract_faces(mesh));
+
+    // Middle slice is a regular hexagon with side length sqrt(2).
+    Vector3F direction(1.0, 1.0, 1.0);
+    VectorF intercepts(1);
+    intercepts << 0.0;
+    slicer.slice(direction, intercepts);
+
+    const MatrixFr vertices = slicer.get_slice_vertices(0);
+    const auto loops = slicer.get_slice_loops(0);
+    ASSERT_EQ(1, loops.size());
+    ASSERT_NEAR(3.0 * sqrt(3.0),
+            compute_signed_area(vertices, loops[0], direction), 1e-12);
+
+    // Reversing the direction flips the loop orientation.
+    slicer.slice(-direction, intercepts);
+    const MatrixFr flipped_vertices = slicer.get_slice_vertices(0);
+    const auto flipped_loops = slicer.get_slice_loops(0);
+    ASSERT_EQ(1, flipped_loops.size());
+    ASSERT_NEAR(3.0 * sqrt(3.0), compute_signed_area(
+                flipped_vertices, flipped_loops[0], -direction), 1e-12);
+}
+
+TEST_F(MeshSlicerTest, Empty) {
+    MeshPtr mesh = load_mesh("cube.obj");
+    MeshSlicer slicer(extract_vertices(mesh), extract_faces(mesh));
+
+    Vector3F direction(0.0, 1.0, 0.0);
+    Vector2F intercepts(-2.0, 2.0);
+    slicer.slice(direction, intercepts);
+    ASSERT_EQ(2, slicer.get_num_slices());
+    ASSERT_EQ(0, slicer.get_slice_edges(0).rows());
+    ASSERT_EQ(0, slicer.get_slice_loops(1).size());
+
+    ASSERT_THROW(slicer.slice(direction, Vector2F(1.0, 0.0)), RuntimeError);
+}
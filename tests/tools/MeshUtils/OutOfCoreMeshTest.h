@@ -0,0 +1,255 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include <MeshUtils/OutOfCoreMesh.h>
+
+#include <TestBase.h>
+
+class OutOfCoreMeshTest : public TestBase {
+    protected:
+        virtual void SetUp() {
+            TestBase::SetUp();
+            m_tmp_dir = "/tmp";
+        }
+
+        Float get_brick_size(const MatrixFr& vertices, size_t num_bricks) {
+            const Float extent = (vertices.colwise().maxCoeff() -
+                    vertices.colwise().minCoeff()).maxCoeff();
+            return extent / num_bricks * 1.0001;
+        }
+
+        /**
+         * Faces as sorted lists of corner coordinates, so meshes can be
+         * compared regardless of vertex order.
+         */
+        std::vector<std::vector<Float> > get_face_coordinates(
+                const MatrixFr& vertices, const MatrixIr& faces) {
+            std::vector<std::vector<Float> > result;
+            const size_t num_faces = faces.rows();
+            for (size_t i=0; i<num_faces; i++) {
+                std::vector<Float> coords;
+                for (size_t j=0; j<3; j++) {
+                    for (size_t k=0; k<3; k++) {
+                        coords.push_back(vertices(faces(i,j), k));
+                    }
+                }
+                result.push_back(coords);
+            }
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+        void assert_same_faces(const MatrixFr& vertices, const MatrixIr& faces,
+                const MatrixFr& vertices2, const MatrixIr& faces2) {
+            ASSERT_EQ(faces.rows(), faces2.rows());
+            ASSERT_TRUE(get_face_coordinates(vertices, faces) ==
+                    get_face_coordinates(vertices2, faces2));
+        }
+
+        std::string m_tmp_dir;
+};
+
+TEST_F(OutOfCoreMeshTest, RoundTrip) {
+    MeshPtr mesh = load_mesh("ball.msh");
+    const MatrixFr vertices = mesh->get_vertex_matrix();
+    const MatrixIr faces = mesh->get_face_matrix();
+
+    OutOfCoreMesh store(m_tmp_dir, get_brick_size(vertices, 3), 0.1);
+    store.import_mesh(vertices, faces);
+    ASSERT_EQ(27, store.get_num_bricks());
+    ASSERT_EQ(vertices.rows(), store.get_num_vertices());
+    ASSERT_EQ(faces.rows(), store.get_num_faces());
+
+    MatrixFr out_vertices;
+    MatrixIr out_faces;
+    store.export_mesh(out_vertices, out_faces);
+    ASSERT_EQ(vertices.rows(), out_vertices.rows());
+    assert_same_faces(vertices, faces, out_vertices, out_faces);
+}
+
+TEST_F(OutOfCoreMeshTest, Halo) {
+    MeshPtr mesh = load_mesh("ball.msh");
+    const MatrixFr vertices = mesh->get_vertex_matrix();
+    const MatrixIr faces = mesh->get_face_matrix();
+
+    OutOfCoreMesh store(m_tmp_dir, get_brick_size(vertices, 2), 0.0);
+    store.import_mesh(vertices, faces);
+
+    size_t num_owned_faces = 0;
+    for (auto index : store.get_active_bricks()) {
+        auto brick = store.load_brick(index);
+        const size_t num_faces = brick.faces.rows();
+        const size_t num_owned = brick.face_owned.sum();
+        num_owned_faces += num_owned;
+
+        // The sphere crosses every seam, so each brick sees neighbour faces
+        // sharing its vertices.
+        ASSERT_LT(num_owned, num_faces);
+        ASSERT_LT(0, brick.vertex_on_seam.sum());
+        for (size_t i=0; i<num_faces; i++) {
+            for (size_t j=0; j<3; j++) {
+                const size_t v = brick.faces(i,j);
+                ASSERT_TRUE(brick.vertices.row(v) ==
+                        vertices.row(brick.vertex_ids[v]));
+                if (!brick.face_owned[i]) {
+                    ASSERT_EQ(1, brick.vertex_on_seam[v]);
+                }
+            }
+        }
+    }
+    ASSERT_EQ(faces.rows(), num_owned_faces);
+}
+
+TEST_F(OutOfCoreMeshTest, Process) {
+    MeshPtr mesh = load_mesh("ball.msh");
+    const MatrixFr vertices = mesh->get_vertex_matrix();
+    const MatrixIr faces = mesh->get_face_matrix();
+
+    OutOfCoreMesh store(m_tmp_dir, get_brick_size(vertices, 3), 0.1);
+    store.import_mesh(vertices, faces);
+
+    // Split every owned face at its centroid.
+    std::atomic<size_t> num_bricks(0);
+    store.process([&](OutOfCoreMesh::Brick& brick) {
+        const size_t num_vertices = brick.vertices.rows();
+        const size_t num_faces = brick.faces.rows();
+        const size_t num_owned = brick.face_owned.sum();
+        MatrixFr new_vertices(num_vertices + num_owned, 3);
+        MatrixIr new_faces(num_faces + 2 * num_owned, 3);
+        new_vertices.topRows(num_vertices) = brick.vertices;
+        new_faces.topRows(num_faces) = brick.faces;
+        VectorI face_owned = VectorI::Ones(new_faces.rows());
+        face_owned.segment(0, num_faces) = brick.face_owned;
+
+        size_t v_count = num_vertices;
+        size_t f_count = num_faces;
+        for (size_t i=0; i<num_faces; i++) {
+            if (!brick.face_owned[i]) continue;
+            const Vector3I f = brick.faces.row(i);
+            new_vertices.row(v_count) = (brick.vertices.row(f[0]) +
+                    brick.vertices.row(f[1]) + brick.vertices.row(f[2])) / 3.0;
+            new_faces.row(i) << f[0], f[1], v_count;
+            new_faces.row(f_count++) << f[1], f[2], v_count;
+            new_faces.row(f_count++) << f[2], f[0], v_count;
+            brick.vertex_ids.push_back(OutOfCoreMesh::INVALID);
+            brick.vertex_bricks.push_back(brick.index);
+            v_count++;
+        }
+        brick.vertices = new_vertices;
+        brick.faces = new_faces;
+        brick.face_owned = face_owned;
+        num_bricks++;
+    });
+
+    ASSERT_EQ(store.get_active_bricks().size(), num_bricks);
+    ASSERT_EQ(vertices.rows() + faces.rows(), store.get_num_vertices());
+    ASSERT_EQ(faces.rows() * 3, store.get_num_faces());
+
+    MatrixFr out_vertices;
+    MatrixIr out_faces;
+    store.export_mesh(out_vertices, out_faces);
+    ASSERT_EQ(faces.rows() * 3, out_faces.rows());
+    ASSERT_LT(out_faces.maxCoeff(), out_vertices.rows());
+}
+
+TEST_F(OutOfCoreMeshTest, RemoveDuplicatedVertices) {
+    MeshPtr mesh = load_mesh("ball.msh");
+    const MatrixFr vertices = mesh->get_vertex_matrix();
+    const MatrixIr faces = mesh->get_face_matrix();
+    const size_t num_faces = faces.rows();
+
+    // Triangle soup: every face has its own copy of its vertices.
+    MatrixFr soup_vertices(num_faces * 3, 3);
+    MatrixIr soup_faces(num_faces, 3);
+    for (size_t i=0; i<num_faces; i++) {
+        for (size_t j=0; j<3; j++) {
+            soup_vertices.row(i*3+j) = vertices.row(faces(i,j));
+            soup_faces(i,j) = i*3+j;
+        }
+    }
+    std::vector<int> used(faces.data(), faces.data() + faces.size());
+    std::sort(used.begin(), used.end());
+    const size_t num_used = std::unique(used.begin(), used.end()) - used.begin();
+
+    OutOfCoreMesh store(m_tmp_dir, get_brick_size(vertices, 3), 0.1);
+    store.import_mesh(soup_vertices, soup_faces);
+    const size_t num_removed = store.remove_duplicated_vertices(1e-6);
+    ASSERT_EQ(num_faces * 3 - num_used, num_removed);
+    ASSERT_EQ(num_used, store.get_num_vertices());
+
+    MatrixFr out_vertices;
+    MatrixIr out_faces;
+    store.export_mesh(out_vertices, out_faces);
+    ASSERT_EQ(num_used, out_vertices.rows());
+    assert_same_faces(vertices, faces, out_vertices, out_faces);
+
+    // Faces stored before their vertices were merged are forwarded.
+    ASSERT_EQ(0, store.remove_duplicated_vertices(1e-6));
+    ASSERT_EQ(num_used, store.get_num_vertices());
+}
+
+TEST_F(OutOfCoreMeshTest, LongFaces) {
+    MatrixFr vertices(5, 3);
+    vertices << 0.5, 0.0, 0.0,
+                4.5, 0.5, 0.0,
+                4.5, 0.0, 0.0,
+                4.5, 0.5, 0.0,
+                2.5, 1.0, 0.0;
+    MatrixIr faces(3, 3);
+    faces << 0, 2, 3,
+             2, 1, 4,
+             4, 0, 2;
+
+    // Faces span up to 5 bricks along X.  Vertex 3 duplicates vertex 1 and
+    // is only used by a face of a brick that is not a neighbour.
+    OutOfCoreMesh store(m_tmp_dir, get_brick_size(vertices, 5), 0.1);
+    store.import_mesh(vertices, faces);
+    ASSERT_EQ(5, store.get_grid_size()[0]);
+
+    auto brick = store.load_brick(4);
+    const auto itr = std::find(brick.vertex_ids.begin(),
+            brick.vertex_ids.end(), 3);
+    ASSERT_TRUE(itr != brick.vertex_ids.end());
+    ASSERT_EQ(1, brick.vertex_on_seam[itr - brick.vertex_ids.begin()]);
+
+    ASSERT_EQ(1, store.remove_duplicated_vertices(1e-6));
+    ASSERT_EQ(4, store.get_num_vertices());
+    MatrixFr out_vertices;
+    MatrixIr out_faces;
+    store.export_mesh(out_vertices, out_faces);
+    assert_same_faces(vertices, faces, out_vertices, out_faces);
+
+    ASSERT_EQ(0, store.remove_duplicated_vertices(1e-6));
+    store.export_mesh(out_vertices, out_faces);
+    assert_same_faces(vertices, faces, out_vertices, out_faces);
+}
+
+TEST_F(OutOfCoreMeshTest, PLY) {
+    MeshPtr mesh = load_mesh("ball.msh");
+    const MatrixFr vertices = mesh->get_vertex_matrix();
+    const MatrixIr faces = mesh->get_face_matrix();
+    const std::string filename = m_tmp_dir + "/out_of_core_ball.ply";
+
+    {
+        OutOfCoreMesh store(m_tmp_dir, get_brick_size(vertices, 2), 0.1);
+        store.import_mesh(vertices, faces);
+        store.export_ply(filename);
+    }
+
+    OutOfCoreMesh store2(m_tmp_dir, get_brick_size(vertices, 3), 0.1);
+    store2.import_ply(filename);
+    ASSERT_EQ(vertices.rows(), store2.get_num_vertices());
+    ASSERT_EQ(faces.rows(), store2.get_num_faces());
+
+    MatrixFr out_vertices;
+    MatrixIr out_faces;
+    store2.export_mesh(out_vertices, out_faces);
+    assert_same_faces(vertices, faces, out_vertices, out_faces);
+    std::remove(filename.c_str());
+}
@@ -180,3 +180,28 @@ TEST_F(PointLocatorTest, ZeroElements) {
     MeshPtr mesh = load_mesh("tet.obj");
     ASSERT_THROW(PointLocator locator(mesh), RuntimeError);
 }
+
+TEST_F(PointLocatorTest, Batched) {
+    MeshPtr mesh = load_mesh("cube.msh");
+    PointLocator locator(mesh);
+    MatrixF pts = uniform_samples(23, -1*VectorF::Ones(3), VectorF::Ones(3));
+    size_t num_pts = pts.rows();
+
+    locator.locate(pts);
+    VectorI elem_indices = locator.get_enclosing_voxels();
+    MatrixF barycentric_coords = locator.get_barycentric_coords();
+
+    ASSERT_EQ(num_pts, elem_indices.size());
+    ASSERT_EQ(num_pts, barycentric_coords.rows());
+    ASSERT_LE(-1e-6, barycentric_coords.minCoeff());
+
+    for (size_t i=0; i<num_pts; i++) {
+        VectorI voxel = mesh->get_voxel(elem_indices[i]);
+        check_barycentric_coord(mesh, pts.row(i), voxel,
+                barycentric_coords.row(i));
+    }
+
+    // Results must not depend on scheduling.
+    locator.locate(pts);
+    ASSERT_EQ(0, (locator.get_enclosing_voxels() - elem_indices).cwiseAbs().maxCoeff());
+}
@@ -1,8 +1,10 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #include <gtest/gtest.h>
+#include "AttributeTransferTest.h"
 #include "AttributeUtilsTest.h"
 #include "BoundaryEdgesTest.h"
 #include "BoundaryFacesTest.h"
+#include "BoxMeshGeneratorTest.h"
 #include "DuplicatedVertexRemovalTest.h"
 #include "DegeneratedTriangleRemovalTest.h"
 #include "EdgeSplitterTest.h"
@@ -15,8 +17,10 @@
 #include "MeshCheckerTest.h"
 #include "MeshCutterTest.h"
 #include "MeshSeparatorTest.h"
+#include "MeshSlicerTest.h"
 #include "ManifoldCheckTest.h"
 #include "ObtuseTriangleRemovalTest.h"
+#include "OutOfCoreMeshTest.h"
 #include "PointLocatorTest.h"
 #include "ShortEdgeRemovalTest.h"
 #include "SimpleSubdivisionTest.h"
@@ -0,0 +1,99 @@
+/* This file is part of PyMesh. Copyright (c) 2019 by Qingnan Zhou */
+#pragma once
+
+#include <TestBase.h>
+#include <Predicates/BatchPredicates.h>
+extern "C" {
+#include <Predicates/predicates.h>
+}
+
+class BatchPredicatesTest : public TestBase {
+    protected:
+        /**
+         * Points on a coarse grid, so that many queries are degenerate and
+         * have to go through the exact path.
+         */
+        MatrixFr generate_points(size_t num_points, size_t dim) {
+            MatrixFr points(num_points, dim);
+            for (size_t i=0; i<num_points; i++) {
+                for (size_t j=0; j<dim; j++) {
+                    points(i, j) = ((i * (7 + 4*j) + j) % 5) * 0.1;
+                }
+            }
+            return points;
+        }
+
+        MatrixIr generate_queries(size_t num_queries, size_t arity,
+                size_t num_points) {
+            MatrixIr queries(num_queries, arity);
+            for (size_t i=0; i<num_queries; i++) {
+                for (size_t j=0; j<arity; j++) {
+                    queries(i, j) = (i * 31 + j * 17 + i/7) % num_points;
+                }
+            }
+            return queries;
+        }
+};
+
+TEST_F(BatchPredicatesTest, orient2d) {
+    MatrixFr points = generate_points(50, 2);
+    MatrixIr queries = generate_queries(1000, 3, 50);
+    VectorF results = BatchPredicates::orient2d(points, queries);
+    ASSERT_EQ(1000, results.size());
+    for (size_t i=0; i<1000; i++) {
+        Vector2F p0 = points.row(queries(i, 0));
+        Vector2F p1 = points.row(queries(i, 1));
+        Vector2F p2 = points.row(queries(i, 2));
+        ASSERT_EQ(orient2d(p0.data(), p1.data(), p2.data()), results[i]);
+    }
+}
+
+TEST_F(BatchPredicatesTest, orient3d) {
+    MatrixFr points = generate_points(50, 3);
+    MatrixIr queries = generate_queries(1000, 4, 50);
+    VectorF results = BatchPredicates::orient3d(points, queries);
+    for (size_t i=0; i<1000; i++) {
+        Vector3F p0 = points.row(queries(i, 0));
+        Vector3F p1 = points.row(queries(i, 1));
+        Vector3F p2 = points.row(queries(i, 2));
+        Vector3F p3 = points.row(queries(i, 3));
+        ASSERT_EQ(orient3d(p0.data(), p1.data(), p2.data(), p3.data()),
+                results[i]);
+    }
+}
+
+TEST_F(BatchPredicatesTest, incircle) {
+    MatrixFr points = generate_points(50, 2);
+    MatrixIr queries = generate_queries(1000, 4, 50);
+    VectorF results = BatchPredicates::incircle(points, queries);
+    for (size_t i=0; i<1000; i++) {
+        Vector2F p0 = points.row(queries(i, 0));
+        Vector2F p1 = points.row(queries(i, 1));
+        Vector2F p2 = points.row(queries(i, 2));
+        Vector2F p3 = points.row(queries(i, 3));
+        ASSERT_EQ(incircle(p0.data(), p1.data(), p2.data(), p3.data()),
+                results[i]);
+    }
+}
+
+TEST_F(BatchPredicatesTest, insphere) {
+    MatrixFr points = generate_points(50, 3);
+    MatrixIr queries = generate_queries(1000, 5, 50);
+    VectorF results = BatchPredicates::insphere(points, queries);
+    for (size_t i=0; i<1000; i++) {
+        Vector3F p0 = points.row(queries(i, 0));
+        Vector3F p1 = points.row(queries(i, 1));
+        Vector3F p2 = points.row(queries(i, 2));
+        Vector3F p3 = points.row(queries(i, 3));
+        Vector3F p4 = points.row(queries(i, 4));
+        ASSERT_EQ(insphere(p0.data(), p1.data(), p2.data(), p3.data(),
+                    p4.data()), results[i]);
+    }
+}
+
+TEST_F(BatchPredicatesTest, invalid_input) {
+    MatrixFr points = generate_points(10, 3);
+    MatrixIr queries = generate_queries(10, 3, 10);
+    ASSERT_THROW(BatchPredicates::orient2d(points, queries), RuntimeError);
+    ASSERT_THROW(BatchPredicates::orient3d(points, queries), RuntimeError);
+}
@@ -0,0 +1,184 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <Wires/Inflator/PeriodicBoundaryRemesher.h>
+#include <WireTest.h>
+
+class PeriodicBoundaryRemesherTest : public WireTest {
+    protected:
+        typedef std::array<Float, 2> Point2;
+
+        /**
+         * Surface of the unit cube with a square tunnel [0.4, 0.6]^2 drilled
+         * along X from the max side down to x = 1 - depth.  depth = 0 gives
+         * the plain cube, depth = 1 a tunnel through the whole cell, and
+         * anything in between a blind pocket seen only by the max X side.
+         */
+        void generate_cube(Float depth) {
+            const Float lo = 0.4, hi = 0.6;
+            std::vector<Vector3F> vertices;
+            std::vector<Vector3I> faces;
+            auto add_vertex = [&](Float x, Float y, Float z) {
+                vertices.emplace_back(x, y, z);
+                return int(vertices.size() - 1);
+            };
+            auto add_quad = [&](int v0, int v1, int v2, int v3) {
+                faces.emplace_back(v0, v1, v2);
+                faces.emplace_back(v0, v2, v3);
+            };
+
+            // Cube corners, indexed by x + 2y + 4z.
+            for (size_t i=0; i<8; i++) {
+                add_vertex(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+            }
+            add_quad(0, 4, 5, 1); // y = 0
+            add_quad(2, 3, 7, 6); // y = 1
+            add_quad(0, 1, 3, 2); // z = 0
+            add_quad(4, 6, 7, 5); // z = 1
+
+            // Corners of the X sides and of the tunnel, in matching (y, z)
+            // order around the axis.
+            const std::array<Point2, 4> inner = {{
+                {{lo, lo}}, {{hi, lo}}, {{hi, hi}}, {{lo, hi}} }};
+            const std::array<int, 4> min_corners = {{0, 2, 6, 4}};
+            const std::array<int, 4> max_corners = {{1, 3, 7, 5}};
+
+            if (depth <= 0.0) {
+                add_quad(min_corners[0], min_corners[3],
+                        min_corners[2], min_corners[1]);
+                add_quad(max_corners[0], max_corners[1],
+                        max_corners[2], max_corners[3]);
+            } else {
+                const Float bottom = 1.0 - depth;
+                std::array<int, 4> top_ring, bottom_ring;
+                for (size_t i=0; i<4; i++) {
+                    top_ring[i] = add_vertex(1.0, inner[i][0], inner[i][1]);
+                    bottom_ring[i] = add_vertex(
+                            bottom, inner[i][0], inner[i][1]);
+                }
+                for (size_t i=0; i<4; i++) {
+                    const size_t j = (i+1) % 4;
+                    add_quad(max_corners[i], max_corners[j],
+                            top_ring[j], top_ring[i]);
+                    add_quad(top_ring[i], top_ring[j],
+                            bottom_ring[j], bottom_ring[i]);
+                }
+                if (depth < 1.0) {
+                    add_quad(min_corners[0], min_corners[3],
+                            min_corners[2], min_corners[1]);
+                    add_quad(bottom_ring[0], bottom_ring[3],
+                            bottom_ring[2], bottom_ring[1]);
+                } else {
+                    for (size_t i=0; i<4; i++) {
+                        const size_t j = (i+1) % 4;
+                        add_quad(min_corners[j], min_corners[i],
+                                bottom_ring[i], bottom_ring[j]);
+                    }
+                }
+            }
+
+            m_vertices.resize(vertices.size(), 3);
+            for (size_t i=0; i<vertices.size(); i++) {
+                m_vertices.row(i) = vertices[i].transpose();
+            }
+            m_faces.resize(faces.size(), 3);
+            for (size_t i=0; i<faces.size(); i++) {
+                m_faces.row(i) = faces[i].transpose();
+            }
+        }
+
+        void remesh(Float ave_edge_len) {
+            PeriodicBoundaryRemesher remesher(m_vertices, m_faces,
+                    Vector3F::Zero(), Vector3F::Ones());
+            remesher.remesh(ave_edge_len);
+            m_vertices = remesher.get_vertices();
+            m_faces = remesher.get_faces();
+            ASSERT_LT(0, m_vertices.rows());
+            ASSERT_LT(0, m_faces.rows());
+        }
+
+        std::vector<Point2> get_side_vertices(size_t axis, Float value) {
+            const size_t coord_1 = (axis + 1) % 3;
+            const size_t coord_2 = (axis + 2) % 3;
+            std::vector<Point2> result;
+            const size_t num_vertices = m_vertices.rows();
+            for (size_t i=0; i<num_vertices; i++) {
+                if (fabs(m_vertices(i, axis) - value) > 1e-9) continue;
+                result.push_back({{
+                        m_vertices(i, coord_1), m_vertices(i, coord_2)}});
+            }
+            return result;
+        }
+
+        Float get_side_area(size_t axis, Float value) {
+            Float area = 0.0;
+            const size_t num_faces = m_faces.rows();
+            for (size_t i=0; i<num_faces; i++) {
+                const Vector3F v0 = m_vertices.row(m_faces(i, 0));
+                const Vector3F v1 = m_vertices.row(m_faces(i, 1));
+                const Vector3F v2 = m_vertices.row(m_faces(i, 2));
+                if (fabs(v0[axis] - value) > 1e-9 ||
+                        fabs(v1[axis] - value) > 1e-9 ||
+                        fabs(v2[axis] - value) > 1e-9) continue;
+                area += 0.5 * (v1 - v0).cross(v2 - v0).norm();
+            }
+            return area;
+        }
+
+        void ASSERT_PERIODIC() {
+            for (size_t axis=0; axis<3; axis++) {
+                const auto min_side = get_side_vertices(axis, 0.0);
+                const auto max_side = get_side_vertices(axis, 1.0);
+                ASSERT_LT(0, min_side.size());
+                ASSERT_EQ(min_side.size(), max_side.size());
+                for (const auto& p : min_side) {
+                    auto match = std::find_if(max_side.begin(), max_side.end(),
+                            [&](const Point2& q) {
+                                return fabs(p[0] - q[0]) < 1e-9 &&
+                                    fabs(p[1] - q[1]) < 1e-9;
+                            });
+                    ASSERT_TRUE(match != max_side.end());
+                }
+                ASSERT_NEAR(get_side_area(axis, 0.0),
+                        get_side_area(axis, 1.0), 1e-9);
+            }
+        }
+
+    protected:
+        MatrixFr m_vertices;
+        MatrixIr m_faces;
+};
+
+TEST_F(PeriodicBoundaryRemesherTest, cube) {
+    generate_cube(0.0);
+    remesh(0.25);
+    ASSERT_PERIODIC();
+    for (size_t axis=0; axis<3; axis++) {
+        ASSERT_NEAR(1.0, get_side_area(axis, 0.0), 1e-9);
+    }
+    // Remeshed sides are refined to the target edge length.
+    ASSERT_LT(12, m_faces.rows());
+}
+
+TEST_F(PeriodicBoundaryRemesherTest, unmatched_loop) {
+    // The hole in the max X side has no counterpart on the min side.
+    generate_cube(0.5);
+    PeriodicBoundaryRemesher remesher(m_vertices, m_faces,
+            Vector3F::Zero(), Vector3F::Ones());
+    ASSERT_THROW(remesher.remesh(0.25), RuntimeError);
+}
+
+TEST_F(PeriodicBoundaryRemesherTest, multi_loop_side) {
+    // Both X sides are bounded by an outer loop and a hole loop.
+    generate_cube(1.0);
+    remesh(0.25);
+    ASSERT_PERIODIC();
+    ASSERT_NEAR(1.0 - 0.2 * 0.2, get_side_area(0, 0.0), 1e-9);
+    ASSERT_NEAR(1.0, get_side_area(1, 0.0), 1e-9);
+    ASSERT_NEAR(1.0, get_side_area(2, 0.0), 1e-9);
+}
@@ -9,6 +9,8 @@
 #include <WireTest.h>
 #include <IO/MeshWriter.h>
 
+#include "MeshValidation.h"
+
 class SimpleInflatorTest : public WireTest {
 };
 
@@ -143,3 +145,38 @@ TEST_F(SimpleInflatorTest, 3D_tile_with_parameters) {
     save_mesh("tmp.obj", vertices, faces);
 }
 
+TEST_F(SimpleInflatorTest, 3D_partitioned) {
+    WireNetwork::Ptr network = load_wire_shared("cube.wire");
+    network->compute_connectivity();
+
+    Vector3F bbox_min(0.0, 0.0, 0.0);
+    Vector3F bbox_max(30.0, 30.0, 30.0);
+    Vector3I repetitions(3, 3, 3);
+    AABBTiler tiler(network, bbox_min, bbox_max, repetitions);
+    WireNetwork::Ptr tiled_network = tiler.tile();
+    tiled_network->compute_connectivity();
+    const size_t num_edges = tiled_network->get_num_edges();
+
+    SimpleInflator inflator(tiled_network);
+    inflator.set_thickness_type(SimpleInflator::PER_EDGE);
+    inflator.set_thickness(VectorF::Ones(num_edges) * 0.5);
+    inflator.with_partitions(2);
+    inflator.inflate();
+
+    MatrixFr vertices = inflator.get_vertices();
+    MatrixIr faces = inflator.get_faces();
+    VectorI  face_sources = inflator.get_face_sources();
+
+    ASSERT_LT(0, vertices.rows());
+    ASSERT_EQ(3, vertices.cols());
+    ASSERT_LT(0, faces.rows());
+    ASSERT_EQ(faces.rows(), face_sources.size());
+    ASSERT_TRUE(MeshValidation::is_water_tight(vertices, faces));
+    ASSERT_TRUE(MeshValidation::is_manifold(vertices, faces));
+
+    // Partitioned inflation must be deterministic.
+    inflator.inflate();
+    ASSERT_FLOAT_EQ(0.0,
+            (inflator.get_vertices() - vertices).cwiseAbs().maxCoeff());
+    ASSERT_EQ(0, (inflator.get_faces() - faces).cwiseAbs().maxCoeff());
+}
@@ -0,0 +1,42 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <Wires/Inflator/TiledInflator.h>
+#include <Wires/Parameters/ParameterManager.h>
+#include <WireTest.h>
+
+#include "MeshValidation.h"
+
+class TiledInflatorTest : public WireTest {
+};
+
+TEST_F(TiledInflatorTest, cube) {
+    WireNetwork::Ptr network = load_wire_shared("cube.wire");
+    network->compute_connectivity();
+    ParameterManager::Ptr manager =
+        ParameterManager::create_empty_manager(network, 0.5);
+
+    TiledInflator inflator(network, manager);
+    inflator.inflate_with_guide_bbox(
+            Vector3F(0.0, 0.0, 0.0), Vector3F(10.0, 10.0, 10.0),
+            Vector3I(2, 2, 2));
+    ASSERT_EQ(1, inflator.get_num_cached_cells());
+
+    MatrixFr vertices = inflator.get_vertices();
+    MatrixIr faces = inflator.get_faces();
+    VectorI  face_sources = inflator.get_face_sources();
+
+    ASSERT_LT(0, vertices.rows());
+    ASSERT_EQ(3, vertices.cols());
+    ASSERT_LT(0, faces.rows());
+    ASSERT_EQ(faces.rows(), face_sources.size());
+    ASSERT_TRUE(MeshValidation::is_water_tight(vertices, faces));
+    ASSERT_TRUE(MeshValidation::is_manifold(vertices, faces));
+
+    // Same cell size and parameters hit the cache.
+    inflator.inflate_with_guide_bbox(
+            Vector3F(0.0, 0.0, 0.0), Vector3F(15.0, 15.0, 15.0),
+            Vector3I(3, 3, 3));
+    ASSERT_EQ(1, inflator.get_num_cached_cells());
+    ASSERT_LT(vertices.rows(), inflator.get_vertices().rows());
+}
@@ -1,6 +1,8 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #pragma once
 
+#include <cstdio>
+
 #include <WireTest.h>
 #include <Wires/Parameters/ParameterManager.h>
 #include <Wires/Parameters/ParameterCommon.h>
@@ -385,6 +387,7 @@ TEST_F(ParameterManagerTest, save_dofs) {
     ParameterManager::Ptr manager2 =
         ParameterManager::create_from_dof_file(wire_network, 0.5, "tmp.dof");
     VectorF dofs2 = manager2->get_dofs();
+    std::remove("tmp.dof");
 
     ASSERT_EQ(dofs.size(), dofs2.size());
     ASSERT_NEAR(0.0, (dofs-dofs2).norm(), 1e-12);
@@ -61,3 +61,39 @@ TEST_F(VertexThicknessParameterDerivativeTest, brick5) {
 
     ASSERT_NE(0.0, flattened_derivative.norm());
 }
+
+TEST_F(VertexThicknessParameterDerivativeTest, sparse) {
+    WireNetwork::Ptr wire_network = load_wire_shared("brick5.wire");
+    wire_network->scale(Vector3F::Ones() * 2.5);
+    VectorI roi_0(4), roi_1(4);
+    roi_0 << 0, 1, 2, 3;
+    roi_1 << 4, 5, 6, 7;
+
+    ParameterManager::Ptr manager = ParameterManager::create_empty_manager(wire_network);
+    manager->set_thickness_type(ParameterCommon::VERTEX);
+    manager->add_thickness_parameter(roi_0, "", 1.5);
+    manager->add_thickness_parameter(roi_1, "", 1.5);
+
+    Mesh::Ptr mesh = inflate(wire_network, manager);
+    ASSERT_EQ(3, mesh->get_dim());
+
+    auto dense_velocity = manager->compute_shape_velocity(mesh);
+    auto sparse_velocity = manager->compute_sparse_shape_velocity(mesh);
+    ASSERT_EQ(2, dense_velocity.size());
+    ASSERT_EQ(2, sparse_velocity.size());
+
+    const size_t num_vertices = mesh->get_num_vertices();
+    for (size_t i=0; i<2; i++) {
+        const VectorI& indices = sparse_velocity[i].first;
+        const MatrixFr& values = sparse_velocity[i].second;
+        ASSERT_EQ(indices.size(), values.rows());
+        ASSERT_LT(indices.size(), num_vertices);
+
+        MatrixFr velocity = MatrixFr::Zero(num_vertices, 3);
+        for (size_t j=0; j<indices.size(); j++) {
+            velocity.row(indices[j]) = values.row(j);
+        }
+        ASSERT_NE(0.0, velocity.norm());
+        ASSERT_FLOAT_EQ(0.0, (velocity - dense_velocity[i]).norm());
+    }
+}
@@ -217,6 +217,23 @@ TEST_F(AABBTilerTest, square) {
     ASSERT_BBOX_SIZE(*tiled_network, bbox_max - bbox_min);
 }
 
+TEST_F(AABBTilerTest, cube_grid) {
+    WireNetwork::Ptr wire_network = load_wire_shared("cube.wire");
+    VectorF bbox_min = VectorF::Zero(3);
+    VectorF bbox_max = Vector3F(8, 3, 5);
+    VectorI repetitions = Vector3I(8, 6, 5);
+
+    AABBTiler tiler(wire_network, bbox_min, bbox_max, repetitions);
+    WireNetwork::Ptr tiled_network = tiler.tile();
+
+    ASSERT_EQ(9*7*6, tiled_network->get_num_vertices());
+    ASSERT_EQ(8*7*6 + 9*6*6 + 9*7*5, tiled_network->get_num_edges());
+    ASSERT_VALID_EDGES(*tiled_network);
+    ASSERT_BBOX_SIZE(*tiled_network, bbox_max - bbox_min);
+    ASSERT_EQ(9*7*6,
+            tiled_network->get_attribute("vertex_offset").rows());
+}
+
 TEST_F(AABBTilerTest, VertexAttributes) {
     run_periodic_vertex_index_check("square.wire");
     run_periodic_vertex_index_check("cube.wire");
@@ -236,3 +253,17 @@ TEST_F(AABBTilerTest, EdgeAttributes) {
 TEST_F(AABBTilerTest, postive_min_angles) {
     run_min_angle_check("truncated_octahedron_s1.wire");
 }
+
+TEST_F(AABBTilerTest, unit_wire_unchanged) {
+    WireNetwork::Ptr wire_network = load_wire_shared("brick5.wire");
+    const MatrixFr vertices = wire_network->get_vertices();
+    VectorF bbox_min = VectorF::Ones(3);
+    VectorF bbox_max = VectorF::Ones(3)*5;
+    VectorI repetitions = VectorI::Ones(3);
+
+    AABBTiler tiler(wire_network, bbox_min, bbox_max, repetitions);
+    WireNetwork::Ptr tiled_network = tiler.tile();
+
+    ASSERT_BBOX_SIZE(*tiled_network, bbox_max - bbox_min);
+    ASSERT_MATRIX_EQ(vertices, wire_network->get_vertices());
+}
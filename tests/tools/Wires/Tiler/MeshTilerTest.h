@@ -120,3 +120,63 @@ TEST_F(MeshTilerTest, hex_s1) {
     ASSERT_FLOAT_EQ( 0.2, offset.maxCoeff());
     ASSERT_FLOAT_EQ(-0.2, offset.minCoeff());
 }
+
+TEST_F(MeshTilerTest, duplicated_corners) {
+    VectorF vertices(12);
+    vertices << 0, 0, 1, 0, 2, 0, 2, 1, 1, 1, 0, 1;
+    VectorI faces(8);
+    faces << 0, 1, 4, 5, 1, 2, 3, 4;
+    VectorF split_vertices(16);
+    split_vertices << 0, 0, 1, 0, 1, 1, 0, 1, 1, 0, 2, 0, 2, 1, 1, 1;
+    VectorI split_faces(8);
+    split_faces << 0, 1, 2, 3, 4, 5, 6, 7;
+    VectorI voxels(0);
+
+    MeshPtr mesh = MeshFactory().load_data(
+            vertices, faces, voxels, 2, 4, 0).create();
+    MeshPtr split_mesh = MeshFactory().load_data(
+            split_vertices, split_faces, voxels, 2, 4, 0).create();
+
+    MeshTiler tiler(load_wire_shared("box.wire"), mesh);
+    WireNetwork::Ptr tiled_network = tiler.tile();
+    MeshTiler split_tiler(load_wire_shared("box.wire"), split_mesh);
+    WireNetwork::Ptr split_network = split_tiler.tile();
+
+    ASSERT_EQ(tiled_network->get_num_vertices(),
+            split_network->get_num_vertices());
+    ASSERT_EQ(tiled_network->get_num_edges(),
+            split_network->get_num_edges());
+    ASSERT_FLOAT_EQ(0.0, (tiled_network->get_vertices() -
+                split_network->get_vertices()).norm());
+    ASSERT_FLOAT_EQ(0.0, (tiled_network->get_edges() -
+                split_network->get_edges()).norm());
+}
+
+TEST_F(MeshTilerTest, hanging_node) {
+    // A loop through the corners and edge midpoints of the unit box.
+    MatrixFr wire_vertices(8, 2);
+    wire_vertices << 0.0, 0.0, 0.5, 0.0, 1.0, 0.0, 1.0, 0.5,
+                     1.0, 1.0, 0.5, 1.0, 0.0, 1.0, 0.0, 0.5;
+    MatrixIr wire_edges(8, 2);
+    for (size_t i=0; i<8; i++) {
+        wire_edges.row(i) << i, (i+1) % 8;
+    }
+
+    // The right side of the coarse cell has a hanging node at (2, 1).
+    VectorF vertices(16);
+    vertices << 0, 0, 2, 0, 2, 2, 0, 2, 3, 0, 3, 1, 2, 1, 3, 2;
+    VectorI faces(12);
+    faces << 0, 1, 2, 3, 1, 4, 5, 6, 6, 5, 7, 2;
+    VectorI voxels(0);
+
+    MeshPtr mesh = MeshFactory().load_data(
+            vertices, faces, voxels, 2, 4, 0).create();
+    MeshTiler tiler(WireNetwork::create_raw(wire_vertices, wire_edges), mesh);
+    WireNetwork::Ptr tiled_network = tiler.tile();
+
+    // 8 coarse vertices and 13 fine ones, 3 of which are shared.  Only
+    // the fine cells share edges.
+    ASSERT_EQ(18, tiled_network->get_num_vertices());
+    ASSERT_EQ(22, tiled_network->get_num_edges());
+    ASSERT_BBOX_MATCHES(tiled_network->get_vertices(), mesh->get_vertices());
+}
@@ -1,13 +1,17 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #pragma once
 
-#include <string>
+#include <cstddef>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <string>
 
 #include <Core/EigenTypedef.h>
 #include <Core/Exception.h>
 #include <Misc/Environment.h>
 
+#include <Wires/WireNetwork/WireBinaryFormat.h>
 #include <Wires/WireNetwork/WireNetwork.h>
 
 #include <WireTest.h>
@@ -139,6 +143,82 @@ TEST_F(WireNetworkTest, IO) {
     ASSERT_FLOAT_EQ(0.0, (network.get_edges() - tmp_network.get_edges()).norm());
 }
 
+TEST_F(WireNetworkTest, BinaryIO) {
+    std::string wire_file = m_data_dir + "cube.wire";
+    WireNetwork network(wire_file);
+    const size_t num_vertices = network.get_num_vertices();
+    network.add_attribute("test", true, false);
+    network.set_attribute("test", MatrixFr::Ones(num_vertices, 2));
+    network.add_attribute("edge_length", false);
+
+    std::string tmp_wire_file = "tmp.wireb";
+    network.write_to_file(tmp_wire_file);
+    WireNetwork tmp_network(tmp_wire_file);
+
+    ASSERT_EQ(network.get_dim(), tmp_network.get_dim());
+    ASSERT_MATRIX_EQ(network.get_vertices(), tmp_network.get_vertices());
+    ASSERT_MATRIX_EQ(network.get_edges(), tmp_network.get_edges());
+    ASSERT_TRUE(tmp_network.is_vertex_attribute("test"));
+    ASSERT_MATRIX_EQ(network.get_attribute("test"),
+            tmp_network.get_attribute("test"));
+    ASSERT_FALSE(tmp_network.is_vertex_attribute("edge_length"));
+    ASSERT_MATRIX_EQ(network.get_attribute("edge_length"),
+            tmp_network.get_attribute("edge_length"));
+}
+
+TEST_F(WireNetworkTest, TruncatedBinary) {
+    std::string wire_file = m_data_dir + "cube.wire";
+    WireNetwork network(wire_file);
+    std::string tmp_wire_file = "tmp.wireb";
+    network.write_to_file(tmp_wire_file);
+
+    std::ifstream fin(tmp_wire_file.c_str(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(fin)),
+            std::istreambuf_iterator<char>());
+    fin.close();
+    std::ofstream fout(tmp_wire_file.c_str(), std::ios::binary);
+    fout.write(content.data(), content.size() / 2);
+    fout.close();
+
+    ASSERT_THROW(WireNetwork tmp_network(tmp_wire_file), IOError);
+}
+
+TEST_F(WireNetworkTest, InvalidBinaryDim) {
+    std::string wire_file = m_data_dir + "cube.wire";
+    WireNetwork network(wire_file);
+    std::string tmp_wire_file = "tmp.wireb";
+    network.write_to_file(tmp_wire_file);
+
+    std::fstream fio(tmp_wire_file.c_str(),
+            std::ios::binary | std::ios::in | std::ios::out);
+    const uint32_t dim = 0;
+    fio.seekp(offsetof(WireBinaryFormat::Header, dim));
+    fio.write(reinterpret_cast<const char*>(&dim), sizeof(dim));
+    fio.close();
+
+    ASSERT_THROW(WireNetwork tmp_network(tmp_wire_file), IOError);
+}
+
+TEST_F(WireNetworkTest, LargeText) {
+    // Large enough to be parsed in several chunks.
+    const size_t num_vertices = 100000;
+    MatrixFr vertices(num_vertices, 3);
+    MatrixIr edges(num_vertices-1, 2);
+    for (size_t i=0; i<num_vertices; i++) {
+        vertices.row(i) << i * 0.5, i % 7, -0.25 * (i % 13);
+        if (i > 0) edges.row(i-1) << i-1, i;
+    }
+    auto wires = WireNetwork::create_raw(vertices, edges);
+
+    std::string tmp_wire_file = "tmp_large.wire";
+    wires->write_to_file(tmp_wire_file);
+    WireNetwork tmp_network(tmp_wire_file);
+
+    ASSERT_EQ(3, tmp_network.get_dim());
+    ASSERT_MATRIX_EQ(vertices, tmp_network.get_vertices());
+    ASSERT_MATRIX_EQ(edges, tmp_network.get_edges());
+}
+
 TEST_F(WireNetworkTest, DropZeroDim) {
     MatrixFr vertices(4, 3);
     vertices << 0.0, 0.0, 0.0,
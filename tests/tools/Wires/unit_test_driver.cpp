@@ -14,8 +14,10 @@
 #include "Inflator/GeometryCorrectionTableTest.h"
 #include "Inflator/PeriodicInflator2DTest.h"
 #include "Inflator/PeriodicInflator3DTest.h"
+#include "Inflator/PeriodicBoundaryRemesherTest.h"
 #include "Inflator/PhantomMeshGeneratorTest.h"
 #include "Inflator/SimpleInflatorTest.h"
+#include "Inflator/TiledInflatorTest.h"
 #include "Inflator/WireProfileTest.h"
 #include "Interfaces/PeriodicExplorationTest.h"
 #include "Misc/BilinearInterpolationTest.h"
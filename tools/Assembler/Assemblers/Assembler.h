@@ -5,6 +5,7 @@
 
 #include <Assembler/FESetting/FESetting.h>
 #include <Math/ZSparseMatrix.h>
+#include <Misc/Profiler.h>
 
 namespace PyMesh {
 
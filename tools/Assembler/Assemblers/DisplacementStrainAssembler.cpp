@@ -13,6 +13,7 @@
 using namespace PyMesh;
 
 ZSparseMatrix DisplacementStrainAssembler::assemble(FESettingPtr setting) {
+    PYMESH_PROFILE_ZONE("DisplacementStrainAssembler::assemble");
     typedef FESetting::FEMeshPtr FEMeshPtr;
     typedef FESetting::FEBasisPtr FEBasisPtr;
 
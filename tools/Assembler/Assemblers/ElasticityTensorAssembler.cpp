@@ -7,6 +7,7 @@
 using namespace PyMesh;
 
 ZSparseMatrix ElasticityTensorAssembler::assemble(FESettingPtr setting) {
+    PYMESH_PROFILE_ZONE("ElasticityTensorAssembler::assemble");
     typedef FESetting::FEMeshPtr FEMeshPtr;
     typedef FESetting::MaterialPtr MaterialPtr;
 
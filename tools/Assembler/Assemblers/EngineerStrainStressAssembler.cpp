@@ -7,6 +7,7 @@
 using namespace PyMesh;
 
 ZSparseMatrix EngineerStrainStressAssembler::assemble(FESettingPtr setting) {
+    PYMESH_PROFILE_ZONE("EngineerStrainStressAssembler::assemble");
     typedef FESetting::FEMeshPtr FEMeshPtr;
     typedef FESetting::MaterialPtr MaterialPtr;
 
@@ -12,6 +12,7 @@
 using namespace PyMesh;
 
 ZSparseMatrix GradientAssembler::assemble(FESettingPtr setting) {
+    PYMESH_PROFILE_ZONE("GradientAssembler::assemble");
     auto mesh = setting->get_mesh();
     auto basis = setting->get_basis();
 
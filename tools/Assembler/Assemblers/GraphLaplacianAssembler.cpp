@@ -6,6 +6,7 @@
 using namespace PyMesh;
 
 ZSparseMatrix GraphLaplacianAssembler::assemble(FESettingPtr setting) {
+    PYMESH_PROFILE_ZONE("GraphLaplacianAssembler::assemble");
     typedef FESetting::FEMeshPtr FEMeshPtr;
     typedef Eigen::Triplet<Float, size_t> T;
     std::vector<T> entries;
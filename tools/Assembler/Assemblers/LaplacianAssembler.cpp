@@ -14,6 +14,7 @@
 using namespace PyMesh;
 
 ZSparseMatrix LaplacianAssembler::assemble(FESettingPtr setting) {
+    PYMESH_PROFILE_ZONE("LaplacianAssembler::assemble");
     typedef FESetting::FEMeshPtr FEMeshPtr;
     typedef FESetting::FEBasisPtr FEBasisPtr;
     typedef FESetting::MaterialPtr MaterialPtr;
@@ -11,6 +11,7 @@
 using namespace PyMesh;
 
 ZSparseMatrix LumpedMassAssembler::assemble(FESettingPtr setting) {
+    PYMESH_PROFILE_ZONE("LumpedMassAssembler::assemble");
     typedef FESetting::FEMeshPtr FEMeshPtr;
     typedef FESetting::MaterialPtr MaterialPtr;
 
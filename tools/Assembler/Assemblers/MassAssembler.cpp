@@ -11,6 +11,7 @@
 using namespace PyMesh;
 
 ZSparseMatrix MassAssembler::assemble(FESettingPtr setting) {
+    PYMESH_PROFILE_ZONE("MassAssembler::assemble");
     typedef FESetting::FEMeshPtr FEMeshPtr;
     typedef FESetting::FEBasisPtr FEBasisPtr;
     typedef FESetting::MaterialPtr MaterialPtr;
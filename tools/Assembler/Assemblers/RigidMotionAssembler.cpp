@@ -4,6 +4,7 @@
 using namespace PyMesh;
 
 ZSparseMatrix RigidMotionAssembler::assemble(FESettingPtr setting) {
+    PYMESH_PROFILE_ZONE("RigidMotionAssembler::assemble");
     typedef FESetting::FEMeshPtr FEMeshPtr;
 
     typedef Eigen::Triplet<Float> T;
@@ -14,6 +14,7 @@
 using namespace PyMesh;
 
 ZSparseMatrix StiffnessAssembler::assemble(FESettingPtr setting) {
+    PYMESH_PROFILE_ZONE("StiffnessAssembler::assemble");
     typedef FESetting::FEMeshPtr FEMeshPtr;
     typedef FESetting::FEBasisPtr FEBasisPtr;
     typedef FESetting::MaterialPtr MaterialPtr;
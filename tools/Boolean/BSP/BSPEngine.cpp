@@ -95,6 +95,7 @@ namespace BSPEngineHelper {
 using namespace BSPEngineHelper;
 
 void BSPEngine::compute_union() {
+    PYMESH_PROFILE_ZONE("BSPEngine::compute_union");
     BSPPtr mesh1 = raw_to_bsp(m_vertices_1, m_faces_1);
     BSPPtr mesh2 = raw_to_bsp(m_vertices_2, m_faces_2);
     BSPPtr result = BSPlib::Bsp::Union(mesh1, mesh2);
@@ -102,6 +103,7 @@ void BSPEngine::compute_union() {
 }
 
 void BSPEngine::compute_intersection() {
+    PYMESH_PROFILE_ZONE("BSPEngine::compute_intersection");
     BSPPtr mesh1 = raw_to_bsp(m_vertices_1, m_faces_1);
     BSPPtr mesh2 = raw_to_bsp(m_vertices_2, m_faces_2);
     BSPPtr result = BSPlib::Bsp::Intersection(mesh1, mesh2);
@@ -109,6 +111,7 @@ void BSPEngine::compute_intersection() {
 }
 
 void BSPEngine::compute_difference() {
+    PYMESH_PROFILE_ZONE("BSPEngine::compute_difference");
     BSPPtr mesh1 = raw_to_bsp(m_vertices_1, m_faces_1);
     BSPPtr mesh2 = raw_to_bsp(m_vertices_2, m_faces_2);
     BSPPtr result = BSPlib::Bsp::Difference(mesh1, mesh2);
@@ -116,6 +119,7 @@ void BSPEngine::compute_difference() {
 }
 
 void BSPEngine::compute_symmetric_difference() {
+    PYMESH_PROFILE_ZONE("BSPEngine::compute_symmetric_difference");
     BSPPtr mesh1 = raw_to_bsp(m_vertices_1, m_faces_1);
     BSPPtr mesh2 = raw_to_bsp(m_vertices_2, m_faces_2);
     BSPPtr left = BSPlib::Bsp::Difference(mesh1, mesh2);
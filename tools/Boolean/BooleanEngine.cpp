@@ -103,7 +103,7 @@ bool BooleanEngine::supports(const std::string& engine_name) {
     return false;
 }
 
-std::vector<std::string> get_available_engines() {
+std::vector<std::string> BooleanEngine::get_available_engines() {
     std::vector<std::string> engine_names;
 #if WITH_IGL_AND_CGAL
     engine_names.push_back("igl");
@@ -130,6 +130,7 @@ std::vector<std::string> get_available_engines() {
 }
 
 void BooleanEngine::clean_up() {
+    PYMESH_PROFILE_ZONE("BooleanEngine::clean_up");
     remove_duplicated_vertices();
     remove_short_edges();
     remove_isolated_vertices();
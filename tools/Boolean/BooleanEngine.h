@@ -7,6 +7,7 @@
 
 #include <Core/EigenTypedef.h>
 #include <Core/Exception.h>
+#include <Misc/Profiler.h>
 
 namespace PyMesh {
 
@@ -22,12 +23,14 @@ class BooleanEngine {
 
     public:
         void set_mesh_1(const MatrixFr& vertices, const MatrixIr& faces) {
+            PYMESH_PROFILE_ZONE("BooleanEngine::set_mesh_1");
             m_vertices_1 = vertices;
             m_faces_1 = faces;
             convert_mesh_to_native_format(MeshSelection::FIRST);
         }
 
         void set_mesh_2(const MatrixFr& vertices, const MatrixIr& faces) {
+            PYMESH_PROFILE_ZONE("BooleanEngine::set_mesh_2");
             m_vertices_2 = vertices;
             m_faces_2 = faces;
             convert_mesh_to_native_format(MeshSelection::SECOND);
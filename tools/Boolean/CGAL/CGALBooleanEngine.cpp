@@ -29,6 +29,7 @@ namespace CGALBooleanEngineHelper {
 using namespace CGALBooleanEngineHelper;
 
 void CGALBooleanEngine::compute_union() {
+    PYMESH_PROFILE_ZONE("CGALBooleanEngine::compute_union");
     Nef_polyhedron nef_result = m_nef_mesh_1 + m_nef_mesh_2;
     if (nef_result.is_simple()) {
         Polyhedron result;
@@ -40,6 +41,7 @@ void CGALBooleanEngine::compute_union() {
 }
 
 void CGALBooleanEngine::compute_intersection() {
+    PYMESH_PROFILE_ZONE("CGALBooleanEngine::compute_intersection");
     Nef_polyhedron nef_result = m_nef_mesh_1 * m_nef_mesh_2;
     if (nef_result.is_simple()) {
         Polyhedron result;
@@ -51,6 +53,7 @@ void CGALBooleanEngine::compute_intersection() {
 }
 
 void CGALBooleanEngine::compute_difference() {
+    PYMESH_PROFILE_ZONE("CGALBooleanEngine::compute_difference");
     Nef_polyhedron nef_result = m_nef_mesh_1 - m_nef_mesh_2;
     if (nef_result.is_simple()) {
         Polyhedron result;
@@ -62,6 +65,7 @@ void CGALBooleanEngine::compute_difference() {
 }
 
 void CGALBooleanEngine::compute_symmetric_difference() {
+    PYMESH_PROFILE_ZONE("CGALBooleanEngine::compute_symmetric_difference");
     Nef_polyhedron nef_result = m_nef_mesh_1 ^ m_nef_mesh_2;
     if (nef_result.is_simple()) {
         Polyhedron result;
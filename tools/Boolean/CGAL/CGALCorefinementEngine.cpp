@@ -77,6 +77,7 @@ namespace CGALCorefinementEngineHelper {
 using namespace CGALCorefinementEngineHelper;
 
 void CGALCorefinementEngine::compute_union() {
+    PYMESH_PROFILE_ZONE("CGALCorefinementEngine::compute_union");
     using namespace CGAL::Polygon_mesh_processing;
     SurfaceMesh out;
 
@@ -87,6 +88,7 @@ void CGALCorefinementEngine::compute_union() {
 }
 
 void CGALCorefinementEngine::compute_intersection() {
+    PYMESH_PROFILE_ZONE("CGALCorefinementEngine::compute_intersection");
     using namespace CGAL::Polygon_mesh_processing;
     SurfaceMesh out;
 
@@ -97,6 +99,7 @@ void CGALCorefinementEngine::compute_intersection() {
 }
 
 void CGALCorefinementEngine::compute_difference() {
+    PYMESH_PROFILE_ZONE("CGALCorefinementEngine::compute_difference");
     using namespace CGAL::Polygon_mesh_processing;
     SurfaceMesh out;
 
@@ -107,6 +110,7 @@ void CGALCorefinementEngine::compute_difference() {
 }
 
 void CGALCorefinementEngine::compute_symmetric_difference() {
+    PYMESH_PROFILE_ZONE("CGALCorefinementEngine::compute_symmetric_difference");
     using namespace CGAL::Polygon_mesh_processing;
     SurfaceMesh diff12, diff21, out;
 
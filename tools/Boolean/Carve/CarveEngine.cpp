@@ -86,6 +86,7 @@ namespace CarveEngineHelper {
 using namespace CarveEngineHelper;
 
 void CarveEngine::compute_union() {
+    PYMESH_PROFILE_ZONE("CarveEngine::compute_union");
     CarveMeshPtr mesh_1 = m_mesh_1;
     CarveMeshPtr mesh_2 = m_mesh_2;
     carve::csg::CSG csg;
@@ -99,6 +100,7 @@ void CarveEngine::compute_union() {
 }
 
 void CarveEngine::compute_intersection() {
+    PYMESH_PROFILE_ZONE("CarveEngine::compute_intersection");
     CarveMeshPtr mesh_1 = m_mesh_1;
     CarveMeshPtr mesh_2 = m_mesh_2;
     carve::csg::CSG csg;
@@ -112,6 +114,7 @@ void CarveEngine::compute_intersection() {
 }
 
 void CarveEngine::compute_difference() {
+    PYMESH_PROFILE_ZONE("CarveEngine::compute_difference");
     CarveMeshPtr mesh_1 = m_mesh_1;
     CarveMeshPtr mesh_2 = m_mesh_2;
     carve::csg::CSG csg;
@@ -125,6 +128,7 @@ void CarveEngine::compute_difference() {
 }
 
 void CarveEngine::compute_symmetric_difference() {
+    PYMESH_PROFILE_ZONE("CarveEngine::compute_symmetric_difference");
     CarveMeshPtr mesh_1 = m_mesh_1;
     CarveMeshPtr mesh_2 = m_mesh_2;
     carve::csg::CSG csg;
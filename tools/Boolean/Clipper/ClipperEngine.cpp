@@ -119,18 +119,22 @@ namespace ClipperEngineHelper {
 using namespace ClipperEngineHelper;
 
 void ClipperEngine::compute_union() {
+    PYMESH_PROFILE_ZONE("ClipperEngine::compute_union");
     clip(ClipperLib::ctUnion);
 }
 
 void ClipperEngine::compute_intersection() {
+    PYMESH_PROFILE_ZONE("ClipperEngine::compute_intersection");
     clip(ClipperLib::ctIntersection);
 }
 
 void ClipperEngine::compute_difference() {
+    PYMESH_PROFILE_ZONE("ClipperEngine::compute_difference");
     clip(ClipperLib::ctDifference);
 }
 
 void ClipperEngine::compute_symmetric_difference() {
+    PYMESH_PROFILE_ZONE("ClipperEngine::compute_symmetric_difference");
     clip(ClipperLib::ctXor);
 }
 
@@ -78,6 +78,7 @@ CorkEngine::~CorkEngine() {
 }
 
 void CorkEngine::compute_union() {
+    PYMESH_PROFILE_ZONE("CorkEngine::compute_union");
     CorkTriMesh result;
 
     computeUnion(m_mesh_1, m_mesh_2, &result);
@@ -88,6 +89,7 @@ void CorkEngine::compute_union() {
 }
 
 void CorkEngine::compute_intersection() {
+    PYMESH_PROFILE_ZONE("CorkEngine::compute_intersection");
     CorkTriMesh result;
 
     computeIntersection(m_mesh_1, m_mesh_2, &result);
@@ -98,6 +100,7 @@ void CorkEngine::compute_intersection() {
 }
 
 void CorkEngine::compute_difference() {
+    PYMESH_PROFILE_ZONE("CorkEngine::compute_difference");
     CorkTriMesh result;
 
     computeDifference(m_mesh_1, m_mesh_2, &result);
@@ -108,6 +111,7 @@ void CorkEngine::compute_difference() {
 }
 
 void CorkEngine::compute_symmetric_difference() {
+    PYMESH_PROFILE_ZONE("CorkEngine::compute_symmetric_difference");
     CorkTriMesh result;
 
     computeSymmetricDifference(m_mesh_1, m_mesh_2, &result);
@@ -23,6 +23,7 @@ using namespace IGLEngineHelper;
 #endif
 
 void IGLEngine::compute_union() {
+    PYMESH_PROFILE_ZONE("IGLEngine::compute_union");
     igl::copyleft::cgal::mesh_boolean(
             m_vertices_1, m_faces_1, 
             m_vertices_2, m_faces_2,
@@ -32,6 +33,7 @@ void IGLEngine::compute_union() {
 }
 
 void IGLEngine::compute_intersection() {
+    PYMESH_PROFILE_ZONE("IGLEngine::compute_intersection");
     igl::copyleft::cgal::mesh_boolean(
             m_vertices_1, m_faces_1, 
             m_vertices_2, m_faces_2,
@@ -41,6 +43,7 @@ void IGLEngine::compute_intersection() {
 }
 
 void IGLEngine::compute_difference() {
+    PYMESH_PROFILE_ZONE("IGLEngine::compute_difference");
     igl::copyleft::cgal::mesh_boolean(
             m_vertices_1, m_faces_1, 
             m_vertices_2, m_faces_2,
@@ -50,6 +53,7 @@ void IGLEngine::compute_difference() {
 }
 
 void IGLEngine::compute_symmetric_difference() {
+    PYMESH_PROFILE_ZONE("IGLEngine::compute_symmetric_difference");
     igl::copyleft::cgal::mesh_boolean(
             m_vertices_1, m_faces_1, 
             m_vertices_2, m_faces_2,
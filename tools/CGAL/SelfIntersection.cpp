@@ -2,11 +2,14 @@
 #ifdef WITH_CGAL
 #include "SelfIntersection.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include <Core/Exception.h>
 #include <Math/MatrixUtils.h>
 
-#include <boost/function.hpp>
-#include <boost/bind.hpp>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
 
 #include <CGAL/box_intersection_d.h>
 
@@ -31,9 +34,60 @@ namespace SelfIntersectionHelper {
             ID m_id;
     };
 
-    void handle_intersection_candidate(
-            SelfIntersection* self, const Box& a, const Box& b) {
-        self->handle_intersection_candidate(a.id(), b.id());
+    /**
+     * Static error bound for the floating point evaluation of orient3d.
+     * The constant is the one derived by CGAL's static filters (see
+     * Static_filters/Orientation_3.h), it needs to be scaled by the
+     * product of the maximal coordinate difference along each axis.
+     */
+    const Float ORIENT3D_STATIC_BOUND = 5.1107127829973299e-15;
+
+    /**
+     * Evaluate orient3d in floating point.  Return 1 or -1 if the sign is
+     * certified by the error bound, and 0 if it is undecided.
+     */
+    int filtered_orient3d(
+            const SelfIntersection::Point_3& a,
+            const SelfIntersection::Point_3& b,
+            const SelfIntersection::Point_3& c,
+            const SelfIntersection::Point_3& d,
+            const Float err_bound) {
+        const Float adx = a.x() - d.x();
+        const Float ady = a.y() - d.y();
+        const Float adz = a.z() - d.z();
+        const Float bdx = b.x() - d.x();
+        const Float bdy = b.y() - d.y();
+        const Float bdz = b.z() - d.z();
+        const Float cdx = c.x() - d.x();
+        const Float cdy = c.y() - d.y();
+        const Float cdz = c.z() - d.z();
+        const Float det =
+            adx * (bdy * cdz - bdz * cdy) +
+            bdx * (cdy * adz - cdz * ady) +
+            cdx * (ady * bdz - adz * bdy);
+        if (det > err_bound) return 1;
+        if (det < -err_bound) return -1;
+        return 0;
+    }
+
+    /**
+     * Return true iff all query points are certified to lie strictly on the
+     * same side of the plane spanned by a, b and c.
+     */
+    bool filtered_same_side(
+            const SelfIntersection::Point_3& a,
+            const SelfIntersection::Point_3& b,
+            const SelfIntersection::Point_3& c,
+            const SelfIntersection::Point_3* queries[],
+            size_t num_queries,
+            const Float err_bound) {
+        int ori = filtered_orient3d(a, b, c, *queries[0], err_bound);
+        if (ori == 0) return false;
+        for (size_t i=1; i<num_queries; i++) {
+            if (filtered_orient3d(a, b, c, *queries[i], err_bound) != ori)
+                return false;
+        }
+        return true;
     }
 
     Vector2I get_opposite_edge(const Vector3I& f, size_t v) {
@@ -65,14 +119,12 @@ namespace SelfIntersectionHelper {
         boxes.reserve(num_faces);
         for (size_t i=0; i<num_faces; i++) {
             const Vector3I f = faces.row(i);
-            const std::vector<SelfIntersection::Point_3> corners{
-                pts[f[0]], pts[f[1]], pts[f[2]]
-            };
             if (CGAL::collinear(pts[f[0]], pts[f[1]], pts[f[2]])) {
                 // Triangle is degenerated.
                 continue;
             }
-            boxes.emplace_back(CGAL::bbox_3(corners.begin(), corners.end()));
+            boxes.emplace_back(
+                    pts[f[0]].bbox() + pts[f[1]].bbox() + pts[f[2]].bbox());
             boxes.back().set_id(i);
         }
         return boxes;
@@ -82,8 +134,7 @@ using namespace SelfIntersectionHelper;
 
 SelfIntersection::SelfIntersection(
         const MatrixFr& vertices, const MatrixIr& faces)
-: m_faces(faces) {
-    const size_t num_vertices = vertices.rows();
+: m_faces(faces), m_grid_initialized(false), m_cell_size(1.0) {
     const size_t dim = vertices.cols();
     const size_t vertex_per_face = faces.cols();
 
@@ -96,6 +147,11 @@ SelfIntersection::SelfIntersection(
                 "Self intersection check only works with triangles");
     }
 
+    init_points(vertices);
+}
+
+void SelfIntersection::init_points(const MatrixFr& vertices) {
+    const size_t num_vertices = vertices.rows();
     m_points.resize(num_vertices);
     for (size_t i=0; i<num_vertices; i++) {
         m_points[i] = Point_3(
@@ -103,31 +159,291 @@ SelfIntersection::SelfIntersection(
                 vertices(i,1),
                 vertices(i,2));
     }
+
+    // Any coordinate difference along an axis is bounded by twice the
+    // maximum absolute coordinate along that axis.
+    m_filter_bound = -1.0;
+    if (num_vertices > 0) {
+        const Vector3F max_coord =
+            vertices.cwiseAbs().colwise().maxCoeff().transpose();
+        const Float bound = ORIENT3D_STATIC_BOUND *
+            (2 * max_coord[0]) * (2 * max_coord[1]) * (2 * max_coord[2]);
+        // Disable the filter if overflow/underflow could void the bound.
+        if (max_coord.maxCoeff() < 1e60 && bound > 1e-150) {
+            m_filter_bound = bound;
+        }
+    }
 }
 
 void SelfIntersection::detect_self_intersection() {
     clear();
+    m_grid.clear();
+    m_grid_initialized = false;
     std::vector<Box> boxes = get_triangle_bboxes(m_points, m_faces);
-    boost::function<void(const Box& a, const Box& b)> cb =
-        boost::bind(SelfIntersectionHelper::handle_intersection_candidate,
-                this, _1, _2);
-    CGAL::box_self_intersection_d(boxes.begin(), boxes.end(), cb);
+
+    std::vector<Vector2I> candidates;
+    CGAL::box_self_intersection_d(boxes.begin(), boxes.end(),
+            [&candidates](const Box& a, const Box& b) {
+                candidates.emplace_back(a.id(), b.id());
+            });
+
+    classify_candidates(candidates);
+}
+
+void SelfIntersection::update(const MatrixFr& vertices, const MatrixIr& faces,
+        const VectorI& changed_faces) {
+    if (faces.rows() != m_faces.rows()) {
+        throw RuntimeError(
+                "Number of faces changed, source faces are required.");
+    }
+    const size_t num_faces = faces.rows();
+    const VectorI source_faces = VectorI::LinSpaced(
+            num_faces, 0, num_faces-1);
+    update(vertices, faces, source_faces, changed_faces);
+}
+
+void SelfIntersection::update(const MatrixFr& vertices, const MatrixIr& faces,
+        const VectorI& source_faces, const VectorI& changed_faces) {
+    if (vertices.cols() != 3 || faces.cols() != 3) {
+        throw NotImplementedError(
+                "Self intersection check only works with 3D triangles");
+    }
+    const size_t num_old_faces = m_faces.rows();
+    const size_t num_faces = faces.rows();
+    if (size_t(source_faces.size()) != num_faces) {
+        throw RuntimeError("Source faces size does not match number of faces");
+    }
+
+    std::vector<bool> is_changed(num_faces, false);
+    const size_t num_changed = changed_faces.size();
+    for (size_t i=0; i<num_changed; i++) {
+        const int fi = changed_faces[i];
+        if (fi < 0 || size_t(fi) >= num_faces) {
+            throw RuntimeError("Changed face index out of bound");
+        }
+        is_changed[fi] = true;
+    }
+
+    // Unchanged faces keep their identity, everything else is treated as
+    // removed and re-inserted.
+    std::vector<int> old_to_new(num_old_faces, -1);
+    bool identity_map = (num_faces == num_old_faces);
+    for (size_t i=0; i<num_faces; i++) {
+        const int src = source_faces[i];
+        if (src >= int(num_old_faces)) {
+            throw RuntimeError("Source face index out of bound");
+        }
+        if (src < 0 || is_changed[i] || old_to_new[src] >= 0) {
+            is_changed[i] = true;
+            continue;
+        }
+        old_to_new[src] = i;
+        identity_map &= (size_t(src) == i);
+    }
+
+    // Stale faces must be removed while their old geometry is available.
+    if (m_grid_initialized) {
+        for (size_t i=0; i<num_old_faces; i++) {
+            if (old_to_new[i] < 0) remove_face(i);
+        }
+    }
+
+    std::vector<Vector2I> kept_pairs;
+    kept_pairs.reserve(m_intersecting_pairs.size());
+    for (const auto& pair : m_intersecting_pairs) {
+        const int f0 = old_to_new[pair[0]];
+        const int f1 = old_to_new[pair[1]];
+        if (f0 >= 0 && f1 >= 0) {
+            kept_pairs.emplace_back(f0, f1);
+        }
+    }
+    m_intersecting_pairs.swap(kept_pairs);
+
+    m_faces = faces;
+    init_points(vertices);
+
+    std::vector<int> faces_to_check;
+    for (size_t i=0; i<num_faces; i++) {
+        if (is_changed[i]) faces_to_check.push_back(i);
+    }
+
+    if (m_grid_initialized) {
+        if (!identity_map) {
+            for (auto& cell : m_grid) {
+                for (auto& fi : cell.second) {
+                    fi = old_to_new[fi];
+                }
+            }
+        }
+        for (const auto fi : faces_to_check) {
+            insert_face(fi);
+        }
+    } else {
+        init_grid();
+    }
+
+    classify_candidates(get_candidates(faces_to_check, is_changed));
+}
+
+void SelfIntersection::classify_candidates(
+        const std::vector<Vector2I>& candidates) {
+    const size_t num_candidates = candidates.size();
+    std::vector<char> intersecting(num_candidates, 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_candidates),
+            [this, &candidates, &intersecting](
+                const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    intersecting[i] = is_intersecting(
+                            candidates[i][0], candidates[i][1]);
+                }
+            });
+
+    for (size_t i=0; i<num_candidates; i++) {
+        if (intersecting[i]) {
+            m_intersecting_pairs.push_back(candidates[i]);
+        }
+    }
 }
 
 void SelfIntersection::clear() {
     m_intersecting_pairs.clear();
 }
 
+CGAL::Bbox_3 SelfIntersection::get_face_bbox(size_t fi) const {
+    const auto& p0 = m_points[m_faces(fi, 0)];
+    const auto& p1 = m_points[m_faces(fi, 1)];
+    const auto& p2 = m_points[m_faces(fi, 2)];
+    return p0.bbox() + p1.bbox() + p2.bbox();
+}
+
+bool SelfIntersection::is_degenerated(size_t fi) const {
+    return CGAL::collinear(
+            m_points[m_faces(fi, 0)],
+            m_points[m_faces(fi, 1)],
+            m_points[m_faces(fi, 2)]);
+}
+
+SelfIntersection::CellKey SelfIntersection::get_cell_key(
+        Float x, Float y, Float z) const {
+    return CellKey({
+            long(std::floor(x / m_cell_size)),
+            long(std::floor(y / m_cell_size)),
+            long(std::floor(z / m_cell_size))});
+}
+
+void SelfIntersection::init_grid() {
+    const size_t num_faces = m_faces.rows();
+    Float total_size = 0.0;
+    for (size_t i=0; i<num_faces; i++) {
+        const auto bbox = get_face_bbox(i);
+        total_size += std::max({
+                bbox.xmax() - bbox.xmin(),
+                bbox.ymax() - bbox.ymin(),
+                bbox.zmax() - bbox.zmin()});
+    }
+    m_cell_size = num_faces > 0 ? total_size / num_faces : 0.0;
+    if (m_cell_size <= 0.0) m_cell_size = 1.0;
+
+    m_grid.clear();
+    for (size_t i=0; i<num_faces; i++) {
+        insert_face(i);
+    }
+    m_grid_initialized = true;
+}
+
+void SelfIntersection::insert_face(size_t fi) {
+    if (is_degenerated(fi)) return;
+    const auto bbox = get_face_bbox(fi);
+    const CellKey min_key = get_cell_key(bbox.xmin(), bbox.ymin(), bbox.zmin());
+    const CellKey max_key = get_cell_key(bbox.xmax(), bbox.ymax(), bbox.zmax());
+    for (long x=min_key[0]; x<=max_key[0]; x++) {
+        for (long y=min_key[1]; y<=max_key[1]; y++) {
+            for (long z=min_key[2]; z<=max_key[2]; z++) {
+                m_grid[CellKey({x, y, z})].push_back(fi);
+            }
+        }
+    }
+}
+
+void SelfIntersection::remove_face(size_t fi) {
+    const auto bbox = get_face_bbox(fi);
+    const CellKey min_key = get_cell_key(bbox.xmin(), bbox.ymin(), bbox.zmin());
+    const CellKey max_key = get_cell_key(bbox.xmax(), bbox.ymax(), bbox.zmax());
+    for (long x=min_key[0]; x<=max_key[0]; x++) {
+        for (long y=min_key[1]; y<=max_key[1]; y++) {
+            for (long z=min_key[2]; z<=max_key[2]; z++) {
+                auto itr = m_grid.find(CellKey({x, y, z}));
+                if (itr == m_grid.end()) continue;
+                auto& cell = itr->second;
+                auto pos = std::find(cell.begin(), cell.end(), int(fi));
+                if (pos == cell.end()) continue;
+                *pos = cell.back();
+                cell.pop_back();
+                if (cell.empty()) m_grid.erase(itr);
+            }
+        }
+    }
+}
+
+std::vector<Vector2I> SelfIntersection::get_candidates(
+        const std::vector<int>& changed_faces,
+        const std::vector<bool>& is_changed) const {
+    std::vector<Vector2I> candidates;
+    std::vector<int> neighbors;
+    for (const auto fi : changed_faces) {
+        if (is_degenerated(fi)) continue;
+        const auto bbox = get_face_bbox(fi);
+        const CellKey min_key = get_cell_key(bbox.xmin(), bbox.ymin(), bbox.zmin());
+        const CellKey max_key = get_cell_key(bbox.xmax(), bbox.ymax(), bbox.zmax());
+
+        neighbors.clear();
+        for (long x=min_key[0]; x<=max_key[0]; x++) {
+            for (long y=min_key[1]; y<=max_key[1]; y++) {
+                for (long z=min_key[2]; z<=max_key[2]; z++) {
+                    auto itr = m_grid.find(CellKey({x, y, z}));
+                    if (itr == m_grid.end()) continue;
+                    neighbors.insert(neighbors.end(),
+                            itr->second.begin(), itr->second.end());
+                }
+            }
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                neighbors.end());
+
+        for (const auto fj : neighbors) {
+            if (fj == fi) continue;
+            // Pairs of changed faces are only tested once.
+            if (is_changed[fj] && fj < fi) continue;
+            if (!CGAL::do_overlap(bbox, get_face_bbox(fj))) continue;
+            candidates.emplace_back(fi, fj);
+        }
+    }
+    return candidates;
+}
+
 void SelfIntersection::handle_intersection_candidate(
         size_t f_idx_1, size_t f_idx_2) {
-    auto duplicated_vertices = topological_overlap(f_idx_1, f_idx_2);
+    if (is_intersecting(f_idx_1, f_idx_2)) {
+        m_intersecting_pairs.emplace_back(f_idx_1, f_idx_2);
+    }
+}
+
+bool SelfIntersection::is_intersecting(size_t f_idx_1, size_t f_idx_2) const {
+    Vector3I duplicated_vertices;
+    const size_t num_duplicated_vertices =
+        topological_overlap(f_idx_1, f_idx_2, duplicated_vertices);
+    if (is_separated_by_filter(f_idx_1, f_idx_2,
+                duplicated_vertices, num_duplicated_vertices)) {
+        return false;
+    }
+
     const Vector3I f1 = m_faces.row(f_idx_1);
     const Vector3I f2 = m_faces.row(f_idx_2);
     const Triangle_3 t1(m_points[f1[0]], m_points[f1[1]], m_points[f1[2]]);
     const Triangle_3 t2(m_points[f2[0]], m_points[f2[1]], m_points[f2[2]]);
 
-    bool is_intersecting = false;
-    const size_t num_duplicated_vertices = duplicated_vertices.size();
+    bool result = false;
     switch (num_duplicated_vertices) {
         case 0:
             // triangles do not touch.
@@ -137,15 +453,15 @@ void SelfIntersection::handle_intersection_candidate(
                 if (t1_degenerate || t2_degenerate) {
                     // Degenerated triangles are considered as
                     // self-intersecting.
-                    is_intersecting = true;
+                    result = true;
                 } else {
-                    is_intersecting = CGAL::do_intersect(t1, t2);
+                    result = CGAL::do_intersect(t1, t2);
                 }
             }
             break;
         case 3:
             // duplicated face
-            is_intersecting = true;
+            result = true;
             break;
         case 1:
             {
@@ -155,7 +471,7 @@ void SelfIntersection::handle_intersection_candidate(
                 Vector2I opp_edge_2 = get_opposite_edge(f2, shared_vertex);
                 Segment_3 seg_1(m_points[opp_edge_1[0]], m_points[opp_edge_1[1]]);
                 Segment_3 seg_2(m_points[opp_edge_2[0]], m_points[opp_edge_2[1]]);
-                is_intersecting =
+                result =
                     CGAL::do_intersect(t1, seg_2) ||
                     CGAL::do_intersect(t2, seg_1);
             }
@@ -173,16 +489,16 @@ void SelfIntersection::handle_intersection_candidate(
                 const auto& p4 = m_points[shared_edge[1]];
                 if (CGAL::coplanar(p1, p2, p3, p4)) {
                     if (CGAL::collinear(p3, p4, p1)) {
-                        is_intersecting = true;
+                        result = true;
                     } else if (CGAL::collinear(p3, p4, p2)) {
-                        is_intersecting = true;
+                        result = true;
                     } else {
                         switch (CGAL::coplanar_orientation(p3, p4, p1, p2)) {
                             case CGAL::POSITIVE:
-                                is_intersecting = true;
+                                result = true;
                                 break;
                             case CGAL::NEGATIVE:
-                                is_intersecting = false;
+                                result = false;
                                 break;
                             case CGAL::COLLINEAR:
                                 throw RuntimeError(
@@ -191,7 +507,7 @@ void SelfIntersection::handle_intersection_candidate(
                         }
                     }
                 } else {
-                    is_intersecting = false;
+                    result = false;
                 }
             }
             break;
@@ -200,24 +516,80 @@ void SelfIntersection::handle_intersection_candidate(
                     "Two triangles sharing more than 3 vertices? Something is very wrong");
     }
 
-    if (is_intersecting) {
-        m_intersecting_pairs.emplace_back(f_idx_1, f_idx_2);
-    }
+    return result;
 }
 
-std::vector<size_t> SelfIntersection::topological_overlap(size_t id1, size_t id2) const {
-    Vector3I f1 = m_faces.row(id1);
-    Vector3I f2 = m_faces.row(id2);
-    std::vector<size_t> duplicated_vertices;
-    duplicated_vertices.reserve(3);
+size_t SelfIntersection::topological_overlap(size_t id1, size_t id2,
+        Vector3I& shared) const {
+    const Vector3I f1 = m_faces.row(id1);
+    const Vector3I f2 = m_faces.row(id2);
+    size_t num_shared = 0;
     for (size_t i=0; i<3; i++) {
         for (size_t j=0; j<3; j++) {
             if (f1[i] == f2[j]) {
-                duplicated_vertices.push_back(f1[i]);
+                if (num_shared >= 3) {
+                    throw RuntimeError(
+                            "Two triangles sharing more than 3 vertices? Something is very wrong");
+                }
+                shared[num_shared] = f1[i];
+                num_shared++;
             }
         }
     }
-    return duplicated_vertices;
+    return num_shared;
+}
+
+bool SelfIntersection::is_separated_by_filter(size_t f_idx_1, size_t f_idx_2,
+        const Vector3I& shared, size_t num_shared) const {
+    if (m_filter_bound < 0.0) return false;
+
+    const Vector3I f1 = m_faces.row(f_idx_1);
+    const Vector3I f2 = m_faces.row(f_idx_2);
+    const Point_3& p10 = m_points[f1[0]];
+    const Point_3& p11 = m_points[f1[1]];
+    const Point_3& p12 = m_points[f1[2]];
+    const Point_3& p20 = m_points[f2[0]];
+    const Point_3& p21 = m_points[f2[1]];
+    const Point_3& p22 = m_points[f2[2]];
+
+    switch (num_shared) {
+        case 0:
+            {
+                // One triangle lies strictly on one side of the other's
+                // supporting plane.
+                const Point_3* q2[] = {&p20, &p21, &p22};
+                if (filtered_same_side(p10, p11, p12, q2, 3, m_filter_bound))
+                    return true;
+                const Point_3* q1[] = {&p10, &p11, &p12};
+                return filtered_same_side(p20, p21, p22, q1, 3, m_filter_bound);
+            }
+        case 1:
+            {
+                // The opposite edge of one triangle lies strictly on one side
+                // of the other's supporting plane, so they only meet at the
+                // shared vertex.
+                const Vector2I e1 = get_opposite_edge(f1, shared[0]);
+                const Vector2I e2 = get_opposite_edge(f2, shared[0]);
+                const Point_3* q2[] = {&m_points[e2[0]], &m_points[e2[1]]};
+                if (filtered_same_side(p10, p11, p12, q2, 2, m_filter_bound))
+                    return true;
+                const Point_3* q1[] = {&m_points[e1[0]], &m_points[e1[1]]};
+                return filtered_same_side(p20, p21, p22, q1, 2, m_filter_bound);
+            }
+        case 2:
+            {
+                // Triangles sharing an edge only intersect if coplanar.
+                const Vector2I shared_edge(shared[0], shared[1]);
+                const size_t v1 = get_opposite_vertex(f1, shared_edge);
+                const size_t v2 = get_opposite_vertex(f2, shared_edge);
+                return filtered_orient3d(
+                        m_points[v1], m_points[v2],
+                        m_points[shared_edge[0]], m_points[shared_edge[1]],
+                        m_filter_bound) != 0;
+            }
+        default:
+            return false;
+    }
 }
 
 #endif
@@ -4,9 +4,12 @@
 
 #include <vector>
 #include <set>
+#include <unordered_map>
 
 #include <Core/EigenTypedef.h>
 #include <Math/MatrixUtils.h>
+#include <Misc/HashKey.h>
+#include <Misc/HashMapTrait.h>
 
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 
@@ -26,9 +29,42 @@ class SelfIntersection {
     public:
         /**
          * Detect triangle-triangle intersections for non-degenerated triangles.
+         *
+         * Candidate pairs are gathered with CGAL's box intersection sweep
+         * and then classified in parallel.  Each candidate is first
+         * tested with a floating point orientation filter with certified
+         * error bound, exact predicates are only used when the filter
+         * fails to separate the triangles.
          */
         void detect_self_intersection();
 
+        /**
+         * Incrementally update the intersecting pairs after a local edit of
+         * the mesh.  Only candidate pairs involving changed faces are
+         * re-tested, unchanged pairs are carried over.  The face spatial
+         * index is built on the first update and kept between calls.
+         *
+         * detect_self_intersection() should be called on the mesh before
+         * its first edit.
+         *
+         * @param vertices       Vertices after the edit.
+         * @param faces          Faces after the edit.
+         * @param source_faces   For each face after the edit, the index of
+         *                       the face it originates from before the edit,
+         *                       or -1 if it is newly created (e.g.
+         *                       ShortEdgeRemoval::get_face_indices()).
+         * @param changed_faces  Indices of faces (after the edit) whose
+         *                       geometry or vertex indices changed.
+         */
+        void update(const MatrixFr& vertices, const MatrixIr& faces,
+                const VectorI& source_faces, const VectorI& changed_faces);
+
+        /**
+         * Same as above for edits that preserve face indices.
+         */
+        void update(const MatrixFr& vertices, const MatrixIr& faces,
+                const VectorI& changed_faces);
+
         void clear();
 
         MatrixIr get_self_intersecting_pairs() const {
@@ -41,13 +77,48 @@ class SelfIntersection {
     public:
         void handle_intersection_candidate(size_t f_idx_1, size_t f_idx_2);
 
+        /**
+         * Return true iff faces f_idx_1 and f_idx_2 intersect at places
+         * other than their shared vertices/edge.  This method is thread safe.
+         */
+        bool is_intersecting(size_t f_idx_1, size_t f_idx_2) const;
+
     private:
-        std::vector<size_t> topological_overlap(size_t id1, size_t id2) const;
+        typedef VectorHashKey<long, 3> CellKey;
+        typedef std::unordered_map<CellKey, std::vector<int>,
+                HashMapTrait<3, 0>::HashMapFunc> CellMap;
+
+        void init_points(const MatrixFr& vertices);
+        void classify_candidates(const std::vector<Vector2I>& candidates);
+
+        CGAL::Bbox_3 get_face_bbox(size_t fi) const;
+        bool is_degenerated(size_t fi) const;
+        CellKey get_cell_key(Float x, Float y, Float z) const;
+        void init_grid();
+        void insert_face(size_t fi);
+        void remove_face(size_t fi);
+        std::vector<Vector2I> get_candidates(
+                const std::vector<int>& changed_faces,
+                const std::vector<bool>& is_changed) const;
+
+        /**
+         * Store vertices shared by faces id1 and id2 in the first entries of
+         * shared, and return the number of shared vertices.
+         */
+        size_t topological_overlap(size_t id1, size_t id2,
+                Vector3I& shared) const;
+        bool is_separated_by_filter(size_t f_idx_1, size_t f_idx_2,
+                const Vector3I& shared, size_t num_shared) const;
 
     private:
         std::vector<Vector2I> m_intersecting_pairs;
         Points m_points;
         MatrixIr m_faces;
+        Float m_filter_bound;
+
+        bool m_grid_initialized;
+        Float m_cell_size;
+        CellMap m_grid;
 };
 
 }
@@ -1,6 +1,12 @@
 /* This file is part of PyMesh. Copyright (c) 2018 by Qingnan Zhou */
 
 #include "CompressionEngine.h"
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <Misc/Profiler.h>
+
 #if WITH_DRACO
 #include "Draco/DracoCompressionEngine.h"
 #endif
@@ -30,3 +36,29 @@ std::vector<std::string> CompressionEngine::get_available_engines() {
 #endif
     return engines;
 }
+
+std::vector<CompressionEngine::Buffer> CompressionEngine::compress_batch(
+        const std::vector<Mesh::Ptr>& meshes, const Options& options) const {
+    PYMESH_PROFILE_ZONE("CompressionEngine::compress_batch");
+    std::vector<Buffer> results(meshes.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, meshes.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i<r.end(); i++) {
+                    results[i] = compress(meshes[i], options);
+                }
+            });
+    return results;
+}
+
+std::vector<Mesh::Ptr> CompressionEngine::decompress_batch(
+        const std::vector<DataView>& data) const {
+    PYMESH_PROFILE_ZONE("CompressionEngine::decompress_batch");
+    std::vector<Mesh::Ptr> results(data.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, data.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i<r.end(); i++) {
+                    results[i] = decompress(data[i].first, data[i].second);
+                }
+            });
+    return results;
+}
@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <Mesh.h>
@@ -17,18 +18,77 @@ class CompressionEngine {
         static bool supports(const std::string& library_name);
         static std::vector<std::string> get_available_engines();
 
+    public:
+        using Buffer = std::vector<char>;
+        using DataView = std::pair<const char*, size_t>;
+
+        /**
+         * Per call settings.  Quantization bits are given per attribute kind,
+         * and speeds range from 0 (best compression) to 10 (fastest).
+         * Negative values keep the engine defaults.
+         */
+        struct Options {
+            int position_bits = -1;
+            int normal_bits = -1;
+            int texture_bits = -1;
+            int generic_bits = -1;
+            int encoding_speed = -1;
+            int decoding_speed = -1;
+            bool with_attributes = true;
+        };
+
+        /**
+         * Size of a decoded geometry.  Point clouds have no faces.
+         */
+        struct DecodedSize {
+            size_t dim;
+            size_t num_vertices;
+            size_t num_faces;
+        };
+
     public:
         virtual ~CompressionEngine() = default;
 
     public:
         virtual std::string compress(Mesh::Ptr mesh) const {
+            const Buffer data = compress(mesh, Options());
+            return std::string(data.data(), data.size());
+        }
+
+        virtual Buffer compress(Mesh::Ptr mesh, const Options& options) const {
             throw NotImplementedError("Compression algorithm is not implemented");
         }
 
         virtual Mesh::Ptr decompress(const std::string& data) const {
+            return decompress(data.data(), data.size());
+        }
+
+        virtual Mesh::Ptr decompress(const char* data, size_t size) const {
+            throw NotImplementedError("Decompression algorithm is not implemented");
+        }
+
+        /**
+         * Decode geometry only into caller provided buffers.  vertices must
+         * hold num_vertices * dim values and faces num_faces * 3 values.  If
+         * either capacity is too small, nothing is written and the returned
+         * size tells how much is needed.
+         */
+        virtual DecodedSize decompress_into(const char* data, size_t size,
+                Float* vertices, size_t vertex_capacity,
+                int* faces, size_t face_capacity) const {
             throw NotImplementedError("Decompression algorithm is not implemented");
         }
+
+    public:
+        /**
+         * Compress or decompress many meshes concurrently.  Results are in
+         * input order.
+         */
+        std::vector<Buffer> compress_batch(
+                const std::vector<Mesh::Ptr>& meshes,
+                const Options& options) const;
+        std::vector<Mesh::Ptr> decompress_batch(
+                const std::vector<DataView>& data) const;
 };
 
 }
-
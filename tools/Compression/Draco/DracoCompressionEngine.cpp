@@ -6,135 +6,132 @@
 #include <Core/Exception.h>
 #include <Mesh.h>
 #include <MeshFactory.h>
+#include <Misc/Profiler.h>
 
 #include <draco/attributes/geometry_attribute.h>
 #include <draco/compression/encode.h>
 #include <draco/compression/decode.h>
 #include <draco/mesh/mesh.h>
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 using namespace PyMesh;
 
 namespace DracoCompressionEngineHelper {
 
-template <typename DracoMesh>
-void copy_vertices(Mesh::Ptr mesh, std::unique_ptr<DracoMesh>& draco_mesh) {
-    const auto dim = mesh->get_dim();
-    const auto num_vertices = mesh->get_num_vertices();
-    draco_mesh->set_num_points(num_vertices);
-    draco::GeometryAttribute positions;
-    positions.Init(draco::GeometryAttribute::POSITION, // Attribute type
-            nullptr,                                   // data buffer
-            dim,                                       // number of components
-            draco::DT_FLOAT64,                         // data type
-            false,                                     // normalized
-            sizeof(Float) * dim,                       // byte stride
-            0);                                        // byte offset
-    auto pos_att_id = draco_mesh->AddAttribute(
-            positions,      // attribute object
-            true,           // identity mapping
-            num_vertices);  // num attribute values
-
-    for (int i = 0; i < num_vertices; ++i) {
-        draco_mesh->attribute(pos_att_id)->SetAttributeValue(
-                draco::AttributeValueIndex(i), mesh->get_vertex(i).data());
+using Options = CompressionEngine::Options;
+
+template<typename Target, typename T>
+int add_values(draco::PointCloud& draco_mesh,
+        draco::GeometryAttribute::Type type, draco::DataType data_type,
+        const T* values, size_t num_rows, size_t num_cols) {
+    draco::GeometryAttribute attr;
+    attr.Init(type,                        // Attribute type
+            nullptr,                       // data buffer
+            num_cols,                      // number of components
+            data_type,                     // data type
+            false,                         // normalized
+            sizeof(Target) * num_cols,     // byte stride
+            0);                            // byte offset
+    const auto id = draco_mesh.AddAttribute(attr, true, num_rows);
+
+    auto point_attr = draco_mesh.attribute(id);
+    std::vector<Target> row(num_cols);
+    for (size_t i=0; i<num_rows; i++) {
+        std::copy(values + i*num_cols, values + (i+1)*num_cols, row.begin());
+        point_attr->SetAttributeValue(draco::AttributeValueIndex(i),
+                row.data());
     }
+    return id;
 }
 
-template <typename DracoMesh>
-void copy_faces(Mesh::Ptr mesh, std::unique_ptr<DracoMesh>& draco_mesh) {
-    const auto num_faces = mesh->get_num_faces();
-    const auto& faces = mesh->get_faces();
-    for (int i = 0; i < num_faces; ++i) {
-        draco_mesh->AddFace({{
-                draco::PointIndex(faces[i*3]),
-                draco::PointIndex(faces[i*3+1]),
-                draco::PointIndex(faces[i*3+2])
-                }});
+/**
+ * Draco only quantizes float32 attributes, so attributes that are quantized
+ * are stored in single precision and the others in double precision.
+ */
+template<typename T>
+int add_attribute(draco::PointCloud& draco_mesh,
+        draco::GeometryAttribute::Type type, const T* values,
+        size_t num_rows, size_t num_cols, int quantization_bits) {
+    if (quantization_bits >= 0) {
+        return add_values<float>(draco_mesh, type, draco::DT_FLOAT32,
+                values, num_rows, num_cols);
+    } else {
+        return add_values<Float>(draco_mesh, type, draco::DT_FLOAT64,
+                values, num_rows, num_cols);
     }
 }
 
-template <typename DracoMesh>
-void copy_vertex_attributes(Mesh::Ptr mesh,
-        std::unique_ptr<DracoMesh>& draco_mesh) {
-    const auto num_vertices = mesh->get_num_vertices();
-    const auto& attribute_names = mesh->get_attribute_names();
-    for (const auto& name : attribute_names) {
-        const auto& values = mesh->get_attribute(name);
-        if (values.size() % num_vertices != 0) continue;
-        const auto num_rows = num_vertices;
-        const auto num_cols = values.size() / num_vertices;
-        draco::GeometryAttribute attr;
-        if (name == "vertex_normal") {
-            attr.Init(draco::GeometryAttribute::NORMAL, nullptr,
-                    num_cols, draco::DT_FLOAT64, false,
-                    sizeof(Float) * num_cols, 0);
-        } else if (name == "vertex_texture") {
-            attr.Init(draco::GeometryAttribute::TEX_COORD, nullptr,
-                    num_cols, draco::DT_FLOAT64, false,
-                    sizeof(Float) * num_cols, 0);
-        } else if (name.substr(0, 6) == "vertex"){
-            attr.Init(draco::GeometryAttribute::GENERIC, nullptr,
-                    num_cols, draco::DT_FLOAT64, false,
-                    sizeof(Float) * num_cols, 0);
-        } else {
-            // Not a vertex attribute.
-            continue;
-        }
-        const auto id = draco_mesh->AddAttribute(attr, true, num_rows);
-        for (size_t i=0; i<num_rows; i++) {
-            draco_mesh->attribute(id)->SetAttributeValue(
-                    draco::AttributeValueIndex(i), values.data() +i*num_cols);
-        }
+void copy_vertices(Mesh::Ptr mesh, draco::PointCloud& draco_mesh,
+        const Options& options) {
+    const size_t dim = mesh->get_dim();
+    const size_t num_vertices = mesh->get_num_vertices();
+    draco_mesh.set_num_points(num_vertices);
+    if (mesh->has_single_precision_vertices()) {
+        add_attribute(draco_mesh, draco::GeometryAttribute::POSITION,
+                mesh->get_vertex_matrix_f32().data(), num_vertices, dim,
+                options.position_bits);
+    } else {
+        add_attribute(draco_mesh, draco::GeometryAttribute::POSITION,
+                mesh->get_vertex_matrix().data(), num_vertices, dim,
+                options.position_bits);
+    }
+}
 
-        std::unique_ptr<draco::AttributeMetadata> metadata =
-            std::make_unique<draco::AttributeMetadata>();
-        metadata->AddEntryString("name", name);
-        draco_mesh->AddAttributeMetadata(id, std::move(metadata));
+void copy_faces(Mesh::Ptr mesh, draco::Mesh& draco_mesh) {
+    const auto faces = mesh->get_face_matrix();
+    const size_t num_faces = faces.rows();
+    for (size_t i=0; i<num_faces; ++i) {
+        draco_mesh.AddFace({{
+                draco::PointIndex(faces(i, 0)),
+                draco::PointIndex(faces(i, 1)),
+                draco::PointIndex(faces(i, 2))
+                }});
     }
 }
 
-void copy_face_attributes(Mesh::Ptr mesh,
-        std::unique_ptr<draco::Mesh>& draco_mesh) {
-    const auto num_faces = mesh->get_num_faces();
+void copy_vertex_attributes(Mesh::Ptr mesh, draco::PointCloud& draco_mesh,
+        const Options& options) {
+    const size_t num_vertices = mesh->get_num_vertices();
+    if (num_vertices == 0) return;
     const auto& attribute_names = mesh->get_attribute_names();
     for (const auto& name : attribute_names) {
-        const auto& values = mesh->get_attribute(name);
-        if (values.size() % num_faces != 0) continue;
-        const auto num_rows = num_faces;
-        const auto num_cols = values.size() / num_faces;
-        draco::GeometryAttribute attr;
-        if (name == "face_normal") {
-            attr.Init(draco::GeometryAttribute::NORMAL, nullptr,
-                    num_cols, draco::DT_FLOAT64, false,
-                    sizeof(Float) * num_cols, 0);
-        } else if (name.substr(0, 4) == "face"){
-            attr.Init(draco::GeometryAttribute::GENERIC, nullptr,
-                    num_cols, draco::DT_FLOAT64, false,
-                    sizeof(Float) * num_cols, 0);
-        } else {
-            // Not a face attribute.
+        if (name.substr(0, 6) != "vertex") {
+            // Not a vertex attribute.
             continue;
         }
-        const auto id = draco_mesh->AddAttribute(attr, true, num_rows);
-        draco_mesh->SetAttributeElementType(id, draco::MESH_FACE_ATTRIBUTE);
-        for (size_t i=0; i<num_rows; i++) {
-            draco_mesh->attribute(id)->SetAttributeValue(
-                    draco::AttributeValueIndex(i), values.data() + i*num_cols);
+        const auto values = mesh->get_attribute_view(name);
+        if (values.size() == 0 || values.size() % num_vertices != 0) continue;
+        const size_t num_cols = values.size() / num_vertices;
+
+        draco::GeometryAttribute::Type type;
+        int quantization_bits;
+        if (name == "vertex_normal") {
+            type = draco::GeometryAttribute::NORMAL;
+            quantization_bits = options.normal_bits;
+        } else if (name == "vertex_texture") {
+            type = draco::GeometryAttribute::TEX_COORD;
+            quantization_bits = options.texture_bits;
+        } else {
+            type = draco::GeometryAttribute::GENERIC;
+            quantization_bits = options.generic_bits;
         }
+        const auto id = add_attribute(draco_mesh, type, values.data(),
+                num_vertices, num_cols, quantization_bits);
 
         std::unique_ptr<draco::AttributeMetadata> metadata =
             std::make_unique<draco::AttributeMetadata>();
         metadata->AddEntryString("name", name);
-        draco_mesh->AddAttributeMetadata(id, std::move(metadata));
+        draco_mesh.AddAttributeMetadata(id, std::move(metadata));
     }
 }
 
 std::unique_ptr<draco::Mesh> to_draco_mesh(Mesh::Ptr mesh,
-        bool with_attributes=true) {
+        const Options& options) {
     std::unique_ptr<draco::Mesh> draco_mesh(new draco::Mesh());
 
     const size_t vertex_per_face = mesh->get_vertex_per_face();
@@ -143,75 +140,152 @@ std::unique_ptr<draco::Mesh> to_draco_mesh(Mesh::Ptr mesh,
                 "Draco encoding only supports triangle mesh.");
     }
 
-    copy_vertices(mesh, draco_mesh);
-    copy_faces(mesh, draco_mesh);
+    copy_vertices(mesh, *draco_mesh, options);
+    copy_faces(mesh, *draco_mesh);
 
-    if (with_attributes) {
-        copy_vertex_attributes(mesh, draco_mesh);
-        //copy_face_attributes(mesh, draco_mesh);
+    if (options.with_attributes) {
+        copy_vertex_attributes(mesh, *draco_mesh, options);
     }
 
     return draco_mesh;
 }
 
 std::unique_ptr<draco::PointCloud> to_draco_point_cloud(Mesh::Ptr mesh,
-        bool with_attributes=true) {
+        const Options& options) {
     std::unique_ptr<draco::PointCloud> draco_mesh(new draco::PointCloud());
     assert(mesh->get_num_faces() == 0);
-    copy_vertices(mesh, draco_mesh);
+    copy_vertices(mesh, *draco_mesh, options);
 
-    if (with_attributes) {
-        copy_vertex_attributes(mesh, draco_mesh);
+    if (options.with_attributes) {
+        copy_vertex_attributes(mesh, *draco_mesh, options);
     }
 
     return draco_mesh;
 }
 
-template<typename DracoMesh>
-VectorF extract_vertices(std::unique_ptr<DracoMesh>& draco_mesh, size_t& dim) {
-    const auto num_vertices = draco_mesh->num_points();
-    const auto positions = draco_mesh->GetNamedAttribute(
-            draco::GeometryAttribute::POSITION);
-    assert(positions->IsValid());
-    dim = positions->num_components();
+void configure_encoder(draco::Encoder& encoder, const Options& options) {
+    if (options.position_bits >= 0) {
+        encoder.SetAttributeQuantization(
+                draco::GeometryAttribute::POSITION, options.position_bits);
+    }
+    if (options.normal_bits >= 0) {
+        encoder.SetAttributeQuantization(
+                draco::GeometryAttribute::NORMAL, options.normal_bits);
+    }
+    if (options.texture_bits >= 0) {
+        encoder.SetAttributeQuantization(
+                draco::GeometryAttribute::TEX_COORD, options.texture_bits);
+    }
+    if (options.generic_bits >= 0) {
+        encoder.SetAttributeQuantization(
+                draco::GeometryAttribute::GENERIC, options.generic_bits);
+    }
+    if (options.encoding_speed >= 0 || options.decoding_speed >= 0) {
+        // Draco treats -1 as unset.
+        encoder.SetSpeedOptions(options.encoding_speed,
+                options.decoding_speed);
+    }
+}
 
-    VectorF vertices(num_vertices * dim);
-    if (dim == 2) {
-        for (size_t i=0; i<num_vertices; i++) {
-            const auto p = positions->template GetValue<Float, 2>(
-                    draco::AttributeValueIndex(i));
-            vertices(i*2  ) = p[0];
-            vertices(i*2+1) = p[1];
+void check_encoding_status(const draco::Status& status) {
+    if (!status.ok()) {
+        std::stringstream err_msg;
+        err_msg << "Draco encoding error: " << status.error_msg();
+        throw RuntimeError(err_msg.str());
+    }
+}
+
+/**
+ * Decode a triangle mesh or a point cloud.  Triangle meshes are returned as
+ * draco::Mesh, which derives from draco::PointCloud.
+ */
+std::unique_ptr<draco::PointCloud> decode(const char* data, size_t size) {
+    draco::DecoderBuffer buffer;
+    buffer.Init(data, size);
+    auto type_statusor = draco::Decoder::GetEncodedGeometryType(&buffer);
+    if (!type_statusor.ok()) {
+        throw RuntimeError("Failed to decode Draco buffer.");
+    }
+
+    draco::Decoder decoder;
+    const draco::EncodedGeometryType geom_type = type_statusor.value();
+    if (geom_type == draco::TRIANGULAR_MESH) {
+        auto statusor = decoder.DecodeMeshFromBuffer(&buffer);
+        if (!statusor.ok()) {
+            throw RuntimeError("Draco decoding from triangle mesh failed.");
         }
-    } else if (dim == 3) {
-        for (size_t i=0; i<num_vertices; i++) {
-            const auto p = positions->template GetValue<Float, 3>(
-                    draco::AttributeValueIndex(i));
-            vertices(i*3  ) = p[0];
-            vertices(i*3+1) = p[1];
-            vertices(i*3+2) = p[2];
+        std::unique_ptr<draco::Mesh> in_mesh = std::move(statusor).value();
+        if (!in_mesh) {
+            throw RuntimeError("Draco decoding from triangle mesh failed.");
+        }
+        return std::move(in_mesh);
+    } else if (geom_type == draco::POINT_CLOUD) {
+        auto statusor = decoder.DecodePointCloudFromBuffer(&buffer);
+        if (!statusor.ok()) {
+            throw RuntimeError("Draco decoding from point cloud failed.");
         }
+        std::unique_ptr<draco::PointCloud> in_mesh = std::move(statusor).value();
+        if (!in_mesh) {
+            throw RuntimeError("Draco decoding from point cloud failed.");
+        }
+        return in_mesh;
     } else {
+        throw NotImplementedError("Unsupported Draco mesh type.");
+    }
+}
+
+CompressionEngine::DecodedSize get_decoded_size(
+        const draco::PointCloud& geometry) {
+    CompressionEngine::DecodedSize size;
+    size.num_vertices = geometry.num_points();
+    const auto draco_mesh = dynamic_cast<const draco::Mesh*>(&geometry);
+    size.num_faces = draco_mesh == nullptr ? 0 : draco_mesh->num_faces();
+
+    const auto positions = geometry.GetNamedAttribute(
+            draco::GeometryAttribute::POSITION);
+    if (positions == nullptr) {
+        if (size.num_vertices > 0) {
+            throw RuntimeError("Draco data has no vertex positions.");
+        }
+        size.dim = 3;
+    } else {
+        size.dim = positions->num_components();
+    }
+    if (size.dim != 2 && size.dim != 3) {
         throw NotImplementedError("Draco mesh encodes high dimensional data");
     }
-    return vertices;
+    return size;
 }
 
-template<typename DracoMesh>
-VectorI extract_faces(std::unique_ptr<DracoMesh>& draco_mesh) {
-    const auto num_faces = draco_mesh->num_faces();
-    VectorI faces(num_faces * 3);
+void extract_vertices(const draco::PointCloud& geometry, Float* vertices) {
+    const size_t num_vertices = geometry.num_points();
+    if (num_vertices == 0) return;
+    const auto positions = geometry.GetNamedAttribute(
+            draco::GeometryAttribute::POSITION);
+    const size_t dim = positions->num_components();
+    for (size_t i=0; i<num_vertices; i++) {
+        positions->ConvertValue(
+                positions->mapped_index(draco::PointIndex(i)),
+                vertices + i*dim);
+    }
+}
+
+void extract_faces(const draco::PointCloud& geometry, int* faces) {
+    const auto draco_mesh = dynamic_cast<const draco::Mesh*>(&geometry);
+    if (draco_mesh == nullptr) return;
+    const size_t num_faces = draco_mesh->num_faces();
     for (size_t i=0; i<num_faces; i++) {
-        const auto f = draco_mesh->face(draco::FaceIndex(i));
-        faces.segment<3>(i*3) << f[0].value(), f[1].value(), f[2].value();
+        const auto& f = draco_mesh->face(draco::FaceIndex(i));
+        faces[i*3  ] = f[0].value();
+        faces[i*3+1] = f[1].value();
+        faces[i*3+2] = f[2].value();
     }
-    return faces;
 }
 
-template<typename DracoMesh>
-void copy_metadata(std::unique_ptr<DracoMesh>& draco_mesh, Mesh::Ptr mesh) {
-    const auto metadata = draco_mesh->GetMetadata();
+void copy_metadata(const draco::PointCloud& geometry, Mesh::Ptr mesh) {
+    const auto metadata = geometry.GetMetadata();
     if (metadata == nullptr) return;
+    const size_t num_vertices = geometry.num_points();
     const auto& attr_metadatas = metadata->attribute_metadatas();
     for (const auto& attr_metadata : attr_metadatas) {
         std::string name="";
@@ -219,100 +293,80 @@ void copy_metadata(std::unique_ptr<DracoMesh>& draco_mesh, Mesh::Ptr mesh) {
         if (name == "") continue;
         auto uid = attr_metadata->att_unique_id();
 
-        const auto attr = draco_mesh->GetAttributeByUniqueId(uid);
-        const auto num_rows = attr->size();
-        const auto num_cols = attr->num_components();
+        const auto attr = geometry.GetAttributeByUniqueId(uid);
+        const size_t num_cols = attr->num_components();
 
-        VectorF data(num_rows * num_cols);
-        for (size_t i=0; i<num_rows; i++) {
-            attr->ConvertValue(draco::AttributeValueIndex(i),
+        VectorF data(num_vertices * num_cols);
+        for (size_t i=0; i<num_vertices; i++) {
+            attr->ConvertValue(attr->mapped_index(draco::PointIndex(i)),
                     data.data() + i*num_cols);
         }
         mesh->add_empty_attribute(name);
-        mesh->set_attribute(name, data);
+        mesh->adopt_attribute(name, data);
     }
 }
 
-Mesh::Ptr from_draco_mesh(std::unique_ptr<draco::Mesh> draco_mesh) {
-    assert(draco_mesh);
-    size_t dim;
-    VectorF vertices = extract_vertices(draco_mesh, dim);
-    VectorI faces = extract_faces(draco_mesh);
-    VectorI voxels;
-    auto mesh = MeshFactory().load_data(vertices, faces, voxels, dim, 3, 4).create();
-    copy_metadata(draco_mesh, mesh);
-    return mesh;
 }
 
-Mesh::Ptr from_draco_point_cloud(std::unique_ptr<draco::PointCloud> draco_pc) {
-    assert(draco_pc);
-    size_t dim;
-    VectorF vertices = extract_vertices(draco_pc, dim);
-    VectorI faces;
-    VectorI voxels;
-    auto mesh = MeshFactory().load_data(vertices, faces, voxels, dim, 3, 4).create();
-    copy_metadata(draco_pc, mesh);
-    return mesh;
-}
-
-}
+using namespace DracoCompressionEngineHelper;
 
-std::string DracoCompressionEngine::compress(Mesh::Ptr mesh) const {
+CompressionEngine::Buffer DracoCompressionEngine::compress(
+        Mesh::Ptr mesh, const Options& options) const {
+    PYMESH_PROFILE_ZONE("DracoCompressionEngine::compress");
     const size_t num_faces = mesh->get_num_faces();
 
     draco::EncoderBuffer buffer;
     draco::Encoder encoder;
+    configure_encoder(encoder, options);
     if (num_faces > 0) {
-        auto draco_mesh = DracoCompressionEngineHelper::to_draco_mesh(mesh);
-        const auto status = encoder.EncodeMeshToBuffer(*draco_mesh, &buffer);
-        if (!status.ok()) {
-            throw RuntimeError("Draco encoding error!");
-        }
-        return std::string(buffer.data(), buffer.size());
+        auto draco_mesh = to_draco_mesh(mesh, options);
+        check_encoding_status(
+                encoder.EncodeMeshToBuffer(*draco_mesh, &buffer));
     } else {
-        auto draco_mesh = DracoCompressionEngineHelper::to_draco_point_cloud(mesh);
-        const auto status = encoder.EncodePointCloudToBuffer(*draco_mesh, &buffer);
-        if (!status.ok()) {
-            throw RuntimeError("Draco encoding error!");
-        }
-        return std::string(buffer.data(), buffer.size());
+        auto draco_mesh = to_draco_point_cloud(mesh, options);
+        check_encoding_status(
+                encoder.EncodePointCloudToBuffer(*draco_mesh, &buffer));
     }
+
+    // Hand over the encoded bytes without copying.
+    Buffer data;
+    data.swap(*buffer.buffer());
+    return data;
 }
 
-Mesh::Ptr DracoCompressionEngine::decompress(const std::string& data) const {
-    draco::DecoderBuffer buffer;
-    buffer.Init(data.c_str(), data.size());
-    auto type_statusor = draco::Decoder::GetEncodedGeometryType(&buffer);
-    if (!type_statusor.ok()) {
-        throw RuntimeError("Failed to decode Draco buffer.");
-    }
+Mesh::Ptr DracoCompressionEngine::decompress(
+        const char* data, size_t size) const {
+    PYMESH_PROFILE_ZONE("DracoCompressionEngine::decompress");
+    auto geometry = decode(data, size);
+    const auto decoded_size = get_decoded_size(*geometry);
 
-    draco::Decoder decoder;
-    draco::Mesh* draco_mesh = nullptr;
-    const draco::EncodedGeometryType geom_type = type_statusor.value();
-    if (geom_type == draco::TRIANGULAR_MESH) {
-        auto statusor = decoder.DecodeMeshFromBuffer(&buffer);
-        if (!statusor.ok()) {
-            throw RuntimeError("Draco decoding from triangle mesh failed.");
-        }
-        std::unique_ptr<draco::Mesh> in_mesh = std::move(statusor).value();
-        if (!in_mesh) {
-            throw RuntimeError("Draco decoding from triangle mesh failed.");
-        }
-        return DracoCompressionEngineHelper::from_draco_mesh(std::move(in_mesh));
-    } else if (geom_type == draco::POINT_CLOUD) {
-        auto statusor = decoder.DecodePointCloudFromBuffer(&buffer);
-        if (!statusor.ok()) {
-            throw RuntimeError("Draco decoding from point cloud failed.");
-        }
-        std::unique_ptr<draco::PointCloud> in_mesh = std::move(statusor).value();
-        if (!in_mesh) {
-            throw RuntimeError("Draco decoding from point cloud failed.");
-        }
-        return DracoCompressionEngineHelper::from_draco_point_cloud(std::move(in_mesh));
-    } else {
-        throw NotImplementedError("Unsupported Draco mesh type.");
+    VectorF vertices(decoded_size.num_vertices * decoded_size.dim);
+    VectorI faces(decoded_size.num_faces * 3);
+    VectorI voxels;
+    extract_vertices(*geometry, vertices.data());
+    extract_faces(*geometry, faces.data());
+
+    auto mesh = MeshFactory().adopt_data(vertices, faces, voxels,
+            decoded_size.dim, 3, 4).create();
+    copy_metadata(*geometry, mesh);
+    return mesh;
+}
+
+CompressionEngine::DecodedSize DracoCompressionEngine::decompress_into(
+        const char* data, size_t size,
+        Float* vertices, size_t vertex_capacity,
+        int* faces, size_t face_capacity) const {
+    PYMESH_PROFILE_ZONE("DracoCompressionEngine::decompress_into");
+    auto geometry = decode(data, size);
+    const auto decoded_size = get_decoded_size(*geometry);
+    if (vertex_capacity < decoded_size.num_vertices * decoded_size.dim ||
+            face_capacity < decoded_size.num_faces * 3) {
+        return decoded_size;
     }
+
+    extract_vertices(*geometry, vertices);
+    extract_faces(*geometry, faces);
+    return decoded_size;
 }
 
 #endif
@@ -8,10 +8,20 @@
 
 namespace PyMesh {
 
+/**
+ * Each call uses its own Draco encoder/decoder, so a single engine can be
+ * shared by concurrent calls (e.g. compress_batch()).
+ */
 class DracoCompressionEngine : public CompressionEngine {
     public:
-        virtual std::string compress(Mesh::Ptr mesh) const;
-        virtual Mesh::Ptr decompress(const std::string& data) const;
+        using CompressionEngine::compress;
+        using CompressionEngine::decompress;
+
+        virtual Buffer compress(Mesh::Ptr mesh, const Options& options) const;
+        virtual Mesh::Ptr decompress(const char* data, size_t size) const;
+        virtual DecodedSize decompress_into(const char* data, size_t size,
+                Float* vertices, size_t vertex_capacity,
+                int* faces, size_t face_capacity) const;
 };
 
 }
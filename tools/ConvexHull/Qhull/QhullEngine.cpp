@@ -19,29 +19,37 @@ extern "C" {
 
 using namespace PyMesh;
 
+std::mutex QhullEngine::m_lock;
+
 void QhullEngine::run(const MatrixFr& points) {
     const size_t num_points = points.rows();
     const size_t dim = points.cols();
     char flags[64];
     sprintf(flags, "qhull Qt");
-    coordT* data = new coordT[num_points * dim];
-    std::copy(points.data(), points.data() + num_points * dim, data);
+    std::vector<coordT> data(points.data(), points.data() + num_points * dim);
 
-    m_lock.lock();
-    int err = qh_new_qhull(dim, num_points, data, false,
-            flags, NULL, stderr);
+    int err;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        err = qh_new_qhull(dim, num_points, data.data(), false,
+                flags, NULL, stderr);
+        if (!err) {
+            try {
+                extract_hull(points);
+            } catch (...) {
+                qh_freeqhull(!qh_ALL);
+                throw;
+            }
+        }
+        qh_freeqhull(!qh_ALL);
+    }
 
-    if (!err) {
-        extract_hull(points);
-    } else {
+    if (err) {
         std::stringstream err_msg;
         err_msg << "Qhull error: " << err;
         throw RuntimeError(err_msg.str());
     }
 
-    qh_freeqhull(!qh_ALL);
-    m_lock.unlock();
-    delete [] data;
     reorient_faces();
 }
 
@@ -19,7 +19,8 @@ class QhullEngine : public ConvexHullEngine {
         void extract_hull(const MatrixFr& points);
 
     protected:
-        std::mutex m_lock;
+        // Qhull keeps its state in globals, all instances share this lock.
+        static std::mutex m_lock;
 };
 
 }
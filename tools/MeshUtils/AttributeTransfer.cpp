@@ -0,0 +1,425 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include "AttributeTransfer.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+#include <tbb/tbb.h>
+
+#include <Core/Exception.h>
+
+using namespace PyMesh;
+
+namespace AttributeTransferHelper {
+    const int MAX_LEAF_SIZE = 4;
+
+    Float compute_box_squared_distance(const Vector3F& p,
+            const Vector3F& bbox_min, const Vector3F& bbox_max) {
+        Float result = 0.0;
+        for (size_t i=0; i<3; i++) {
+            Float d = std::max(Float(0.0),
+                    std::max(bbox_min[i] - p[i], p[i] - bbox_max[i]));
+            result += d * d;
+        }
+        return result;
+    }
+
+    /**
+     * Closest point on triangle abc to p, returned as barycentric
+     * coordinates.  See Ericson, Real-Time Collision Detection, 5.1.5.
+     */
+    Vector3F compute_closest_barycentric_coord(const Vector3F& p,
+            const Vector3F& a, const Vector3F& b, const Vector3F& c) {
+        const Vector3F ab = b - a;
+        const Vector3F ac = c - a;
+        const Vector3F ap = p - a;
+        const Float d1 = ab.dot(ap);
+        const Float d2 = ac.dot(ap);
+        if (d1 <= 0.0 && d2 <= 0.0) return Vector3F(1.0, 0.0, 0.0);
+
+        const Vector3F bp = p - b;
+        const Float d3 = ab.dot(bp);
+        const Float d4 = ac.dot(bp);
+        if (d3 >= 0.0 && d4 <= d3) return Vector3F(0.0, 1.0, 0.0);
+
+        const Float vc = d1*d4 - d3*d2;
+        if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+            const Float v = d1 / (d1 - d3);
+            return Vector3F(1.0 - v, v, 0.0);
+        }
+
+        const Vector3F cp = p - c;
+        const Float d5 = ab.dot(cp);
+        const Float d6 = ac.dot(cp);
+        if (d6 >= 0.0 && d5 <= d6) return Vector3F(0.0, 0.0, 1.0);
+
+        const Float vb = d5*d2 - d1*d6;
+        if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+            const Float w = d2 / (d2 - d6);
+            return Vector3F(1.0 - w, 0.0, w);
+        }
+
+        const Float va = d3*d6 - d5*d4;
+        if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0) {
+            const Float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            return Vector3F(0.0, 1.0 - w, w);
+        }
+
+        const Float sum = va + vb + vc;
+        if (sum <= 0.0) {
+            // Degenerated triangle.
+            return Vector3F(1.0, 0.0, 0.0);
+        }
+        const Float v = vb / sum;
+        const Float w = vc / sum;
+        return Vector3F(1.0 - v - w, v, w);
+    }
+
+    /**
+     * Barycentric coordinates of the centroids of the 4^level sub-triangles
+     * of a uniformly subdivided triangle.
+     */
+    std::vector<Vector3F> compute_area_samples(size_t level) {
+        const size_t n = 1 << level;
+        std::vector<Vector3F> samples;
+        for (size_t i=0; i<n; i++) {
+            for (size_t j=0; i+j<n; j++) {
+                Float b1 = Float(3*i+1) / Float(3*n);
+                Float b2 = Float(3*j+1) / Float(3*n);
+                samples.emplace_back(1.0 - b1 - b2, b1, b2);
+                if (i+j+2 <= n) {
+                    b1 = Float(3*i+2) / Float(3*n);
+                    b2 = Float(3*j+2) / Float(3*n);
+                    samples.emplace_back(1.0 - b1 - b2, b1, b2);
+                }
+            }
+        }
+        return samples;
+    }
+
+    size_t get_nearest_corner(const Vector3F& barycentric_coord) {
+        size_t index;
+        barycentric_coord.maxCoeff(&index);
+        return index;
+    }
+}
+
+using namespace AttributeTransferHelper;
+
+AttributeTransfer::AttributeTransfer(Mesh::Ptr source, Mesh::Ptr target) :
+    m_source(source), m_target(target), m_area_sampling_level(2) {
+        if (m_source->get_dim() != m_target->get_dim()) {
+            throw RuntimeError("Source and target mesh dimension mismatch.");
+        }
+        init_source();
+    }
+
+void AttributeTransfer::transfer_vertex_attribute(
+        const std::string& name, Mode mode) {
+    if (mode != NEAREST && mode != BARYCENTRIC) {
+        throw NotImplementedError(
+                "Vertex attribute transfer only supports NEAREST and BARYCENTRIC modes");
+    }
+    const size_t num_target_vertices = m_target->get_num_vertices();
+    const size_t num_source_vertices = m_source->get_num_vertices();
+    const MatrixFr target_vertices = get_target_vertices();
+    const auto values = m_source->get_attribute_view(name);
+    const size_t stride = get_source_stride(name, num_source_vertices);
+    VectorF target_values(num_target_vertices * stride);
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_target_vertices),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const ClosestPoint closest =
+                        lookup(target_vertices.row(i).transpose());
+                    const auto face = m_source_faces.row(closest.face);
+                    auto value = target_values.segment(i*stride, stride);
+                    if (mode == NEAREST) {
+                        const size_t j = get_nearest_corner(
+                                closest.barycentric_coord);
+                        value = values.segment(face[j]*stride, stride);
+                    } else {
+                        value.setZero();
+                        for (size_t j=0; j<3; j++) {
+                            value += closest.barycentric_coord[j] *
+                                values.segment(face[j]*stride, stride);
+                        }
+                    }
+                }
+            });
+    store_target_attribute(name, target_values);
+}
+
+void AttributeTransfer::transfer_face_attribute(
+        const std::string& name, Mode mode) {
+    if (mode != NEAREST && mode != AREA_WEIGHTED) {
+        throw NotImplementedError(
+                "Face attribute transfer only supports NEAREST and AREA_WEIGHTED modes");
+    }
+    const size_t num_target_faces = m_target->get_num_faces();
+    const size_t num_source_faces = m_source->get_num_faces();
+    const size_t vertex_per_face = m_target->get_vertex_per_face();
+    if (mode == AREA_WEIGHTED && vertex_per_face != 3) {
+        throw NotImplementedError(
+                "Area weighted transfer only supports triangle target mesh");
+    }
+    const auto target_faces = m_target->get_face_matrix();
+    const MatrixFr target_vertices = get_target_vertices();
+    const auto values = m_source->get_attribute_view(name);
+    const size_t stride = get_source_stride(name, num_source_faces);
+    VectorF target_values(num_target_faces * stride);
+
+    std::vector<Vector3F> samples;
+    if (mode == AREA_WEIGHTED) {
+        samples = compute_area_samples(m_area_sampling_level);
+    }
+    const size_t num_samples = samples.size();
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_target_faces),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    auto value = target_values.segment(i*stride, stride);
+                    if (mode == NEAREST) {
+                        Vector3F centroid = Vector3F::Zero();
+                        for (size_t j=0; j<vertex_per_face; j++) {
+                            centroid += target_vertices.row(
+                                    target_faces(i, j)).transpose();
+                        }
+                        centroid /= Float(vertex_per_face);
+                        const ClosestPoint closest = lookup(centroid);
+                        value = values.segment(closest.face*stride, stride);
+                    } else {
+                        const Vector3F v0 = target_vertices.row(target_faces(i, 0));
+                        const Vector3F v1 = target_vertices.row(target_faces(i, 1));
+                        const Vector3F v2 = target_vertices.row(target_faces(i, 2));
+                        // Samples cover sub-triangles of equal area.
+                        value.setZero();
+                        for (const auto& b : samples) {
+                            const ClosestPoint closest =
+                                lookup(b[0] * v0 + b[1] * v1 + b[2] * v2);
+                            value += values.segment(closest.face*stride, stride);
+                        }
+                        value /= Float(num_samples);
+                    }
+                }
+            });
+    store_target_attribute(name, target_values);
+}
+
+void AttributeTransfer::transfer_corner_attribute(
+        const std::string& name, Mode mode) {
+    if (mode != NEAREST && mode != BARYCENTRIC) {
+        throw NotImplementedError(
+                "Corner attribute transfer only supports NEAREST and BARYCENTRIC modes");
+    }
+    const size_t num_target_faces = m_target->get_num_faces();
+    const size_t num_source_faces = m_source->get_num_faces();
+    const size_t vertex_per_face = m_target->get_vertex_per_face();
+    const auto target_faces = m_target->get_face_matrix();
+    const MatrixFr target_vertices = get_target_vertices();
+    const auto values = m_source->get_attribute_view(name);
+    const size_t stride = get_source_stride(name, num_source_faces * 3);
+    VectorF target_values(num_target_faces * vertex_per_face * stride);
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_target_faces),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    Vector3F centroid = Vector3F::Zero();
+                    for (size_t j=0; j<vertex_per_face; j++) {
+                        centroid += target_vertices.row(
+                                target_faces(i, j)).transpose();
+                    }
+                    centroid /= Float(vertex_per_face);
+                    ClosestPoint closest = lookup(centroid);
+                    const size_t source_face = closest.face;
+
+                    for (size_t j=0; j<vertex_per_face; j++) {
+                        const Vector3F p = target_vertices.row(
+                                target_faces(i, j));
+                        project(p, source_face, closest);
+                        const Vector3F& b = closest.barycentric_coord;
+                        auto value = target_values.segment(
+                                (i*vertex_per_face+j)*stride, stride);
+                        if (mode == NEAREST) {
+                            const size_t k = get_nearest_corner(b);
+                            value = values.segment(
+                                    (source_face*3+k)*stride, stride);
+                        } else {
+                            value.setZero();
+                            for (size_t k=0; k<3; k++) {
+                                value += b[k] * values.segment(
+                                        (source_face*3+k)*stride, stride);
+                            }
+                        }
+                    }
+                }
+            });
+    store_target_attribute(name, target_values);
+}
+
+void AttributeTransfer::init_source() {
+    const size_t dim = m_source->get_dim();
+    const size_t num_vertices = m_source->get_num_vertices();
+    const size_t num_faces = m_source->get_num_faces();
+    if (m_source->get_vertex_per_face() != 3) {
+        throw NotImplementedError(
+                "Attribute transfer only supports triangle source mesh");
+    }
+    if (num_faces == 0) {
+        throw RuntimeError("Source mesh has no faces.");
+    }
+
+    m_source_vertices = MatrixFr::Zero(num_vertices, 3);
+    m_source_vertices.leftCols(dim) = m_source->get_vertex_matrix();
+    m_source_faces = m_source->get_face_matrix();
+
+    m_face_centroids.resize(num_faces);
+    m_face_order.resize(num_faces);
+    for (size_t i=0; i<num_faces; i++) {
+        m_face_centroids[i] = (
+                m_source_vertices.row(m_source_faces(i, 0)) +
+                m_source_vertices.row(m_source_faces(i, 1)) +
+                m_source_vertices.row(m_source_faces(i, 2))).transpose() / 3.0;
+        m_face_order[i] = i;
+    }
+
+    m_nodes.clear();
+    m_nodes.reserve(2 * num_faces / MAX_LEAF_SIZE + 1);
+    build_tree(0, num_faces);
+}
+
+int AttributeTransfer::build_tree(int begin, int end) {
+    Node node;
+    node.bbox_min.setConstant(std::numeric_limits<Float>::max());
+    node.bbox_max.setConstant(std::numeric_limits<Float>::lowest());
+    Vector3F centroid_min = node.bbox_min;
+    Vector3F centroid_max = node.bbox_max;
+    for (int i=begin; i<end; i++) {
+        const int fi = m_face_order[i];
+        for (size_t j=0; j<3; j++) {
+            const Vector3F v =
+                m_source_vertices.row(m_source_faces(fi, j)).transpose();
+            node.bbox_min = node.bbox_min.cwiseMin(v);
+            node.bbox_max = node.bbox_max.cwiseMax(v);
+        }
+        centroid_min = centroid_min.cwiseMin(m_face_centroids[fi]);
+        centroid_max = centroid_max.cwiseMax(m_face_centroids[fi]);
+    }
+    node.left = -1;
+    node.right = -1;
+    node.begin = begin;
+    node.end = end;
+
+    const int node_index = m_nodes.size();
+    m_nodes.push_back(node);
+    if (end - begin <= MAX_LEAF_SIZE) return node_index;
+
+    size_t axis;
+    (centroid_max - centroid_min).maxCoeff(&axis);
+    const int mid = (begin + end) / 2;
+    std::nth_element(m_face_order.begin() + begin,
+            m_face_order.begin() + mid,
+            m_face_order.begin() + end,
+            [&](int f0, int f1) {
+                const Float c0 = m_face_centroids[f0][axis];
+                const Float c1 = m_face_centroids[f1][axis];
+                return c0 < c1 || (c0 == c1 && f0 < f1);
+            });
+
+    const int left = build_tree(begin, mid);
+    const int right = build_tree(mid, end);
+    m_nodes[node_index].left = left;
+    m_nodes[node_index].right = right;
+    return node_index;
+}
+
+MatrixFr AttributeTransfer::get_target_vertices() const {
+    const size_t dim = m_target->get_dim();
+    const size_t num_vertices = m_target->get_num_vertices();
+    MatrixFr vertices = MatrixFr::Zero(num_vertices, 3);
+    vertices.leftCols(dim) = m_target->get_vertex_matrix();
+    return vertices;
+}
+
+AttributeTransfer::ClosestPoint AttributeTransfer::lookup(
+        const Vector3F& p) const {
+    // Ties are broken by face index so the result does not depend on
+    // traversal order.
+    ClosestPoint result;
+    result.face = -1;
+    result.squared_distance = std::numeric_limits<Float>::max();
+
+    ClosestPoint candidate;
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (compute_box_squared_distance(p, node.bbox_min, node.bbox_max) >
+                result.squared_distance) {
+            continue;
+        }
+
+        if (node.left < 0) {
+            for (int i=node.begin; i<node.end; i++) {
+                const int fi = m_face_order[i];
+                project(p, fi, candidate);
+                if (candidate.squared_distance < result.squared_distance ||
+                        (candidate.squared_distance == result.squared_distance
+                         && fi < result.face)) {
+                    result = candidate;
+                }
+            }
+        } else {
+            const Node& left = m_nodes[node.left];
+            const Node& right = m_nodes[node.right];
+            const Float left_dist = compute_box_squared_distance(
+                    p, left.bbox_min, left.bbox_max);
+            const Float right_dist = compute_box_squared_distance(
+                    p, right.bbox_min, right.bbox_max);
+            // Visit the closer child first.
+            if (left_dist <= right_dist) {
+                stack.push_back(node.right);
+                stack.push_back(node.left);
+            } else {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+    assert(result.face >= 0);
+    return result;
+}
+
+void AttributeTransfer::project(const Vector3F& p, int face,
+        ClosestPoint& result) const {
+    const Vector3F v0 = m_source_vertices.row(m_source_faces(face, 0)).transpose();
+    const Vector3F v1 = m_source_vertices.row(m_source_faces(face, 1)).transpose();
+    const Vector3F v2 = m_source_vertices.row(m_source_faces(face, 2)).transpose();
+    result.face = face;
+    result.barycentric_coord = compute_closest_barycentric_coord(p, v0, v1, v2);
+    const Vector3F& b = result.barycentric_coord;
+    result.squared_distance = (b[0] * v0 + b[1] * v1 + b[2] * v2 - p).squaredNorm();
+}
+
+size_t AttributeTransfer::get_source_stride(const std::string& name,
+        size_t num_source_elements) const {
+    const size_t attr_size = m_source->get_attribute_view(name).size();
+    if (num_source_elements == 0 || attr_size % num_source_elements != 0) {
+        std::stringstream err_msg;
+        err_msg << "Attribute \"" << name << "\" has size " << attr_size
+            << ", which is not a multiple of " << num_source_elements;
+        throw RuntimeError(err_msg.str());
+    }
+    return attr_size / num_source_elements;
+}
+
+void AttributeTransfer::store_target_attribute(const std::string& name,
+        VectorF& values) {
+    if (!m_target->has_attribute(name)) {
+        m_target->add_empty_attribute(name);
+    }
+    m_target->adopt_attribute(name, values);
+}
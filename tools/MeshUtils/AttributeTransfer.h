@@ -0,0 +1,110 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Core/EigenTypedef.h>
+#include <Mesh.h>
+
+namespace PyMesh {
+
+/**
+ * Transfer attributes from a source triangle mesh onto a target mesh.
+ *
+ * The closest point lookup uses an AABB tree built over the source faces.
+ * BVHEngine is not used: its backends are optional third party libraries,
+ * and the IGL backend links against MeshUtils.  The tree here also breaks
+ * ties by face index, so results do not depend on traversal order.
+ *
+ * Queries and interpolation are done in a single parallel pass.  Results are
+ * then adopted by the target mesh, replacing any existing attribute values.
+ */
+class AttributeTransfer {
+    public:
+        typedef std::shared_ptr<AttributeTransfer> Ptr;
+
+        /**
+         * NEAREST:       value of the nearest source element.
+         * BARYCENTRIC:   linear interpolation at the closest point.
+         * AREA_WEIGHTED: face values averaged over the target face using
+         *                uniformly distributed samples.
+         */
+        enum Mode {
+            NEAREST,
+            BARYCENTRIC,
+            AREA_WEIGHTED
+        };
+
+    public:
+        AttributeTransfer(Mesh::Ptr source, Mesh::Ptr target);
+
+    public:
+        /**
+         * Target faces are split into 4^level sub-triangles in
+         * AREA_WEIGHTED mode, one sample per sub-triangle.  Default is 2.
+         */
+        void set_area_sampling_level(size_t level) {
+            m_area_sampling_level = level;
+        }
+
+        /**
+         * Supported modes: NEAREST, BARYCENTRIC.
+         */
+        void transfer_vertex_attribute(const std::string& name,
+                Mode mode=BARYCENTRIC);
+
+        /**
+         * Supported modes: NEAREST, AREA_WEIGHTED.
+         */
+        void transfer_face_attribute(const std::string& name,
+                Mode mode=NEAREST);
+
+        /**
+         * Per-vertex per-face attribute.  Each target face is matched to the
+         * source face closest to its centroid, and its corners are projected
+         * onto the matched face.  Supported modes: NEAREST, BARYCENTRIC.
+         */
+        void transfer_corner_attribute(const std::string& name,
+                Mode mode=BARYCENTRIC);
+
+    private:
+        struct Node {
+            Vector3F bbox_min;
+            Vector3F bbox_max;
+            int left;
+            int right;
+            int begin;
+            int end;
+        };
+
+        struct ClosestPoint {
+            int face;
+            Float squared_distance;
+            Vector3F barycentric_coord;
+        };
+
+        void init_source();
+        int build_tree(int begin, int end);
+        MatrixFr get_target_vertices() const;
+        ClosestPoint lookup(const Vector3F& p) const;
+        void project(const Vector3F& p, int face, ClosestPoint& result) const;
+
+        size_t get_source_stride(const std::string& name,
+                size_t num_source_elements) const;
+        void store_target_attribute(const std::string& name, VectorF& values);
+
+    private:
+        Mesh::Ptr m_source;
+        Mesh::Ptr m_target;
+        size_t m_area_sampling_level;
+
+        MatrixFr m_source_vertices;
+        MatrixIr m_source_faces;
+        std::vector<Node> m_nodes;
+        std::vector<int> m_face_order;
+        std::vector<Vector3F> m_face_centroids;
+};
+
+}
@@ -3,11 +3,8 @@
 #include <algorithm>
 #include <cassert>
 #include <vector>
-#include <set>
 
 #include <Mesh.h>
-#include <Misc/Multiplet.h>
-#include <Misc/MultipletMap.h>
 
 using namespace PyMesh;
 
@@ -43,46 +40,17 @@ VectorI BoundaryEdges::get_boundary_nodes() const {
 }
 
 void BoundaryEdges::extract_boundary(const Mesh& mesh) {
-    typedef Duplet Edge;
-    typedef DupletMap<size_t> EdgeFaceMap;
-    EdgeFaceMap edge_face_map;
-
-    const size_t num_vertex_per_face = mesh.get_vertex_per_face();
-    const size_t num_faces = mesh.get_num_faces();
-
-    for (size_t i=0; i<num_faces; i++) {
-        const VectorI face = mesh.get_face(i);
-        for (size_t j=0; j<num_vertex_per_face; j++) {
-            auto v0 = face[j];
-            auto v1 = face[(j+1) % num_vertex_per_face];
-            edge_face_map.insert({v0, v1}, i);
-        }
-    }
-
-    std::vector<size_t> boundaries;
-    std::vector<size_t> boundary_faces;
-    for (EdgeFaceMap::const_iterator itr=edge_face_map.begin();
-            itr != edge_face_map.end(); itr++) {
-        if (itr->second.size() == 1) {
-            boundaries.push_back(itr->first.get_ori_data()[0]);
-            boundaries.push_back(itr->first.get_ori_data()[1]);
-            boundary_faces.push_back(itr->second[0]);
-        }
-    }
-
-    m_boundaries.resize(boundaries.size() / 2, 2);
-    std::copy(boundaries.begin(), boundaries.end(), m_boundaries.data());
-    m_boundary_faces.resize(boundary_faces.size());
-    std::copy(boundary_faces.begin(), boundary_faces.end(),
-            m_boundary_faces.data());
+    m_boundaries = mesh.get_boundary_edges();
+    m_boundary_faces = mesh.get_boundary_edge_faces();
 }
 
 void BoundaryEdges::extract_boundary_nodes() {
-    size_t num_entries = m_boundaries.rows() * m_boundaries.cols();
-    std::set<size_t> vertex_set(m_boundaries.data(),
+    const size_t num_entries = m_boundaries.size();
+    std::vector<int> nodes(m_boundaries.data(),
             m_boundaries.data() + num_entries);
-    m_boundary_nodes.resize(vertex_set.size());
-    std::copy(vertex_set.begin(), vertex_set.end(),
-            m_boundary_nodes.data());
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+    m_boundary_nodes.resize(nodes.size());
+    std::copy(nodes.begin(), nodes.end(), m_boundary_nodes.data());
 }
 
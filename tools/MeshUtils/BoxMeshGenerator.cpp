@@ -0,0 +1,387 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include "BoxMeshGenerator.h"
+
+#include <limits>
+#include <sstream>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <Core/Exception.h>
+#include <Misc/Profiler.h>
+
+#include "DuplicatedVertexRemoval.h"
+
+using namespace PyMesh;
+
+namespace BoxMeshGeneratorHelper {
+    const int quad_to_tris[2][3] = {
+        {0, 1, 2}, {0, 2, 3}
+    };
+
+    // Local vertex 4 is the quad center.
+    const int quad_to_tris_symmetric[4][3] = {
+        {0, 1, 4}, {1, 2, 4}, {2, 3, 4}, {3, 0, 4}
+    };
+
+    const int hex_to_tets[6][4] = {
+        {0, 3, 7, 6},
+        {0, 3, 6, 2},
+        {0, 2, 6, 1},
+        {5, 0, 6, 1},
+        {5, 0, 4, 6},
+        {6, 0, 4, 7}
+    };
+
+    // Local vertices 8 to 13 are the centers of the bottom, top, right, left,
+    // front and back faces, and 14 is the hex center.
+    const int hex_to_tets_symmetric[24][4] = {
+        { 0,  1,  8, 14}, { 1,  2,  8, 14}, { 2,  3,  8, 14}, { 3,  0,  8, 14},
+        { 5,  4,  9, 14}, { 4,  7,  9, 14}, { 7,  6,  9, 14}, { 6,  5,  9, 14},
+        { 2,  1, 10, 14}, { 1,  5, 10, 14}, { 5,  6, 10, 14}, { 6,  2, 10, 14},
+        { 0,  3, 11, 14}, { 3,  7, 11, 14}, { 7,  4, 11, 14}, { 4,  0, 11, 14},
+        { 0,  4, 12, 14}, { 4,  5, 12, 14}, { 5,  1, 12, 14}, { 1,  0, 12, 14},
+        { 3,  2, 13, 14}, { 2,  6, 13, 14}, { 6,  7, 13, 14}, { 7,  3, 13, 14}
+    };
+
+    /**
+     * Interpolate in a form that reproduces both ends exactly.
+     */
+    inline Float lerp(Float min, Float max, Float t) {
+        return min * (1.0 - t) + max * t;
+    }
+
+    void check_num_vertices(size_t num_vertices) {
+        if (num_vertices > size_t(std::numeric_limits<int>::max())) {
+            std::stringstream err_msg;
+            err_msg << "Box mesh with " << num_vertices
+                << " vertices exceeds the index range.";
+            throw RuntimeError(err_msg.str());
+        }
+    }
+}
+
+using namespace BoxMeshGeneratorHelper;
+
+BoxMeshGenerator::BoxMeshGenerator(const VectorF& box_min,
+        const VectorF& box_max, const VectorI& num_cells)
+    : m_box_min(box_min), m_box_max(box_max), m_num_cells(num_cells),
+      m_subdiv_order(0) {
+    const size_t dim = m_box_min.size();
+    if (dim != 2 && dim != 3) {
+        throw NotImplementedError("Only 2D and 3D boxes are supported.");
+    }
+    if (size_t(m_box_max.size()) != dim || size_t(m_num_cells.size()) != dim) {
+        throw RuntimeError("Box corners and cell counts must have the same dimension.");
+    }
+    if (m_num_cells.minCoeff() <= 0) {
+        throw RuntimeError("Number of cells must be positive.");
+    }
+}
+
+void BoxMeshGenerator::run(ElementType type) {
+    PYMESH_PROFILE_ZONE("BoxMeshGenerator::run");
+    if (m_box_min.size() == 2) {
+        generate_2D(type);
+    } else {
+        generate_3D(type);
+    }
+}
+
+void BoxMeshGenerator::generate_2D(ElementType type) {
+    const size_t scale = size_t(1) << m_subdiv_order;
+    const size_t nx = m_num_cells[0] * scale;
+    const size_t ny = m_num_cells[1] * scale;
+    const size_t num_cells = nx * ny;
+    const bool symmetric = type == SYMMETRIC_SIMPLEX;
+
+    const size_t num_grid_vertices = (nx+1) * (ny+1);
+    const size_t num_vertices = num_grid_vertices +
+        (symmetric ? num_cells : 0);
+    check_num_vertices(num_vertices);
+
+    size_t elem_per_cell, vertex_per_elem;
+    switch (type) {
+        case SIMPLEX:
+            elem_per_cell = 2;
+            vertex_per_elem = 3;
+            break;
+        case SYMMETRIC_SIMPLEX:
+            elem_per_cell = 4;
+            vertex_per_elem = 3;
+            break;
+        case CUBE:
+            elem_per_cell = 1;
+            vertex_per_elem = 4;
+            break;
+        default:
+            throw NotImplementedError("Unknown element type.");
+    }
+
+    const VectorF& bmin = m_box_min;
+    const VectorF& bmax = m_box_max;
+    auto set_vertex = [&](size_t row, Float x, Float y) {
+        m_vertices(row, 0) = lerp(bmin[0], bmax[0], x / nx);
+        m_vertices(row, 1) = lerp(bmin[1], bmax[1], y / ny);
+    };
+
+    m_vertices.resize(num_vertices, 2);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, nx+1),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i<r.end(); i++) {
+                    for (size_t j=0; j<=ny; j++) {
+                        set_vertex(i*(ny+1)+j, i, j);
+                    }
+                    if (symmetric && i < nx) {
+                        for (size_t j=0; j<ny; j++) {
+                            set_vertex(num_grid_vertices + i*ny+j,
+                                    i+0.5, j+0.5);
+                        }
+                    }
+                }
+            });
+
+    m_elements.resize(num_cells * elem_per_cell, vertex_per_elem);
+    m_cell_index.resize(num_cells * elem_per_cell);
+    const size_t coarse_ny = m_num_cells[1];
+    const size_t order = m_subdiv_order;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_cells),
+            [&](const tbb::blocked_range<size_t>& r) {
+                int corners[5];
+                for (size_t ci=r.begin(); ci<r.end(); ci++) {
+                    const size_t i = ci / ny;
+                    const size_t j = ci % ny;
+                    corners[0] = i*(ny+1)+j;
+                    corners[1] = (i+1)*(ny+1)+j;
+                    corners[2] = (i+1)*(ny+1)+j+1;
+                    corners[3] = i*(ny+1)+j+1;
+                    corners[4] = num_grid_vertices + ci;
+
+                    const int cell_index =
+                        (i >> order) * coarse_ny + (j >> order);
+                    const size_t base = ci * elem_per_cell;
+                    for (size_t t=0; t<elem_per_cell; t++) {
+                        for (size_t l=0; l<vertex_per_elem; l++) {
+                            int local;
+                            switch (type) {
+                                case SIMPLEX:
+                                    local = quad_to_tris[t][l];
+                                    break;
+                                case SYMMETRIC_SIMPLEX:
+                                    local = quad_to_tris_symmetric[t][l];
+                                    break;
+                                default:
+                                    local = l;
+                            }
+                            m_elements(base+t, l) = corners[local];
+                        }
+                        m_cell_index[base+t] = cell_index;
+                    }
+                }
+            });
+}
+
+void BoxMeshGenerator::generate_3D(ElementType type) {
+    const size_t scale = size_t(1) << m_subdiv_order;
+    const size_t nx = m_num_cells[0] * scale;
+    const size_t ny = m_num_cells[1] * scale;
+    const size_t nz = m_num_cells[2] * scale;
+    const size_t num_cells = nx * ny * nz;
+    const bool symmetric = type == SYMMETRIC_SIMPLEX;
+
+    // Vertices are stored in blocks: lattice points, then the centers of
+    // faces orthogonal to X, Y and Z, then cell centers.  Face and cell
+    // centers are only generated for the symmetric split.
+    const size_t num_grid_vertices = (nx+1) * (ny+1) * (nz+1);
+    const size_t x_face_offset = num_grid_vertices;
+    const size_t y_face_offset = x_face_offset + (nx+1) * ny * nz;
+    const size_t z_face_offset = y_face_offset + nx * (ny+1) * nz;
+    const size_t center_offset = z_face_offset + nx * ny * (nz+1);
+    const size_t num_vertices = symmetric ?
+        center_offset + num_cells : num_grid_vertices;
+    check_num_vertices(num_vertices);
+
+    size_t elem_per_cell, vertex_per_elem;
+    switch (type) {
+        case SIMPLEX:
+            elem_per_cell = 6;
+            vertex_per_elem = 4;
+            break;
+        case SYMMETRIC_SIMPLEX:
+            elem_per_cell = 24;
+            vertex_per_elem = 4;
+            break;
+        case CUBE:
+            elem_per_cell = 1;
+            vertex_per_elem = 8;
+            break;
+        default:
+            throw NotImplementedError("Unknown element type.");
+    }
+
+    const VectorF& bmin = m_box_min;
+    const VectorF& bmax = m_box_max;
+    auto set_vertex = [&](size_t row, Float x, Float y, Float z) {
+        m_vertices(row, 0) = lerp(bmin[0], bmax[0], x / nx);
+        m_vertices(row, 1) = lerp(bmin[1], bmax[1], y / ny);
+        m_vertices(row, 2) = lerp(bmin[2], bmax[2], z / nz);
+    };
+
+    m_vertices.resize(num_vertices, 3);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, nx+1),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i<r.end(); i++) {
+                    for (size_t j=0; j<=ny; j++) {
+                        for (size_t k=0; k<=nz; k++) {
+                            set_vertex((i*(ny+1)+j)*(nz+1)+k, i, j, k);
+                        }
+                    }
+                    if (!symmetric) continue;
+                    for (size_t j=0; j<ny; j++) {
+                        for (size_t k=0; k<nz; k++) {
+                            set_vertex(x_face_offset + (i*ny+j)*nz+k,
+                                    i, j+0.5, k+0.5);
+                        }
+                    }
+                    if (i == nx) continue;
+                    for (size_t j=0; j<=ny; j++) {
+                        for (size_t k=0; k<nz; k++) {
+                            set_vertex(y_face_offset + (i*(ny+1)+j)*nz+k,
+                                    i+0.5, j, k+0.5);
+                        }
+                    }
+                    for (size_t j=0; j<ny; j++) {
+                        for (size_t k=0; k<=nz; k++) {
+                            set_vertex(z_face_offset + (i*ny+j)*(nz+1)+k,
+                                    i+0.5, j+0.5, k);
+                        }
+                        for (size_t k=0; k<nz; k++) {
+                            set_vertex(center_offset + (i*ny+j)*nz+k,
+                                    i+0.5, j+0.5, k+0.5);
+                        }
+                    }
+                }
+            });
+
+    m_elements.resize(num_cells * elem_per_cell, vertex_per_elem);
+    m_cell_index.resize(num_cells * elem_per_cell);
+    const size_t coarse_ny = m_num_cells[1];
+    const size_t coarse_nz = m_num_cells[2];
+    const size_t order = m_subdiv_order;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_cells),
+            [&](const tbb::blocked_range<size_t>& r) {
+                int corners[15];
+                for (size_t ci=r.begin(); ci<r.end(); ci++) {
+                    const size_t i = ci / (ny*nz);
+                    const size_t j = (ci / nz) % ny;
+                    const size_t k = ci % nz;
+                    auto grid = [&](size_t a, size_t b, size_t c) {
+                        return int((a*(ny+1)+b)*(nz+1)+c);
+                    };
+                    corners[0] = grid(i  , j  , k  );
+                    corners[1] = grid(i+1, j  , k  );
+                    corners[2] = grid(i+1, j+1, k  );
+                    corners[3] = grid(i  , j+1, k  );
+                    corners[4] = grid(i  , j  , k+1);
+                    corners[5] = grid(i+1, j  , k+1);
+                    corners[6] = grid(i+1, j+1, k+1);
+                    corners[7] = grid(i  , j+1, k+1);
+                    if (symmetric) {
+                        corners[ 8] = z_face_offset + (i*ny+j)*(nz+1)+k;
+                        corners[ 9] = z_face_offset + (i*ny+j)*(nz+1)+k+1;
+                        corners[10] = x_face_offset + ((i+1)*ny+j)*nz+k;
+                        corners[11] = x_face_offset + (i*ny+j)*nz+k;
+                        corners[12] = y_face_offset + (i*(ny+1)+j)*nz+k;
+                        corners[13] = y_face_offset + (i*(ny+1)+j+1)*nz+k;
+                        corners[14] = center_offset + ci;
+                    }
+
+                    const int cell_index =
+                        ((i >> order) * coarse_ny + (j >> order))
+                        * coarse_nz + (k >> order);
+                    const size_t base = ci * elem_per_cell;
+                    for (size_t t=0; t<elem_per_cell; t++) {
+                        for (size_t l=0; l<vertex_per_elem; l++) {
+                            int local;
+                            switch (type) {
+                                case SIMPLEX:
+                                    local = hex_to_tets[t][l];
+                                    break;
+                                case SYMMETRIC_SIMPLEX:
+                                    local = hex_to_tets_symmetric[t][l];
+                                    break;
+                                default:
+                                    local = l;
+                            }
+                            m_elements(base+t, l) = corners[local];
+                        }
+                        m_cell_index[base+t] = cell_index;
+                    }
+                }
+            });
+}
+
+HexToTet::HexToTet(const MatrixFr& vertices, const MatrixIr& hexes)
+    : m_vertices(vertices), m_hexes(hexes) {
+    if (m_vertices.cols() != 3 || m_hexes.cols() != 8) {
+        throw RuntimeError("HexToTet expects a 3D hex mesh.");
+    }
+}
+
+void HexToTet::run(bool keep_symmetry, size_t subdiv_order) {
+    PYMESH_PROFILE_ZONE("HexToTet::run");
+    // Split the unit cube once and map the result into every hex by
+    // trilinear interpolation.  This reproduces recursive midpoint
+    // subdivision exactly since the map is multilinear.
+    Vector3F unit_min(0, 0, 0);
+    Vector3F unit_max(1, 1, 1);
+    Vector3I unit_cells(1, 1, 1);
+    BoxMeshGenerator generator(unit_min, unit_max, unit_cells);
+    generator.set_subdiv_order(subdiv_order);
+    generator.run(keep_symmetry ?
+            BoxMeshGenerator::SYMMETRIC_SIMPLEX : BoxMeshGenerator::SIMPLEX);
+    const MatrixFr& ref_vertices = generator.get_vertices();
+    const MatrixIr& ref_tets = generator.get_elements();
+
+    const size_t num_hexes = m_hexes.rows();
+    const size_t num_ref_vertices = ref_vertices.rows();
+    const size_t num_ref_tets = ref_tets.rows();
+    BoxMeshGeneratorHelper::check_num_vertices(num_hexes * num_ref_vertices);
+
+    MatrixFr vertices(num_hexes * num_ref_vertices, 3);
+    MatrixIr tets(num_hexes * num_ref_tets, 4);
+    m_cell_index.resize(num_hexes * num_ref_tets);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_hexes),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i<r.end(); i++) {
+                    const auto hex = m_hexes.row(i);
+                    for (size_t j=0; j<num_ref_vertices; j++) {
+                        const Float u = ref_vertices(j, 0);
+                        const Float v = ref_vertices(j, 1);
+                        const Float w = ref_vertices(j, 2);
+                        const Float weights[8] = {
+                            (1-u)*(1-v)*(1-w), u*(1-v)*(1-w),
+                            u*v*(1-w), (1-u)*v*(1-w),
+                            (1-u)*(1-v)*w, u*(1-v)*w,
+                            u*v*w, (1-u)*v*w
+                        };
+                        Vector3F p = Vector3F::Zero();
+                        for (size_t l=0; l<8; l++) {
+                            p += weights[l] *
+                                m_vertices.row(hex[l]).transpose();
+                        }
+                        vertices.row(i*num_ref_vertices+j) = p.transpose();
+                    }
+                    const int offset = i * num_ref_vertices;
+                    tets.block(i*num_ref_tets, 0, num_ref_tets, 4) =
+                        ref_tets.array() + offset;
+                    m_cell_index.segment(i*num_ref_tets, num_ref_tets)
+                        .setConstant(i);
+                }
+            });
+
+    DuplicatedVertexRemoval remover(vertices, tets);
+    remover.run(1e-12);
+    m_tet_vertices = remover.get_vertices();
+    m_tets = remover.get_faces();
+}
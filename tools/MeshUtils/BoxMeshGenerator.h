@@ -0,0 +1,101 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+#include <Core/EigenTypedef.h>
+
+namespace PyMesh {
+
+/**
+ * Structured mesh of an axis-aligned box in 2D or 3D.  The box is split into
+ * num_cells[0] x num_cells[1] (x num_cells[2]) cells, and each cell is
+ * subdivided 2^subdiv_order times along each axis.  Vertex and element
+ * indices are closed-form functions of the grid coordinates, and no
+ * duplicated vertices are ever created.
+ *
+ * Element types per (sub)cell:
+ *   * SIMPLEX: 2 triangles or 6 tets.
+ *   * SYMMETRIC_SIMPLEX: 4 triangles or 24 tets around the cell center,
+ *     respecting all reflective symmetries of the cell.
+ *   * CUBE: 1 quad or 1 hex.
+ *
+ * Corner ordering:
+ *         7 _______ 6
+ *          /:     /|        z
+ *       4 /______/ |        |
+ *        |  :   5| |        |  y
+ *        |  :... |.|        | /
+ *        | . 3   | /2       |/
+ *        |_______|/         /-------x
+ *        0        1
+ */
+class BoxMeshGenerator {
+    public:
+        enum ElementType {
+            SIMPLEX=0,
+            SYMMETRIC_SIMPLEX=1,
+            CUBE=2
+        };
+
+    public:
+        BoxMeshGenerator(const VectorF& box_min, const VectorF& box_max,
+                const VectorI& num_cells);
+
+    public:
+        void set_subdiv_order(size_t order) { m_subdiv_order = order; }
+        void run(ElementType type);
+
+        const MatrixFr& get_vertices() const { return m_vertices; }
+
+        /**
+         * Triangles/quads in 2D, tets/hexes in 3D.
+         */
+        const MatrixIr& get_elements() const { return m_elements; }
+
+        /**
+         * Index of the (unsubdivided) cell each element belongs to.  Cells
+         * are ordered with z varying fastest.
+         */
+        const VectorI& get_cell_index() const { return m_cell_index; }
+
+    private:
+        void generate_2D(ElementType type);
+        void generate_3D(ElementType type);
+
+    private:
+        VectorF m_box_min;
+        VectorF m_box_max;
+        VectorI m_num_cells;
+        size_t m_subdiv_order;
+        MatrixFr m_vertices;
+        MatrixIr m_elements;
+        VectorI m_cell_index;
+};
+
+/**
+ * Split each hex of a hex mesh into tets.  Hexes are first subdivided
+ * 2^subdiv_order times along each axis by trilinear interpolation.
+ * Vertices shared by neighboring hexes are merged.
+ */
+class HexToTet {
+    public:
+        HexToTet(const MatrixFr& vertices, const MatrixIr& hexes);
+
+    public:
+        void run(bool keep_symmetry, size_t subdiv_order=0);
+
+        const MatrixFr& get_vertices() const { return m_tet_vertices; }
+        const MatrixIr& get_voxels() const { return m_tets; }
+
+        /**
+         * Index of the hex each tet belongs to.
+         */
+        const VectorI& get_cell_index() const { return m_cell_index; }
+
+    private:
+        MatrixFr m_vertices;
+        MatrixIr m_hexes;
+        MatrixFr m_tet_vertices;
+        MatrixIr m_tets;
+        VectorI m_cell_index;
+};
+
+}
@@ -101,16 +101,18 @@ std::vector<VectorI> EdgeUtils::chain_edges(const MatrixIr& edges) {
     return chains;
 }
 
-DupletMap<size_t> EdgeUtils::compute_edge_face_adjacency(const MatrixIr& faces) {
-    DupletMap<size_t> adjacency;
+DupletIndex<size_t> EdgeUtils::compute_edge_face_adjacency(const MatrixIr& faces) {
     const size_t num_faces = faces.rows();
     const size_t vertex_per_face = faces.cols();
+    std::vector<Duplet> edges(num_faces * vertex_per_face);
+    std::vector<size_t> adj_faces(num_faces * vertex_per_face);
     for (size_t i=0; i<num_faces; i++) {
         const auto& f = faces.row(i);
         for (size_t j=0; j<vertex_per_face; j++) {
-            adjacency.insert({f[j], f[(j+1)%vertex_per_face]}, i);
+            edges[i*vertex_per_face+j] = {f[j], f[(j+1)%vertex_per_face]};
+            adj_faces[i*vertex_per_face+j] = i;
         }
     }
-    return adjacency;
+    return DupletIndex<size_t>(edges, adj_faces);
 }
 
@@ -4,7 +4,7 @@
 #include <Core/EigenTypedef.h>
 
 #include <vector>
-#include <Misc/MultipletMap.h>
+#include <Misc/MultipletIndex.h>
 
 namespace PyMesh {
 namespace EdgeUtils {
@@ -14,6 +14,9 @@ namespace EdgeUtils {
      */
     std::vector<VectorI> chain_edges(const MatrixIr& edges);
 
-    DupletMap<size_t> compute_edge_face_adjacency(const MatrixIr& faces);
+    /**
+     * Faces adjacent to each undirected edge, in increasing face order.
+     */
+    DupletIndex<size_t> compute_edge_face_adjacency(const MatrixIr& faces);
 }
 }
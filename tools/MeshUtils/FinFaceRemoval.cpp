@@ -6,7 +6,7 @@
 
 #include <Core/Exception.h>
 #include <Misc/Multiplet.h>
-#include <Misc/MultipletMap.h>
+#include <Misc/MultipletIndex.h>
 
 using namespace PyMesh;
 
@@ -75,12 +75,13 @@ size_t FinFaceRemoval::run() {
     }
 
     const size_t num_faces = m_faces.rows();
-    TripletMap<size_t> face_index_map;
+    TripletIndex<size_t> face_index_map;
     for (size_t i=0; i<num_faces; i++) {
         const VectorI& f = m_faces.row(i);
         Triplet key(f[0], f[1], f[2]);
         face_index_map.insert(key, i);
     }
+    face_index_map.build();
 
     std::list<int> face_list;
     std::list<size_t> face_indices;
@@ -94,7 +95,7 @@ size_t FinFaceRemoval::run() {
         }
         Triplet key(f[0], f[1], f[2]);
 
-        const auto& indices = face_index_map[key];
+        const auto indices = face_index_map.get(key);
         size_t correctly_orientated_fid = std::numeric_limits<size_t>::max();
         const int majority_orientation = compute_majority_orientation(
                 m_faces, indices, correctly_orientated_fid);
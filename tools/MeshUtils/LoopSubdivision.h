@@ -2,44 +2,32 @@
 #pragma once
 #include "Subdivision.h"
 
-#include <map>
 #include <vector>
 
-#include <Math/ZSparseMatrix.h>
-#include <Misc/Multiplet.h>
-
 namespace PyMesh {
 
 class LoopSubdivision : public Subdivision {
     public:
         virtual ~LoopSubdivision() {}
 
-        virtual void subdivide(MatrixFr vertices, MatrixIr faces,
-                size_t num_iterations);
-
-        virtual const std::vector<ZSparseMatrix>& get_subdivision_matrices() const {
-            return m_subdivision_matrices;
-        }
-
     protected:
-        void subdivide_once();
-        void initialize_face_indices();
-        void extract_edges();
-        void compute_vertex_valance();
-        void extract_sub_faces();
-        void compute_subdivided_vertices();
+        virtual void prepare_stencils();
+        virtual size_t get_stencil_size(size_t row) const;
+        virtual void compute_stencil(size_t row,
+                int* indices, Float* weights) const;
 
-        void register_edges(const VectorI& face, size_t base_index);
+        void compute_vertex_edge_adjacency();
+        void compute_boundary_vertices();
 
-        Float compute_beta(size_t valance);
-        Vector3I get_edge_indices(const VectorI& face);
-        std::vector<bool> compute_boundary_vertices() const;
+        Float compute_beta(size_t valance) const;
+        size_t get_vertex_valance(size_t vi) const {
+            return m_vertex_edge_offsets[vi+1] - m_vertex_edge_offsets[vi];
+        }
 
     protected:
-        std::map<Duplet, size_t> m_edge_index_map;
-        std::map<Duplet, size_t> m_boundary_edge;
-        std::vector<size_t> m_vertex_valance;
-        std::vector<ZSparseMatrix> m_subdivision_matrices;
+        std::vector<int> m_vertex_edge_offsets;
+        std::vector<int> m_vertex_edges;
+        std::vector<char> m_on_boundary;
 };
 
 }
@@ -64,10 +64,11 @@ MatrixIr ManifoldCheck::is_edge_manifold(const MatrixIr& faces) {
     MatrixIr is_manifold(num_faces, vertex_per_face);
     for (size_t i=0; i<num_faces; i++) {
         for (size_t j=0; j<vertex_per_face; j++) {
-            const auto itr = edge_map.find(
+            const size_t edge_index = edge_map.find(
                     {faces(i,j), faces(i,(j+1)%vertex_per_face)});
-            assert(itr != edge_map.end());
-            is_manifold(i,j) = itr->second.size() > 2 ? 0 : 1;
+            assert(edge_index < edge_map.size());
+            is_manifold(i,j) =
+                edge_map.get_values(edge_index).size() > 2 ? 0 : 1;
         }
     }
     return is_manifold;
@@ -1,17 +1,19 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #include "MeshChecker.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <iostream>
 #include <numeric>
 #include <sstream>
-#include <unordered_map>
+
+#include <tbb/tbb.h>
 
 #include <Core/EigenTypedef.h>
 #include <Core/Exception.h>
-#include <Misc/Multiplet.h>
 #include <Math/MatrixUtils.h>
 
-#include "Boundary.h"
 #include "EdgeUtils.h"
 #include "MeshSeparator.h"
 
@@ -20,112 +22,109 @@ using namespace PyMesh;
 MeshChecker::MeshChecker(const MatrixFr& vertices, const MatrixIr& faces,
         const MatrixIr& voxels)
     : m_vertices(vertices), m_faces(faces), m_voxels(voxels) {
-        init_boundary();
+        init_edge_table();
+        sweep_edge_table();
         init_boundary_loops();
-        init_edge_face_adjacency();
+}
+
+MeshChecker::Report MeshChecker::check_all() const {
+    Report report;
+    report.edge_manifold = m_edge_manifold;
+    report.closed = is_closed();
+    report.edge_with_odd_adj_faces = m_edge_with_odd_adj_faces;
+    report.oriented = m_oriented;
+    report.complex_boundary = m_complex_bd;
+    report.num_boundary_edges = get_num_boundary_edges();
+    report.num_boundary_loops = get_num_boundary_loops();
+    report.num_connected_volume_components = 0;
+
+    tbb::task_group tasks;
+    tasks.run([&]() { report.vertex_manifold = is_vertex_manifold(); });
+    tasks.run([&]() {
+            report.euler_characteristic = get_euler_characteristic(); });
+    tasks.run([&]() {
+            report.num_connected_components = get_num_connected_components();
+            });
+    tasks.run([&]() {
+            report.num_connected_surface_components =
+                get_num_connected_surface_components(); });
+    if (m_voxels.rows() > 0) {
+        tasks.run([&]() {
+                report.num_connected_volume_components =
+                    get_num_connected_volume_components(); });
+    }
+    tasks.run([&]() {
+            report.num_isolated_vertices = get_num_isolated_vertices(); });
+    tasks.run([&]() {
+            report.num_duplicated_faces = get_num_duplicated_faces(); });
+    tasks.run([&]() {
+            report.signed_volume = compute_signed_volume_from_surface(); });
+    tasks.wait();
+
+    report.genus = (2 - report.euler_characteristic -
+            int(report.num_boundary_loops)) / 2;
+    return report;
 }
 
 bool MeshChecker::is_vertex_manifold() const {
     const size_t num_vertices = m_vertices.rows();
     const size_t num_faces = m_faces.rows();
     const size_t vertex_per_face = m_faces.cols();
-
-    std::vector<std::vector<VectorI> > opposite_edges(num_vertices);
-    if (vertex_per_face == 3) {
-        for (size_t i=0; i<num_faces; i++) {
-            const auto& f = m_faces.row(i);
-            opposite_edges[f[0]].push_back(Vector2I(f[1], f[2]));
-            opposite_edges[f[1]].push_back(Vector2I(f[2], f[0]));
-            opposite_edges[f[2]].push_back(Vector2I(f[0], f[1]));
-        }
-    } else if (vertex_per_face == 4) {
-        for (size_t i=0; i<num_faces; i++) {
-            const auto& f = m_faces.row(i);
-            opposite_edges[f[0]].push_back(Vector2I(f[1], f[2]));
-            opposite_edges[f[0]].push_back(Vector2I(f[2], f[3]));
-            opposite_edges[f[1]].push_back(Vector2I(f[2], f[3]));
-            opposite_edges[f[1]].push_back(Vector2I(f[3], f[0]));
-            opposite_edges[f[2]].push_back(Vector2I(f[3], f[0]));
-            opposite_edges[f[2]].push_back(Vector2I(f[0], f[1]));
-            opposite_edges[f[3]].push_back(Vector2I(f[0], f[1]));
-            opposite_edges[f[3]].push_back(Vector2I(f[1], f[2]));
-        }
-    } else {
+    if (vertex_per_face != 3 && vertex_per_face != 4) {
         std::stringstream err_msg;
         err_msg << "Vertex manifold check does not support face with "
             << vertex_per_face << " vertices.";
         throw NotImplementedError(err_msg.str());
     }
 
-    for (const auto& entries: opposite_edges) {
-        if (entries.empty()) continue;
-        try {
-            auto edge_loops = EdgeUtils::chain_edges(
-                    MatrixUtils::rowstack(entries));
-            if (edge_loops.size() != 1) return false;
-        } catch (...) {
-            return false;
+    // Opposite edges of each vertex in CSR form.  A triangle contributes one
+    // opposite edge per corner, a quad contributes two.
+    const size_t edges_per_corner = vertex_per_face - 2;
+    std::vector<int> offsets(num_vertices+1, 0);
+    for (size_t i=0; i<num_faces; i++) {
+        for (size_t j=0; j<vertex_per_face; j++) {
+            offsets[m_faces(i, j)+1] += edges_per_corner;
         }
     }
-    return true;
-}
-
-bool MeshChecker::is_edge_manifold() const {
-    for (auto adj : m_edge_face_adjacency) {
-        if (adj.second.size() > 2) {
-            return false;
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    MatrixIr opposite_edges(offsets[num_vertices], 2);
+    std::vector<int> cursor(offsets.begin(), offsets.end()-1);
+    for (size_t i=0; i<num_faces; i++) {
+        const auto& f = m_faces.row(i);
+        for (size_t j=0; j<vertex_per_face; j++) {
+            const int v = f[j];
+            for (size_t k=1; k<=edges_per_corner; k++) {
+                opposite_edges(cursor[v], 0) = f[(j+k) % vertex_per_face];
+                opposite_edges(cursor[v], 1) = f[(j+k+1) % vertex_per_face];
+                cursor[v]++;
+            }
         }
     }
-    return true;
-}
 
-bool MeshChecker::is_oriented() const {
-    // For each edge (s, d), check to see if the number of faces containing
-    // (s, d) as an edge and the number of faces containing (d, s) as an edge
-    // are equal.
-    //
-    // Boundary edges are skipped.
-    const size_t num_vertex_per_face = m_faces.cols();
-    for (auto adj : m_edge_face_adjacency) {
-        if (adj.second.size() == 1) continue;
-
-        const auto& e = adj.first.get_ori_data();
-        if (e[0] == e[1]) {
-            // It is impossible to determine the orientaiton of faces such as
-            // [a, b, b] or [a, a, a].
-            return false;
-        } else {
-            int consistent_count = 0;
-            for (auto fid : adj.second) {
-                VectorI f = m_faces.row(fid);
-                for (size_t i=0; i<num_vertex_per_face; i++) {
-                    if (f[i] == e[0] && f[(i+1)%num_vertex_per_face] == e[1]) {
-                        consistent_count++;
-                    } else if (f[i] == e[1] &&
-                            f[(i+1)%num_vertex_per_face] == e[0]) {
-                        consistent_count--;
+    std::atomic<bool> manifold(true);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_vertices),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    if (!manifold) return;
+                    const int num_entries = offsets[i+1] - offsets[i];
+                    if (num_entries == 0) continue;
+                    try {
+                        auto edge_loops = EdgeUtils::chain_edges(
+                                opposite_edges.middleRows(
+                                    offsets[i], num_entries));
+                        if (edge_loops.size() != 1) manifold = false;
+                    } catch (...) {
+                        manifold = false;
                     }
                 }
-            }
-            if (consistent_count != 0) return false;
-        }
-    }
-    return true;
+            });
+    return manifold;
 }
 
 bool MeshChecker::is_closed() const {
     return m_boundary_edges.rows() == 0;
 }
 
-bool MeshChecker::has_edge_with_odd_adj_faces() const {
-    for (auto adj : m_edge_face_adjacency) {
-        if (adj.second.size() % 2 != 0) {
-            return true;
-        }
-    }
-    return false;
-}
-
 size_t MeshChecker::get_num_boundary_edges() const {
     return m_boundary_edges.rows();
 }
@@ -155,7 +154,7 @@ int MeshChecker::get_euler_characteristic() const {
         num_vertices = std::accumulate(on_surface.begin(),
                 on_surface.end(), 0);
     }
-    const int num_edges = m_edge_face_adjacency.size();
+    const int num_edges = m_edge_offsets.size() - 1;
     const int num_faces = m_faces.rows();
     return num_vertices - num_edges + num_faces;
 }
@@ -200,31 +199,28 @@ size_t MeshChecker::get_num_isolated_vertices() const {
 }
 
 size_t MeshChecker::get_num_duplicated_faces() const {
+    // Faces are identified by (min, max, sum) of their vertex indices.
+    typedef std::array<int, 3> FaceKey;
     const size_t num_faces = m_faces.rows();
-    auto hash_fn = [](const VectorI& key) -> size_t {
-        const size_t size = key.size();
-        size_t hash = 0;
-        for (size_t i=0; i<size; i++)
-            hash += std::hash<int>()(key[i]);
-        return hash;
-    };
-    typedef std::unordered_map<VectorI, size_t, decltype(hash_fn)> FaceMap;
-    FaceMap face_counts( num_faces, hash_fn);
-
-    for (size_t i=0; i<num_faces; i++) {
-        const auto& f = m_faces.row(i);
-        Vector3I key(f.minCoeff(), f.maxCoeff(), f.sum());
-        auto itr = face_counts.find(key);
-        if (itr == face_counts.end()) {
-            face_counts.insert(itr, std::make_pair(key, 1));
-        } else {
-            itr->second ++;
-        }
+    std::vector<FaceKey> keys(num_faces);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_faces),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const auto& f = m_faces.row(i);
+                    keys[i] = {{f.minCoeff(), f.maxCoeff(), f.sum()}};
+                }
+            });
+    tbb::parallel_sort(keys.begin(), keys.end());
+
+    size_t count = 0;
+    size_t i = 0;
+    while (i < num_faces) {
+        size_t j = i+1;
+        while (j < num_faces && keys[j] == keys[i]) j++;
+        if (j - i != 1) count++;
+        i = j;
     }
-
-    return std::count_if(face_counts.begin(), face_counts.end(),
-            [](FaceMap::value_type& p) {
-            return p.second != 1; });
+    return count;
 }
 
 Float MeshChecker::compute_signed_volume_from_surface() const {
@@ -283,10 +279,93 @@ Float MeshChecker::compute_signed_volume_from_surface() const {
     return volume / 6.0;
 }
 
-void MeshChecker::init_boundary() {
-    Boundary::Ptr bd = Boundary::extract_surface_boundary_raw(
-            m_vertices, m_faces);
-    m_boundary_edges = bd->get_boundaries();
+void MeshChecker::init_edge_table() {
+    const size_t num_faces = m_faces.rows();
+    const size_t vertex_per_face = m_faces.cols();
+    const size_t num_half_edges = num_faces * vertex_per_face;
+    m_half_edges.resize(num_half_edges);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_faces),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const auto& f = m_faces.row(i);
+                    for (size_t j=0; j<vertex_per_face; j++) {
+                        const int s = f[j];
+                        const int d = f[(j+1) % vertex_per_face];
+                        m_half_edges[i*vertex_per_face+j] = {
+                            std::min(s, d), std::max(s, d), int(i),
+                            s <= d ? 1 : -1 };
+                    }
+                }
+            });
+    tbb::parallel_sort(m_half_edges.begin(), m_half_edges.end(),
+            [](const HalfEdge& a, const HalfEdge& b) {
+                if (a.v0 != b.v0) return a.v0 < b.v0;
+                if (a.v1 != b.v1) return a.v1 < b.v1;
+                return a.face < b.face;
+            });
+
+    m_edge_offsets.clear();
+    for (size_t i=0; i<num_half_edges; i++) {
+        if (i == 0 ||
+                m_half_edges[i].v0 != m_half_edges[i-1].v0 ||
+                m_half_edges[i].v1 != m_half_edges[i-1].v1) {
+            m_edge_offsets.push_back(i);
+        }
+    }
+    m_edge_offsets.push_back(num_half_edges);
+}
+
+void MeshChecker::sweep_edge_table() {
+    const size_t num_edges = m_edge_offsets.size() - 1;
+    std::atomic<bool> edge_manifold(true);
+    std::atomic<bool> odd_adj_faces(false);
+    std::atomic<bool> oriented(true);
+    std::vector<char> is_boundary(num_edges, 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_edges),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const size_t begin = m_edge_offsets[i];
+                    const size_t end = m_edge_offsets[i+1];
+                    const size_t num_adj_faces = end - begin;
+                    if (num_adj_faces > 2) edge_manifold = false;
+                    if (num_adj_faces % 2 != 0) odd_adj_faces = true;
+                    if (num_adj_faces == 1) {
+                        is_boundary[i] = 1;
+                        continue;
+                    }
+
+                    // Interior edges must be traversed equally often in
+                    // both directions.  It is impossible to determine the
+                    // orientation of faces such as [a, b, b] or [a, a, a].
+                    const auto& e = m_half_edges[begin];
+                    int consistent_count = 0;
+                    for (size_t j=begin; j<end; j++) {
+                        consistent_count += m_half_edges[j].orientation;
+                    }
+                    if (e.v0 == e.v1 || consistent_count != 0) {
+                        oriented = false;
+                    }
+                }
+            });
+    m_edge_manifold = edge_manifold;
+    m_edge_with_odd_adj_faces = odd_adj_faces;
+    m_oriented = oriented;
+
+    // Boundary edges follow the orientation of their adjacent face.
+    const size_t num_bd_edges =
+        std::count(is_boundary.begin(), is_boundary.end(), 1);
+    m_boundary_edges.resize(num_bd_edges, 2);
+    size_t count = 0;
+    for (size_t i=0; i<num_edges; i++) {
+        if (!is_boundary[i]) continue;
+        const auto& e = m_half_edges[m_edge_offsets[i]];
+        if (e.orientation > 0) {
+            m_boundary_edges.row(count) << e.v0, e.v1;
+        } else {
+            m_boundary_edges.row(count) << e.v1, e.v0;
+        }
+        count++;
+    }
 }
 
 void MeshChecker::init_boundary_loops() {
@@ -298,8 +377,3 @@ void MeshChecker::init_boundary_loops() {
         std::cerr << "Warning: " << e.what() << std::endl;
     }
 }
-
-void MeshChecker::init_edge_face_adjacency() {
-    m_edge_face_adjacency = EdgeUtils::compute_edge_face_adjacency(m_faces);
-}
-
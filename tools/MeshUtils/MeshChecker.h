@@ -4,7 +4,6 @@
 #include <vector>
 
 #include <Core/EigenTypedef.h>
-#include <Misc/MultipletMap.h>
 
 namespace PyMesh {
 
@@ -13,6 +12,36 @@ class MeshChecker {
         MeshChecker(const MatrixFr& vertices, const MatrixIr& faces,
                 const MatrixIr& voxels);
 
+    public:
+        /**
+         * Result of running every check at once.
+         */
+        struct Report {
+            bool vertex_manifold;
+            bool edge_manifold;
+            bool closed;
+            bool edge_with_odd_adj_faces;
+            bool oriented;
+            bool complex_boundary;
+            size_t num_boundary_edges;
+            size_t num_boundary_loops;
+            int euler_characteristic;
+            int genus;
+            size_t num_connected_components;
+            size_t num_connected_surface_components;
+            size_t num_connected_volume_components;
+            size_t num_isolated_vertices;
+            size_t num_duplicated_faces;
+            Float signed_volume;
+        };
+
+        /**
+         * Compute all properties below concurrently.  Edge based properties
+         * come from a single sweep over the sorted edge table built at
+         * construction.
+         */
+        Report check_all() const;
+
     public:
         /**
          * Returns true iff 1 ring of every vertex is topologically a disk.
@@ -23,7 +52,7 @@ class MeshChecker {
         /**
          * Return true iff every edge is adjacent to up to 2 faces.
          */
-        bool is_edge_manifold() const;
+        bool is_edge_manifold() const { return m_edge_manifold; }
 
         /**
          * Returns true iff the mesh does not contain any boundary.
@@ -34,7 +63,9 @@ class MeshChecker {
          * Returns true iff the mesh contains edges with odd number of adjacent
          * faces.
          */
-        bool has_edge_with_odd_adj_faces() const;
+        bool has_edge_with_odd_adj_faces() const {
+            return m_edge_with_odd_adj_faces;
+        }
 
         /**
          * A surface is oriented if its normal vector field changes continuously
@@ -45,7 +76,7 @@ class MeshChecker {
          * Note that this method will return true if the surface is oriented but
          * with normals pointing inward.
          */
-        bool is_oriented() const;
+        bool is_oriented() const { return m_oriented; }
 
         /**
          * Returns true iff mesh boundary does not form simple loops.
@@ -90,18 +121,33 @@ class MeshChecker {
         Float compute_signed_volume_from_surface() const;
 
     private:
-        void init_boundary();
+        /**
+         * A face side of an undirected edge (v0, v1) with v0 <= v1.
+         * orientation is +1 if the face traverses v0 -> v1, -1 otherwise.
+         */
+        struct HalfEdge {
+            int v0;
+            int v1;
+            int face;
+            int orientation;
+        };
+
+        void init_edge_table();
+        void sweep_edge_table();
         void init_boundary_loops();
-        void init_edge_face_adjacency();
 
     private:
         MatrixFr m_vertices;
         MatrixIr m_faces;
         MatrixIr m_voxels;
         MatrixIr m_boundary_edges;
-        DupletMap<size_t> m_edge_face_adjacency;
+        std::vector<HalfEdge> m_half_edges;
+        std::vector<size_t> m_edge_offsets;
         std::vector<VectorI> m_boundary_loops;
         bool m_complex_bd;
+        bool m_edge_manifold;
+        bool m_edge_with_odd_adj_faces;
+        bool m_oriented;
 };
 
 }
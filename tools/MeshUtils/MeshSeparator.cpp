@@ -1,65 +1,140 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #include "MeshSeparator.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <list>
-#include <queue>
+
+#include <tbb/tbb.h>
 
 #include <Core/EigenTypedef.h>
 #include <Core/Exception.h>
-#include <Misc/Multiplet.h>
-#include <Misc/MultipletMap.h>
 
 using namespace PyMesh;
 
+namespace MeshSeparatorHelper {
+    /**
+     * Lock-free union-find.  Roots are always linked to the smaller index,
+     * so the root of each set is its smallest element regardless of the
+     * order in which unions are performed.
+     */
+    class UnionFind {
+        public:
+            UnionFind(size_t size) : m_parent(size) {
+                for (size_t i=0; i<size; i++) {
+                    m_parent[i].store(i, std::memory_order_relaxed);
+                }
+            }
+
+            int find(int x) {
+                while (true) {
+                    int p = m_parent[x].load();
+                    if (p == x) return x;
+                    const int gp = m_parent[p].load();
+                    if (gp != p) {
+                        // Path halving.
+                        m_parent[x].compare_exchange_weak(p, gp);
+                    }
+                    x = gp;
+                }
+            }
+
+            void merge(int a, int b) {
+                while (true) {
+                    a = find(a);
+                    b = find(b);
+                    if (a == b) return;
+                    if (a < b) std::swap(a, b);
+                    int expected = a;
+                    if (m_parent[a].compare_exchange_strong(expected, b)) {
+                        return;
+                    }
+                }
+            }
+
+        private:
+            std::vector<std::atomic<int> > m_parent;
+    };
+}
+
+using namespace MeshSeparatorHelper;
+
 MeshSeparator::MeshSeparator(const MatrixIr& elements)
     : m_elements(elements), m_connectivity_type(VERTEX) { }
 
 size_t MeshSeparator::separate() {
-    compute_connectivity();
+    std::vector<Connector> connectors = compute_connectors();
+    tbb::parallel_sort(connectors.begin(), connectors.end());
 
-    m_components.clear();
-    m_sources.clear();
+    // Elements sharing the same connector are adjacent after sorting.
     const size_t num_elements = m_elements.rows();
-    m_visited = std::vector<bool>(num_elements, false);
+    const size_t num_connectors = connectors.size();
+    UnionFind uf(num_elements);
+    tbb::parallel_for(tbb::blocked_range<size_t>(1, std::max<size_t>(num_connectors, 1)),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    if (connectors[i].first == connectors[i-1].first) {
+                        uf.merge(connectors[i].second, connectors[i-1].second);
+                    }
+                }
+            });
 
-    for (size_t i=0; i<num_elements; i++) {
-        if (m_visited[i]) continue;
-        VectorI sources;
-        m_components.push_back(flood(i, sources));
-        m_sources.push_back(sources);
-    }
+    std::vector<int> roots(num_elements);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_elements),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    roots[i] = uf.find(i);
+                }
+            });
 
-    return m_components.size();
+    compute_components(roots);
+    return m_component_offsets.size() - 1;
+}
+
+MatrixIr MeshSeparator::get_component(size_t i) const {
+    const VectorI sources = get_sources(i);
+    const size_t num_sources = sources.size();
+    MatrixIr comp(num_sources, m_elements.cols());
+    for (size_t j=0; j<num_sources; j++) {
+        comp.row(j) = m_elements.row(sources[j]);
+    }
+    return comp;
 }
 
-void MeshSeparator::compute_connectivity() {
+std::vector<MeshSeparator::Connector> MeshSeparator::compute_connectors() const {
+    std::vector<Connector> connectors;
     switch(m_connectivity_type) {
         case VERTEX:
-            compute_vertex_connectivity();
+            compute_vertex_connectors(connectors);
             break;
         case FACE:
-            compute_face_connectivity();
+            compute_face_connectors(connectors);
             break;
         case VOXEL:
-            compute_voxel_connectivity();
+            compute_voxel_connectors(connectors);
             break;
     }
+    return connectors;
 }
 
-void MeshSeparator::compute_vertex_connectivity() {
-    m_vertex_connectivity.clear();
+void MeshSeparator::compute_vertex_connectors(
+        std::vector<Connector>& connectors) const {
     const size_t num_elements = m_elements.rows();
     const size_t vertex_per_element = m_elements.cols();
-    for (size_t i=0; i<num_elements; i++) {
-        for (size_t j=0; j<vertex_per_element; j++) {
-            m_vertex_connectivity.insert({m_elements(i, j)}, i);
-        }
-    }
+    connectors.resize(num_elements * vertex_per_element);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_elements),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    for (size_t j=0; j<vertex_per_element; j++) {
+                        connectors[i*vertex_per_element+j] =
+                        {{{m_elements(i, j), -1, -1, -1}}, int(i)};
+                    }
+                }
+            });
 }
 
-void MeshSeparator::compute_face_connectivity() {
-    m_face_connectivity.clear();
+void MeshSeparator::compute_face_connectors(
+        std::vector<Connector>& connectors) const {
     const size_t num_elements = m_elements.rows();
     const size_t vertex_per_element = m_elements.cols();
     if (vertex_per_element != 3 && vertex_per_element != 4) {
@@ -67,140 +142,102 @@ void MeshSeparator::compute_face_connectivity() {
                 "Unknow face type!  Only triangle and quad faces are supported");
     }
 
-    for (size_t i=0; i<num_elements; i++) {
-        const auto& e = m_elements.row(i);
-        for (size_t j=0; j<vertex_per_element; j++) {
-            m_face_connectivity.insert({e[j], e[(j+1)%vertex_per_element]}, i);
-        }
-    }
+    connectors.resize(num_elements * vertex_per_element);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_elements),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const auto& e = m_elements.row(i);
+                    for (size_t j=0; j<vertex_per_element; j++) {
+                        const int v0 = e[j];
+                        const int v1 = e[(j+1)%vertex_per_element];
+                        connectors[i*vertex_per_element+j] = {{{
+                            std::min(v0, v1), std::max(v0, v1), -1, -1}},
+                            int(i)};
+                    }
+                }
+            });
 }
 
-void MeshSeparator::compute_voxel_connectivity() {
+void MeshSeparator::compute_voxel_connectors(
+        std::vector<Connector>& connectors) const {
     const size_t num_elements= m_elements.rows();
     const size_t vertex_per_element = m_elements.cols();
+    // Local vertex indices of each voxel facet, padded with -1.
+    std::vector<std::array<int, 4> > facets;
     if (vertex_per_element == 4) {
-        for (size_t i=0; i<num_elements; i++) {
-            const auto& voxel = m_elements.row(i);
-            m_tet_connectivity.insert({voxel[0], voxel[1], voxel[2]}, i);
-            m_tet_connectivity.insert({voxel[1], voxel[2], voxel[3]}, i);
-            m_tet_connectivity.insert({voxel[2], voxel[3], voxel[0]}, i);
-            m_tet_connectivity.insert({voxel[3], voxel[0], voxel[1]}, i);
-        }
+        facets = {
+            {{0, 1, 2, -1}},
+            {{1, 2, 3, -1}},
+            {{2, 3, 0, -1}},
+            {{3, 0, 1, -1}}
+        };
     } else if (vertex_per_element == 8) {
-        for (size_t i=0; i<num_elements; i++) {
-            const auto& voxel = m_elements.row(i);
-            m_hex_connectivity.insert(
-                    {voxel[0], voxel[1], voxel[2], voxel[3]}, i);
-            m_hex_connectivity.insert(
-                    {voxel[4], voxel[5], voxel[6], voxel[7]}, i);
-            m_hex_connectivity.insert(
-                    {voxel[0], voxel[4], voxel[7], voxel[3]}, i);
-            m_hex_connectivity.insert(
-                    {voxel[1], voxel[5], voxel[6], voxel[2]}, i);
-            m_hex_connectivity.insert(
-                    {voxel[0], voxel[1], voxel[4], voxel[5]}, i);
-            m_hex_connectivity.insert(
-                    {voxel[3], voxel[2], voxel[6], voxel[7]}, i);
-        }
+        facets = {
+            {{0, 1, 2, 3}},
+            {{4, 5, 6, 7}},
+            {{0, 4, 7, 3}},
+            {{1, 5, 6, 2}},
+            {{0, 1, 4, 5}},
+            {{3, 2, 6, 7}}
+        };
     } else {
         throw RuntimeError(
                 "Only tetrahedron and hexahedron elements are supported");
     }
+
+    const size_t num_facets = facets.size();
+    connectors.resize(num_elements * num_facets);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_elements),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    for (size_t j=0; j<num_facets; j++) {
+                        ConnectorKey key;
+                        for (size_t k=0; k<4; k++) {
+                            key[k] = facets[j][k] < 0 ?
+                                -1 : m_elements(i, facets[j][k]);
+                        }
+                        // Sort so that padding goes last.
+                        const size_t size = facets[j][3] < 0 ? 3 : 4;
+                        std::sort(key.begin(), key.begin() + size);
+                        connectors[i*num_facets+j] = {key, int(i)};
+                    }
+                }
+            });
 }
 
-MatrixIr MeshSeparator::flood(size_t seed, VectorI& sources) {
-    std::queue<size_t> Q;
-    Q.push(seed);
-    m_visited[seed] = true;
-
-    std::list<size_t> element_list;
-    while (!Q.empty()) {
-        size_t ei = Q.front();
-        Q.pop();
-        element_list.push_back(ei);
-
-        std::vector<size_t> neighbors = get_adjacent_element(ei);
-        for (size_t i=0; i<neighbors.size(); i++) {
-            size_t f_next = neighbors[i];
-            if (m_visited[f_next]) continue;
-            Q.push(f_next);
-            m_visited[f_next] = true;
+void MeshSeparator::compute_components(const std::vector<int>& roots) {
+    const size_t num_elements = roots.size();
+    std::vector<int> comp_index(num_elements, -1);
+    int num_comps = 0;
+    for (size_t i=0; i<num_elements; i++) {
+        if (roots[i] == int(i)) {
+            comp_index[i] = num_comps;
+            num_comps++;
         }
     }
 
-    const size_t vertex_per_element = m_elements.cols();
-    MatrixIr comp(element_list.size(), vertex_per_element);
-    sources.resize(element_list.size());
-    size_t count = 0;
-    for (std::list<size_t>::const_iterator itr = element_list.begin();
-            itr != element_list.end(); itr++) {
-        assert(count < m_elements.rows());
-        assert(*itr < m_elements.rows());
-        comp.row(count) = m_elements.row(*itr);
-        sources[count] = *itr;
-        count++;
+    m_labels.resize(num_elements);
+    m_component_offsets = VectorI::Zero(num_comps+1);
+    for (size_t i=0; i<num_elements; i++) {
+        m_labels[i] = comp_index[roots[i]];
+        m_component_offsets[m_labels[i]+1]++;
     }
-    return comp;
-}
-
-std::vector<size_t> MeshSeparator::get_adjacent_element(size_t index) {
-    std::vector<size_t> neighbors;
-    neighbors.reserve(8);
-    const auto& element = m_elements.row(index);
-    const size_t vertex_per_element = element.size();
-
-    switch (m_connectivity_type) {
-        case VERTEX:
-            for (size_t i=0; i<vertex_per_element; i++) {
-                Singleton conn(element[i]);
-                AdjElements& neighbor = m_vertex_connectivity[conn];
-                neighbors.insert(neighbors.end(), neighbor.begin(), neighbor.end());
-            }
-            break;
-        case FACE:
-            for (size_t i=0; i<vertex_per_element; i++) {
-                Duplet conn(element[i], element[(i+1)%vertex_per_element]);
-                AdjElements& neighbor = m_face_connectivity[conn];
-                neighbors.insert(neighbors.end(), neighbor.begin(), neighbor.end());
-            }
-            break;
-        case VOXEL:
-            if (vertex_per_element == 4) {
-                for (size_t i=0; i<vertex_per_element; i++) {
-                    Triplet conn(element[i],
-                            element[(i+1)%vertex_per_element],
-                            element[(i+2)%vertex_per_element]);
-                    AdjElements& neighbor = m_tet_connectivity[conn];
-                    neighbors.insert(neighbors.end(), neighbor.begin(), neighbor.end());
-                }
-            } else if (vertex_per_element == 8) {
-                Quadruplet connectors[] = {
-                    {element[0], element[1], element[2], element[3]},
-                    {element[4], element[5], element[6], element[7]},
-                    {element[0], element[4], element[7], element[3]},
-                    {element[1], element[5], element[6], element[2]},
-                    {element[0], element[1], element[4], element[5]},
-                    {element[3], element[2], element[6], element[7]}
-                };
-                for (size_t i=0; i<6; i++) {
-                    AdjElements& neighbor = m_hex_connectivity[connectors[i]];
-                    neighbors.insert(neighbors.end(), neighbor.begin(), neighbor.end());
-                }
-            } else {
-                throw RuntimeError("Only tet and hex elements are supported.");
-            }
-            break;
+    for (int i=0; i<num_comps; i++) {
+        m_component_offsets[i+1] += m_component_offsets[i];
     }
 
-    return neighbors;
+    m_component_elements.resize(num_elements);
+    std::vector<int> cursor(m_component_offsets.data(),
+            m_component_offsets.data() + num_comps);
+    for (size_t i=0; i<num_elements; i++) {
+        const int label = m_labels[i];
+        m_component_elements[cursor[label]] = i;
+        cursor[label]++;
+    }
 }
 
 void MeshSeparator::clear() {
-    m_components.clear();
-    m_sources.clear();
-    m_visited.clear();
-    m_vertex_connectivity.clear();
-    m_face_connectivity.clear();
-    m_tet_connectivity.clear();
-    m_hex_connectivity.clear();
+    m_labels.resize(0);
+    m_component_offsets.resize(0);
+    m_component_elements.resize(0);
 }
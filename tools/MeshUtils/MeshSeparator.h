@@ -1,10 +1,11 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #pragma once
+#include <array>
+#include <utility>
 #include <vector>
 
 #include <Core/EigenTypedef.h>
 #include <Mesh.h>
-#include <Misc/MultipletMap.h>
 
 namespace PyMesh {
 
@@ -25,45 +26,62 @@ class MeshSeparator {
             m_connectivity_type = connectivity;
         }
 
+        /**
+         * Label connected components using a parallel union-find over
+         * elements sharing a connector (vertex, edge or facet).  Components
+         * are ordered by their smallest element index.
+         */
         size_t separate();
 
-        MatrixIr get_component(size_t i) const {
-            return m_components.at(i);
-        }
+        /**
+         * Elements of the i-th component, in increasing source order.
+         */
+        MatrixIr get_component(size_t i) const;
 
         VectorI get_sources(size_t i) const {
-            return m_sources.at(i);
+            return m_component_elements.segment(
+                    m_component_offsets[i],
+                    m_component_offsets[i+1] - m_component_offsets[i]);
+        }
+
+        /**
+         * Component index of each element.
+         */
+        const VectorI& get_labels() const { return m_labels; }
+
+        /**
+         * Components in CSR form: the elements of component i are
+         * get_component_elements()[offsets[i]:offsets[i+1]].
+         */
+        const VectorI& get_component_offsets() const {
+            return m_component_offsets;
+        }
+        const VectorI& get_component_elements() const {
+            return m_component_elements;
         }
 
         void clear();
 
     private:
-        void compute_connectivity();
-        void compute_vertex_connectivity();
-        void compute_face_connectivity();
-        void compute_voxel_connectivity();
+        /**
+         * Sorted vertex indices of a connector, padded with -1.
+         */
+        typedef std::array<int, 4> ConnectorKey;
+        typedef std::pair<ConnectorKey, int> Connector;
 
-        MatrixIr flood(size_t seed, VectorI& sources);
-        std::vector<size_t> get_adjacent_element(size_t fi);
+        std::vector<Connector> compute_connectors() const;
+        void compute_vertex_connectors(std::vector<Connector>& connectors) const;
+        void compute_face_connectors(std::vector<Connector>& connectors) const;
+        void compute_voxel_connectors(std::vector<Connector>& connectors) const;
+        void compute_components(const std::vector<int>& roots);
 
     private:
-        std::vector<MatrixIr> m_components;
-        std::vector<VectorI> m_sources;
         MatrixIr m_elements;
-        std::vector<bool> m_visited;
-
         ConnectivityType m_connectivity_type;
 
-        using VertexConnector = Singleton;
-        using FaceConnector = Duplet;
-        using TetConnector = Triplet;
-        using HexConnector = Quadruplet;
-        using AdjElements = MultipletMap<Singleton, size_t>::ValueType;
-
-        MultipletMap<Singleton, size_t> m_vertex_connectivity;
-        MultipletMap<Duplet, size_t> m_face_connectivity;
-        MultipletMap<Triplet, size_t> m_tet_connectivity;
-        MultipletMap<Quadruplet, size_t> m_hex_connectivity;
+        VectorI m_labels;
+        VectorI m_component_offsets;
+        VectorI m_component_elements;
 };
 
 }
@@ -0,0 +1,229 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include "MeshSlicer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include <tbb/tbb.h>
+
+#include <Core/Exception.h>
+
+using namespace PyMesh;
+
+namespace MeshSlicerHelper {
+    uint64_t get_edge_key(int v0, int v1) {
+        const uint32_t a = std::min(v0, v1);
+        const uint32_t b = std::max(v0, v1);
+        return (uint64_t(a) << 32) | b;
+    }
+}
+
+using namespace MeshSlicerHelper;
+
+MeshSlicer::MeshSlicer(const MatrixFr& vertices, const MatrixIr& faces) :
+    m_vertices(vertices), m_faces(faces) {
+        if (m_vertices.cols() != 3) {
+            throw NotImplementedError("Only slicing 3D mesh is supported.");
+        }
+        if (m_faces.cols() != 3) {
+            throw NotImplementedError("Only triangle mesh is supported.");
+        }
+    }
+
+void MeshSlicer::slice(const VectorF& direction, const VectorF& intercepts) {
+    if (direction.size() != 3) {
+        throw RuntimeError("Slice direction must be a 3D vector.");
+    }
+    const size_t num_slices = intercepts.size();
+    for (size_t i=1; i<num_slices; i++) {
+        if (intercepts[i] < intercepts[i-1]) {
+            throw RuntimeError("Slice intercepts must be in ascending order.");
+        }
+    }
+
+    const VectorF heights = m_vertices * direction;
+    std::vector<int> offsets;
+    std::vector<int> faces;
+    bucket_faces(heights, intercepts, offsets, faces);
+
+    m_slices.clear();
+    m_slices.resize(num_slices);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_slices),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    slice_plane(heights, intercepts[i],
+                            faces.data() + offsets[i],
+                            offsets[i+1] - offsets[i], m_slices[i]);
+                    chain_segments(m_slices[i]);
+                }
+            });
+}
+
+void MeshSlicer::bucket_faces(const VectorF& heights,
+        const VectorF& intercepts,
+        std::vector<int>& offsets, std::vector<int>& faces) const {
+    // A face crosses plane c iff min height < c <= max height, so it spans a
+    // contiguous range of the sorted planes.
+    typedef std::pair<Float, int> HeightFace;
+    const size_t num_faces = m_faces.rows();
+    const size_t num_slices = intercepts.size();
+    const Float* intercepts_begin = intercepts.data();
+    const Float* intercepts_end = intercepts.data() + num_slices;
+
+    std::vector<HeightFace> sorted_faces(num_faces);
+    std::vector<int> span_begin(num_faces);
+    std::vector<int> span_end(num_faces);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_faces),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const Float h0 = heights[m_faces(i, 0)];
+                    const Float h1 = heights[m_faces(i, 1)];
+                    const Float h2 = heights[m_faces(i, 2)];
+                    const Float h_min = std::min({h0, h1, h2});
+                    const Float h_max = std::max({h0, h1, h2});
+                    sorted_faces[i] = {h_min, int(i)};
+                    span_begin[i] = std::upper_bound(intercepts_begin,
+                            intercepts_end, h_min) - intercepts_begin;
+                    span_end[i] = std::upper_bound(intercepts_begin,
+                            intercepts_end, h_max) - intercepts_begin;
+                }
+            });
+    tbb::parallel_sort(sorted_faces.begin(), sorted_faces.end());
+
+    std::vector<int> counts(num_slices+1, 0);
+    for (size_t i=0; i<num_faces; i++) {
+        counts[span_begin[i]]++;
+        counts[span_end[i]]--;
+    }
+    offsets.assign(num_slices+1, 0);
+    int count = 0;
+    for (size_t i=0; i<num_slices; i++) {
+        count += counts[i];
+        offsets[i+1] = offsets[i] + count;
+    }
+
+    faces.resize(offsets[num_slices]);
+    std::vector<int> cursor(offsets.begin(), offsets.end()-1);
+    for (const auto& item : sorted_faces) {
+        const int fi = item.second;
+        for (int j=span_begin[fi]; j<span_end[fi]; j++) {
+            faces[cursor[j]] = fi;
+            cursor[j]++;
+        }
+    }
+}
+
+void MeshSlicer::slice_plane(const VectorF& heights, Float intercept,
+        const int* faces, size_t num_faces, Slice& slice) const {
+    typedef std::pair<uint64_t, uint64_t> Segment;
+    std::vector<Segment> segments(num_faces);
+    for (size_t i=0; i<num_faces; i++) {
+        const int fi = faces[i];
+        bool above[3];
+        for (size_t j=0; j<3; j++) {
+            above[j] = heights[m_faces(fi, j)] >= intercept;
+        }
+
+        // Vertex a is on the opposite side from b and c.
+        size_t lone = 0;
+        if (above[0] == above[1]) lone = 2;
+        else if (above[0] == above[2]) lone = 1;
+        const int a = m_faces(fi, lone);
+        const int b = m_faces(fi, (lone+1)%3);
+        const int c = m_faces(fi, (lone+2)%3);
+        const uint64_t key_ab = get_edge_key(a, b);
+        const uint64_t key_ca = get_edge_key(c, a);
+        if (above[lone]) {
+            segments[i] = {key_ab, key_ca};
+        } else {
+            segments[i] = {key_ca, key_ab};
+        }
+    }
+
+    std::vector<uint64_t> keys;
+    keys.reserve(num_faces * 2);
+    for (const auto& segment : segments) {
+        keys.push_back(segment.first);
+        keys.push_back(segment.second);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    const size_t num_vertices = keys.size();
+
+    // Intersection points are computed from the edge in canonical order so
+    // both faces adjacent to an edge generate the same point.
+    slice.vertices.resize(num_vertices, 3);
+    for (size_t i=0; i<num_vertices; i++) {
+        const int v0 = keys[i] >> 32;
+        const int v1 = keys[i] & 0xFFFFFFFF;
+        const Float h0 = heights[v0];
+        const Float h1 = heights[v1];
+        const Float t = (intercept - h0) / (h1 - h0);
+        slice.vertices.row(i) = m_vertices.row(v0) +
+            t * (m_vertices.row(v1) - m_vertices.row(v0));
+    }
+
+    slice.edges.resize(num_faces, 2);
+    for (size_t i=0; i<num_faces; i++) {
+        slice.edges(i, 0) = std::lower_bound(keys.begin(), keys.end(),
+                segments[i].first) - keys.begin();
+        slice.edges(i, 1) = std::lower_bound(keys.begin(), keys.end(),
+                segments[i].second) - keys.begin();
+    }
+}
+
+void MeshSlicer::chain_segments(Slice& slice) const {
+    const size_t num_vertices = slice.vertices.rows();
+    const size_t num_edges = slice.edges.rows();
+
+    std::vector<int> out_offsets(num_vertices+1, 0);
+    std::vector<int> in_degree(num_vertices, 0);
+    for (size_t i=0; i<num_edges; i++) {
+        out_offsets[slice.edges(i, 0)+1]++;
+        in_degree[slice.edges(i, 1)]++;
+    }
+    for (size_t i=0; i<num_vertices; i++) {
+        out_offsets[i+1] += out_offsets[i];
+    }
+    std::vector<int> out_edges(num_edges);
+    std::vector<int> cursor(out_offsets.begin(), out_offsets.end()-1);
+    for (size_t i=0; i<num_edges; i++) {
+        const int from = slice.edges(i, 0);
+        out_edges[cursor[from]] = i;
+        cursor[from]++;
+    }
+
+    // cursor[v] now points to the next unused outgoing edge of v.
+    std::copy(out_offsets.begin(), out_offsets.end()-1, cursor.begin());
+    auto walk = [&](int start) {
+        std::vector<int> loop;
+        loop.push_back(start);
+        int curr = start;
+        while (cursor[curr] < out_offsets[curr+1]) {
+            const int next = slice.edges(out_edges[cursor[curr]], 1);
+            cursor[curr]++;
+            if (next == start) break;
+            loop.push_back(next);
+            curr = next;
+        }
+        VectorI result(loop.size());
+        std::copy(loop.begin(), loop.end(), result.data());
+        slice.loops.push_back(result);
+    };
+
+    // Open polylines start where there are more outgoing than incoming
+    // segments, the rest are closed loops.
+    slice.loops.clear();
+    for (size_t i=0; i<num_vertices; i++) {
+        const int out_degree = out_offsets[i+1] - out_offsets[i];
+        for (int j=in_degree[i]; j<out_degree; j++) {
+            walk(i);
+        }
+    }
+    for (size_t i=0; i<num_vertices; i++) {
+        while (cursor[i] < out_offsets[i+1]) {
+            walk(i);
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <vector>
+
+#include <Core/EigenTypedef.h>
+
+namespace PyMesh {
+
+/**
+ * Slice a triangle mesh with a set of parallel planes.
+ *
+ * The i-th plane is {x : x.dot(direction) == intercepts[i]}.  Each cross
+ * section is returned as a set of directed segments forming closed loops if
+ * the input is closed and manifold.  Loops are oriented counterclockwise
+ * around the interior of the solid when viewed from +direction.
+ *
+ * Vertices lying exactly on a plane are treated as if they were slightly
+ * above it, so contour vertices are always associated with a mesh edge.
+ */
+class MeshSlicer {
+    public:
+        MeshSlicer(const MatrixFr& vertices, const MatrixIr& faces);
+
+    public:
+        /**
+         * Intercepts must be sorted in ascending order.
+         */
+        void slice(const VectorF& direction, const VectorF& intercepts);
+
+        size_t get_num_slices() const { return m_slices.size(); }
+
+        MatrixFr get_slice_vertices(size_t i) const {
+            return m_slices.at(i).vertices;
+        }
+
+        /**
+         * Directed segments, each row is (from, to).
+         */
+        MatrixIr get_slice_edges(size_t i) const {
+            return m_slices.at(i).edges;
+        }
+
+        /**
+         * Segments chained into polylines.  Closed loops do not repeat
+         * their first vertex.
+         */
+        std::vector<VectorI> get_slice_loops(size_t i) const {
+            return m_slices.at(i).loops;
+        }
+
+    private:
+        struct Slice {
+            MatrixFr vertices;
+            MatrixIr edges;
+            std::vector<VectorI> loops;
+        };
+
+        void bucket_faces(const VectorF& heights, const VectorF& intercepts,
+                std::vector<int>& offsets, std::vector<int>& faces) const;
+        void slice_plane(const VectorF& heights, Float intercept,
+                const int* faces, size_t num_faces,
+                Slice& slice) const;
+        void chain_segments(Slice& slice) const;
+
+    private:
+        MatrixFr m_vertices;
+        MatrixIr m_faces;
+        std::vector<Slice> m_slices;
+};
+
+}
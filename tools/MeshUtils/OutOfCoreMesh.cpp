@@ -0,0 +1,832 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include "OutOfCoreMesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <Core/Exception.h>
+#include <IO/PLYStreamReader.h>
+#include <IO/PLYStreamWriter.h>
+#include <Misc/HashGrid.h>
+#include <Misc/Profiler.h>
+
+using namespace PyMesh;
+
+namespace OutOfCoreMeshHelper {
+    struct VertexRecord {
+        uint64_t id;
+        uint64_t brick;
+        Float coord[3];
+    };
+
+    struct FaceRecord {
+        uint64_t vertex[3];
+        uint64_t brick[3];
+    };
+
+    /**
+     * A vertex removed from its brick and the vertex replacing it.
+     */
+    struct ForwardRecord {
+        uint64_t id;
+        uint64_t target;
+        uint64_t target_brick;
+    };
+
+    const size_t MAX_BUFFERED_BYTES = size_t(64) << 20;
+
+    template<typename T>
+    std::vector<T> read_records(const std::string& filename) {
+        std::vector<T> records;
+        std::ifstream fin(filename, std::ios::binary | std::ios::ate);
+        if (!fin.is_open()) return records;
+        const size_t num_bytes = fin.tellg();
+        if (num_bytes % sizeof(T) != 0) {
+            throw IOError("Corrupted brick file: " + filename);
+        }
+        records.resize(num_bytes / sizeof(T));
+        fin.seekg(0);
+        fin.read(reinterpret_cast<char*>(records.data()), num_bytes);
+        if (!fin.good()) {
+            throw IOError("Failed to read brick file: " + filename);
+        }
+        return records;
+    }
+
+    template<typename T>
+    void append_records(const std::string& filename,
+            const std::vector<T>& records) {
+        if (records.empty()) return;
+        std::ofstream fout(filename,
+                std::ios::binary | std::ios::out | std::ios::app);
+        fout.write(reinterpret_cast<const char*>(records.data()),
+                records.size() * sizeof(T));
+        if (!fout.good()) {
+            throw IOError("Failed to write brick file: " + filename);
+        }
+    }
+
+    /**
+     * Replace the content of a brick file.  The data is written to a
+     * temporary file first so concurrent readers never see a partial file.
+     */
+    template<typename T>
+    void write_records(const std::string& filename,
+            const std::vector<T>& records) {
+        const std::string tmp_filename = filename + ".tmp";
+        {
+            std::ofstream fout(tmp_filename,
+                    std::ios::binary | std::ios::out | std::ios::trunc);
+            fout.write(reinterpret_cast<const char*>(records.data()),
+                    records.size() * sizeof(T));
+            if (!fout.good()) {
+                throw IOError("Failed to write brick file: " + filename);
+            }
+        }
+        if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+            throw IOError("Failed to replace brick file: " + filename);
+        }
+    }
+
+    template<typename Derived>
+    bool is_inside(const Float* coord, const Eigen::MatrixBase<Derived>& box_min,
+            const Eigen::MatrixBase<Derived>& box_max) {
+        for (size_t i=0; i<3; i++) {
+            if (coord[i] < box_min[i] || coord[i] > box_max[i]) return false;
+        }
+        return true;
+    }
+
+    size_t get_forward_target(
+            const std::unordered_map<size_t, size_t>& forwards, size_t id) {
+        auto itr = forwards.find(id);
+        if (itr == forwards.end()) {
+            std::stringstream err_msg;
+            err_msg << "Vertex " << id << " is missing";
+            throw RuntimeError(err_msg.str());
+        }
+        return itr->second;
+    }
+}
+
+using namespace OutOfCoreMeshHelper;
+
+/**
+ * Buffers records per brick and appends them to the spill files once the
+ * buffers grow too large.
+ */
+class OutOfCoreMesh::Partitioner {
+    public:
+        Partitioner(OutOfCoreMesh& store) : m_store(store),
+            m_vertex_buffers(store.get_num_bricks()),
+            m_face_buffers(store.get_num_bricks()),
+            m_seam_buffers(store.get_num_bricks()),
+            m_buffered_bytes(0) { }
+
+        void add_vertex(const Float* coord) {
+            const size_t brick = m_store.get_brick_index(coord);
+            VertexRecord record;
+            record.id = m_vertex_bricks.size();
+            record.brick = brick;
+            std::copy(coord, coord+3, record.coord);
+            m_vertex_bricks.push_back(uint32_t(brick));
+            m_vertex_buffers[brick].push_back(record);
+            m_store.m_brick_num_vertices[brick]++;
+            reserve(sizeof(VertexRecord));
+        }
+
+        void add_face(size_t v0, size_t v1, size_t v2) {
+            const size_t num_vertices = m_vertex_bricks.size();
+            if (v0 >= num_vertices || v1 >= num_vertices ||
+                    v2 >= num_vertices) {
+                throw RuntimeError("Face refers to a vertex that is not read yet");
+            }
+            FaceRecord record;
+            record.vertex[0] = v0;
+            record.vertex[1] = v1;
+            record.vertex[2] = v2;
+            for (size_t i=0; i<3; i++) {
+                record.brick[i] = m_vertex_bricks[record.vertex[i]];
+            }
+            const size_t owner = record.brick[0];
+            m_face_buffers[owner].push_back(record);
+            m_store.m_brick_num_faces[owner]++;
+            reserve(sizeof(FaceRecord));
+
+            for (size_t i=1; i<3; i++) {
+                if (record.brick[i] == owner) continue;
+                m_seam_buffers[record.brick[i]].push_back(record.vertex[i]);
+                reserve(sizeof(uint64_t));
+            }
+        }
+
+        void flush() {
+            const size_t num_bricks = m_store.get_num_bricks();
+            for (size_t i=0; i<num_bricks; i++) {
+                append_records(m_store.get_vertex_file(i), m_vertex_buffers[i]);
+                append_records(m_store.get_face_file(i), m_face_buffers[i]);
+                append_records(m_store.get_seam_file(i), m_seam_buffers[i]);
+                m_vertex_buffers[i].clear();
+                m_face_buffers[i].clear();
+                m_seam_buffers[i].clear();
+            }
+            m_buffered_bytes = 0;
+        }
+
+        size_t get_num_vertices() const { return m_vertex_bricks.size(); }
+
+    private:
+        void reserve(size_t num_bytes) {
+            m_buffered_bytes += num_bytes;
+            if (m_buffered_bytes > MAX_BUFFERED_BYTES) flush();
+        }
+
+    private:
+        OutOfCoreMesh& m_store;
+        std::vector<uint32_t> m_vertex_bricks;
+        std::vector<std::vector<VertexRecord> > m_vertex_buffers;
+        std::vector<std::vector<FaceRecord> > m_face_buffers;
+        std::vector<std::vector<uint64_t> > m_seam_buffers;
+        size_t m_buffered_bytes;
+};
+
+constexpr size_t OutOfCoreMesh::INVALID;
+
+OutOfCoreMesh::OutOfCoreMesh(const std::string& work_dir,
+        Float brick_size, Float halo_width) :
+    m_work_dir(work_dir),
+    m_brick_size(brick_size),
+    m_halo_width(halo_width),
+    m_bbox_min(Vector3F::Zero()),
+    m_grid_size(Vector3I::Zero()),
+    m_next_vertex_id(0) {
+    if (brick_size <= 0.0) {
+        throw RuntimeError("Brick size must be positive");
+    }
+    if (halo_width < 0.0 || halo_width > brick_size) {
+        throw RuntimeError("Halo width must be between 0 and the brick size");
+    }
+}
+
+OutOfCoreMesh::~OutOfCoreMesh() {
+    clear();
+}
+
+void OutOfCoreMesh::import_ply(const std::string& filename) {
+    PYMESH_PROFILE_ZONE("OutOfCoreMesh::import_ply");
+    clear();
+    PLYStreamReader reader(filename);
+
+    Vector3F bbox_min = Vector3F::Constant(std::numeric_limits<Float>::max());
+    Vector3F bbox_max = Vector3F::Constant(std::numeric_limits<Float>::lowest());
+    size_t num_vertices = 0;
+    {
+        PYMESH_PROFILE_ZONE("OutOfCoreMesh::bbox_pass");
+        reader.read([&](const Float* coord) {
+                    for (size_t i=0; i<3; i++) {
+                        bbox_min[i] = std::min(bbox_min[i], coord[i]);
+                        bbox_max[i] = std::max(bbox_max[i], coord[i]);
+                    }
+                    num_vertices++;
+                }, PLYStreamReader::FaceCallback());
+    }
+    if (num_vertices == 0) {
+        bbox_min.setZero();
+        bbox_max.setZero();
+    }
+    initialize_grid(bbox_min, bbox_max);
+
+    PYMESH_PROFILE_ZONE("OutOfCoreMesh::partition_pass");
+    Partitioner partitioner(*this);
+    reader.read([&](const Float* coord) {
+                partitioner.add_vertex(coord);
+            },
+            [&](const int* indices, size_t size) {
+                // Polygons are fan triangulated.
+                for (size_t i=2; i<size; i++) {
+                    partitioner.add_face(indices[0], indices[i-1], indices[i]);
+                }
+            });
+    partitioner.flush();
+    m_next_vertex_id = partitioner.get_num_vertices();
+}
+
+void OutOfCoreMesh::import_mesh(const MatrixFr& vertices, const MatrixIr& faces) {
+    PYMESH_PROFILE_ZONE("OutOfCoreMesh::import_mesh");
+    if (vertices.cols() != 3) {
+        throw NotImplementedError("Out-of-core meshes must be 3D");
+    }
+    if (faces.rows() > 0 && faces.cols() != 3) {
+        throw NotImplementedError("Out-of-core meshes must be triangle meshes");
+    }
+    clear();
+
+    const size_t num_vertices = vertices.rows();
+    if (num_vertices > 0) {
+        initialize_grid(vertices.colwise().minCoeff().transpose(),
+                vertices.colwise().maxCoeff().transpose());
+    } else {
+        initialize_grid(Vector3F::Zero(), Vector3F::Zero());
+    }
+
+    Partitioner partitioner(*this);
+    for (size_t i=0; i<num_vertices; i++) {
+        partitioner.add_vertex(vertices.row(i).data());
+    }
+    const size_t num_faces = faces.rows();
+    for (size_t i=0; i<num_faces; i++) {
+        partitioner.add_face(faces(i,0), faces(i,1), faces(i,2));
+    }
+    partitioner.flush();
+    m_next_vertex_id = num_vertices;
+}
+
+void OutOfCoreMesh::export_ply(const std::string& filename, bool in_ascii) const {
+    PYMESH_PROFILE_ZONE("OutOfCoreMesh::export_ply");
+    PLYStreamWriter writer(filename, get_num_vertices(), get_num_faces(),
+            in_ascii);
+
+    const auto active_bricks = get_active_bricks();
+    const uint32_t NOT_FOUND = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> index_map(m_next_vertex_id, NOT_FOUND);
+    uint32_t count = 0;
+    for (auto brick : active_bricks) {
+        const auto vertices = read_records<VertexRecord>(get_vertex_file(brick));
+        for (const auto& v : vertices) {
+            index_map[v.id] = count++;
+            writer.write_vertex(v.coord);
+        }
+    }
+
+    const auto forwards = read_forwards();
+    for (auto brick : active_bricks) {
+        const auto faces = read_records<FaceRecord>(get_face_file(brick));
+        for (const auto& f : faces) {
+            uint32_t corners[3];
+            for (size_t i=0; i<3; i++) {
+                size_t id = f.vertex[i];
+                while (index_map[id] == NOT_FOUND) {
+                    id = get_forward_target(forwards, id);
+                }
+                corners[i] = index_map[id];
+            }
+            writer.write_face(corners[0], corners[1], corners[2]);
+        }
+    }
+    writer.close();
+}
+
+void OutOfCoreMesh::export_mesh(MatrixFr& vertices, MatrixIr& faces) const {
+    PYMESH_PROFILE_ZONE("OutOfCoreMesh::export_mesh");
+    vertices.resize(get_num_vertices(), 3);
+    faces.resize(get_num_faces(), 3);
+
+    const auto active_bricks = get_active_bricks();
+    std::vector<int> index_map(m_next_vertex_id, -1);
+    size_t vertex_count = 0;
+    for (auto brick : active_bricks) {
+        const auto records = read_records<VertexRecord>(get_vertex_file(brick));
+        for (const auto& v : records) {
+            index_map[v.id] = vertex_count;
+            vertices.row(vertex_count) << v.coord[0], v.coord[1], v.coord[2];
+            vertex_count++;
+        }
+    }
+
+    const auto forwards = read_forwards();
+    size_t face_count = 0;
+    for (auto brick : active_bricks) {
+        const auto records = read_records<FaceRecord>(get_face_file(brick));
+        for (const auto& f : records) {
+            for (size_t i=0; i<3; i++) {
+                size_t id = f.vertex[i];
+                while (index_map[id] < 0) {
+                    id = get_forward_target(forwards, id);
+                }
+                faces(face_count, i) = index_map[id];
+            }
+            face_count++;
+        }
+    }
+    assert(vertex_count == size_t(vertices.rows()));
+    assert(face_count == size_t(faces.rows()));
+}
+
+size_t OutOfCoreMesh::get_num_vertices() const {
+    size_t count = 0;
+    for (auto n : m_brick_num_vertices) count += n;
+    return count;
+}
+
+size_t OutOfCoreMesh::get_num_faces() const {
+    size_t count = 0;
+    for (auto n : m_brick_num_faces) count += n;
+    return count;
+}
+
+std::vector<size_t> OutOfCoreMesh::get_active_bricks() const {
+    std::vector<size_t> bricks;
+    const size_t num_bricks = get_num_bricks();
+    for (size_t i=0; i<num_bricks; i++) {
+        if (m_brick_num_vertices[i] > 0 || m_brick_num_faces[i] > 0) {
+            bricks.push_back(i);
+        }
+    }
+    return bricks;
+}
+
+OutOfCoreMesh::Brick OutOfCoreMesh::load_brick(size_t index) const {
+    PYMESH_PROFILE_ZONE("OutOfCoreMesh::load_brick");
+    const auto neighbours = get_neighbours(index);
+
+    // Bricks beyond the neighbours may be processed concurrently, so their
+    // forward and vertex files are read together under the brick lock.
+    std::unordered_map<size_t, std::vector<VertexRecord> > far_records;
+    auto read_forward_table = [&](size_t b,
+            std::unordered_map<size_t, ForwardRecord>& table) {
+        const bool is_far = b != index &&
+            std::find(neighbours.begin(), neighbours.end(), b)
+            == neighbours.end();
+        std::unique_lock<std::mutex> lock(m_brick_locks[b], std::defer_lock);
+        if (is_far) {
+            lock.lock();
+            far_records[b] = read_records<VertexRecord>(get_vertex_file(b));
+        }
+        for (const auto& r : read_records<ForwardRecord>(
+                    get_forward_file(b))) {
+            table[r.id] = r;
+        }
+    };
+
+    // Faces of other bricks may still refer to vertices merged away since
+    // they were stored, so corners are forwarded to their replacement.
+    std::unordered_map<size_t, std::unordered_map<size_t, ForwardRecord> >
+        forward_tables;
+    auto resolve = [&](FaceRecord& f) {
+        for (size_t i=0; i<3; i++) {
+            while (true) {
+                auto table_itr = forward_tables.find(f.brick[i]);
+                if (table_itr == forward_tables.end()) {
+                    read_forward_table(f.brick[i],
+                            forward_tables[f.brick[i]]);
+                    table_itr = forward_tables.find(f.brick[i]);
+                }
+                auto itr = table_itr->second.find(f.vertex[i]);
+                if (itr == table_itr->second.end()) break;
+                f.vertex[i] = itr->second.target;
+                f.brick[i] = itr->second.target_brick;
+            }
+        }
+    };
+
+    // Vertices of the brick and its neighbours, used for the halo test.
+    auto records = read_records<VertexRecord>(get_vertex_file(index));
+    const size_t num_owned_vertices = records.size();
+    std::unordered_map<size_t, VertexRecord> pool;
+    for (auto n : neighbours) {
+        for (const auto& v : read_records<VertexRecord>(get_vertex_file(n))) {
+            pool[v.id] = v;
+        }
+    }
+
+    const Vector3I coord = get_brick_coordinate(index);
+    const Vector3F box_min = m_bbox_min + coord.cast<Float>() * m_brick_size
+        - Vector3F::Constant(m_halo_width);
+    const Vector3F box_max = box_min
+        + Vector3F::Constant(m_brick_size + 2 * m_halo_width);
+
+    auto faces = read_records<FaceRecord>(get_face_file(index));
+    const size_t num_owned_faces = faces.size();
+    for (auto& f : faces) resolve(f);
+    for (auto n : neighbours) {
+        for (auto f : read_records<FaceRecord>(get_face_file(n))) {
+            resolve(f);
+            for (size_t i=0; i<3; i++) {
+                if (f.brick[i] == index) {
+                    // Touches an owned vertex.
+                    faces.push_back(f);
+                    break;
+                }
+                auto itr = pool.find(f.vertex[i]);
+                if (itr != pool.end() &&
+                        is_inside(itr->second.coord, box_min, box_max)) {
+                    faces.push_back(f);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Gather face corners, fetching far away ones from their own bricks.
+    std::unordered_map<size_t, size_t> local_index;
+    for (size_t i=0; i<num_owned_vertices; i++) {
+        local_index[records[i].id] = i;
+    }
+    std::map<size_t, std::unordered_set<size_t> > missing;
+    for (const auto& f : faces) {
+        for (size_t i=0; i<3; i++) {
+            if (local_index.find(f.vertex[i]) != local_index.end()) continue;
+            auto itr = pool.find(f.vertex[i]);
+            if (itr != pool.end()) {
+                local_index[f.vertex[i]] = records.size();
+                records.push_back(itr->second);
+            } else {
+                missing[f.brick[i]].insert(f.vertex[i]);
+            }
+        }
+    }
+    for (auto& entry : missing) {
+        for (const auto& v : far_records[entry.first]) {
+            if (local_index.find(v.id) != local_index.end()) continue;
+            if (entry.second.find(v.id) == entry.second.end()) continue;
+            local_index[v.id] = records.size();
+            records.push_back(v);
+        }
+    }
+
+    // Owned vertices referenced by faces of other bricks, including bricks
+    // too far away for their faces to be loaded here.
+    std::unordered_set<size_t> seam_ids;
+    {
+        std::lock_guard<std::mutex> lock(m_brick_locks[index]);
+        for (auto id : read_records<uint64_t>(get_seam_file(index))) {
+            seam_ids.insert(id);
+        }
+    }
+
+    const size_t num_vertices = records.size();
+    const size_t num_faces = faces.size();
+    Brick brick;
+    brick.index = index;
+    brick.vertices.resize(num_vertices, 3);
+    brick.vertex_ids.resize(num_vertices);
+    brick.vertex_bricks.resize(num_vertices);
+    brick.vertex_on_seam = VectorI::Zero(num_vertices);
+    for (size_t i=0; i<num_vertices; i++) {
+        const auto& v = records[i];
+        brick.vertices.row(i) << v.coord[0], v.coord[1], v.coord[2];
+        brick.vertex_ids[i] = v.id;
+        brick.vertex_bricks[i] = v.brick;
+        brick.vertex_on_seam[i] = (v.brick != index) ||
+            (seam_ids.find(v.id) != seam_ids.end());
+    }
+
+    brick.faces.resize(num_faces, 3);
+    brick.face_owned.resize(num_faces);
+    for (size_t i=0; i<num_faces; i++) {
+        const bool owned = i < num_owned_faces;
+        brick.face_owned[i] = owned;
+        for (size_t j=0; j<3; j++) {
+            auto itr = local_index.find(faces[i].vertex[j]);
+            if (itr == local_index.end()) {
+                std::stringstream err_msg;
+                err_msg << "Vertex " << faces[i].vertex[j]
+                    << " is missing from brick " << faces[i].brick[j];
+                throw RuntimeError(err_msg.str());
+            }
+            brick.faces(i, j) = itr->second;
+            if (!owned) brick.vertex_on_seam[itr->second] = 1;
+        }
+    }
+    return brick;
+}
+
+void OutOfCoreMesh::store_brick(Brick& brick) {
+    PYMESH_PROFILE_ZONE("OutOfCoreMesh::store_brick");
+    const size_t num_vertices = brick.vertices.rows();
+    const size_t num_faces = brick.faces.rows();
+    if (brick.vertex_ids.size() != num_vertices ||
+            brick.vertex_bricks.size() != num_vertices) {
+        throw RuntimeError("Brick vertex ids do not match its vertices");
+    }
+    if (size_t(brick.face_owned.size()) != num_faces) {
+        throw RuntimeError("Brick face ownership does not match its faces");
+    }
+    if (num_faces > 0 && brick.faces.cols() != 3) {
+        throw NotImplementedError("Out-of-core meshes must be triangle meshes");
+    }
+
+    std::vector<VertexRecord> vertices;
+    for (size_t i=0; i<num_vertices; i++) {
+        if (brick.vertex_bricks[i] != brick.index) {
+            if (brick.vertex_ids[i] == INVALID) {
+                throw RuntimeError("New vertices must belong to the brick");
+            }
+            continue;
+        }
+        if (brick.vertex_ids[i] == INVALID) {
+            brick.vertex_ids[i] = m_next_vertex_id++;
+        }
+        VertexRecord record;
+        record.id = brick.vertex_ids[i];
+        record.brick = brick.index;
+        std::copy(brick.vertices.row(i).data(),
+                brick.vertices.row(i).data() + 3, record.coord);
+        vertices.push_back(record);
+    }
+
+    // Vertices of other bricks used by owned faces, and forward targets,
+    // are seam vertices of the brick owning them.
+    std::map<size_t, std::unordered_set<size_t> > seam_ids;
+    std::vector<FaceRecord> faces;
+    for (size_t i=0; i<num_faces; i++) {
+        if (!brick.face_owned[i]) continue;
+        FaceRecord record;
+        for (size_t j=0; j<3; j++) {
+            record.vertex[j] = brick.vertex_ids[brick.faces(i,j)];
+            record.brick[j] = brick.vertex_bricks[brick.faces(i,j)];
+            if (record.brick[j] != brick.index) {
+                seam_ids[record.brick[j]].insert(record.vertex[j]);
+            }
+        }
+        faces.push_back(record);
+    }
+
+    std::vector<ForwardRecord> forwards;
+    if (!brick.forwarded_vertices.empty()) {
+        forwards = read_records<ForwardRecord>(get_forward_file(brick.index));
+        for (const auto& entry : brick.forwarded_vertices) {
+            ForwardRecord record;
+            record.id = entry.first;
+            record.target = brick.vertex_ids[entry.second];
+            record.target_brick = brick.vertex_bricks[entry.second];
+            forwards.push_back(record);
+            seam_ids[record.target_brick].insert(record.target);
+            brick.vertex_on_seam[entry.second] = 1;
+        }
+        brick.forwarded_vertices.clear();
+    }
+
+    for (const auto& entry : seam_ids) {
+        std::lock_guard<std::mutex> lock(m_brick_locks[entry.first]);
+        const std::string seam_file = get_seam_file(entry.first);
+        const auto known = read_records<uint64_t>(seam_file);
+        std::unordered_set<size_t> added(entry.second);
+        for (auto id : known) added.erase(id);
+        append_records(seam_file,
+                std::vector<uint64_t>(added.begin(), added.end()));
+    }
+
+    std::lock_guard<std::mutex> lock(m_brick_locks[brick.index]);
+    if (!forwards.empty()) {
+        write_records(get_forward_file(brick.index), forwards);
+    }
+    write_records(get_vertex_file(brick.index), vertices);
+    write_records(get_face_file(brick.index), faces);
+    m_brick_num_vertices[brick.index] = vertices.size();
+    m_brick_num_faces[brick.index] = faces.size();
+}
+
+void OutOfCoreMesh::process(const Operation& op) {
+    PYMESH_PROFILE_ZONE("OutOfCoreMesh::process");
+    const auto active_bricks = get_active_bricks();
+    for (int phase=0; phase<8; phase++) {
+        std::vector<size_t> bricks;
+        for (auto index : active_bricks) {
+            const Vector3I coord = get_brick_coordinate(index);
+            const int color = (coord[0] & 1) | ((coord[1] & 1) << 1) |
+                ((coord[2] & 1) << 2);
+            if (color == phase) bricks.push_back(index);
+        }
+
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, bricks.size(), 1),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    for (size_t i=r.begin(); i<r.end(); i++) {
+                        Brick brick = load_brick(bricks[i]);
+                        op(brick);
+                        store_brick(brick);
+                    }
+                });
+    }
+}
+
+size_t OutOfCoreMesh::remove_duplicated_vertices(Float tol) {
+    PYMESH_PROFILE_ZONE("OutOfCoreMesh::remove_duplicated_vertices");
+    std::atomic<size_t> num_duplications(0);
+    process([&](Brick& brick) {
+        const size_t num_vertices = brick.vertices.rows();
+        HashGrid::Ptr grid = HashGrid::create(tol, 3);
+        std::vector<int> index_map(num_vertices, -1);
+
+        // Vertices of other bricks cannot be removed here, so they are
+        // inserted first and serve as merge targets.
+        for (size_t i=0; i<num_vertices; i++) {
+            if (brick.vertex_bricks[i] == brick.index) continue;
+            grid->insert(i, brick.vertices.row(i));
+            index_map[i] = i;
+        }
+        for (size_t i=0; i<num_vertices; i++) {
+            if (brick.vertex_bricks[i] != brick.index) continue;
+            const VectorF& v = brick.vertices.row(i);
+            const VectorI candidates = grid->get_items_near_point(v);
+            int best_match = -1;
+            Float min_dist = tol;
+            for (size_t j=0; j<size_t(candidates.size()); j++) {
+                const Float dist =
+                    (brick.vertices.row(candidates[j]) - v.transpose()).norm();
+                if (dist < min_dist) {
+                    min_dist = dist;
+                    best_match = candidates[j];
+                }
+            }
+            if (best_match >= 0) {
+                index_map[i] = best_match;
+                num_duplications++;
+            } else {
+                grid->insert(i, v);
+                index_map[i] = i;
+            }
+        }
+
+        std::vector<int> compact_index(num_vertices, -1);
+        size_t count = 0;
+        for (size_t i=0; i<num_vertices; i++) {
+            if (index_map[i] != int(i)) continue;
+            compact_index[i] = count;
+            count++;
+        }
+        for (size_t i=0; i<num_vertices; i++) {
+            if (index_map[i] != int(i) && brick.vertex_on_seam[i]) {
+                brick.forwarded_vertices.emplace_back(brick.vertex_ids[i],
+                        compact_index[index_map[i]]);
+            }
+        }
+        for (size_t i=0; i<num_vertices; i++) {
+            if (index_map[i] != int(i)) continue;
+            const size_t j = compact_index[i];
+            brick.vertices.row(j) = brick.vertices.row(i);
+            brick.vertex_ids[j] = brick.vertex_ids[i];
+            brick.vertex_bricks[j] = brick.vertex_bricks[i];
+            brick.vertex_on_seam[j] = brick.vertex_on_seam[i];
+        }
+        brick.vertices.conservativeResize(count, 3);
+        brick.vertex_ids.resize(count);
+        brick.vertex_bricks.resize(count);
+        brick.vertex_on_seam.conservativeResize(count);
+
+        const size_t num_faces = brick.faces.rows();
+        for (size_t i=0; i<num_faces; i++) {
+            for (size_t j=0; j<3; j++) {
+                brick.faces(i,j) = compact_index[index_map[brick.faces(i,j)]];
+            }
+        }
+    });
+    return num_duplications;
+}
+
+void OutOfCoreMesh::initialize_grid(const Vector3F& bbox_min,
+        const Vector3F& bbox_max) {
+    m_bbox_min = bbox_min;
+    size_t num_bricks = 1;
+    for (size_t i=0; i<3; i++) {
+        const Float extent = bbox_max[i] - bbox_min[i];
+        m_grid_size[i] = std::max(1, int(std::ceil(extent / m_brick_size)));
+        num_bricks *= m_grid_size[i];
+        if (num_bricks > std::numeric_limits<uint32_t>::max()) {
+            throw RuntimeError("Too many bricks, please increase brick size");
+        }
+    }
+    m_brick_num_vertices.assign(num_bricks, 0);
+    m_brick_num_faces.assign(num_bricks, 0);
+    m_brick_locks.reset(new std::mutex[num_bricks]);
+
+    // Spill files are appended to, so stale ones must go.
+    for (size_t i=0; i<num_bricks; i++) {
+        std::remove(get_vertex_file(i).c_str());
+        std::remove(get_face_file(i).c_str());
+        std::remove(get_forward_file(i).c_str());
+        std::remove(get_seam_file(i).c_str());
+    }
+}
+
+size_t OutOfCoreMesh::get_brick_index(const Float* coord) const {
+    size_t index = 0;
+    for (int i=2; i>=0; i--) {
+        int cell = int(std::floor((coord[i] - m_bbox_min[i]) / m_brick_size));
+        cell = std::max(0, std::min(m_grid_size[i]-1, cell));
+        index = index * m_grid_size[i] + cell;
+    }
+    return index;
+}
+
+Vector3I OutOfCoreMesh::get_brick_coordinate(size_t index) const {
+    Vector3I coord;
+    for (size_t i=0; i<3; i++) {
+        coord[i] = index % m_grid_size[i];
+        index /= m_grid_size[i];
+    }
+    return coord;
+}
+
+std::vector<size_t> OutOfCoreMesh::get_neighbours(size_t index) const {
+    const Vector3I coord = get_brick_coordinate(index);
+    std::vector<size_t> neighbours;
+    for (int k=std::max(0, coord[2]-1); k<=std::min(m_grid_size[2]-1, coord[2]+1); k++) {
+        for (int j=std::max(0, coord[1]-1); j<=std::min(m_grid_size[1]-1, coord[1]+1); j++) {
+            for (int i=std::max(0, coord[0]-1); i<=std::min(m_grid_size[0]-1, coord[0]+1); i++) {
+                const size_t n = i + m_grid_size[0] * (j + size_t(m_grid_size[1]) * k);
+                if (n != index) neighbours.push_back(n);
+            }
+        }
+    }
+    return neighbours;
+}
+
+std::string OutOfCoreMesh::get_vertex_file(size_t index) const {
+    std::stringstream filename;
+    filename << m_work_dir << "/brick_" << index << ".vtx";
+    return filename.str();
+}
+
+std::unordered_map<size_t, size_t> OutOfCoreMesh::read_forwards() const {
+    std::unordered_map<size_t, size_t> forwards;
+    const size_t num_bricks = get_num_bricks();
+    for (size_t i=0; i<num_bricks; i++) {
+        for (const auto& r : read_records<ForwardRecord>(get_forward_file(i))) {
+            forwards[r.id] = r.target;
+        }
+    }
+    return forwards;
+}
+
+std::string OutOfCoreMesh::get_forward_file(size_t index) const {
+    std::stringstream filename;
+    filename << m_work_dir << "/brick_" << index << ".fwd";
+    return filename.str();
+}
+
+std::string OutOfCoreMesh::get_seam_file(size_t index) const {
+    std::stringstream filename;
+    filename << m_work_dir << "/brick_" << index << ".sem";
+    return filename.str();
+}
+
+std::string OutOfCoreMesh::get_face_file(size_t index) const {
+    std::stringstream filename;
+    filename << m_work_dir << "/brick_" << index << ".fac";
+    return filename.str();
+}
+
+void OutOfCoreMesh::clear() {
+    const size_t num_bricks = get_num_bricks();
+    for (size_t i=0; i<num_bricks; i++) {
+        std::remove(get_vertex_file(i).c_str());
+        std::remove(get_face_file(i).c_str());
+        std::remove(get_forward_file(i).c_str());
+        std::remove(get_seam_file(i).c_str());
+    }
+    m_brick_num_vertices.clear();
+    m_brick_num_faces.clear();
+    m_next_vertex_id = 0;
+}
@@ -0,0 +1,141 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Core/EigenTypedef.h>
+
+namespace PyMesh {
+
+/**
+ * Out-of-core storage for 3D triangle meshes that do not fit in memory.
+ *
+ * The mesh is streamed in once and split into a regular grid of bricks.
+ * Each brick owns the vertices inside it and the faces whose first vertex it
+ * owns, and keeps them in its own spill files under the work directory.
+ * Vertices keep a global id, which is how faces in different bricks refer to
+ * the same vertex and how results are stitched together at brick seams.
+ *
+ * When a brick is loaded, faces from neighbouring bricks that come within
+ * the halo width of it are included as read-only context.  process() runs an
+ * operation on every brick across cores; bricks are scheduled in 8 colour
+ * phases so that no two concurrent bricks are neighbours.  Long faces can
+ * still reach bricks further away, so each brick records which of its
+ * vertices are used by faces of other bricks, and files of bricks beyond the
+ * neighbours are only accessed under a per-brick lock.
+ *
+ * Only a brick neighbourhood per worker thread is held in memory, plus 4
+ * bytes per vertex while importing or exporting and the table of merged
+ * seam vertices while exporting.
+ */
+class OutOfCoreMesh {
+    public:
+        using Ptr = std::shared_ptr<OutOfCoreMesh>;
+        static constexpr size_t INVALID = std::numeric_limits<size_t>::max();
+
+        /**
+         * A loaded brick.  vertex_ids holds the global id of each vertex and
+         * vertex_bricks the brick owning it.  Faces with face_owned[i] == 0
+         * and vertices owned by other bricks are halo context.
+         *
+         * vertex_on_seam marks vertices shared with other bricks, including
+         * owned vertices used by faces of bricks that are not neighbours.
+         * Operations may only change owned faces and owned vertices, must not
+         * move seam vertices, and may only remove an owned seam vertex by
+         * listing its global id and the local vertex replacing it in
+         * forwarded_vertices.
+         * New vertices should be appended with id INVALID and this brick's
+         * index.  Halo faces are dropped when storing.
+         */
+        struct Brick {
+            size_t index;
+            MatrixFr vertices;
+            MatrixIr faces;
+            std::vector<size_t> vertex_ids;
+            std::vector<size_t> vertex_bricks;
+            VectorI vertex_on_seam;
+            VectorI face_owned;
+            std::vector<std::pair<size_t, size_t> > forwarded_vertices;
+        };
+        using Operation = std::function<void(Brick&)>;
+
+    public:
+        /**
+         * work_dir must exist.  halo_width must not exceed brick_size.
+         */
+        OutOfCoreMesh(const std::string& work_dir,
+                Float brick_size, Float halo_width);
+        ~OutOfCoreMesh();
+
+    public:
+        /**
+         * Stream a PLY file into bricks.  The file is read twice: once for
+         * the bounding box and once to distribute the data.  Polygons are
+         * fan triangulated.
+         */
+        void import_ply(const std::string& filename);
+        void import_mesh(const MatrixFr& vertices, const MatrixIr& faces);
+
+        /**
+         * Write the stitched mesh.  Vertices are numbered brick by brick.
+         */
+        void export_ply(const std::string& filename, bool in_ascii=false) const;
+        void export_mesh(MatrixFr& vertices, MatrixIr& faces) const;
+
+    public:
+        size_t get_num_vertices() const;
+        size_t get_num_faces() const;
+        size_t get_num_bricks() const { return m_brick_num_vertices.size(); }
+        Vector3I get_grid_size() const { return m_grid_size; }
+        std::vector<size_t> get_active_bricks() const;
+
+        Brick load_brick(size_t index) const;
+        void store_brick(Brick& brick);
+
+        /**
+         * Run op on every non-empty brick and store the result.
+         */
+        void process(const Operation& op);
+
+        /**
+         * Merge vertices closer than tol, including duplicates referenced
+         * from different bricks.  Returns the number of vertices removed.
+         */
+        size_t remove_duplicated_vertices(Float tol);
+
+    private:
+        class Partitioner;
+
+        void initialize_grid(const Vector3F& bbox_min,
+                const Vector3F& bbox_max);
+        size_t get_brick_index(const Float* coord) const;
+        Vector3I get_brick_coordinate(size_t index) const;
+        std::vector<size_t> get_neighbours(size_t index) const;
+        std::string get_vertex_file(size_t index) const;
+        std::string get_face_file(size_t index) const;
+        std::string get_forward_file(size_t index) const;
+        std::string get_seam_file(size_t index) const;
+        std::unordered_map<size_t, size_t> read_forwards() const;
+        void clear();
+
+    private:
+        std::string m_work_dir;
+        Float m_brick_size;
+        Float m_halo_width;
+        Vector3F m_bbox_min;
+        Vector3I m_grid_size;
+        std::vector<size_t> m_brick_num_vertices;
+        std::vector<size_t> m_brick_num_faces;
+        std::unique_ptr<std::mutex[]> m_brick_locks;
+        std::atomic<size_t> m_next_vertex_id;
+};
+
+}
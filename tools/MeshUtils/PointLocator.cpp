@@ -1,63 +1,97 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #include "PointLocator.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <limits>
 #include <sstream>
+#include <utility>
+
+#include <tbb/tbb.h>
 
 #include <Core/Exception.h>
 #include <Misc/HashGrid.h>
 
 using namespace PyMesh;
 
+namespace PointLocatorHelper {
+    const Float EPSILON = 1e-6;
+    const size_t BATCH_SIZE = 256;
+    const size_t MAX_WALK_STEPS = 64;
+
+    /**
+     * Interleave the lower bits of x with num_gaps zero bits in between.
+     */
+    uint64_t spread_bits(uint64_t x, size_t num_bits, size_t num_gaps) {
+        uint64_t result = 0;
+        for (size_t i=0; i<num_bits; i++) {
+            result |= ((x >> i) & uint64_t(1)) << (i * (num_gaps+1));
+        }
+        return result;
+    }
+}
+
+using namespace PointLocatorHelper;
+
 PointLocator::PointLocator(Mesh::Ptr mesh) : m_mesh(mesh) {
     init_elements();
     init_barycentric_solvers();
     init_hash_grid();
+    init_neighbors();
 }
 
 void PointLocator::locate(const MatrixFr& points) {
-    const Float eps = 1e-6;
     const size_t num_pts = points.rows();
+    if (num_pts > 0 && size_t(points.cols()) != m_dim) {
+        std::stringstream err_msg;
+        err_msg << "Point dimension mismatch, expect " << m_dim;
+        throw RuntimeError(err_msg.str());
+    }
     m_voxel_idx = VectorI::Zero(num_pts);
     m_barycentric_coords = MatrixFr::Zero(num_pts, m_vertex_per_element);
 
-    for (size_t i=0; i<num_pts; i++) {
-        VectorF v = points.row(i);
-        VectorI candidate_elems = m_grid->get_items_near_point(v);
-
-        VectorF barycentric_coord;
-        VectorF best_barycentric_coord;
-
-        bool found = false;
-        Float least_negative_coordinate = -std::numeric_limits<Float>::max();
-        const size_t num_candidates = candidate_elems.size();
-        for (size_t j=0; j<num_candidates; j++) {
-            barycentric_coord = compute_barycentric_coord(
-                    v, candidate_elems[j]);
-            Float min_barycentric_coord = barycentric_coord.minCoeff();
-            if (min_barycentric_coord > least_negative_coordinate) {
-                found = true;
-                least_negative_coordinate = min_barycentric_coord;
-                m_voxel_idx[i] = candidate_elems[j];
-                best_barycentric_coord = barycentric_coord;
-                if (min_barycentric_coord >= -eps) {
-                    break;
+    const std::vector<size_t> order = compute_morton_order(points);
+    std::vector<char> not_found(num_pts, 0);
+    const size_t num_batches = (num_pts + BATCH_SIZE - 1) / BATCH_SIZE;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_batches),
+            [&](const tbb::blocked_range<size_t>& r) {
+                Float coord[4];
+                for (size_t b=r.begin(); b!=r.end(); b++) {
+                    // Each batch restarts the walk so the result does not
+                    // depend on scheduling.
+                    int prev_elem = -1;
+                    const size_t batch_end =
+                        std::min(num_pts, (b+1) * BATCH_SIZE);
+                    for (size_t k=b*BATCH_SIZE; k<batch_end; k++) {
+                        const size_t i = order[k];
+                        const Float* v = points.data() + i * m_dim;
+                        int elem_idx = -1;
+                        if (prev_elem < 0 ||
+                                !walk(v, prev_elem, elem_idx, coord)) {
+                            if (!search_grid(v, elem_idx, coord)) {
+                                not_found[i] = 1;
+                                continue;
+                            }
+                        }
+                        m_voxel_idx[i] = elem_idx;
+                        for (size_t j=0; j<m_vertex_per_element; j++) {
+                            m_barycentric_coords(i, j) = coord[j];
+                        }
+                        prev_elem = elem_idx;
+                    }
                 }
-            }
-        }
+            });
 
-        if (!found) {
-            std::stringstream err_msg;
-            err_msg << "Point ( ";
-            for (size_t i=0; i<m_mesh->get_dim(); i++) {
-                err_msg << v[i] << " ";
-            }
-            err_msg << ") is not inside of any voxels" << std::endl;
-            throw RuntimeError(err_msg.str());
+    for (size_t i=0; i<num_pts; i++) {
+        if (!not_found[i]) continue;
+        std::stringstream err_msg;
+        err_msg << "Point ( ";
+        for (size_t j=0; j<m_dim; j++) {
+            err_msg << points(i, j) << " ";
         }
-
-        m_barycentric_coords.row(i) = best_barycentric_coord;
+        err_msg << ") is not inside of any voxels" << std::endl;
+        throw RuntimeError(err_msg.str());
     }
 }
 
@@ -68,6 +102,7 @@ void PointLocator::clear() {
 
 void PointLocator::init_elements() {
     const size_t dim = m_mesh->get_dim();
+    m_dim = dim;
 
     if (dim == 2) {
         if (m_mesh->get_num_faces() == 0) {
@@ -95,22 +130,30 @@ void PointLocator::init_elements() {
 }
 
 void PointLocator::init_barycentric_solvers() {
-    const size_t dim = m_mesh->get_dim();
-
+    const size_t dim = m_dim;
     const size_t num_elements = m_elements.size() / m_vertex_per_element;
-    m_barycentric_solvers = MatrixF::Zero(num_elements*dim, dim);
-    m_last_vertices = MatrixF::Zero(num_elements, dim);
+    m_barycentric_solvers.resize(num_elements*dim*dim);
+    m_last_vertices.resize(num_elements*dim);
 
-    for (size_t i=0; i<num_elements; i++) {
-        VectorI elem = m_elements.segment(i*m_vertex_per_element, m_vertex_per_element);
-        VectorF last_v = m_mesh->get_vertex(elem[dim]);
-        MatrixFr M(dim, dim);
-        for (size_t j=0; j<dim; j++) {
-            M.row(j) = m_mesh->get_vertex(elem[j]) - last_v;
-        }
-        m_barycentric_solvers.block(i*dim, 0, dim, dim) = M.transpose().inverse();
-        m_last_vertices.row(i) = last_v;
-    }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_elements),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    VectorI elem = m_elements.segment(
+                            i*m_vertex_per_element, m_vertex_per_element);
+                    VectorF last_v = m_mesh->get_vertex(elem[dim]);
+                    MatrixF M(dim, dim);
+                    for (size_t j=0; j<dim; j++) {
+                        M.row(j) = m_mesh->get_vertex(elem[j]) - last_v;
+                    }
+                    MatrixF solver = M.transpose().inverse();
+                    for (size_t j=0; j<dim; j++) {
+                        for (size_t k=0; k<dim; k++) {
+                            m_barycentric_solvers[(i*dim+j)*dim+k] = solver(j,k);
+                        }
+                        m_last_vertices[i*dim+j] = last_v[j];
+                    }
+                }
+            });
 }
 
 void PointLocator::init_hash_grid() {
@@ -149,15 +192,134 @@ Float PointLocator::compute_cell_size() const {
     return 0.1 * ave_edge_len;
 }
 
-VectorF PointLocator::compute_barycentric_coord(const VectorF& v,
-        size_t elem_idx) {
-    const size_t dim = m_mesh->get_dim();
-    MatrixF solver = m_barycentric_solvers.block(elem_idx*dim, 0, dim, dim);
-    VectorF last_v = m_last_vertices.row(elem_idx);
-    VectorF sol = solver * (v - last_v);
-    VectorF barycentric_coord(m_vertex_per_element);
-    barycentric_coord.segment(0, dim) = sol;
-    barycentric_coord[dim] = 1.0 - sol.sum();
-    return barycentric_coord;
+void PointLocator::init_neighbors() {
+    const size_t num_elements = m_elements.size() / m_vertex_per_element;
+    if (m_dim == 2) {
+        m_mesh->enable_face_connectivity();
+    } else {
+        m_mesh->enable_voxel_connectivity();
+    }
+
+    m_neighbors.assign(num_elements * m_vertex_per_element, -1);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_elements),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const VectorI adj_elems = (m_dim == 2) ?
+                        m_mesh->get_face_adjacent_faces(i) :
+                        m_mesh->get_voxel_adjacent_voxels(i);
+                    const int* elem = m_elements.data() + i*m_vertex_per_element;
+                    const size_t num_adj = adj_elems.size();
+                    for (size_t j=0; j<num_adj; j++) {
+                        const int* adj = m_elements.data() +
+                            adj_elems[j]*m_vertex_per_element;
+                        // The neighbor is opposite to the only vertex not
+                        // shared with it.
+                        for (size_t k=0; k<m_vertex_per_element; k++) {
+                            if (std::find(adj, adj+m_vertex_per_element,
+                                        elem[k]) == adj+m_vertex_per_element) {
+                                m_neighbors[i*m_vertex_per_element+k] =
+                                    adj_elems[j];
+                                break;
+                            }
+                        }
+                    }
+                }
+            });
 }
 
+std::vector<size_t> PointLocator::compute_morton_order(
+        const MatrixFr& points) const {
+    typedef std::pair<uint64_t, size_t> CodeIndex;
+    const size_t num_pts = points.rows();
+    std::vector<size_t> order(num_pts);
+    if (num_pts == 0) return order;
+
+    const size_t num_bits = (m_dim == 2) ? 31 : 21;
+    const Float max_code = Float((uint64_t(1) << num_bits) - 1);
+    const VectorF bbox_min = points.colwise().minCoeff();
+    const VectorF bbox_max = points.colwise().maxCoeff();
+    const Float extent = (bbox_max - bbox_min).maxCoeff();
+    const Float scale = extent > 0.0 ? max_code / extent : 0.0;
+
+    std::vector<CodeIndex> codes(num_pts);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_pts),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    uint64_t code = 0;
+                    for (size_t j=0; j<m_dim; j++) {
+                        const uint64_t c = uint64_t(
+                                (points(i, j) - bbox_min[j]) * scale);
+                        code |= spread_bits(c, num_bits, m_dim-1) << j;
+                    }
+                    codes[i] = {code, i};
+                }
+            });
+    tbb::parallel_sort(codes.begin(), codes.end());
+
+    for (size_t i=0; i<num_pts; i++) {
+        order[i] = codes[i].second;
+    }
+    return order;
+}
+
+void PointLocator::compute_barycentric_coord(const Float* v,
+        size_t elem_idx, Float* barycentric_coord) const {
+    const size_t dim = m_dim;
+    const Float* solver = m_barycentric_solvers.data() + elem_idx*dim*dim;
+    const Float* last_v = m_last_vertices.data() + elem_idx*dim;
+    Float sum = 0.0;
+    for (size_t i=0; i<dim; i++) {
+        Float val = 0.0;
+        for (size_t j=0; j<dim; j++) {
+            val += solver[i*dim+j] * (v[j] - last_v[j]);
+        }
+        barycentric_coord[i] = val;
+        sum += val;
+    }
+    barycentric_coord[dim] = 1.0 - sum;
+}
+
+bool PointLocator::walk(const Float* v, int start_elem,
+        int& elem_idx, Float* barycentric_coord) const {
+    int curr_elem = start_elem;
+    for (size_t step=0; step<MAX_WALK_STEPS; step++) {
+        compute_barycentric_coord(v, curr_elem, barycentric_coord);
+        const Float* min_itr = std::min_element(barycentric_coord,
+                barycentric_coord + m_vertex_per_element);
+        if (*min_itr >= -EPSILON) {
+            elem_idx = curr_elem;
+            return true;
+        }
+        // Step across the facet opposite to the most negative coordinate.
+        curr_elem = m_neighbors[curr_elem*m_vertex_per_element +
+            (min_itr - barycentric_coord)];
+        if (curr_elem < 0) return false;
+    }
+    return false;
+}
+
+bool PointLocator::search_grid(const Float* v,
+        int& elem_idx, Float* barycentric_coord) const {
+    VectorF p = Eigen::Map<const VectorF>(v, m_dim);
+    VectorI candidate_elems = m_grid->get_items_near_point(p);
+
+    Float coord[4];
+    bool found = false;
+    Float least_negative_coordinate = -std::numeric_limits<Float>::max();
+    const size_t num_candidates = candidate_elems.size();
+    for (size_t j=0; j<num_candidates; j++) {
+        compute_barycentric_coord(v, candidate_elems[j], coord);
+        Float min_barycentric_coord = *std::min_element(
+                coord, coord + m_vertex_per_element);
+        if (min_barycentric_coord > least_negative_coordinate) {
+            found = true;
+            least_negative_coordinate = min_barycentric_coord;
+            elem_idx = candidate_elems[j];
+            std::copy(coord, coord + m_vertex_per_element, barycentric_coord);
+            if (min_barycentric_coord >= -EPSILON) {
+                break;
+            }
+        }
+    }
+    return found;
+}
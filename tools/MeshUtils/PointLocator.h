@@ -15,6 +15,10 @@ class PointLocator {
         /**
          * Determine the voxel enclosing each point.  Compute barycentric
          * coordinates as a byproduct.
+         *
+         * Points are processed in parallel batches in Morton order.  Each
+         * point starts a visibility walk from the previous point's element
+         * and falls back to a hash grid query if the walk fails.
          */
         void locate(const MatrixFr& points);
 
@@ -32,18 +36,36 @@ class PointLocator {
         void init_elements();
         void init_barycentric_solvers();
         void init_hash_grid();
+        void init_neighbors();
 
         Float compute_cell_size() const;
-        VectorF compute_barycentric_coord(const VectorF& v, size_t elem_idx);
+        std::vector<size_t> compute_morton_order(const MatrixFr& points) const;
+        void compute_barycentric_coord(const Float* v, size_t elem_idx,
+                Float* barycentric_coord) const;
+        bool walk(const Float* v, int start_elem,
+                int& elem_idx, Float* barycentric_coord) const;
+        bool search_grid(const Float* v,
+                int& elem_idx, Float* barycentric_coord) const;
 
     private:
         Mesh::Ptr m_mesh;
 
         VectorI m_elements;
+        size_t m_dim;
         size_t m_vertex_per_element;
 
-        MatrixF m_barycentric_solvers;
-        MatrixF m_last_vertices;
+        /**
+         * Per element, dim x dim row-major inverse of the edge matrix and the
+         * coordinates of the last element vertex, stored contiguously.
+         */
+        std::vector<Float> m_barycentric_solvers;
+        std::vector<Float> m_last_vertices;
+
+        /**
+         * m_neighbors[i*vertex_per_element+j] is the element sharing the
+         * facet opposite to the j-th vertex of element i, or -1.
+         */
+        std::vector<int> m_neighbors;
 
         HashGrid::Ptr m_grid;
 
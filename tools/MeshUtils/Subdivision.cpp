@@ -3,7 +3,11 @@
 #include "SimpleSubdivision.h"
 #include "LoopSubdivision.h"
 
+#include <cstdint>
 #include <sstream>
+#include <utility>
+
+#include <tbb/tbb.h>
 
 #include <Core/Exception.h>
 
@@ -20,3 +24,214 @@ Subdivision::Ptr Subdivision::create(const std::string& type) {
         throw NotImplementedError(err_msg.str());
     }
 }
+
+void Subdivision::subdivide(
+        MatrixFr vertices, MatrixIr faces, size_t num_iterations) {
+    if (faces.cols() != 3) {
+        throw NotImplementedError(
+                "Only triangles mesh subdivision are supported!");
+    }
+    m_vertices = vertices;
+    m_faces = faces;
+    m_subdivision_matrices.clear();
+    initialize_face_indices();
+
+    for (size_t i=0; i<num_iterations; i++) {
+        subdivide_once();
+    }
+}
+
+void Subdivision::initialize_face_indices() {
+    const size_t num_faces = m_faces.rows();
+    m_face_indices.resize(num_faces);
+    for (size_t i=0; i<num_faces; i++) {
+        m_face_indices[i] = i;
+    }
+}
+
+void Subdivision::subdivide_once() {
+    extract_edges();
+    prepare_stencils();
+    compute_subdivided_vertices();
+    extract_sub_faces();
+}
+
+void Subdivision::extract_edges() {
+    typedef std::pair<uint64_t, int> KeyCorner;
+    const size_t num_faces = m_faces.rows();
+    const size_t num_corners = num_faces * 3;
+
+    // Sort all face corners by their undirected edge key, ties are broken
+    // by corner index so that the first corner of each group is the edge's
+    // first appearance.
+    std::vector<KeyCorner> corners(num_corners);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_faces),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    for (size_t j=0; j<3; j++) {
+                        const uint32_t v0 = m_faces(i, j);
+                        const uint32_t v1 = m_faces(i, (j+1)%3);
+                        const uint64_t key = v0 < v1 ?
+                            (uint64_t(v0) << 32) | v1 :
+                            (uint64_t(v1) << 32) | v0;
+                        corners[i*3+j] = {key, int(i*3+j)};
+                    }
+                }
+            });
+    tbb::parallel_sort(corners.begin(), corners.end());
+
+    std::vector<size_t> group_starts;
+    for (size_t i=0; i<num_corners; i++) {
+        if (i == 0 || corners[i].first != corners[i-1].first) {
+            group_starts.push_back(i);
+        }
+    }
+    const size_t num_edges = group_starts.size();
+    group_starts.push_back(num_corners);
+
+    // Edge index is the rank of its first corner.
+    std::vector<int> edge_index(num_corners, 0);
+    for (size_t i=0; i<num_edges; i++) {
+        edge_index[corners[group_starts[i]].second] = 1;
+    }
+    int count = 0;
+    for (size_t i=0; i<num_corners; i++) {
+        const int is_first = edge_index[i];
+        edge_index[i] = count;
+        count += is_first;
+    }
+
+    m_edges.resize(num_edges, 2);
+    m_face_edges.resize(num_faces, 3);
+    m_edge_adj_offsets.assign(num_edges+1, 0);
+    m_edge_adj_corners.resize(num_corners);
+    for (size_t i=0; i<num_edges; i++) {
+        const int first_corner = corners[group_starts[i]].second;
+        m_edge_adj_offsets[edge_index[first_corner]+1] =
+            group_starts[i+1] - group_starts[i];
+    }
+    for (size_t i=0; i<num_edges; i++) {
+        m_edge_adj_offsets[i+1] += m_edge_adj_offsets[i];
+    }
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_edges),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const int first_corner = corners[group_starts[i]].second;
+                    const int edge_idx = edge_index[first_corner];
+                    const int fi = first_corner / 3;
+                    const int ci = first_corner % 3;
+                    m_edges(edge_idx, 0) = m_faces(fi, ci);
+                    m_edges(edge_idx, 1) = m_faces(fi, (ci+1)%3);
+
+                    int offset = m_edge_adj_offsets[edge_idx];
+                    for (size_t j=group_starts[i]; j<group_starts[i+1]; j++) {
+                        const int corner = corners[j].second;
+                        m_edge_adj_corners[offset] = corner;
+                        m_face_edges(corner / 3, corner % 3) = edge_idx;
+                        offset++;
+                    }
+                }
+            });
+}
+
+void Subdivision::extract_sub_faces() {
+    const size_t num_faces = m_faces.rows();
+    const int base_index = m_vertices.rows() - get_num_edges();
+    const size_t num_sub_faces = 4 * num_faces;
+
+    MatrixIr sub_faces(num_sub_faces, 3);
+    VectorI sub_face_indices(num_sub_faces);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_faces),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const Vector3I face = m_faces.row(i);
+                    const Vector3I mid_edge_idx =
+                        m_face_edges.row(i).transpose().array() + base_index;
+
+                    sub_faces.row(i*4  ) << face[0], mid_edge_idx[0], mid_edge_idx[2];
+                    sub_faces.row(i*4+1) << face[1], mid_edge_idx[1], mid_edge_idx[0];
+                    sub_faces.row(i*4+2) << face[2], mid_edge_idx[2], mid_edge_idx[1];
+                    sub_faces.row(i*4+3) << mid_edge_idx[0], mid_edge_idx[1], mid_edge_idx[2];
+                    sub_face_indices.segment<4>(i*4).setConstant(m_face_indices[i]);
+                }
+            });
+
+    m_faces.swap(sub_faces);
+    m_face_indices.swap(sub_face_indices);
+}
+
+void Subdivision::compute_subdivided_vertices() {
+    const size_t num_vertices = m_vertices.rows();
+    const size_t num_rows = num_vertices + get_num_edges();
+    const size_t dim = m_vertices.cols();
+    MatrixFr sub_vertices(num_rows, dim);
+
+    if (m_matrix_mode == MATRIX_FREE) {
+        // Evaluate stencils on the fly without storing them.
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_rows),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    std::vector<int> indices;
+                    std::vector<Float> weights;
+                    for (size_t i=r.begin(); i!=r.end(); i++) {
+                        const size_t row_size = get_stencil_size(i);
+                        indices.resize(row_size);
+                        weights.resize(row_size);
+                        compute_stencil(i, indices.data(), weights.data());
+
+                        sub_vertices.row(i).setZero();
+                        for (size_t j=0; j<row_size; j++) {
+                            sub_vertices.row(i) +=
+                                weights[j] * m_vertices.row(indices[j]);
+                        }
+                    }
+                });
+        m_vertices.swap(sub_vertices);
+        return;
+    }
+
+    std::vector<int> offsets(num_rows+1, 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_rows),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    offsets[i+1] = get_stencil_size(i);
+                }
+            });
+    for (size_t i=0; i<num_rows; i++) {
+        offsets[i+1] += offsets[i];
+    }
+
+    typedef Eigen::Triplet<Float> T;
+    const size_t num_entries = offsets[num_rows];
+    std::vector<T> entries(num_entries);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_rows),
+            [&](const tbb::blocked_range<size_t>& r) {
+                std::vector<int> indices;
+                std::vector<Float> weights;
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const size_t row_size = offsets[i+1] - offsets[i];
+                    indices.resize(row_size);
+                    weights.resize(row_size);
+                    compute_stencil(i, indices.data(), weights.data());
+
+                    sub_vertices.row(i).setZero();
+                    for (size_t j=0; j<row_size; j++) {
+                        sub_vertices.row(i) +=
+                            weights[j] * m_vertices.row(indices[j]);
+                        entries[offsets[i]+j] = T(i, indices[j], weights[j]);
+                    }
+                }
+            });
+
+    ZSparseMatrix subdiv_mat(num_rows, num_vertices);
+    subdiv_mat.setFromTriplets(entries.begin(), entries.end());
+    if (m_matrix_mode == COMPOSED_MATRIX && !m_subdivision_matrices.empty()) {
+        ZSparseMatrix::ParentType composed =
+            subdiv_mat * m_subdivision_matrices.back();
+        m_subdivision_matrices.back() = composed;
+    } else {
+        m_subdivision_matrices.push_back(subdiv_mat);
+    }
+
+    m_vertices.swap(sub_vertices);
+}
@@ -13,18 +13,42 @@ class Subdivision {
 
         static Ptr create(const std::string& type);
 
+        /**
+         * Controls how the subdivision operators are stored.
+         *
+         * PER_LEVEL_MATRICES: one sparse matrix per iteration (default).
+         * COMPOSED_MATRIX:    a single sparse matrix mapping the input
+         *                     vertices to the output vertices.
+         * MATRIX_FREE:        stencils are applied directly to the
+         *                     vertices, no matrix is stored.
+         */
+        enum MatrixMode {
+            PER_LEVEL_MATRICES,
+            COMPOSED_MATRIX,
+            MATRIX_FREE
+        };
+
     public:
+        Subdivision() : m_matrix_mode(PER_LEVEL_MATRICES) {}
         virtual ~Subdivision() {}
 
         virtual void subdivide(MatrixFr vertices, MatrixIr faces,
-                size_t num_iterations)=0;
+                size_t num_iterations);
 
         /**
          * Each iteration of subdivision can be thought of as applying a linear
          * transfermation on the vertex coordinates.  This method compute and
          * returns such transformation matrices for each iteration.
+         *
+         * In COMPOSED_MATRIX mode, a single matrix combining all iterations
+         * is returned.  In MATRIX_FREE mode, the returned vector is empty.
          */
-        virtual const std::vector<ZSparseMatrix>& get_subdivision_matrices() const=0;
+        virtual const std::vector<ZSparseMatrix>& get_subdivision_matrices() const {
+            return m_subdivision_matrices;
+        }
+
+        void set_matrix_mode(MatrixMode mode) { m_matrix_mode = mode; }
+        MatrixMode get_matrix_mode() const { return m_matrix_mode; }
 
     public:
         MatrixFr get_vertices() const { return m_vertices; }
@@ -34,9 +58,51 @@ class Subdivision {
         size_t get_num_vertices() const { return m_vertices.rows(); }
         size_t get_num_faces() const { return m_faces.rows(); }
 
+    protected:
+        void initialize_face_indices();
+        void subdivide_once();
+
+        /**
+         * Extract the unique edges of the current level.  Edges are indexed
+         * by their first appearance in the face array.
+         */
+        void extract_edges();
+        void extract_sub_faces();
+        void compute_subdivided_vertices();
+
+        /**
+         * Subdivision schemes are defined by a stencil for each output
+         * vertex.  The first #vertices rows are the updated input vertices,
+         * the next #edges rows are the mid-edge vertices.
+         */
+        virtual void prepare_stencils() {}
+        virtual size_t get_stencil_size(size_t row) const =0;
+        virtual void compute_stencil(size_t row,
+                int* indices, Float* weights) const =0;
+
+        size_t get_num_edges() const { return m_edges.rows(); }
+        size_t get_edge_valance(size_t edge_idx) const {
+            return m_edge_adj_offsets[edge_idx+1] - m_edge_adj_offsets[edge_idx];
+        }
+
     protected:
         MatrixFr m_vertices;
         MatrixIr m_faces;
         VectorI  m_face_indices;
+
+        MatrixMode m_matrix_mode;
+        std::vector<ZSparseMatrix> m_subdivision_matrices;
+
+        /**
+         * Per level edge table.
+         *   m_edges:            unique edges, oriented as first encountered.
+         *   m_face_edges:       edge index of (f[j], f[j+1]) for each face.
+         *   m_edge_adj_offsets: CSR offsets into m_edge_adj_corners.
+         *   m_edge_adj_corners: face corners (3*f+j) adjacent to each edge.
+         */
+        MatrixIr m_edges;
+        MatrixIr m_face_edges;
+        std::vector<int> m_edge_adj_offsets;
+        std::vector<int> m_edge_adj_corners;
 };
 }
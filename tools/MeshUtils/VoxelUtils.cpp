@@ -1,9 +1,12 @@
 /* This file is part of PyMesh. Copyright (c) 2017 by Qingnan Zhou */
 #include "VoxelUtils.h"
 
+#include <limits>
+#include <vector>
+
 #include <Core/Exception.h>
-#include <Predicates/predicates.h>
-#include <Misc/MultipletMap.h>
+#include <Predicates/BatchPredicates.h>
+#include <Misc/MultipletIndex.h>
 
 using namespace PyMesh;
 
@@ -20,38 +23,19 @@ VectorF VoxelUtils::get_tet_orientations(
         throw RuntimeError("Degenerate tet expect a tet mesh.");
     }
 
-    exactinit();
-    VectorF results(num_tets);
-    results.setZero();
-    for (size_t i=0; i<num_tets; i++) {
-        const Vector4I tet = voxels.row(i);
-        Float a[3]{
-            vertices(tet[0], 0),
-            vertices(tet[0], 1),
-            vertices(tet[0], 2)};
-        Float b[3]{
-            vertices(tet[1], 0),
-            vertices(tet[1], 1),
-            vertices(tet[1], 2)};
-        Float c[3]{
-            vertices(tet[2], 0),
-            vertices(tet[2], 1),
-            vertices(tet[2], 2)};
-        Float d[3]{
-            vertices(tet[3], 0),
-            vertices(tet[3], 1),
-            vertices(tet[3], 2)};
-
-        // NOTE:
-        //
-        // orient3d(a,b,c,d) returns positive if d is below the plane defined by
-        // triangle (a, b, c).  The tet vertex ordering used by MSH format is
-        // the opposite (i.e. d is above the triangle (a,b,c)), so this check
-        // switch the ordering of a and b to return positive if tet is not
-        // inverted.
-        results[i] = orient3d(b, a, c, d);
-    }
-    return results;
+    // NOTE:
+    //
+    // orient3d(a,b,c,d) returns positive if d is below the plane defined by
+    // triangle (a, b, c).  The tet vertex ordering used by MSH format is
+    // the opposite (i.e. d is above the triangle (a,b,c)), so this check
+    // switch the ordering of a and b to return positive if tet is not
+    // inverted.
+    MatrixIr queries(num_tets, 4);
+    queries.col(0) = voxels.col(1);
+    queries.col(1) = voxels.col(0);
+    queries.col(2) = voxels.col(2);
+    queries.col(3) = voxels.col(3);
+    return BatchPredicates::orient3d(vertices, queries);
 }
 
 VectorF VoxelUtils::is_delaunay(
@@ -61,13 +45,14 @@ VectorF VoxelUtils::is_delaunay(
     VectorF result(num_tets);
     result.setConstant(1);
 
-    MultipletMap<Triplet, size_t> adj_list;
+    TripletIndex<size_t> adj_list;
     for (size_t i=0; i<num_tets; i++) {
         adj_list.insert({tets(i,0), tets(i,1), tets(i,2)}, i);
         adj_list.insert({tets(i,1), tets(i,2), tets(i,3)}, i);
         adj_list.insert({tets(i,2), tets(i,3), tets(i,0)}, i);
         adj_list.insert({tets(i,3), tets(i,0), tets(i,1)}, i);
     }
+    adj_list.build();
 
     constexpr int INVALID = std::numeric_limits<int>::max();
     auto get_opposite_vertex = [&tets](size_t index, const Triplet& f) {
@@ -83,15 +68,14 @@ VectorF VoxelUtils::is_delaunay(
         return INVALID;
     };
 
+    // Gather one insphere query per (tet, adjacent tet) pair.
+    std::vector<int> query_data;
+    std::vector<size_t> query_tets;
     for (size_t i=0; i<num_tets; i++) {
         const int i0 = tets(i,0);
         const int i1 = tets(i,1);
         const int i2 = tets(i,2);
         const int i3 = tets(i,3);
-        const Vector3F v0 = vertices.row(i0);
-        const Vector3F v1 = vertices.row(i1);
-        const Vector3F v2 = vertices.row(i2);
-        const Vector3F v3 = vertices.row(i3);
 
         std::vector<Triplet> faces = {
             {i0, i1, i2},
@@ -101,30 +85,32 @@ VectorF VoxelUtils::is_delaunay(
         };
 
         for (const auto& f : faces) {
-            if (result[i] < 0) break;
-            const auto& adj_tets = adj_list[f];
+            const auto adj_tets = adj_list.get(f);
             for (auto j : adj_tets) {
                 if (i==j) continue;
-                if (result[i] < 0) break;
                 const int oppo = get_opposite_vertex(j, f);
-                const Vector3F vo = vertices.row(oppo);
-                // Note that the orientation of the sphere/tet is different from
-                // the orientation defined by the MSH format.  Swapping v0 and
-                // v1 to ensure consistency.
-                auto r = insphere(
-                        const_cast<double*>(v1.data()),
-                        const_cast<double*>(v0.data()),
-                        const_cast<double*>(v2.data()),
-                        const_cast<double*>(v3.data()),
-                        const_cast<double*>(vo.data()));
-                if (r > 0) {
-                    result[i] = -1;
-                } else if (r == 0) {
-                    result[i] = 0;
-                }
+                if (oppo == INVALID) continue;
+                // Note that the orientation of the sphere/tet is different
+                // from the orientation defined by the MSH format.  Swapping
+                // v0 and v1 to ensure consistency.
+                query_data.insert(query_data.end(), {i1, i0, i2, i3, oppo});
+                query_tets.push_back(i);
             }
         }
     }
+
+    const size_t num_queries = query_tets.size();
+    const Eigen::Map<const MatrixIr> queries(
+            query_data.data(), num_queries, 5);
+    const VectorF r = BatchPredicates::insphere(vertices, queries);
+    for (size_t k=0; k<num_queries; k++) {
+        Float& value = result[query_tets[k]];
+        if (value < 0) continue;
+        if (r[k] > 0) {
+            value = -1;
+        } else if (r[k] == 0) {
+            value = 0;
+        }
+    }
     return result;
 }
-
@@ -0,0 +1,297 @@
+/* This file is part of PyMesh. Copyright (c) 2019 by Qingnan Zhou */
+#include "BatchPredicates.h"
+
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <sstream>
+
+#include <tbb/tbb.h>
+
+#include <Core/Exception.h>
+
+extern "C" {
+#include "predicates.h"
+}
+
+using namespace PyMesh;
+
+namespace BatchPredicatesHelper {
+    constexpr size_t BLOCK_SIZE = 64;
+
+    // Same error bounds as exactinit() computes for IEEE doubles.
+    constexpr double EPSILON = std::numeric_limits<double>::epsilon() / 2;
+    constexpr double CCW_ERRBOUND_A = (3.0 + 16.0 * EPSILON) * EPSILON;
+    constexpr double O3D_ERRBOUND_A = (7.0 + 56.0 * EPSILON) * EPSILON;
+    constexpr double ICC_ERRBOUND_A = (10.0 + 96.0 * EPSILON) * EPSILON;
+    constexpr double ISP_ERRBOUND_A = (16.0 + 224.0 * EPSILON) * EPSILON;
+
+    void init() {
+        static std::once_flag flag;
+        std::call_once(flag, []() { exactinit(); });
+    }
+
+    /**
+     * Coordinates of a block of queries in structure of arrays layout:
+     * c[k*DIM+d][lane] is coordinate d of the k-th point of a query.
+     */
+    template<size_t N, size_t DIM>
+    struct Block {
+        double c[N*DIM][BLOCK_SIZE];
+        double det[BLOCK_SIZE];
+        bool certain[BLOCK_SIZE];
+    };
+
+    /**
+     * Run `filter` over blocks of queries and `exact` on the lanes it
+     * cannot certify.
+     */
+    template<size_t N, size_t DIM, typename Filter, typename Exact>
+    VectorF evaluate(const MatrixFr& points, const MatrixIr& queries,
+            Filter filter, Exact exact) {
+        if (points.cols() != DIM) {
+            std::stringstream err_msg;
+            err_msg << "Expect " << DIM << "D points, got "
+                << points.cols() << "D points.";
+            throw RuntimeError(err_msg.str());
+        }
+        if (queries.cols() != N) {
+            std::stringstream err_msg;
+            err_msg << "Expect " << N << " points per query, got "
+                << queries.cols() << ".";
+            throw RuntimeError(err_msg.str());
+        }
+        init();
+
+        const size_t num_queries = queries.rows();
+        const size_t num_blocks = (num_queries + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        VectorF results(num_queries);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    Block<N, DIM> block;
+                    for (size_t bi=r.begin(); bi!=r.end(); bi++) {
+                        const size_t begin = bi * BLOCK_SIZE;
+                        const size_t num_lanes = std::min(
+                                BLOCK_SIZE, num_queries - begin);
+                        for (size_t i=0; i<BLOCK_SIZE; i++) {
+                            for (size_t k=0; k<N; k++) {
+                                for (size_t d=0; d<DIM; d++) {
+                                    block.c[k*DIM+d][i] = i < num_lanes ?
+                                        points(queries(begin+i, k), d) : 0.0;
+                                }
+                            }
+                        }
+
+                        filter(block);
+
+                        for (size_t i=0; i<num_lanes; i++) {
+                            if (block.certain[i]) {
+                                results[begin+i] = block.det[i];
+                            } else {
+                                double p[N][DIM];
+                                for (size_t k=0; k<N; k++) {
+                                    for (size_t d=0; d<DIM; d++) {
+                                        p[k][d] = block.c[k*DIM+d][i];
+                                    }
+                                }
+                                results[begin+i] = exact(p);
+                            }
+                        }
+                    }
+                });
+        return results;
+    }
+
+    // The filters below repeat the first stage of the scalar predicates
+    // operation by operation, so certified lanes return the same value.
+
+    void orient2d_filter(Block<3, 2>& b) {
+        const auto& c = b.c;
+        for (size_t i=0; i<BLOCK_SIZE; i++) {
+            const double detleft = (c[0][i] - c[4][i]) * (c[3][i] - c[5][i]);
+            const double detright = (c[1][i] - c[5][i]) * (c[2][i] - c[4][i]);
+            const double det = detleft - detright;
+            const double detsum = std::abs(detleft) + std::abs(detright);
+            b.det[i] = det;
+            b.certain[i] = std::abs(det) >= CCW_ERRBOUND_A * detsum;
+        }
+    }
+
+    void orient3d_filter(Block<4, 3>& b) {
+        const auto& c = b.c;
+        for (size_t i=0; i<BLOCK_SIZE; i++) {
+            const double adx = c[0][i] - c[9][i];
+            const double bdx = c[3][i] - c[9][i];
+            const double cdx = c[6][i] - c[9][i];
+            const double ady = c[1][i] - c[10][i];
+            const double bdy = c[4][i] - c[10][i];
+            const double cdy = c[7][i] - c[10][i];
+            const double adz = c[2][i] - c[11][i];
+            const double bdz = c[5][i] - c[11][i];
+            const double cdz = c[8][i] - c[11][i];
+
+            const double bdxcdy = bdx * cdy;
+            const double cdxbdy = cdx * bdy;
+            const double cdxady = cdx * ady;
+            const double adxcdy = adx * cdy;
+            const double adxbdy = adx * bdy;
+            const double bdxady = bdx * ady;
+
+            const double det = adz * (bdxcdy - cdxbdy)
+                + bdz * (cdxady - adxcdy)
+                + cdz * (adxbdy - bdxady);
+            const double permanent =
+                (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz)
+                + (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz)
+                + (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+            b.det[i] = det;
+            b.certain[i] = std::abs(det) > O3D_ERRBOUND_A * permanent;
+        }
+    }
+
+    void incircle_filter(Block<4, 2>& b) {
+        const auto& c = b.c;
+        for (size_t i=0; i<BLOCK_SIZE; i++) {
+            const double adx = c[0][i] - c[6][i];
+            const double bdx = c[2][i] - c[6][i];
+            const double cdx = c[4][i] - c[6][i];
+            const double ady = c[1][i] - c[7][i];
+            const double bdy = c[3][i] - c[7][i];
+            const double cdy = c[5][i] - c[7][i];
+
+            const double bdxcdy = bdx * cdy;
+            const double cdxbdy = cdx * bdy;
+            const double alift = adx * adx + ady * ady;
+            const double cdxady = cdx * ady;
+            const double adxcdy = adx * cdy;
+            const double blift = bdx * bdx + bdy * bdy;
+            const double adxbdy = adx * bdy;
+            const double bdxady = bdx * ady;
+            const double clift = cdx * cdx + cdy * cdy;
+
+            const double det = alift * (bdxcdy - cdxbdy)
+                + blift * (cdxady - adxcdy)
+                + clift * (adxbdy - bdxady);
+            const double permanent =
+                (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift
+                + (std::abs(cdxady) + std::abs(adxcdy)) * blift
+                + (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+            b.det[i] = det;
+            b.certain[i] = std::abs(det) > ICC_ERRBOUND_A * permanent;
+        }
+    }
+
+    void insphere_filter(Block<5, 3>& b) {
+        const auto& c = b.c;
+        for (size_t i=0; i<BLOCK_SIZE; i++) {
+            const double aex = c[0][i] - c[12][i];
+            const double bex = c[3][i] - c[12][i];
+            const double cex = c[6][i] - c[12][i];
+            const double dex = c[9][i] - c[12][i];
+            const double aey = c[1][i] - c[13][i];
+            const double bey = c[4][i] - c[13][i];
+            const double cey = c[7][i] - c[13][i];
+            const double dey = c[10][i] - c[13][i];
+            const double aez = c[2][i] - c[14][i];
+            const double bez = c[5][i] - c[14][i];
+            const double cez = c[8][i] - c[14][i];
+            const double dez = c[11][i] - c[14][i];
+
+            const double aexbey = aex * bey;
+            const double bexaey = bex * aey;
+            const double ab = aexbey - bexaey;
+            const double bexcey = bex * cey;
+            const double cexbey = cex * bey;
+            const double bc = bexcey - cexbey;
+            const double cexdey = cex * dey;
+            const double dexcey = dex * cey;
+            const double cd = cexdey - dexcey;
+            const double dexaey = dex * aey;
+            const double aexdey = aex * dey;
+            const double da = dexaey - aexdey;
+            const double aexcey = aex * cey;
+            const double cexaey = cex * aey;
+            const double ac = aexcey - cexaey;
+            const double bexdey = bex * dey;
+            const double dexbey = dex * bey;
+            const double bd = bexdey - dexbey;
+
+            const double abc = aez * bc - bez * ac + cez * ab;
+            const double bcd = bez * cd - cez * bd + dez * bc;
+            const double cda = cez * da + dez * ac + aez * cd;
+            const double dab = dez * ab + aez * bd + bez * da;
+
+            const double alift = aex * aex + aey * aey + aez * aez;
+            const double blift = bex * bex + bey * bey + bez * bez;
+            const double clift = cex * cex + cey * cey + cez * cez;
+            const double dlift = dex * dex + dey * dey + dez * dez;
+
+            const double det =
+                (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+
+            const double aezplus = std::abs(aez);
+            const double bezplus = std::abs(bez);
+            const double cezplus = std::abs(cez);
+            const double dezplus = std::abs(dez);
+            const double aexbeyplus = std::abs(aexbey);
+            const double bexaeyplus = std::abs(bexaey);
+            const double bexceyplus = std::abs(bexcey);
+            const double cexbeyplus = std::abs(cexbey);
+            const double cexdeyplus = std::abs(cexdey);
+            const double dexceyplus = std::abs(dexcey);
+            const double dexaeyplus = std::abs(dexaey);
+            const double aexdeyplus = std::abs(aexdey);
+            const double aexceyplus = std::abs(aexcey);
+            const double cexaeyplus = std::abs(cexaey);
+            const double bexdeyplus = std::abs(bexdey);
+            const double dexbeyplus = std::abs(dexbey);
+            const double permanent = ((cexdeyplus + dexceyplus) * bezplus
+                    + (dexbeyplus + bexdeyplus) * cezplus
+                    + (bexceyplus + cexbeyplus) * dezplus)
+                * alift
+                + ((dexaeyplus + aexdeyplus) * cezplus
+                        + (aexceyplus + cexaeyplus) * dezplus
+                        + (cexdeyplus + dexceyplus) * aezplus)
+                * blift
+                + ((aexbeyplus + bexaeyplus) * dezplus
+                        + (bexdeyplus + dexbeyplus) * aezplus
+                        + (dexaeyplus + aexdeyplus) * bezplus)
+                * clift
+                + ((bexceyplus + cexbeyplus) * aezplus
+                        + (cexaeyplus + aexceyplus) * bezplus
+                        + (aexbeyplus + bexaeyplus) * cezplus)
+                * dlift;
+            b.det[i] = det;
+            b.certain[i] = std::abs(det) > ISP_ERRBOUND_A * permanent;
+        }
+    }
+}
+
+using namespace BatchPredicatesHelper;
+
+VectorF BatchPredicates::orient2d(
+        const MatrixFr& points, const MatrixIr& queries) {
+    return evaluate<3, 2>(points, queries, orient2d_filter,
+            [](double p[3][2]) { return ::orient2d(p[0], p[1], p[2]); });
+}
+
+VectorF BatchPredicates::orient3d(
+        const MatrixFr& points, const MatrixIr& queries) {
+    return evaluate<4, 3>(points, queries, orient3d_filter,
+            [](double p[4][3]) {
+                return ::orient3d(p[0], p[1], p[2], p[3]); });
+}
+
+VectorF BatchPredicates::incircle(
+        const MatrixFr& points, const MatrixIr& queries) {
+    return evaluate<4, 2>(points, queries, incircle_filter,
+            [](double p[4][2]) {
+                return ::incircle(p[0], p[1], p[2], p[3]); });
+}
+
+VectorF BatchPredicates::insphere(
+        const MatrixFr& points, const MatrixIr& queries) {
+    return evaluate<5, 3>(points, queries, insphere_filter,
+            [](double p[5][3]) {
+                return ::insphere(p[0], p[1], p[2], p[3], p[4]); });
+}
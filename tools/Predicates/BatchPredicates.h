@@ -0,0 +1,41 @@
+/* This file is part of PyMesh. Copyright (c) 2019 by Qingnan Zhou */
+#pragma once
+
+#include <Core/EigenTypedef.h>
+
+namespace PyMesh {
+
+/**
+ * Batched versions of Shewchuk's adaptive predicates.
+ *
+ * Each row of `queries` holds the indices of the points forming one query,
+ * in the same argument order as the scalar predicate.  Queries are processed
+ * in blocks: a branch-free floating point filter is evaluated over all lanes
+ * of a block, and only lanes the filter cannot certify fall back to the
+ * adaptive exact predicate.  Blocks are distributed over threads.
+ *
+ * Results are identical to calling the scalar predicate on each query.
+ */
+namespace BatchPredicates {
+    /**
+     * queries: #queries by 3.  points: #points by 2.
+     */
+    VectorF orient2d(const MatrixFr& points, const MatrixIr& queries);
+
+    /**
+     * queries: #queries by 4.  points: #points by 3.
+     */
+    VectorF orient3d(const MatrixFr& points, const MatrixIr& queries);
+
+    /**
+     * queries: #queries by 4.  points: #points by 2.
+     */
+    VectorF incircle(const MatrixFr& points, const MatrixIr& queries);
+
+    /**
+     * queries: #queries by 5.  points: #points by 3.
+     */
+    VectorF insphere(const MatrixFr& points, const MatrixIr& queries);
+}
+
+}
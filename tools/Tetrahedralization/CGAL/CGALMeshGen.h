@@ -43,6 +43,7 @@ class CGALMeshGen<InexactKernel, CGALDomainType::EXPLICIT_WITH_FEATURES>
 : public TetrahedralizationEngine {
     public:
         virtual void run() override {
+            PYMESH_PROFILE_ZONE("CGALMeshGen::run");
             using namespace CGAL::parameters;
             using Kernel = InexactKernel;
             preprocess();
@@ -70,6 +71,7 @@ class CGALMeshGen<InexactKernel, CGALDomainType::EXPLICIT>
 : public TetrahedralizationEngine {
     public:
         virtual void run() override {
+            PYMESH_PROFILE_ZONE("CGALMeshGen::run");
             using namespace CGAL::parameters;
             using Kernel = InexactKernel;
             preprocess();
@@ -102,6 +104,7 @@ class CGALMeshGen<InexactKernel, CGALDomainType::IMPLICIT_WITH_FEATURES>
 : public TetrahedralizationEngine {
     public:
         virtual void run() override {
+            PYMESH_PROFILE_ZONE("CGALMeshGen::run");
             using namespace CGAL::parameters;
             using Kernel = InexactKernel;
             using OracleType = Oracle<MatrixFr, MatrixIr>;
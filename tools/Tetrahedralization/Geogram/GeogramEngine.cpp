@@ -11,6 +11,7 @@
 using namespace PyMesh;
 
 void GeogramEngine::run() {
+    PYMESH_PROFILE_ZONE("GeogramEngine::run");
     GEO::Delaunay_var delaunay = GEO::Delaunay::create(3, "tetgen");
     delaunay->initialize();
     delaunay->set_refine(true);
@@ -12,6 +12,7 @@ extern "C" {
 using namespace PyMesh;
 
 void MMGEngine::run() {
+    PYMESH_PROFILE_ZONE("MMGEngine::run");
     constexpr Float EPS = 0.1;
     const Vector3F bbox_min = m_vertices.colwise().minCoeff().array() - EPS;
     const Vector3F bbox_max = m_vertices.colwise().maxCoeff().array() + EPS;
@@ -13,6 +13,7 @@
 using namespace PyMesh;
 
 void QuartetEngine::run() {
+    PYMESH_PROFILE_ZONE("QuartetEngine::run");
     using VertexArray = std::vector<Vec3f>;
     using FaceArray = std::vector<Vec3i>;
     using TetArray = std::vector<Vec4i>;
@@ -9,6 +9,7 @@
 using namespace PyMesh;
 
 void TetGenEngine::run() {
+    PYMESH_PROFILE_ZONE("TetGenEngine::run");
     preprocess();
 
     // Use the volume of regular tetrahedron of radius m_cell_size as max
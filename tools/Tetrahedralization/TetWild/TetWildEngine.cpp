@@ -11,6 +11,7 @@
 using namespace PyMesh;
 
 void TetWildEngine::run() {
+    PYMESH_PROFILE_ZONE("TetWildEngine::run");
     preprocess();
     tetwild::Args args;
 
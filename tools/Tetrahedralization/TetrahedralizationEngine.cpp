@@ -84,6 +84,7 @@ TetrahedralizationEngine::Ptr TetrahedralizationEngine::create(
 }
 
 void TetrahedralizationEngine::preprocess() {
+    PYMESH_PROFILE_ZONE("TetrahedralizationEngine::preprocess");
     assert_mesh_is_valid();
     auto_compute_meshing_params();
 }
@@ -6,6 +6,7 @@
 #include <iostream>
 #include <Core/EigenTypedef.h>
 #include <Core/Exception.h>
+#include <Misc/Profiler.h>
 
 namespace PyMesh {
 
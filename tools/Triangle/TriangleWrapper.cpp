@@ -6,6 +6,7 @@
 #include <iostream>
 #include <list>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <unordered_map>
 #include <vector>
@@ -28,6 +29,8 @@ extern "C" {
 
 using namespace PyMesh;
 
+std::mutex TriangleWrapper::m_lock;
+
 namespace TriangleWrapperHelper {
     const int REGION_BOUNDARY = 2;
     using Region = TriangleWrapper::Region;
@@ -352,7 +355,10 @@ void TriangleWrapper::run_triangle(const std::string& flags) {
                 in.trianglearealist);
     }
 
-    triangulate(const_cast<char*>(flags.c_str()), &in, &out, &out_voro);
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        triangulate(const_cast<char*>(flags.c_str()), &in, &out, &out_voro);
+    }
 
     if (out.numberofpoints > 0 && out.pointlist) {
         m_vertices.resize(out.numberofpoints, dim);
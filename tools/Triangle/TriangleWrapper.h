@@ -2,6 +2,7 @@
 #pragma once
 #ifdef WITH_TRIANGLE
 #include <list>
+#include <mutex>
 #include <string>
 #include <Core/EigenTypedef.h>
 
@@ -189,6 +190,9 @@ class TriangleWrapper {
         // Output Voronoi data
         MatrixFr m_voronoi_vertices;
         MatrixIr m_voronoi_edges;
+
+        // Triangle keeps its state in globals, all instances share this lock.
+        static std::mutex m_lock;
 };
 
 }
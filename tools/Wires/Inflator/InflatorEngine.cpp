@@ -12,6 +12,7 @@
 #include <MeshUtils/ShortEdgeRemoval.h>
 #include <MeshUtils/Subdivision.h>
 #include <MeshFactory.h>
+#include <Misc/Profiler.h>
 
 #include <Wires/Misc/MeshCleaner.h>
 
@@ -110,6 +111,11 @@ void InflatorEngine::with_shape_velocities() {
             "Shape velocity computation is not supported for this type of inflator");
 }
 
+void InflatorEngine::with_partitions(size_t num_cells) {
+    throw NotImplementedError(
+            "Partitioned inflation is not supported for this type of inflator");
+}
+
 void InflatorEngine::set_uniform_thickness(Float thickness) {
     if (m_thickness_type == PER_VERTEX) {
         set_thickness(VectorF::Ones(m_wire_network->get_num_vertices())
@@ -159,6 +165,7 @@ void InflatorEngine::with_abs_geometry_correction(const VectorF& correction) {
 }
 
 void InflatorEngine::clean_up() {
+    PYMESH_PROFILE_ZONE("InflatorEngine::clean_up");
     remove_isolated_vertices();
     MeshCleaner cleaner;
     cleaner.remove_duplicated_vertices(m_vertices, m_faces, 1e-3);
@@ -35,6 +35,7 @@ class InflatorEngine {
 
     public:
         virtual void with_shape_velocities();
+        virtual void with_partitions(size_t num_cells);
         virtual void inflate() {
             throw NotImplementedError(
                     "Wire inflation algorithm is not implemented");
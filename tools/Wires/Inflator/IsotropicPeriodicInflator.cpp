@@ -13,6 +13,7 @@
 #include <MeshUtils/EdgeSplitter.h>
 #include <MeshUtils/ShortEdgeRemoval.h>
 #include <MeshUtils/SubMesh.h>
+#include <Misc/Profiler.h>
 #include <Wires/Misc/BoundaryRemesher.h>
 #include <Wires/Misc/BoxChecker.h>
 #include <Wires/Misc/MeshCleaner.h>
@@ -58,6 +59,7 @@ IsotropicPeriodicInflator::IsotropicPeriodicInflator(
 }
 
 void IsotropicPeriodicInflator::clip_to_center_cell() {
+    PYMESH_PROFILE_ZONE("IsotropicPeriodicInflator::clip_to_center_cell");
     initialize_center_cell_and_octa_cell();
     clip_phantom_mesh_with_octa_cell();
     snap_to_cell_border();
@@ -1,18 +1,22 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #include "PeriodicBoundaryRemesher.h"
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <iostream>
+#include <tuple>
 #include <vector>
 
+#include <tbb/tbb.h>
+
 #include <Core/Exception.h>
 #include <IO/MeshWriter.h>
 #include <Mesh.h>
 #include <MeshFactory.h>
 #include <MeshUtils/Boundary.h>
 #include <MeshUtils/DuplicatedVertexRemoval.h>
-#include <Misc/HashGrid.h>
+#include <Misc/Profiler.h>
 #include <Triangle/TriangleWrapper.h>
 
 #include <Wires/Misc/BoxChecker.h>
@@ -25,6 +29,27 @@ namespace PeriodicBoundaryRemesherHelper {
     enum Axis { X=0, Y=1, Z=2 };
     const short min_axis_marker[3] = {-1, -2, -3};
     const short max_axis_marker[3] = { 1,  2,  3};
+    const short bd_labels[6] = {-1, 1, -2, 2, -3, 3};
+
+    size_t get_label_index(short label) {
+        assert(label != 0);
+        return label < 0 ? 2 * size_t(-label-1) : 2 * size_t(label-1) + 1;
+    }
+
+    /**
+     * Grid cell of a vertex projected onto the plane orthogonal to an axis,
+     * followed by the vertex index.
+     */
+    typedef std::tuple<long, long, int> CellEntry;
+
+    long get_cell(Float value, Float cell_size) {
+        return long(std::round(value / cell_size));
+    }
+
+    bool cell_less(const CellEntry& a, const CellEntry& b) {
+        return std::get<0>(a) < std::get<0>(b) ||
+            (std::get<0>(a) == std::get<0>(b) && std::get<1>(a) < std::get<1>(b));
+    }
 
     void triangulate(MatrixFr vertices, MatrixIr edges,
             MatrixFr& output_vertices, MatrixIr& output_faces, Float max_area) {
@@ -125,80 +150,93 @@ void PeriodicBoundaryRemesher::clean_up() {
 }
 
 void PeriodicBoundaryRemesher::label_bd_faces() {
-    m_bd_face_markers.clear();
-    m_bd_face_markers.resize(m_faces.rows(), 0);
+    PYMESH_PROFILE_ZONE("PeriodicBoundaryRemesher::label_bd_faces");
+    assert(m_vertices.cols() == 3);
+    const Float tol = 1e-3;
+    const size_t num_vertices = m_vertices.rows();
+    const size_t num_faces = m_faces.rows();
 
-    label_bd_faces(X);
-    label_bd_faces(Y);
-    label_bd_faces(Z);
+    // Label and snap vertices against all 3 axes in a single pass.
+    std::vector<short> vertex_labels(num_vertices * 3, 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_vertices),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    for (size_t axis=0; axis<3; axis++) {
+                        const Float v = m_vertices(i, axis);
+                        if (fabs(v - m_bbox_min[axis]) < tol) {
+                            vertex_labels[i*3+axis] = -1;
+                            m_vertices(i, axis) = m_bbox_min[axis];
+                        } else if (fabs(v - m_bbox_max[axis]) < tol) {
+                            vertex_labels[i*3+axis] = 1;
+                            m_vertices(i, axis) = m_bbox_max[axis];
+                        }
+                    }
+                }
+            });
+
+    // A face is labeled by the first axis, in X, Y, Z order, on which all of
+    // its vertices lie on the same side of the bbox.
+    m_bd_face_markers.assign(num_faces, 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_faces),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const Vector3I& f = m_faces.row(i);
+                    for (size_t axis=0; axis<3; axis++) {
+                        Vector3I label(
+                                vertex_labels[f[0]*3+axis],
+                                vertex_labels[f[1]*3+axis],
+                                vertex_labels[f[2]*3+axis]);
+                        if ((label.array() > 0).all()) {
+                            m_bd_face_markers[i] = max_axis_marker[axis];
+                            break;
+                        } else if ((label.array() < 0).all()) {
+                            m_bd_face_markers[i] = min_axis_marker[axis];
+                            break;
+                        }
+                    }
+                }
+            });
 
     //VectorF labels(m_faces.rows());
     //std::copy(m_bd_face_markers.begin(), m_bd_face_markers.end(), labels.data());
     //save_mesh("face_labels.msh", m_vertices, m_faces, labels);
 }
 
-void PeriodicBoundaryRemesher::label_bd_faces(int axis) {
-    assert(axis >=0 && axis < m_vertices.cols());
-    const Float tol = 1e-3;
-    const size_t num_vertices = m_vertices.rows();
+void PeriodicBoundaryRemesher::extract_bd_loops() {
+    PYMESH_PROFILE_ZONE("PeriodicBoundaryRemesher::extract_bd_loops");
     const size_t num_faces = m_faces.rows();
-
-    std::vector<short> vertex_label(num_vertices, 0);
-    for (size_t i=0; i<num_vertices; i++) {
-        const VectorF& v = m_vertices.row(i);
-        if (fabs(v[axis] - m_bbox_min[axis]) < tol) {
-            vertex_label[i] = -1;
-            m_vertices(i, axis) = m_bbox_min[axis];
-        } else if (fabs(v[axis] - m_bbox_max[axis]) < tol) {
-            vertex_label[i] = 1;
-            m_vertices(i, axis) = m_bbox_max[axis];
-        }
-    }
-
+    std::vector<std::vector<int> > flattened_faces(6);
     for (size_t i=0; i<num_faces; i++) {
-        if (m_bd_face_markers[i] != 0) continue;
+        if (m_bd_face_markers[i] == 0) continue;
+        auto& label_faces = flattened_faces[get_label_index(m_bd_face_markers[i])];
         const Vector3I& f = m_faces.row(i);
-        Vector3I label(
-                vertex_label[f[0]],
-                vertex_label[f[1]],
-                vertex_label[f[2]]);
-        if ((label.array() > 0).all()) {
-            m_bd_face_markers[i] = max_axis_marker[axis];
-        } else if ((label.array() < 0).all()) {
-            m_bd_face_markers[i] = min_axis_marker[axis];
-        }
+        label_faces.push_back(f[0]);
+        label_faces.push_back(f[1]);
+        label_faces.push_back(f[2]);
     }
-}
 
-void PeriodicBoundaryRemesher::extract_bd_loops() {
-    m_bd_loops.clear();
-    extract_bd_loops(min_axis_marker[X]);
-    extract_bd_loops(max_axis_marker[X]);
-    extract_bd_loops(min_axis_marker[Y]);
-    extract_bd_loops(max_axis_marker[Y]);
-    extract_bd_loops(min_axis_marker[Z]);
-    extract_bd_loops(max_axis_marker[Z]);
-}
+    // The six sides of the bbox are independent.
+    std::vector<MatrixIr> bd_loops(6);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, 6, 1),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const auto& label_faces = flattened_faces[i];
+                    assert(label_faces.size() > 0);
+                    MatrixIr faces(label_faces.size() / 3, 3);
+                    std::copy(label_faces.begin(), label_faces.end(),
+                            faces.data());
+
+                    Boundary::Ptr bd_extractor =
+                        Boundary::extract_surface_boundary_raw(
+                                m_vertices, faces);
+                    bd_loops[i] = bd_extractor->get_boundaries();
+                }
+            });
 
-void PeriodicBoundaryRemesher::extract_bd_loops(short label) {
-    const size_t num_faces = m_faces.rows();
-    std::vector<size_t> flattened_faces;
-    for (size_t i=0; i<num_faces; i++) {
-        if (m_bd_face_markers[i] == label) {
-            const Vector3I& f = m_faces.row(i);
-            flattened_faces.push_back(f[0]);
-            flattened_faces.push_back(f[1]);
-            flattened_faces.push_back(f[2]);
-        }
+    m_bd_loops.clear();
+    for (size_t i=0; i<6; i++) {
+        m_bd_loops.emplace(bd_labels[i], std::move(bd_loops[i]));
     }
-    assert(flattened_faces.size() > 0);
-
-    MatrixIr faces(flattened_faces.size() / 3, 3);
-    std::copy(flattened_faces.begin(), flattened_faces.end(), faces.data());
-
-    Boundary::Ptr bd_extractor = Boundary::extract_surface_boundary_raw(
-            m_vertices, faces);
-    m_bd_loops.emplace(label, bd_extractor->get_boundaries());
 }
 
 void PeriodicBoundaryRemesher::collapse_short_bd_edges(Float tol) {
@@ -253,6 +291,8 @@ void PeriodicBoundaryRemesher::collapse_short_bd_edges(short label, Float tol) {
 }
 
 void PeriodicBoundaryRemesher::match_bd_loops() {
+    PYMESH_PROFILE_ZONE("PeriodicBoundaryRemesher::match_bd_loops");
+    // Axes share the vertices along bbox edges, so they are matched in turn.
     match_bd_loops(X);
     match_bd_loops(Y);
     match_bd_loops(Z);
@@ -260,6 +300,7 @@ void PeriodicBoundaryRemesher::match_bd_loops() {
 
 void PeriodicBoundaryRemesher::match_bd_loops(short axis) {
     const Float tol = 1e-12;
+    const Float cell_size = 1e-2;
     const size_t dim = m_vertices.cols();
     const size_t coord_1 = (axis+1) % dim;
     const size_t coord_2 = (axis+2) % dim;
@@ -269,61 +310,95 @@ void PeriodicBoundaryRemesher::match_bd_loops(short axis) {
     MatrixIr& min_bd_loops = m_bd_loops[min_axis_marker[axis]];
     MatrixIr& max_bd_loops = m_bd_loops[max_axis_marker[axis]];
 
-    HashGrid::Ptr grid = HashGrid::create(1e-2, dim);
-
+    // Min vertices sorted by grid cell, so candidates are found by binary
+    // search instead of a hash grid, and lookups can run concurrently.
+    std::vector<CellEntry> min_cells;
     const size_t num_min_edges = min_bd_loops.rows();
+    min_cells.reserve(num_min_edges * 2);
     for (size_t i=0; i<num_min_edges; i++) {
-        const VectorI& e = min_bd_loops.row(i);
-        const VectorF& v0 = m_vertices.row(e[0]);
-        const VectorF& v1 = m_vertices.row(e[1]);
-
-        grid->insert(e[0], v0);
-        grid->insert(e[1], v1);
+        for (size_t j=0; j<2; j++) {
+            const int v = min_bd_loops(i,j);
+            min_cells.emplace_back(
+                    get_cell(m_vertices(v, coord_1), cell_size),
+                    get_cell(m_vertices(v, coord_2), cell_size), v);
+        }
     }
+    std::sort(min_cells.begin(), min_cells.end());
+    min_cells.erase(std::unique(min_cells.begin(), min_cells.end()),
+            min_cells.end());
 
-    std::vector<int> vertex_map(num_vertices, -1);
+    std::vector<int> max_vertices;
+    std::vector<bool> visited(num_vertices, false);
     const size_t num_max_edges = max_bd_loops.rows();
     for (size_t i=0; i<num_max_edges; i++) {
         for (size_t j=0; j<2; j++) {
-            size_t max_v_idx = max_bd_loops(i,j);
-            if (vertex_map[max_v_idx] >= 0) continue;
-
-            const VectorF& max_v = m_vertices.row(max_v_idx);
-            VectorF min_v = max_v + offset;
-            VectorI candidates = grid->get_items_near_point(min_v);
-            if (candidates.size() > 0) {
-                const size_t num_candidates = candidates.size();
-                size_t best_match = candidates[0];
-                Float best_match_err = (min_v.transpose() -
-                        m_vertices.row(best_match)).squaredNorm();
-                for (size_t k=1; k<num_candidates; k++) {
-                    size_t idx = candidates[k];
-                    Float match_err = (min_v.transpose() -
-                            m_vertices.row(idx)).squaredNorm();
-                    if (match_err < best_match_err) {
-                        best_match = idx;
-                        best_match_err = match_err;
+            const int v = max_bd_loops(i,j);
+            if (visited[v]) continue;
+            visited[v] = true;
+            max_vertices.push_back(v);
+        }
+    }
+
+    const size_t num_max_vertices = max_vertices.size();
+    std::vector<int> best_matches(num_max_vertices, -1);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_max_vertices),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const VectorF min_v =
+                        m_vertices.row(max_vertices[i]).transpose() + offset;
+                    const long cell_1 = get_cell(min_v[coord_1], cell_size);
+                    const long cell_2 = get_cell(min_v[coord_2], cell_size);
+
+                    int best_match = -1;
+                    Float best_match_err = 0.0;
+                    for (long d1=-1; d1<=1; d1++) {
+                        for (long d2=-1; d2<=1; d2++) {
+                            const auto candidates = std::equal_range(
+                                    min_cells.begin(), min_cells.end(),
+                                    CellEntry(cell_1+d1, cell_2+d2, 0),
+                                    cell_less);
+                            for (auto itr=candidates.first;
+                                    itr!=candidates.second; itr++) {
+                                const int idx = std::get<2>(*itr);
+                                const Float match_err = (min_v.transpose() -
+                                        m_vertices.row(idx)).squaredNorm();
+                                if (best_match < 0 ||
+                                        match_err < best_match_err ||
+                                        (match_err == best_match_err &&
+                                         idx < best_match)) {
+                                    best_match = idx;
+                                    best_match_err = match_err;
+                                }
+                            }
+                        }
                     }
+                    best_matches[i] = best_match;
                 }
+            });
 
-                vertex_map[max_v_idx] = best_match;
-                vertex_map[best_match] = max_v_idx;
-
-                const VectorF& matched_v = m_vertices.row(best_match);
-                if (fabs(max_v[coord_1] - m_bbox_min[coord_1]) < tol ||
-                    fabs(max_v[coord_1] - m_bbox_max[coord_1]) < tol) {
-                    m_vertices(best_match, coord_1) = max_v[coord_1];
-                } else {
-                    m_vertices(max_v_idx, coord_1) = matched_v[coord_1];
-                }
+    std::vector<int> vertex_map(num_vertices, -1);
+    for (size_t i=0; i<num_max_vertices; i++) {
+        const int max_v_idx = max_vertices[i];
+        const int best_match = best_matches[i];
+        if (best_match < 0) continue;
+
+        vertex_map[max_v_idx] = best_match;
+        vertex_map[best_match] = max_v_idx;
+
+        const VectorF& max_v = m_vertices.row(max_v_idx);
+        const VectorF& matched_v = m_vertices.row(best_match);
+        if (fabs(max_v[coord_1] - m_bbox_min[coord_1]) < tol ||
+            fabs(max_v[coord_1] - m_bbox_max[coord_1]) < tol) {
+            m_vertices(best_match, coord_1) = max_v[coord_1];
+        } else {
+            m_vertices(max_v_idx, coord_1) = matched_v[coord_1];
+        }
 
-                if (fabs(max_v[coord_2] - m_bbox_min[coord_2]) < tol ||
-                    fabs(max_v[coord_2] - m_bbox_max[coord_2]) < tol) {
-                    m_vertices(best_match, coord_2) = max_v[coord_2];
-                } else {
-                    m_vertices(max_v_idx, coord_2) = matched_v[coord_2];
-                }
-            }
+        if (fabs(max_v[coord_2] - m_bbox_min[coord_2]) < tol ||
+            fabs(max_v[coord_2] - m_bbox_max[coord_2]) < tol) {
+            m_vertices(best_match, coord_2) = max_v[coord_2];
+        } else {
+            m_vertices(max_v_idx, coord_2) = matched_v[coord_2];
         }
     }
 
@@ -376,94 +451,116 @@ void PeriodicBoundaryRemesher::collapse_unmatched_vertices(
 }
 
 void PeriodicBoundaryRemesher::refine_bd_loops(Float ave_edge_len) {
+    PYMESH_PROFILE_ZONE("PeriodicBoundaryRemesher::refine_bd_loops");
     // Only refine bd edges lying on the edge of the bbox.
     // i.e. These bd edges and all their adjacent faces are all on the boundary.
-
-    const size_t num_vertices = m_vertices.rows();
     assert(m_vertices.cols() == 3);
-    std::vector<Float> refined_vertices(num_vertices * 3);
-    std::copy(m_vertices.data(), m_vertices.data() + num_vertices * 3,
-            refined_vertices.begin());
-
-    refine_bd_loops(min_axis_marker[X], ave_edge_len, refined_vertices);
-    refine_bd_loops(max_axis_marker[X], ave_edge_len, refined_vertices);
-    refine_bd_loops(min_axis_marker[Y], ave_edge_len, refined_vertices);
-    refine_bd_loops(max_axis_marker[Y], ave_edge_len, refined_vertices);
-    refine_bd_loops(min_axis_marker[Z], ave_edge_len, refined_vertices);
-    refine_bd_loops(max_axis_marker[Z], ave_edge_len, refined_vertices);
-
-    assert(refined_vertices.size() % 3 == 0);
-    const size_t num_refined_vertices = refined_vertices.size() / 3;
-    if (num_vertices != num_refined_vertices) {
-        m_vertices.resize(num_refined_vertices, 3);
-        std::copy(refined_vertices.begin(), refined_vertices.end(),
-                m_vertices.data());
-    }
-}
-
-void PeriodicBoundaryRemesher::refine_bd_loops(short label, Float ave_edge_len,
-        std::vector<Float>& refined_vertices) {
     BoxChecker checker(m_bbox_min, m_bbox_max);
-    MatrixIr& bd_edges = m_bd_loops[label];
-    std::vector<size_t> refined_edges;
-
-    const size_t num_edges = bd_edges.rows();
-    size_t vertex_count = refined_vertices.size() / 3;
-    assert(refined_vertices.size() % 3 == 0);
-
-    for (size_t i=0; i<num_edges; i++) {
-        const VectorI& e = bd_edges.row(i);
-        const Vector3F& v0 = m_vertices.row(e[0]);
-        const Vector3F& v1 = m_vertices.row(e[1]);
-        Vector3F mid_pt = 0.5 * (v0 + v1);
-        assert(checker.is_on_boundary(mid_pt));
-        if (checker.is_on_boundary_edges(mid_pt)) {
-            Float edge_len = (v1-v0).norm();
-            size_t num_segments = size_t(std::round(edge_len / ave_edge_len));
-            if (num_segments <= 1) {
-                refined_edges.push_back(e[0]);
-                refined_edges.push_back(e[1]);
-            } else {
-                refined_edges.push_back(e[0]);
-                for (size_t j=1; j<num_segments; j++) {
-                    Float ratio = Float(j) / Float(num_segments);
-                    Vector3F p = v0 * (1.0 - ratio) + v1 * ratio;
-                    refined_vertices.push_back(p[0]);
-                    refined_vertices.push_back(p[1]);
-                    refined_vertices.push_back(p[2]);
-                    refined_edges.push_back(vertex_count);
-                    refined_edges.push_back(vertex_count);
-                    vertex_count++;
+    const size_t num_vertices = m_vertices.rows();
+
+    // Count the segments of every loop edge, one label per task.
+    std::vector<std::vector<size_t> > num_segments(6);
+    std::vector<size_t> num_new_vertices(6, 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, 6, 1),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const MatrixIr& bd_edges = m_bd_loops.at(bd_labels[i]);
+                    const size_t num_edges = bd_edges.rows();
+                    num_segments[i].resize(num_edges, 1);
+                    for (size_t j=0; j<num_edges; j++) {
+                        const VectorI& e = bd_edges.row(j);
+                        const Vector3F& v0 = m_vertices.row(e[0]);
+                        const Vector3F& v1 = m_vertices.row(e[1]);
+                        Vector3F mid_pt = 0.5 * (v0 + v1);
+                        assert(checker.is_on_boundary(mid_pt));
+                        if (checker.is_on_boundary_edges(mid_pt)) {
+                            Float edge_len = (v1-v0).norm();
+                            num_segments[i][j] = std::max<size_t>(1,
+                                    size_t(std::round(edge_len / ave_edge_len)));
+                            num_new_vertices[i] += num_segments[i][j] - 1;
+                        }
+                    }
                 }
-                refined_edges.push_back(e[1]);
-            }
-        } else {
-            refined_edges.push_back(e[0]);
-            refined_edges.push_back(e[1]);
-        }
-    }
+            });
 
-    assert(refined_edges.size() % 2 == 0);
-    const size_t num_refined_edges = refined_edges.size() / 2;
-    if (num_refined_edges != num_edges) {
-        bd_edges.resize(num_refined_edges, 2);
-        std::copy(refined_edges.begin(), refined_edges.end(), bd_edges.data());
+    // New vertices are numbered label by label in the original order.
+    std::vector<size_t> vertex_offsets(7, num_vertices);
+    for (size_t i=0; i<6; i++) {
+        vertex_offsets[i+1] = vertex_offsets[i] + num_new_vertices[i];
     }
+    const size_t num_refined_vertices = vertex_offsets.back();
+    if (num_refined_vertices == num_vertices) return;
+
+    MatrixFr refined_vertices(num_refined_vertices, 3);
+    refined_vertices.topRows(num_vertices) = m_vertices;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, 6, 1),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    if (num_new_vertices[i] == 0) continue;
+                    MatrixIr& bd_edges = m_bd_loops.at(bd_labels[i]);
+                    const size_t num_edges = bd_edges.rows();
+                    MatrixIr refined_edges(
+                            num_edges + num_new_vertices[i], 2);
+
+                    size_t vertex_count = vertex_offsets[i];
+                    size_t edge_count = 0;
+                    for (size_t j=0; j<num_edges; j++) {
+                        const VectorI& e = bd_edges.row(j);
+                        const size_t n = num_segments[i][j];
+                        if (n == 1) {
+                            refined_edges.row(edge_count++) = e;
+                            continue;
+                        }
+
+                        const Vector3F& v0 = m_vertices.row(e[0]);
+                        const Vector3F& v1 = m_vertices.row(e[1]);
+                        int prev = e[0];
+                        for (size_t k=1; k<n; k++) {
+                            Float ratio = Float(k) / Float(n);
+                            Vector3F p = v0 * (1.0 - ratio) + v1 * ratio;
+                            refined_vertices.row(vertex_count) = p;
+                            refined_edges.row(edge_count++) <<
+                                prev, int(vertex_count);
+                            prev = vertex_count;
+                            vertex_count++;
+                        }
+                        refined_edges.row(edge_count++) << prev, e[1];
+                    }
+                    assert(edge_count == size_t(refined_edges.rows()));
+                    assert(vertex_count == vertex_offsets[i+1]);
+                    bd_edges.swap(refined_edges);
+                }
+            });
+    m_vertices.swap(refined_vertices);
 }
 
 void PeriodicBoundaryRemesher::remesh_boundary(Float max_area) {
+    PYMESH_PROFILE_ZONE("PeriodicBoundaryRemesher::remesh_boundary");
     std::vector<MatrixFr> remeshed_vertices;
     std::vector<MatrixIr> remeshed_faces;
 
     size_t vertex_count = 0, face_count = 0;
     add_interior_geometry(remeshed_vertices, remeshed_faces,
             vertex_count, face_count);
-    triangulate_bd_loops(max_area, X, remeshed_vertices, remeshed_faces,
-            vertex_count, face_count);
-    triangulate_bd_loops(max_area, Y, remeshed_vertices, remeshed_faces,
-            vertex_count, face_count);
-    triangulate_bd_loops(max_area, Z, remeshed_vertices, remeshed_faces,
-            vertex_count, face_count);
+
+    std::vector<MatrixFr> bd_vertices(3);
+    std::vector<MatrixIr> bd_faces(3);
+    // Only the loop setup and result copies overlap: TriangleWrapper
+    // serializes the triangulate() calls themselves on its global lock.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, 3, 1),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    triangulate_bd_loops(max_area, i,
+                            bd_vertices[i], bd_faces[i]);
+                }
+            });
+
+    for (size_t i=0; i<3; i++) {
+        remeshed_faces.emplace_back(bd_faces[i].array() + int(vertex_count));
+        vertex_count += bd_vertices[i].rows();
+        face_count += bd_faces[i].rows();
+        remeshed_vertices.push_back(std::move(bd_vertices[i]));
+    }
 
     size_t count = 0;
     m_vertices.resize(vertex_count, 3);
@@ -508,33 +605,32 @@ void PeriodicBoundaryRemesher::add_interior_geometry(
     face_count += interior_faces.size() / 3;
 }
 
-void PeriodicBoundaryRemesher::triangulate_bd_loops(Float max_area, short axis,
-        std::vector<MatrixFr>& remeshed_vertices,
-        std::vector<MatrixIr>& remeshed_faces,
-        size_t& vertex_count, size_t& face_count) {
+void PeriodicBoundaryRemesher::triangulate_bd_loops(Float max_area,
+        short axis, MatrixFr& output_vertices, MatrixIr& output_faces) const {
     Vector3F offset(0.0, 0.0, 0.0);
     offset[axis] = m_bbox_max[axis] - m_bbox_min[axis];
     Vector3F normal(0.0, 0.0, 0.0);
     normal[axis] = -1.0;
-    const MatrixIr& min_loops = m_bd_loops[min_axis_marker[axis]];
-
-    MatrixFr output_vertices;
-    MatrixIr output_faces;
-    triangulate(m_vertices, min_loops, output_vertices, output_faces, max_area);
-    reorientate_triangles(output_vertices, output_faces, normal);
-
-    // Add triangulated min boundary
-    remeshed_vertices.emplace_back(output_vertices);
-    remeshed_faces.emplace_back(output_faces.array() + vertex_count);
-    vertex_count += output_vertices.rows();
-    face_count += output_faces.rows();
-
-    // Add triangulated max boundary
-    output_faces.col(2).swap(output_faces.col(1));
-    remeshed_vertices.emplace_back(output_vertices.rowwise() + offset.transpose());
-    remeshed_faces.emplace_back(output_faces.array() + vertex_count);
-    vertex_count += output_vertices.rows();
-    face_count += output_faces.rows();
+    const MatrixIr& min_loops = m_bd_loops.at(min_axis_marker[axis]);
+
+    MatrixFr min_vertices;
+    MatrixIr min_faces;
+    triangulate(m_vertices, min_loops, min_vertices, min_faces, max_area);
+    reorientate_triangles(min_vertices, min_faces, normal);
+
+    // The max boundary is the min boundary shifted by offset, with flipped
+    // orientation.
+    const size_t num_vertices = min_vertices.rows();
+    const size_t num_faces = min_faces.rows();
+    output_vertices.resize(num_vertices * 2, 3);
+    output_vertices.topRows(num_vertices) = min_vertices;
+    output_vertices.bottomRows(num_vertices) =
+        min_vertices.rowwise() + offset.transpose();
+
+    output_faces.resize(num_faces * 2, 3);
+    output_faces.topRows(num_faces) = min_faces;
+    min_faces.col(2).swap(min_faces.col(1));
+    output_faces.bottomRows(num_faces) = min_faces.array() + int(num_vertices);
 }
 
 void PeriodicBoundaryRemesher::update_all_indices(const VectorI& vertex_map) {
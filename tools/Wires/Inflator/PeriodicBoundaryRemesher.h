@@ -22,17 +22,13 @@ class PeriodicBoundaryRemesher {
     protected:
         void clean_up();
         void label_bd_faces();
-        void label_bd_faces(int axis);
         void extract_bd_loops();
-        void extract_bd_loops(short label);
         void collapse_short_bd_edges(Float tol);
         void collapse_short_bd_edges(short label, Float tol);
         void match_bd_loops();
         void match_bd_loops(short axis);
         void collapse_unmatched_vertices(short label, std::vector<int>& vertex_map);
         void refine_bd_loops(Float ave_edge_len);
-        void refine_bd_loops(short label, Float ave_edge_len,
-                std::vector<Float>& refined_vertices);
         void remesh_boundary(Float max_area);
 
         void add_interior_geometry(
@@ -40,10 +36,12 @@ class PeriodicBoundaryRemesher {
                 std::vector<MatrixIr>& remeshed_faces,
                 size_t& vertex_count, size_t& face_count);
 
+        /**
+         * Triangulate the min side loops of axis and copy the result to the
+         * max side.  Output is indexed locally, so axes can run concurrently.
+         */
         void triangulate_bd_loops(Float max_area, short axis,
-                std::vector<MatrixFr>& remeshed_vertices,
-                std::vector<MatrixIr>& remeshed_faces,
-                size_t& vertex_count, size_t& face_count);
+                MatrixFr& output_vertices, MatrixIr& output_faces) const;
 
         void update_all_indices(const VectorI& vertex_map);
 
@@ -9,6 +9,7 @@
 #include <MeshFactory.h>
 #include <BVH/BVHEngine.h>
 #include <Math/ZSparseMatrix.h>
+#include <Misc/Profiler.h>
 #include <Wires/Parameters/ParameterCommon.h>
 
 #include "SimpleInflator.h"
@@ -40,6 +41,7 @@ namespace PeriodicInflatorHelper {
 using namespace PeriodicInflatorHelper;
 
 void PeriodicInflator::inflate() {
+    PYMESH_PROFILE_ZONE("PeriodicInflator::inflate");
     generate_phantom_mesh();
     refine_phantom_mesh();
     initialize_AABB_tree();
@@ -72,6 +74,7 @@ void PeriodicInflator::set_thickness(const VectorF& thickness) {
 }
 
 void PeriodicInflator::generate_phantom_mesh() {
+    PYMESH_PROFILE_ZONE("PeriodicInflator::generate_phantom_mesh");
     PhantomMeshGenerator generator(
             m_wire_network, m_parameter_manager, m_profile);
     if (m_with_shape_velocities)
@@ -88,6 +91,7 @@ void PeriodicInflator::generate_phantom_mesh() {
 }
 
 void PeriodicInflator::initialize_AABB_tree() {
+    PYMESH_PROFILE_ZONE("PeriodicInflator::initialize_AABB_tree");
     const size_t dim = m_parameter_manager->get_wire_network()->get_dim();
     m_tree = BVHEngine::create("auto", dim);
     m_tree->set_mesh(m_phantom_vertices, m_phantom_faces);
@@ -108,7 +112,10 @@ void PeriodicInflator::set_parameter(ParameterManager::Ptr manager) {
 }
 
 void PeriodicInflator::refine_phantom_mesh() {
+    PYMESH_PROFILE_ZONE("PeriodicInflator::refine_phantom_mesh");
     if (!m_refiner) return;
+    m_refiner->set_matrix_mode(m_with_shape_velocities ?
+            Subdivision::COMPOSED_MATRIX : Subdivision::MATRIX_FREE);
     m_refiner->subdivide(m_phantom_vertices, m_phantom_faces, m_subdiv_order);
     m_phantom_vertices = m_refiner->get_vertices();
     m_phantom_faces = m_refiner->get_faces();
@@ -143,6 +150,7 @@ void PeriodicInflator::get_center_cell_bbox(
 }
 
 void PeriodicInflator::update_shape_velocities() {
+    PYMESH_PROFILE_ZONE("PeriodicInflator::update_shape_velocities");
     if (!m_with_shape_velocities) return;
 
     const size_t num_vertices = m_vertices.rows();
@@ -1,6 +1,7 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #include "PeriodicInflator2D.h"
 #include <Misc/TriBox2D.h>
+#include <Misc/Profiler.h>
 #include <Boolean/BooleanEngine.h>
 
 
@@ -86,6 +87,7 @@ namespace PeriodicInflator2DHelper {
 using namespace PeriodicInflator2DHelper;
 
 void PeriodicInflator2D::clip_to_center_cell() {
+    PYMESH_PROFILE_ZONE("PeriodicInflator2D::clip_to_center_cell");
     assert(m_phantom_faces.rows() > 0);
     std::list<Float> vertices;
     std::list<size_t> faces;
@@ -11,6 +11,7 @@
 #include <Boolean/BooleanEngine.h>
 #include <Math/ZSparseMatrix.h>
 #include <MeshFactory.h>
+#include <Misc/Profiler.h>
 
 namespace TriBox3 {
 extern "C" {
@@ -55,6 +56,7 @@ namespace PeriodicInflator3DHelper {
 using namespace PeriodicInflator3DHelper;
 
 void PeriodicInflator3D::clip_to_center_cell() {
+    PYMESH_PROFILE_ZONE("PeriodicInflator3D::clip_to_center_cell");
     clip_phantom_mesh();
     periodic_remesh();
     update_face_sources();
@@ -107,6 +109,7 @@ void PeriodicInflator3D::update_face_sources() {
 }
 
 void PeriodicInflator3D::periodic_remesh() {
+    PYMESH_PROFILE_ZONE("PeriodicInflator3D::periodic_remesh");
     Float default_thickness = m_parameter_manager->get_default_thickness();
     default_thickness *= pow(0.5, m_subdiv_order);
     PeriodicBoundaryRemesher remesher(m_vertices, m_faces,
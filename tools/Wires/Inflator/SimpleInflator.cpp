@@ -1,9 +1,17 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #include "SimpleInflator.h"
 
+#include <algorithm>
 #include <limits>
 #include <iostream>
+
+#include <tbb/tbb.h>
+
 #include <ConvexHull/ConvexHullEngine.h>
+#include <MeshUtils/DuplicatedVertexRemoval.h>
+#include <MeshUtils/IsolatedVertexRemoval.h>
+#include <MeshUtils/ShortEdgeRemoval.h>
+#include <Misc/Profiler.h>
 #include <Triangle/TriangleWrapper.h>
 
 using namespace PyMesh;
@@ -64,17 +72,71 @@ namespace SimpleInflatorHelper {
         VectorF proj = (loop.rowwise() - v0.transpose()) * dir / dir_sq_len;
         return ((proj.array() > 0.0).all() && (proj.array() < 1.0).all());
     }
+
+    bool row_less_than(const MatrixFr& pts, size_t i, const VectorF& p) {
+        const size_t dim = pts.cols();
+        for (size_t j=0; j<dim; j++) {
+            if (pts(i, j) < p[j]) return true;
+            if (pts(i, j) > p[j]) return false;
+        }
+        return false;
+    }
+
+    /**
+     * Return row indices of pts sorted lexicographically.
+     */
+    std::vector<size_t> sort_rows(const MatrixFr& pts) {
+        const size_t num_pts = pts.rows();
+        std::vector<size_t> order(num_pts);
+        for (size_t i=0; i<num_pts; i++) order[i] = i;
+        std::sort(order.begin(), order.end(),
+                [&](size_t i, size_t j) {
+                return row_less_than(pts, i, pts.row(j).transpose()); });
+        return order;
+    }
+
+    /**
+     * Return the row of pts that is bitwise identical to p, or -1.
+     */
+    int find_row(const MatrixFr& pts, const std::vector<size_t>& order,
+            const VectorF& p) {
+        auto itr = std::lower_bound(order.begin(), order.end(), p,
+                [&](size_t i, const VectorF& q) {
+                return row_less_than(pts, i, q); });
+        if (itr == order.end()) return -1;
+        if (pts.row(*itr) == p.transpose()) return *itr;
+        return -1;
+    }
+
+    VectorI compute_seam_importance(const MatrixFr& vertices,
+            const MatrixFr& seam_pts, const std::vector<size_t>& seam_order) {
+        const size_t num_vertices = vertices.rows();
+        VectorI importance = VectorI::Zero(num_vertices);
+        for (size_t i=0; i<num_vertices; i++) {
+            if (find_row(seam_pts, seam_order,
+                        vertices.row(i).transpose()) >= 0) {
+                importance[i] = -1;
+            }
+        }
+        return importance;
+    }
 }
 
 using namespace SimpleInflatorHelper;
 
 void SimpleInflator::inflate() {
+    PYMESH_PROFILE_ZONE("SimpleInflator::inflate");
     initialize();
     compute_end_loop_offsets();
     generate_end_loops();
-    generate_joints();
-    connect_end_loops();
-    finalize();
+    collect_incident_edges();
+    if (m_num_partition_cells > 1) {
+        inflate_partitions();
+    } else {
+        generate_joints();
+        connect_end_loops();
+        finalize();
+    }
     refine();
 }
 
@@ -86,10 +148,8 @@ const std::vector<MatrixFr>& SimpleInflator::get_shape_velocities() const {
 void SimpleInflator::initialize() {
     check_thickness();
     m_end_loops.clear();
-    m_vertex_list.clear();
-    m_face_list.clear();
-    m_face_source_list.clear();
-    m_num_vertex_accumulated = 0;
+    m_incident_edges.clear();
+    m_pieces = MeshPieces();
     m_aspect_max = 1.0;
 
     if (!m_wire_network->with_connectivity()) {
@@ -124,143 +184,267 @@ void SimpleInflator::compute_end_loop_offsets() {
 }
 
 void SimpleInflator::generate_end_loops() {
+    PYMESH_PROFILE_ZONE("SimpleInflator::generate_end_loops");
     const size_t num_edges = m_wire_network->get_num_edges();
 
     const MatrixFr vertices = m_wire_network->get_vertices();
     const MatrixIr edges = m_wire_network->get_edges();
     const MatrixFr edge_thickness = get_edge_thickness();
-    for (size_t i=0; i<num_edges; i++) {
-        const VectorI& edge = edges.row(i);
-        const VectorF& v1 = vertices.row(edge[0]);
-        const VectorF& v2 = vertices.row(edge[1]);
-        Float edge_len = (v2 - v1).norm();
-        MatrixFr loop_1 = m_profile->place(v1, v2,
-                m_end_loop_offsets[edge[0]],
-                edge_thickness(i, 0),
-                m_rel_correction, m_abs_correction, m_correction_cap,
-                m_spread_const);
-        assert(loop_is_valid(loop_1, v1, v2));
-        MatrixFr loop_2 = m_profile->place(v1, v2,
-                edge_len - m_end_loop_offsets[edge[1]],
-                edge_thickness(i, 1),
-                m_rel_correction, m_abs_correction, m_correction_cap,
-                m_spread_const);
-        assert(loop_is_valid(loop_2, v1, v2));
-        m_end_loops.push_back(std::make_pair(loop_1, loop_2));
-    }
+    m_end_loops.resize(num_edges);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_edges),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const VectorI& edge = edges.row(i);
+                    const VectorF& v1 = vertices.row(edge[0]);
+                    const VectorF& v2 = vertices.row(edge[1]);
+                    Float edge_len = (v2 - v1).norm();
+                    MatrixFr loop_1 = m_profile->place(v1, v2,
+                            m_end_loop_offsets[edge[0]],
+                            edge_thickness(i, 0),
+                            m_rel_correction, m_abs_correction, m_correction_cap,
+                            m_spread_const);
+                    assert(loop_is_valid(loop_1, v1, v2));
+                    MatrixFr loop_2 = m_profile->place(v1, v2,
+                            edge_len - m_end_loop_offsets[edge[1]],
+                            edge_thickness(i, 1),
+                            m_rel_correction, m_abs_correction, m_correction_cap,
+                            m_spread_const);
+                    assert(loop_is_valid(loop_2, v1, v2));
+                    m_end_loops[i] = std::make_pair(loop_1, loop_2);
+                }
+            });
 }
 
-void SimpleInflator::generate_joints() {
-    const size_t dim = m_wire_network->get_dim();
+void SimpleInflator::collect_incident_edges() {
     const size_t num_vertices = m_wire_network->get_num_vertices();
     const size_t num_edges = m_wire_network->get_num_edges();
-    const MatrixFr& vertices = m_wire_network->get_vertices();
     const MatrixIr& edges = m_wire_network->get_edges();
-    const size_t loop_size = m_profile->size();
 
-    std::vector<std::vector<const MatrixFr*> > loops(num_vertices);
-    std::vector<std::vector<size_t> > source_edge_indices(num_vertices);
+    m_incident_edges.resize(num_vertices);
     for (size_t i=0; i<num_edges; i++) {
-        const auto& end_loops = m_end_loops[i];
         const auto& edge = edges.row(i);
-        loops[edge[0]].push_back(&end_loops.first);
-        loops[edge[1]].push_back(&end_loops.second);
-        source_edge_indices[edge[0]].push_back(i);
-        source_edge_indices[edge[1]].push_back(i);
+        m_incident_edges[edge[0]].push_back(i);
+        m_incident_edges[edge[1]].push_back(i);
     }
+}
 
+void SimpleInflator::generate_joints() {
+    PYMESH_PROFILE_ZONE("SimpleInflator::generate_joints");
+    const size_t num_vertices = m_wire_network->get_num_vertices();
     for (size_t i=0; i<num_vertices; i++) {
-        const auto& incident_loops = loops[i];
-        const auto& edge_ids = source_edge_indices[i];
-        assert(incident_loops.size() == edge_ids.size());
-        size_t valance = incident_loops.size();
-        MatrixFr pts(valance * loop_size + 1, dim);
-        VectorI  source_ids(pts.rows());
-        pts.row(0) = vertices.row(i);
-        source_ids[0] = -1;
-        size_t count = 0;
-        for (auto loop : incident_loops) {
-            pts.block(count*loop_size+1, 0, loop_size, dim) = *loop;
-            source_ids.segment(count*loop_size+1, loop_size) =
-                VectorI::Ones(loop_size) * edge_ids[count];
-            count++;
-        }
-        generate_joint(pts, source_ids, i);
+        generate_joint(i, m_pieces);
     }
 }
 
 void SimpleInflator::connect_end_loops() {
+    PYMESH_PROFILE_ZONE("SimpleInflator::connect_end_loops");
     const size_t dim = m_wire_network->get_dim();
     const Float ave_thickness = m_thickness.sum() / m_thickness.size();
-    const auto& edge_lengths = m_wire_network->get_attribute("edge_length");
     const size_t num_edges = m_wire_network->get_num_edges();
-    const size_t loop_size = m_profile->size();
+    const MatrixIr connecting_faces = generate_faces_connecting_loops(
+            m_profile->size(), dim != 2);
+
+    for (size_t i=0; i<num_edges; i++) {
+        connect_end_loop(i, connecting_faces, ave_thickness, m_pieces);
+    }
+}
 
+void SimpleInflator::finalize() {
+    assemble(m_pieces, m_vertices, m_faces, m_face_sources);
+    m_pieces = MeshPieces();
+    clean_up();
+}
+
+void SimpleInflator::inflate_partitions() {
+    PYMESH_PROFILE_ZONE("SimpleInflator::inflate_partitions");
+    const size_t dim = m_wire_network->get_dim();
+    const size_t num_vertices = m_wire_network->get_num_vertices();
+    const size_t num_edges = m_wire_network->get_num_edges();
+    const MatrixIr& edges = m_wire_network->get_edges();
+    const size_t loop_size = m_profile->size();
+    const Float ave_thickness = m_thickness.sum() / m_thickness.size();
     const MatrixIr connecting_faces = generate_faces_connecting_loops(
             loop_size, dim != 2);
-    const size_t num_connecting_faces = connecting_faces.rows();
 
+    size_t num_partitions = 1;
+    for (size_t i=0; i<dim; i++) num_partitions *= m_num_partition_cells;
+
+    // Each edge is owned by the partition with the smaller index among its
+    // end points.  The end loop at the other end lies on a partition seam.
+    const VectorI vertex_partitions = compute_vertex_partitions();
+    std::vector<std::vector<size_t> > partition_vertices(num_partitions);
+    std::vector<std::vector<size_t> > partition_edges(num_partitions);
+    for (size_t i=0; i<num_vertices; i++) {
+        partition_vertices[vertex_partitions[i]].push_back(i);
+    }
+    std::vector<const MatrixFr*> seam_loops;
     for (size_t i=0; i<num_edges; i++) {
-        Float edge_length = edge_lengths(i, 0);
-        const auto& end_loops = m_end_loops[i];
-        const size_t num_segments = std::max(1.0,
-                std::round(edge_length / ave_thickness / m_aspect_max));
-        MatrixFr pts((num_segments+1)*loop_size, dim);
-
-        for (size_t j=0; j<num_segments+1; j++) {
-            Float alpha = Float(j) / Float(num_segments);
-            pts.block(j*loop_size, 0, loop_size, dim) =
-                end_loops.first * (1.0 - alpha) + end_loops.second * alpha;
+        const int p0 = vertex_partitions[edges(i, 0)];
+        const int p1 = vertex_partitions[edges(i, 1)];
+        partition_edges[std::min(p0, p1)].push_back(i);
+        if (p0 < p1) {
+            seam_loops.push_back(&m_end_loops[i].second);
+        } else if (p0 > p1) {
+            seam_loops.push_back(&m_end_loops[i].first);
         }
+    }
+
+    // Seam vertices are shared bitwise between the partitions, they are kept
+    // fixed during cleanup so that they can be stitched exactly.
+    MatrixFr seam_pts(seam_loops.size() * loop_size, dim);
+    for (size_t i=0; i<seam_loops.size(); i++) {
+        seam_pts.block(i*loop_size, 0, loop_size, dim) = *seam_loops[i];
+    }
+    const std::vector<size_t> seam_order = sort_rows(seam_pts);
+
+    std::vector<MatrixFr> vertex_blocks(num_partitions);
+    std::vector<MatrixIr> face_blocks(num_partitions);
+    std::vector<VectorI> face_source_blocks(num_partitions);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_partitions, 1),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    MeshPieces pieces;
+                    for (auto vi : partition_vertices[i]) {
+                        generate_joint(vi, pieces);
+                    }
+                    for (auto ei : partition_edges[i]) {
+                        connect_end_loop(ei, connecting_faces, ave_thickness,
+                                pieces);
+                    }
+                    assemble(pieces, vertex_blocks[i], face_blocks[i],
+                            face_source_blocks[i]);
+                    if (face_blocks[i].rows() == 0) continue;
+                    clean_up_partition(vertex_blocks[i], face_blocks[i],
+                            face_source_blocks[i], seam_pts, seam_order);
+                }
+            });
+
+    // Concatenate partitions in order.
+    std::vector<size_t> vertex_offsets(num_partitions+1, 0);
+    std::vector<size_t> face_offsets(num_partitions+1, 0);
+    for (size_t i=0; i<num_partitions; i++) {
+        vertex_offsets[i+1] = vertex_offsets[i] + vertex_blocks[i].rows();
+        face_offsets[i+1] = face_offsets[i] + face_blocks[i].rows();
+    }
+    const size_t total_num_vertices = vertex_offsets.back();
+    const size_t total_num_faces = face_offsets.back();
+    MatrixFr vertices(total_num_vertices, dim);
+    m_faces.resize(total_num_faces, 3);
+    m_face_sources.resize(total_num_faces);
+    for (size_t i=0; i<num_partitions; i++) {
+        if (vertex_blocks[i].rows() > 0) {
+            vertices.block(vertex_offsets[i], 0,
+                    vertex_blocks[i].rows(), dim) = vertex_blocks[i];
+        }
+        if (face_blocks[i].rows() > 0) {
+            m_faces.block(face_offsets[i], 0, face_blocks[i].rows(), 3) =
+                face_blocks[i].array() + int(vertex_offsets[i]);
+            m_face_sources.segment(face_offsets[i], face_blocks[i].rows()) =
+                face_source_blocks[i];
+        }
+    }
 
-        MatrixIr faces(num_connecting_faces * num_segments, 3);
-        for (size_t j=0; j<num_segments; j++) {
-            faces.block(j*num_connecting_faces, 0, num_connecting_faces, 3) =
-                connecting_faces.array() + j*loop_size;
+    // Stitch seams: each seam point maps to its first occurrence.
+    VectorI seam_ids(total_num_vertices);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, total_num_vertices),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    seam_ids[i] = find_row(seam_pts, seam_order,
+                            vertices.row(i).transpose());
+                }
+            });
+    std::vector<int> seam_targets(seam_pts.rows(), -1);
+    VectorI index_map(total_num_vertices);
+    size_t count = 0;
+    for (size_t i=0; i<total_num_vertices; i++) {
+        const int seam_id = seam_ids[i];
+        if (seam_id >= 0 && seam_targets[seam_id] >= 0) {
+            index_map[i] = seam_targets[seam_id];
+            continue;
         }
+        if (seam_id >= 0) seam_targets[seam_id] = count;
+        index_map[i] = count;
+        count++;
+    }
 
-        m_vertex_list.push_back(pts);
-        m_face_list.push_back(faces.array() + m_num_vertex_accumulated);
-        m_face_source_list.push_back(int(i)*(-1)-1);
-        m_num_vertex_accumulated += pts.rows();
+    m_vertices.resize(count, dim);
+    for (size_t i=0; i<total_num_vertices; i++) {
+        m_vertices.row(index_map[i]) = vertices.row(i);
     }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, total_num_faces),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    for (size_t j=0; j<3; j++) {
+                        m_faces(i, j) = index_map[m_faces(i, j)];
+                    }
+                }
+            });
 }
 
-void SimpleInflator::finalize() {
+VectorI SimpleInflator::compute_vertex_partitions() const {
     const size_t dim = m_wire_network->get_dim();
-    size_t num_vertices = 0;
-    size_t num_faces = 0;
-    for (auto itr : m_vertex_list) num_vertices += itr.rows();
-    for (auto itr : m_face_list) num_faces += itr.rows();
+    const size_t num_vertices = m_wire_network->get_num_vertices();
+    const MatrixFr& vertices = m_wire_network->get_vertices();
+    const int num_cells = m_num_partition_cells;
 
-    m_vertices.resize(num_vertices, dim);
-    m_faces.resize(num_faces, 3);
-    m_face_sources.resize(num_faces);
+    VectorF bbox_min = m_wire_network->get_bbox_min();
+    VectorF bbox_max = m_wire_network->get_bbox_max();
+    VectorF cell_size = (bbox_max - bbox_min) / Float(num_cells);
 
-    size_t vertex_count=0;
-    for (auto itr : m_vertex_list) {
-        size_t size = itr.rows();
-        m_vertices.block(vertex_count, 0, size, dim) = itr;
-        vertex_count += size;
+    VectorI partitions(num_vertices);
+    for (size_t i=0; i<num_vertices; i++) {
+        int index = 0;
+        for (size_t j=0; j<dim; j++) {
+            int cell = 0;
+            if (cell_size[j] > 0.0) {
+                cell = std::floor((vertices(i, j) - bbox_min[j]) / cell_size[j]);
+                cell = std::max(0, std::min(num_cells-1, cell));
+            }
+            index = index * num_cells + cell;
+        }
+        partitions[i] = index;
     }
+    return partitions;
+}
 
-    size_t face_count=0;
-    auto source_itr = m_face_source_list.begin();
-    for (auto itr : m_face_list) {
-        size_t size = itr.rows();
-        m_faces.block(face_count, 0, size, 3) = itr;
-        m_face_sources.segment(face_count, size) =
-            VectorI::Ones(size) * (*source_itr);
-        face_count += size;
-        source_itr++;
+void SimpleInflator::clean_up_partition(MatrixFr& vertices, MatrixIr& faces,
+        VectorI& face_sources, const MatrixFr& seam_pts,
+        const std::vector<size_t>& seam_order) const {
+    // Same steps as InflatorEngine::clean_up() except that seam vertices
+    // are left untouched.
+    DuplicatedVertexRemoval duplicate_remover(vertices, faces);
+    duplicate_remover.set_importance_level(
+            compute_seam_importance(vertices, seam_pts, seam_order));
+    duplicate_remover.run(1e-3);
+    vertices = duplicate_remover.get_vertices();
+    faces = duplicate_remover.get_faces();
+
+    ShortEdgeRemoval short_edge_remover(vertices, faces);
+    short_edge_remover.set_importance(
+            compute_seam_importance(vertices, seam_pts, seam_order));
+    short_edge_remover.run(1e-3);
+    vertices = short_edge_remover.get_vertices();
+    faces = short_edge_remover.get_faces();
+
+    const size_t num_faces = faces.rows();
+    const VectorI face_indices = short_edge_remover.get_face_indices();
+    VectorI sources(num_faces);
+    for (size_t i=0; i<num_faces; i++) {
+        sources[i] = face_sources[face_indices[i]];
     }
+    face_sources.swap(sources);
 
-    clean_up();
+    IsolatedVertexRemoval isolated_remover(vertices, faces);
+    isolated_remover.run();
+    vertices = isolated_remover.get_vertices();
+    faces = isolated_remover.get_faces();
 }
 
 void SimpleInflator::refine() {
+    PYMESH_PROFILE_ZONE("SimpleInflator::refine");
     if (!m_refiner) return;
     Subdivision::Ptr subdiv = m_refiner;
+    subdiv->set_matrix_mode(Subdivision::MATRIX_FREE);
     subdiv->subdivide(m_vertices, m_faces, m_subdiv_order);
     m_vertices = subdiv->get_vertices();
     m_faces = subdiv->get_faces();
@@ -339,8 +523,29 @@ MatrixFr SimpleInflator::get_edge_thickness() const {
 }
 
 void SimpleInflator::generate_joint(
-        const MatrixFr& pts, const VectorI& source_ids, size_t vertex_index) {
+        size_t vertex_index, MeshPieces& pieces) const {
     const size_t dim = m_wire_network->get_dim();
+    const MatrixIr& edges = m_wire_network->get_edges();
+    const size_t loop_size = m_profile->size();
+    const auto& edge_ids = m_incident_edges[vertex_index];
+    const size_t valance = edge_ids.size();
+
+    MatrixFr pts(valance * loop_size + 1, dim);
+    VectorI  source_ids(pts.rows());
+    pts.row(0) = m_wire_network->get_vertices().row(vertex_index);
+    source_ids[0] = -1;
+    for (size_t i=0; i<valance; i++) {
+        const size_t edge_id = edge_ids[i];
+        const auto& end_loops = m_end_loops[edge_id];
+        if (size_t(edges(edge_id, 0)) == vertex_index) {
+            pts.block(i*loop_size+1, 0, loop_size, dim) = end_loops.first;
+        } else {
+            pts.block(i*loop_size+1, 0, loop_size, dim) = end_loops.second;
+        }
+        source_ids.segment(i*loop_size+1, loop_size) =
+            VectorI::Ones(loop_size) * edge_id;
+    }
+
     ConvexHullEngine::Ptr convex_hull = ConvexHullEngine::create(dim, "auto");
     convex_hull->run(pts);
 
@@ -363,7 +568,7 @@ void SimpleInflator::generate_joint(
         assert(vertices.rows() == num_vertices);
     }
 
-    m_vertex_list.push_back(vertices);
+    pieces.vertex_list.push_back(vertices);
     const size_t num_faces = faces.rows();
     for (size_t i=0; i<num_faces; i++) {
         const auto& face = faces.row(i);
@@ -371,11 +576,76 @@ void SimpleInflator::generate_joint(
             auto ori_indices = map_indices(face, index_map);
             if (belong_to_the_same_loop(ori_indices, source_ids)) continue;
         }
-        m_face_list.push_back(face.array() + m_num_vertex_accumulated);
-        m_face_source_list.push_back(vertex_index+1);
+        pieces.face_list.push_back(
+                face.array() + int(pieces.num_vertex_accumulated));
+        pieces.face_source_list.push_back(vertex_index+1);
+    }
+
+    pieces.num_vertex_accumulated += vertices.rows();
+}
+
+void SimpleInflator::connect_end_loop(size_t edge_index,
+        const MatrixIr& connecting_faces, Float ave_thickness,
+        MeshPieces& pieces) const {
+    const size_t dim = m_wire_network->get_dim();
+    const auto& edge_lengths = m_wire_network->get_attribute("edge_length");
+    const size_t loop_size = m_profile->size();
+    const size_t num_connecting_faces = connecting_faces.rows();
+
+    Float edge_length = edge_lengths(edge_index, 0);
+    const auto& end_loops = m_end_loops[edge_index];
+    const size_t num_segments = std::max(1.0,
+            std::round(edge_length / ave_thickness / m_aspect_max));
+    MatrixFr pts((num_segments+1)*loop_size, dim);
+
+    for (size_t j=0; j<num_segments+1; j++) {
+        Float alpha = Float(j) / Float(num_segments);
+        pts.block(j*loop_size, 0, loop_size, dim) =
+            end_loops.first * (1.0 - alpha) + end_loops.second * alpha;
+    }
+
+    MatrixIr faces(num_connecting_faces * num_segments, 3);
+    for (size_t j=0; j<num_segments; j++) {
+        faces.block(j*num_connecting_faces, 0, num_connecting_faces, 3) =
+            connecting_faces.array() + j*loop_size;
     }
 
-    m_num_vertex_accumulated += vertices.rows();
+    pieces.vertex_list.push_back(pts);
+    pieces.face_list.push_back(
+            faces.array() + int(pieces.num_vertex_accumulated));
+    pieces.face_source_list.push_back(int(edge_index)*(-1)-1);
+    pieces.num_vertex_accumulated += pts.rows();
+}
+
+void SimpleInflator::assemble(const MeshPieces& pieces, MatrixFr& vertices,
+        MatrixIr& faces, VectorI& face_sources) const {
+    const size_t dim = m_wire_network->get_dim();
+    size_t num_vertices = 0;
+    size_t num_faces = 0;
+    for (const auto& itr : pieces.vertex_list) num_vertices += itr.rows();
+    for (const auto& itr : pieces.face_list) num_faces += itr.rows();
+
+    vertices.resize(num_vertices, dim);
+    faces.resize(num_faces, 3);
+    face_sources.resize(num_faces);
+
+    size_t vertex_count=0;
+    for (const auto& itr : pieces.vertex_list) {
+        size_t size = itr.rows();
+        vertices.block(vertex_count, 0, size, dim) = itr;
+        vertex_count += size;
+    }
+
+    size_t face_count=0;
+    auto source_itr = pieces.face_source_list.begin();
+    for (const auto& itr : pieces.face_list) {
+        size_t size = itr.rows();
+        faces.block(face_count, 0, size, 3) = itr;
+        face_sources.segment(face_count, size) =
+            VectorI::Ones(size) * (*source_itr);
+        face_count += size;
+        source_itr++;
+    }
 }
 
 bool SimpleInflator::belong_to_the_same_loop(
@@ -11,37 +11,70 @@ namespace PyMesh {
 class SimpleInflator : public InflatorEngine {
     public:
         SimpleInflator(WireNetwork::Ptr wire_network)
-            : InflatorEngine(wire_network) {}
+            : InflatorEngine(wire_network), m_num_partition_cells(0) {}
         virtual ~SimpleInflator() {}
 
     public:
         virtual void inflate();
         virtual const std::vector<MatrixFr>& get_shape_velocities() const;
 
+        /**
+         * Split the bounding box of the wire network into num_cells^dim
+         * partitions.  Joints and struts of each partition are generated and
+         * cleaned in parallel, and partition seams are stitched afterwards.
+         * Set to 0 or 1 to inflate the whole network at once (default).
+         */
+        virtual void with_partitions(size_t num_cells) {
+            m_num_partition_cells = num_cells;
+        }
+
+    protected:
+        /**
+         * Geometry pieces (joints and struts) waiting to be assembled.
+         */
+        struct MeshPieces {
+            MeshPieces() : num_vertex_accumulated(0) {}
+            size_t num_vertex_accumulated;
+            std::list<MatrixFr> vertex_list;
+            std::list<MatrixIr> face_list;
+            std::list<int> face_source_list;
+        };
+
     protected:
         void initialize();
         void compute_end_loop_offsets();
         void generate_end_loops();
+        void collect_incident_edges();
         void generate_joints();
         void connect_end_loops();
         void finalize();
         void refine();
 
+        void inflate_partitions();
+        VectorI compute_vertex_partitions() const;
+        void clean_up_partition(MatrixFr& vertices, MatrixIr& faces,
+                VectorI& face_sources, const MatrixFr& seam_pts,
+                const std::vector<size_t>& seam_order) const;
+
         VectorF compute_vertex_thickness() const;
         void validate_end_loop_offset() const;
         MatrixFr get_edge_thickness() const;
-        void generate_joint(const MatrixFr& pts, const VectorI& source_ids, size_t vertex_index);
+        void generate_joint(size_t vertex_index, MeshPieces& pieces) const;
+        void connect_end_loop(size_t edge_index,
+                const MatrixIr& connecting_faces, Float ave_thickness,
+                MeshPieces& pieces) const;
+        void assemble(const MeshPieces& pieces, MatrixFr& vertices,
+                MatrixIr& faces, VectorI& face_sources) const;
         bool belong_to_the_same_loop(
                 const VectorI& indices, const VectorI& source_ids) const;
 
     protected:
         VectorF m_end_loop_offsets;
         std::vector<std::pair<MatrixFr, MatrixFr> > m_end_loops;
+        std::vector<std::vector<size_t> > m_incident_edges;
 
-        size_t m_num_vertex_accumulated;
-        std::list<MatrixFr> m_vertex_list;
-        std::list<MatrixIr> m_face_list;
-        std::list<int> m_face_source_list;
+        MeshPieces m_pieces;
+        size_t m_num_partition_cells;
 };
 
 }
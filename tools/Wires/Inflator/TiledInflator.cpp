@@ -0,0 +1,340 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#include "TiledInflator.h"
+
+#include <functional>
+#include <sstream>
+#include <unordered_map>
+
+#include <tbb/tbb.h>
+
+#include <Core/Exception.h>
+#include <Misc/Multiplet.h>
+#include <Misc/Profiler.h>
+#include <MeshUtils/DuplicatedVertexRemoval.h>
+#include <MeshUtils/IsolatedVertexRemoval.h>
+#include <Wires/Tiler/MeshTilerHelper.h>
+
+#include "InflatorEngine.h"
+
+using namespace PyMesh;
+
+namespace TiledInflatorHelper {
+    std::vector<VectorI> enumerate(const VectorI& repetitions) {
+        std::vector<VectorI> result;
+        const size_t dim = repetitions.size();
+        if (dim == 2) {
+            for (size_t i=0; i<repetitions[0]; i++) {
+                for (size_t j=0; j<repetitions[1]; j++) {
+                    result.push_back(Vector2I(i,j));
+                }
+            }
+        } else if (dim == 3) {
+            for (size_t i=0; i<repetitions[0]; i++) {
+                for (size_t j=0; j<repetitions[1]; j++) {
+                    for (size_t k=0; k<repetitions[2]; k++) {
+                        result.push_back(Vector3I(i,j,k));
+                    }
+                }
+            }
+        } else {
+            std::stringstream err_msg;
+            err_msg << "Unsupported dim: " << dim;
+            throw NotImplementedError(err_msg.str());
+        }
+        return result;
+    }
+
+    void normalize_unit_wire(WireNetwork::Ptr wire_network,
+            const VectorF& cell_size) {
+        if (cell_size.minCoeff() <= 1e-30) {
+            throw RuntimeError("Degenerated tile cell size.");
+        }
+        VectorF factors = cell_size.cwiseQuotient(
+                wire_network->get_bbox_max() - wire_network->get_bbox_min());
+        wire_network->center_at_origin();
+        wire_network->scale(factors);
+    }
+
+    size_t hash_values(const VectorF& values) {
+        std::hash<Float> hash_func;
+        size_t result = 0;
+        const size_t num_values = values.size();
+        for (size_t i=0; i<num_values; i++) {
+            result ^= hash_func(values[i]) + 0x9e3779b9 +
+                (result << 6) + (result >> 2);
+        }
+        return result;
+    }
+}
+
+using namespace TiledInflatorHelper;
+
+TiledInflator::TiledInflator(WireNetwork::Ptr unit_wire_network,
+        ParameterManager::Ptr params) :
+    m_unit_wire_network(unit_wire_network),
+    m_params(params),
+    m_refinement_order(0),
+    m_weld_tol(1e-3),
+    m_num_cached_cells(0) {
+        if (!m_params) {
+            m_params = ParameterManager::create_empty_manager(
+                    m_unit_wire_network);
+        }
+        m_params->set_wire_network(m_unit_wire_network);
+    }
+
+void TiledInflator::with_refinement(
+        const std::string& algorithm, size_t order) {
+    m_refinement_algorithm = algorithm;
+    m_refinement_order = order;
+}
+
+void TiledInflator::inflate_with_guide_bbox(
+        const VectorF& bbox_min,
+        const VectorF& bbox_max,
+        const VectorI& repetitions) {
+    PYMESH_PROFILE_ZONE("TiledInflator::inflate_with_guide_bbox");
+    const size_t dim = m_unit_wire_network->get_dim();
+    if (bbox_min.size() != dim || bbox_max.size() != dim ||
+            repetitions.size() != dim) {
+        std::stringstream err_msg;
+        err_msg << "Imcompatible guide bbox dimension, expect " << dim;
+        throw RuntimeError(err_msg.str());
+    }
+
+    VectorF cell_size = (bbox_max - bbox_min).cwiseQuotient(
+            repetitions.cast<Float>());
+    normalize_unit_wire(m_unit_wire_network, cell_size);
+    const VectorF ref_pt = m_unit_wire_network->get_bbox_min();
+
+    // All tiles share the same parameters.
+    ParameterCommon::Variables vars;
+    m_params->evaluate_thickness(vars);
+    m_params->evaluate_offset(vars);
+    const CellGeometry& cell = get_cell(m_params->get_dofs());
+
+    TilerEngine::FuncList funcs;
+    std::vector<const CellGeometry*> cells;
+    for (const auto& index : enumerate(repetitions)) {
+        VectorF offset = cell_size.cwiseProduct(index.cast<Float>()) - ref_pt;
+        funcs.push_back(
+                [=] (const MatrixFr& vertices) {
+                    MatrixFr result(vertices);
+                    result.rowwise() += offset.transpose();
+                    return result;
+                });
+        cells.push_back(&cell);
+    }
+
+    instantiate(funcs, cells);
+    weld();
+}
+
+void TiledInflator::inflate_with_guide_mesh(const MeshPtr mesh) {
+    PYMESH_PROFILE_ZONE("TiledInflator::inflate_with_guide_mesh");
+    const size_t dim = m_unit_wire_network->get_dim();
+    if (mesh->get_dim() != dim) {
+        std::stringstream err_msg;
+        err_msg << "Unsupported dim: " << mesh->get_dim()
+            << ", expect " << dim;
+        throw RuntimeError(err_msg.str());
+    }
+
+    normalize_unit_wire(m_unit_wire_network, VectorF::Ones(dim));
+    m_unit_wire_network->translate(VectorF::Ones(dim) * 0.5);
+
+    TilerEngine::FuncList funcs = (dim == 2) ?
+        MeshTilerHelper::get_2D_tiling_operators(mesh) :
+        MeshTilerHelper::get_3D_tiling_operators(mesh);
+    auto vars_array = MeshTilerHelper::extract_attributes(mesh);
+    assert(vars_array.size() == funcs.size());
+
+    std::vector<const CellGeometry*> cells;
+    for (const auto& vars : vars_array) {
+        m_params->evaluate_thickness(vars);
+        m_params->evaluate_offset(vars);
+        cells.push_back(&get_cell(m_params->get_dofs()));
+    }
+
+    instantiate(funcs, cells);
+    weld();
+}
+
+void TiledInflator::clear_cache() {
+    m_cache.clear();
+    m_num_cached_cells = 0;
+}
+
+VectorF TiledInflator::compute_cell_key(const VectorF& dofs) const {
+    // Cell geometry also depends on the normalized unit cell size.
+    const size_t dim = m_unit_wire_network->get_dim();
+    const size_t num_dofs = dofs.size();
+    VectorF key(num_dofs + dim * 2);
+    key.segment(0, num_dofs) = dofs;
+    key.segment(num_dofs, dim) = m_unit_wire_network->get_bbox_min();
+    key.segment(num_dofs + dim, dim) = m_unit_wire_network->get_bbox_max();
+    return key;
+}
+
+const TiledInflator::CellGeometry& TiledInflator::get_cell(
+        const VectorF& dofs) {
+    const VectorF key = compute_cell_key(dofs);
+    auto& bucket = m_cache[hash_values(key)];
+    for (const auto& cell : bucket) {
+        if (cell.key.size() == key.size() && cell.key == key) {
+            return cell;
+        }
+    }
+
+    bucket.emplace_back();
+    CellGeometry& cell = bucket.back();
+    cell.key = key;
+    inflate_cell(dofs, cell);
+    m_num_cached_cells++;
+    return cell;
+}
+
+void TiledInflator::inflate_cell(const VectorF& dofs, CellGeometry& cell) {
+    // The periodic inflator evaluates parameters without variables, so
+    // formulas are stripped while inflating with the cell's dofs.
+    std::vector<std::string> formulas;
+    for (auto param : m_params->get_thickness_params()) {
+        formulas.push_back(param->get_formula());
+        param->set_formula("");
+    }
+    for (auto param : m_params->get_offset_params()) {
+        formulas.push_back(param->get_formula());
+        param->set_formula("");
+    }
+    const VectorF ori_dofs = m_params->get_dofs();
+    auto restore_parameters = [&]() {
+        auto itr = formulas.begin();
+        for (auto param : m_params->get_thickness_params()) {
+            param->set_formula(*itr);
+            itr++;
+        }
+        for (auto param : m_params->get_offset_params()) {
+            param->set_formula(*itr);
+            itr++;
+        }
+        m_params->set_dofs(ori_dofs);
+    };
+
+    try {
+        m_params->set_dofs(dofs);
+        InflatorEngine::Ptr inflator = InflatorEngine::create_parametric(
+                m_unit_wire_network, m_params);
+        if (m_profile) {
+            inflator->set_profile(m_profile);
+        }
+        if (m_refinement_order > 0) {
+            inflator->with_refinement(
+                    m_refinement_algorithm, m_refinement_order);
+        }
+        inflator->inflate();
+
+        cell.vertices = inflator->get_vertices();
+        cell.faces = inflator->get_faces();
+        cell.face_sources = inflator->get_face_sources();
+    } catch (...) {
+        restore_parameters();
+        throw;
+    }
+    restore_parameters();
+}
+
+void TiledInflator::instantiate(const TilerEngine::FuncList& funcs,
+        const std::vector<const CellGeometry*>& cells) {
+    const size_t dim = m_unit_wire_network->get_dim();
+    const int num_unit_vertices = m_unit_wire_network->get_num_vertices();
+    const int num_unit_edges = m_unit_wire_network->get_num_edges();
+    const size_t num_tiles = cells.size();
+    assert(funcs.size() == num_tiles);
+
+    std::vector<TilerEngine::Func> transforms(funcs.begin(), funcs.end());
+    std::vector<size_t> vertex_offsets(num_tiles+1, 0);
+    std::vector<size_t> face_offsets(num_tiles+1, 0);
+    for (size_t i=0; i<num_tiles; i++) {
+        vertex_offsets[i+1] = vertex_offsets[i] + cells[i]->vertices.rows();
+        face_offsets[i+1] = face_offsets[i] + cells[i]->faces.rows();
+    }
+
+    m_vertices.resize(vertex_offsets.back(), dim);
+    m_faces.resize(face_offsets.back(), 3);
+    m_face_sources.resize(face_offsets.back());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_tiles),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const CellGeometry& cell = *cells[i];
+                    const size_t num_vertices = cell.vertices.rows();
+                    const size_t num_faces = cell.faces.rows();
+                    if (num_vertices > 0) {
+                        m_vertices.block(vertex_offsets[i], 0,
+                                num_vertices, dim) =
+                            transforms[i](cell.vertices);
+                    }
+                    if (num_faces == 0) continue;
+                    m_faces.block(face_offsets[i], 0, num_faces, 3) =
+                        cell.faces.array() + int(vertex_offsets[i]);
+                    for (size_t j=0; j<num_faces; j++) {
+                        const int source = cell.face_sources[j];
+                        int tiled_source = 0;
+                        if (source > 0) {
+                            tiled_source = source + i * num_unit_vertices;
+                        } else if (source < 0) {
+                            tiled_source = source - i * num_unit_edges;
+                        }
+                        m_face_sources[face_offsets[i] + j] = tiled_source;
+                    }
+                }
+            });
+}
+
+void TiledInflator::weld() {
+    PYMESH_PROFILE_ZONE("TiledInflator::weld");
+    DuplicatedVertexRemoval duplicate_remover(m_vertices, m_faces);
+    duplicate_remover.run(m_weld_tol);
+    m_vertices = duplicate_remover.get_vertices();
+    m_faces = duplicate_remover.get_faces();
+
+    remove_cell_walls();
+
+    IsolatedVertexRemoval isolated_remover(m_vertices, m_faces);
+    isolated_remover.run();
+    m_vertices = isolated_remover.get_vertices();
+    m_faces = isolated_remover.get_faces();
+}
+
+void TiledInflator::remove_cell_walls() {
+    PYMESH_PROFILE_ZONE("TiledInflator::remove_cell_walls");
+    // Walls shared by two adjacent cells show up as a pair of faces with the
+    // same vertices after welding.  Both copies are interior.
+    typedef std::unordered_map<Triplet, int, MultipletHashFunc<Triplet> >
+        FaceCount;
+    const size_t num_faces = m_faces.rows();
+    FaceCount face_count;
+    for (size_t i=0; i<num_faces; i++) {
+        if (m_face_sources[i] != 0) continue;
+        Triplet key(m_faces(i, 0), m_faces(i, 1), m_faces(i, 2));
+        face_count[key]++;
+    }
+
+    std::vector<size_t> kept_faces;
+    for (size_t i=0; i<num_faces; i++) {
+        if (m_face_sources[i] == 0) {
+            Triplet key(m_faces(i, 0), m_faces(i, 1), m_faces(i, 2));
+            if (face_count[key] > 1) continue;
+        }
+        kept_faces.push_back(i);
+    }
+
+    const size_t num_kept_faces = kept_faces.size();
+    MatrixIr faces(num_kept_faces, 3);
+    VectorI face_sources(num_kept_faces);
+    for (size_t i=0; i<num_kept_faces; i++) {
+        faces.row(i) = m_faces.row(kept_faces[i]);
+        face_sources[i] = m_face_sources[kept_faces[i]];
+    }
+    m_faces.swap(faces);
+    m_face_sources.swap(face_sources);
+}
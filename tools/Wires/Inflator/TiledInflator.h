@@ -0,0 +1,104 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Mesh.h>
+#include <Wires/Parameters/ParameterManager.h>
+#include <Wires/Tiler/TilerEngine.h>
+#include <Wires/WireNetwork/WireNetwork.h>
+
+#include "WireProfile.h"
+
+namespace PyMesh {
+
+/**
+ * Inflate a tiled lattice one unit cell at a time.
+ *
+ * Each distinct cell, identified by its parameter dofs, is inflated once with
+ * the periodic inflator and cached.  The cached cell is then mapped into every
+ * tile slot using the same cell transforms as the wire tilers.  Finally,
+ * vertices on shared cell boundaries are welded and the internal cell walls
+ * are removed.
+ *
+ * Seams only match when adjacent cells have compatible cross sections on
+ * their shared boundary, e.g. identical parameters.
+ */
+class TiledInflator {
+    public:
+        typedef std::shared_ptr<TiledInflator> Ptr;
+        typedef Mesh::Ptr MeshPtr;
+
+    public:
+        TiledInflator(WireNetwork::Ptr unit_wire_network,
+                ParameterManager::Ptr params);
+
+    public:
+        void with_refinement(const std::string& algorithm, size_t order);
+        void set_profile(WireProfile::Ptr profile) { m_profile = profile; }
+        void set_weld_tolerance(Float tol) { m_weld_tol = tol; }
+
+        /**
+         * Same tile layout as WireTiler::tile_with_guide_bbox().
+         */
+        void inflate_with_guide_bbox(
+                const VectorF& bbox_min,
+                const VectorF& bbox_max,
+                const VectorI& repetitions);
+
+        /**
+         * Same tile layout as WireTiler::tile_with_guide_mesh().
+         */
+        void inflate_with_guide_mesh(const MeshPtr mesh);
+
+        MatrixFr get_vertices() const { return m_vertices; }
+        MatrixIr get_faces() const { return m_faces; }
+
+        /**
+         * Face sources follow the convention of InflatorEngine, where wire
+         * vertex and edge indices refer to the unmerged tiled network, i.e.
+         * the i-th tile owns vertices [i*#v, (i+1)*#v) and edges
+         * [i*#e, (i+1)*#e) of the unit network.  Cell wall faces have source 0.
+         */
+        VectorI  get_face_sources() const { return m_face_sources; }
+
+        size_t get_num_cached_cells() const { return m_num_cached_cells; }
+        void clear_cache();
+
+    private:
+        struct CellGeometry {
+            VectorF key;
+            MatrixFr vertices;
+            MatrixIr faces;
+            VectorI face_sources;
+        };
+
+        VectorF compute_cell_key(const VectorF& dofs) const;
+        const CellGeometry& get_cell(const VectorF& dofs);
+        void inflate_cell(const VectorF& dofs, CellGeometry& cell);
+        void instantiate(const TilerEngine::FuncList& funcs,
+                const std::vector<const CellGeometry*>& cells);
+        void weld();
+        void remove_cell_walls();
+
+    private:
+        WireNetwork::Ptr m_unit_wire_network;
+        ParameterManager::Ptr m_params;
+        WireProfile::Ptr m_profile;
+        std::string m_refinement_algorithm;
+        size_t m_refinement_order;
+        Float m_weld_tol;
+
+        size_t m_num_cached_cells;
+        std::unordered_map<size_t, std::list<CellGeometry> > m_cache;
+
+        MatrixFr m_vertices;
+        MatrixIr m_faces;
+        VectorI  m_face_sources;
+};
+
+}
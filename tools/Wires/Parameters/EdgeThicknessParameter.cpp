@@ -11,11 +11,11 @@ void EdgeThicknessParameter::apply(VectorF& results,
 
     assert(results.size() == num_edges);
 
-    if (m_formula != "") evaluate_formula(vars);
+    const Float value = evaluate_value(vars);
 
     for (size_t i=0; i<roi_size; i++) {
         assert(m_roi[i] < num_edges);
-        results[m_roi[i]] = m_value;
+        results[m_roi[i]] = value;
     }
 }
 
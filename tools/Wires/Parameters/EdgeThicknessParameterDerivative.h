@@ -1,6 +1,7 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #pragma once
 
+#include <vector>
 #include "ParameterDerivative.h"
 
 namespace PyMesh {
@@ -10,11 +11,17 @@ class EdgeThicknessParameterDerivative : public ParameterDerivative {
         EdgeThicknessParameterDerivative(
                 Mesh::Ptr mesh, PatternParameter::Ptr param)
             : ParameterDerivative(mesh, param) { }
+        EdgeThicknessParameterDerivative(
+                Mesh::Ptr mesh, PatternParameter::Ptr param,
+                MeshInfo::Ptr info)
+            : ParameterDerivative(mesh, param, info) { }
 
         virtual ~EdgeThicknessParameterDerivative() {}
 
-    public:
-        virtual MatrixFr compute();
+    protected:
+        virtual std::vector<int> get_relevant_faces() const;
+        virtual void accumulate(size_t face_index, const Vector3I& local_face,
+                MatrixFr& derivative_v, VectorF& weights);
 };
 
 }
@@ -1,58 +1,194 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #include "ParameterDerivative.h"
 
+#include <algorithm>
+
 #include <Core/Exception.h>
 
 using namespace PyMesh;
 
-ParameterDerivative::ParameterDerivative(Mesh::Ptr mesh, PatternParameter::Ptr param)
-    : m_mesh(mesh), m_parameter(param) {
-        initialize_wires();
-        initialize_mesh();
-        initialize_normals();
-        initialize_face_voronoi_areas();
+namespace ParameterDerivativeHelper {
+    /**
+     * Bucket the faces by wire element using counting sort.  Within each
+     * bucket, faces are in increasing order.
+     */
+    void bucket_faces(const std::vector<std::pair<int, int> >& element_faces,
+            size_t num_elements,
+            std::vector<int>& offsets, std::vector<int>& faces) {
+        offsets.assign(num_elements+1, 0);
+        for (const auto& item : element_faces) {
+            offsets[item.first+1]++;
+        }
+        for (size_t i=0; i<num_elements; i++) {
+            offsets[i+1] += offsets[i];
+        }
+        faces.resize(element_faces.size());
+        std::vector<int> cursor(offsets.begin(), offsets.end()-1);
+        for (const auto& item : element_faces) {
+            faces[cursor[item.first]] = item.second;
+            cursor[item.first]++;
+        }
     }
+}
 
-void ParameterDerivative::initialize_wires()  {
-    WireNetwork::Ptr wire_network = m_parameter->get_wire_network();
+using namespace ParameterDerivativeHelper;
+
+ParameterDerivative::MeshInfo::Ptr ParameterDerivative::MeshInfo::create(
+        Mesh::Ptr mesh, WireNetwork::Ptr wire_network) {
+    assert(mesh->get_vertex_per_face() == 3);
     if (!wire_network->with_connectivity()) {
         wire_network->compute_connectivity();
     }
-}
 
-void ParameterDerivative::initialize_mesh() {
-    assert(m_mesh->get_vertex_per_face() == 3);
-    if (!m_mesh->has_attribute("face_voronoi_area")) {
-        m_mesh->add_attribute("face_voronoi_area");
+    if (!mesh->has_attribute("face_voronoi_area")) {
+        mesh->add_attribute("face_voronoi_area");
     }
-
-    if (!m_mesh->has_attribute("face_source")) {
+    if (!mesh->has_attribute("face_source")) {
         throw RuntimeError("Mesh does not have face source attribute");
     }
-    m_face_source = m_mesh->get_attribute("face_source").cast<int>();
-}
 
-void ParameterDerivative::initialize_normals() {
-    const size_t dim = m_mesh->get_dim();
+    const size_t dim = mesh->get_dim();
+    const size_t num_faces = mesh->get_num_faces();
     if (dim == 2) {
         throw NotImplementedError("2D is not supported yet");
-    } else {
-        if (!m_mesh->has_attribute("face_normal")) {
-            m_mesh->add_attribute("face_normal");
-        }
-        VectorF face_normals = m_mesh->get_attribute("face_normal");
-        m_face_normals.resize(m_mesh->get_num_faces(), dim);
-        std::copy(face_normals.data(), face_normals.data() + face_normals.size(),
-                m_face_normals.data());
     }
-}
+    if (!mesh->has_attribute("face_normal")) {
+        mesh->add_attribute("face_normal");
+    }
 
-void ParameterDerivative::initialize_face_voronoi_areas() {
-    VectorF face_voronoi_area = m_mesh->get_attribute("face_voronoi_area");
-    m_face_voronoi_areas.resize(m_mesh->get_num_faces(),
-            m_mesh->get_vertex_per_face());
+    Ptr info = std::make_shared<MeshInfo>();
+    info->face_source = mesh->get_attribute("face_source").cast<int>();
+
+    VectorF face_normals = mesh->get_attribute("face_normal");
+    info->face_normals.resize(num_faces, dim);
+    std::copy(face_normals.data(), face_normals.data() + face_normals.size(),
+            info->face_normals.data());
+
+    VectorF face_voronoi_area = mesh->get_attribute("face_voronoi_area");
+    info->face_voronoi_areas.resize(num_faces, mesh->get_vertex_per_face());
     std::copy(face_voronoi_area.data(),
             face_voronoi_area.data() + face_voronoi_area.size(),
-            m_face_voronoi_areas.data());
+            info->face_voronoi_areas.data());
+
+    const int num_wire_vertices = wire_network->get_num_vertices();
+    const int num_wire_edges = wire_network->get_num_edges();
+    std::vector<std::pair<int, int> > vertex_faces;
+    std::vector<std::pair<int, int> > edge_faces;
+    for (size_t i=0; i<num_faces; i++) {
+        const int source = info->face_source[i];
+        if (source > 0) {
+            assert(source - 1 < num_wire_vertices);
+            vertex_faces.emplace_back(source - 1, i);
+        } else if (source < 0) {
+            assert(-source - 1 < num_wire_edges);
+            edge_faces.emplace_back(-source - 1, i);
+        }
+    }
+    bucket_faces(vertex_faces, num_wire_vertices,
+            info->vertex_face_offsets, info->vertex_faces);
+    bucket_faces(edge_faces, num_wire_edges,
+            info->edge_face_offsets, info->edge_faces);
+
+    return info;
+}
+
+ParameterDerivative::ParameterDerivative(Mesh::Ptr mesh, PatternParameter::Ptr param)
+    : ParameterDerivative(mesh, param,
+            MeshInfo::create(mesh, param->get_wire_network())) { }
+
+ParameterDerivative::ParameterDerivative(Mesh::Ptr mesh,
+        PatternParameter::Ptr param, MeshInfo::Ptr info)
+    : m_mesh(mesh), m_parameter(param), m_info(info),
+      m_face_source(info->face_source),
+      m_face_normals(info->face_normals),
+      m_face_voronoi_areas(info->face_voronoi_areas) { }
+
+MatrixFr ParameterDerivative::compute() {
+    const size_t dim = m_mesh->get_dim();
+    const size_t num_mesh_vertices = m_mesh->get_num_vertices();
+    SparseVelocity sparse_velocity = compute_sparse();
+    const VectorI& indices = sparse_velocity.first;
+    const MatrixFr& values = sparse_velocity.second;
+
+    MatrixFr derivative_v = MatrixFr::Zero(num_mesh_vertices, dim);
+    const size_t num_indices = indices.size();
+    for (size_t i=0; i<num_indices; i++) {
+        derivative_v.row(indices[i]) = values.row(i);
+    }
+    return derivative_v;
+}
+
+ParameterDerivative::SparseVelocity ParameterDerivative::compute_sparse() {
+    WireNetwork::Ptr wire_network = m_parameter->get_wire_network();
+    const size_t dim = m_mesh->get_dim();
+    assert(dim == wire_network->get_dim());
+
+    // Faces are visited in increasing order, the same order as a full scan
+    // of the mesh, so the accumulated values are identical.
+    const std::vector<int> faces = get_relevant_faces();
+    const size_t num_faces = faces.size();
+
+    std::vector<int> vertices;
+    vertices.reserve(num_faces * 3);
+    for (const auto fi : faces) {
+        const VectorI face = m_mesh->get_face(fi);
+        vertices.push_back(face[0]);
+        vertices.push_back(face[1]);
+        vertices.push_back(face[2]);
+    }
+    std::sort(vertices.begin(), vertices.end());
+    vertices.erase(std::unique(vertices.begin(), vertices.end()),
+            vertices.end());
+    const size_t num_vertices = vertices.size();
+
+    MatrixFr derivative_v = MatrixFr::Zero(num_vertices, dim);
+    VectorF weights = VectorF::Zero(num_vertices);
+    for (const auto fi : faces) {
+        const VectorI face = m_mesh->get_face(fi);
+        Vector3I local_face;
+        for (size_t j=0; j<3; j++) {
+            local_face[j] = std::lower_bound(vertices.begin(), vertices.end(),
+                    face[j]) - vertices.begin();
+        }
+        accumulate(fi, local_face, derivative_v, weights);
+    }
+
+    for (size_t i=0; i<num_vertices; i++) {
+        if (weights[i] > 0)
+            derivative_v.row(i) /= weights[i];
+    }
+
+    VectorI indices(num_vertices);
+    std::copy(vertices.begin(), vertices.end(), indices.data());
+    return SparseVelocity(indices, derivative_v);
 }
 
+void ParameterDerivative::append_vertex_faces(size_t wire_vertex_index,
+        std::vector<int>& faces) const {
+    faces.insert(faces.end(),
+            m_info->vertex_faces.begin() +
+            m_info->vertex_face_offsets[wire_vertex_index],
+            m_info->vertex_faces.begin() +
+            m_info->vertex_face_offsets[wire_vertex_index+1]);
+}
+
+void ParameterDerivative::append_edge_faces(size_t wire_edge_index,
+        std::vector<int>& faces) const {
+    faces.insert(faces.end(),
+            m_info->edge_faces.begin() +
+            m_info->edge_face_offsets[wire_edge_index],
+            m_info->edge_faces.begin() +
+            m_info->edge_face_offsets[wire_edge_index+1]);
+}
+
+ParameterDerivative::BoolVector ParameterDerivative::get_roi_mask(
+        size_t domain_size) const {
+    BoolVector in_roi(domain_size, false);
+    VectorI roi = m_parameter->get_roi();
+    const size_t roi_size = roi.size();
+    for (size_t i=0; i<roi_size; i++) {
+        assert(roi[i] >= 0 && roi[i] < domain_size);
+        in_roi[roi[i]] = true;
+    }
+    return in_roi;
+}
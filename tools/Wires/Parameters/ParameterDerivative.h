@@ -3,9 +3,12 @@
 
 #include <memory>
 #include <cassert>
+#include <utility>
+#include <vector>
 
 #include <Mesh.h>
 #include <Core/Exception.h>
+#include <Wires/WireNetwork/WireNetwork.h>
 #include "PatternParameter.h"
 
 namespace PyMesh {
@@ -14,8 +17,34 @@ class ParameterDerivative {
     public:
         typedef std::shared_ptr<ParameterDerivative> Ptr;
 
+        /**
+         * Sparse shape velocity: indices of the vertices with nonzero
+         * velocity and the corresponding "#indices x dim" velocity values.
+         */
+        typedef std::pair<VectorI, MatrixFr> SparseVelocity;
+
+        /**
+         * Per mesh data shared by the derivatives of all parameters, including
+         * the faces generated by each wire vertex and each wire edge in CSR
+         * form.  Must be created before evaluating derivatives concurrently.
+         */
+        struct MeshInfo {
+            typedef std::shared_ptr<MeshInfo> Ptr;
+            static Ptr create(Mesh::Ptr mesh, WireNetwork::Ptr wire_network);
+
+            VectorI  face_source;
+            MatrixFr face_normals;
+            MatrixFr face_voronoi_areas;
+            std::vector<int> vertex_face_offsets;
+            std::vector<int> vertex_faces;
+            std::vector<int> edge_face_offsets;
+            std::vector<int> edge_faces;
+        };
+
     public:
         ParameterDerivative(Mesh::Ptr mesh, PatternParameter::Ptr param);
+        ParameterDerivative(Mesh::Ptr mesh, PatternParameter::Ptr param,
+                MeshInfo::Ptr info);
         virtual ~ParameterDerivative() {}
 
         /**
@@ -24,20 +53,43 @@ class ParameterDerivative {
          * is the numver of vertices, and dim is the dimention of the embedding
          * space.
          */
-        virtual MatrixFr compute()=0;
+        virtual MatrixFr compute();
+
+        /**
+         * Same as compute() but only the rows of affected vertices are
+         * returned.
+         */
+        virtual SparseVelocity compute_sparse();
 
     protected:
-        void initialize_wires();
-        void initialize_mesh();
-        void initialize_normals();
-        void initialize_face_voronoi_areas();
+        typedef std::vector<bool> BoolVector;
+
+        /**
+         * Sorted indices of the faces that may move with the parameter.
+         */
+        virtual std::vector<int> get_relevant_faces() const =0;
+
+        /**
+         * Accumulate the contribution of a relevant face.  Rows of
+         * derivative_v and weights are indexed by local_face, the face
+         * corners' positions in the list of affected vertices.
+         */
+        virtual void accumulate(size_t face_index, const Vector3I& local_face,
+                MatrixFr& derivative_v, VectorF& weights) =0;
+
+        void append_vertex_faces(size_t wire_vertex_index,
+                std::vector<int>& faces) const;
+        void append_edge_faces(size_t wire_edge_index,
+                std::vector<int>& faces) const;
+        BoolVector get_roi_mask(size_t domain_size) const;
 
     protected:
         Mesh::Ptr m_mesh;
         PatternParameter::Ptr m_parameter;
-        VectorI m_face_source;
-        MatrixFr m_face_normals;
-        MatrixFr m_face_voronoi_areas;
+        MeshInfo::Ptr m_info;
+        const VectorI&  m_face_source;
+        const MatrixFr& m_face_normals;
+        const MatrixFr& m_face_voronoi_areas;
 };
 
 }
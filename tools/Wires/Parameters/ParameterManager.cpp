@@ -10,6 +10,8 @@
 #include <string>
 #include <vector>
 
+#include <tbb/tbb.h>
+
 #include <Core/Exception.h>
 
 #include "EdgeThicknessParameterDerivative.h"
@@ -361,30 +363,29 @@ void ParameterManager::set_dofs(const VectorF& values) {
 }
 
 std::vector<MatrixFr> ParameterManager::compute_shape_velocity(Mesh::Ptr mesh) {
-    std::vector<MatrixFr> velocity;
-    for (auto param : m_thickness_params) {
-        ParameterDerivative::Ptr param_derivative;
-        if (param->get_type() == PatternParameter::VERTEX_THICKNESS) {
-            param_derivative = std::make_shared<
-                VertexThicknessParameterDerivative>(mesh, param);
-        } else if (param->get_type() == PatternParameter::EDGE_THICKNESS) {
-            param_derivative = std::make_shared<
-                EdgeThicknessParameterDerivative>(mesh, param);
-        } else {
-            assert(false);
-        }
-        velocity.push_back(param_derivative->compute());
-    }
-
-    for (auto param : m_offset_params) {
-        ParameterDerivative::Ptr param_derivative;
-        assert(param->get_type() == PatternParameter::VERTEX_OFFSET);
-        param_derivative =
-            std::make_shared<VertexOffsetParameterDerivative>(mesh, param);
-        velocity.push_back(param_derivative->compute());
-    }
-    assert(velocity.size() == get_num_dofs());
+    auto derivatives = create_derivatives(mesh);
+    const size_t num_derivatives = derivatives.size();
+    std::vector<MatrixFr> velocity(num_derivatives);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_derivatives),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    velocity[i] = derivatives[i]->compute();
+                }
+            });
+    return velocity;
+}
 
+std::vector<std::pair<VectorI, MatrixFr> >
+ParameterManager::compute_sparse_shape_velocity(Mesh::Ptr mesh) {
+    auto derivatives = create_derivatives(mesh);
+    const size_t num_derivatives = derivatives.size();
+    std::vector<std::pair<VectorI, MatrixFr> > velocity(num_derivatives);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_derivatives),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    velocity[i] = derivatives[i]->compute_sparse();
+                }
+            });
     return velocity;
 }
 
@@ -604,3 +605,34 @@ void ParameterManager::add_isotropic_offset_parameter(const VectorI& roi,
     m_offset_params.add_isotropic(roi, formula, value, dof_dir);
 }
 
+std::vector<ParameterDerivative::Ptr> ParameterManager::create_derivatives(
+        Mesh::Ptr mesh) {
+    // Mesh attributes and face buckets are computed once and shared by all
+    // derivatives so that they can be evaluated concurrently.
+    ParameterDerivative::MeshInfo::Ptr info =
+        ParameterDerivative::MeshInfo::create(mesh, m_wire_network);
+
+    std::vector<ParameterDerivative::Ptr> derivatives;
+    for (auto param : m_thickness_params) {
+        ParameterDerivative::Ptr param_derivative;
+        if (param->get_type() == PatternParameter::VERTEX_THICKNESS) {
+            param_derivative = std::make_shared<
+                VertexThicknessParameterDerivative>(mesh, param, info);
+        } else if (param->get_type() == PatternParameter::EDGE_THICKNESS) {
+            param_derivative = std::make_shared<
+                EdgeThicknessParameterDerivative>(mesh, param, info);
+        } else {
+            assert(false);
+        }
+        derivatives.push_back(param_derivative);
+    }
+
+    for (auto param : m_offset_params) {
+        assert(param->get_type() == PatternParameter::VERTEX_OFFSET);
+        derivatives.push_back(std::make_shared<
+                VertexOffsetParameterDerivative>(mesh, param, info));
+    }
+    assert(derivatives.size() == get_num_dofs());
+
+    return derivatives;
+}
@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <Mesh.h>
@@ -11,6 +12,7 @@
 #include "ParameterCommon.h"
 #include "ThicknessParameters.h"
 #include "OffsetParameters.h"
+#include "ParameterDerivative.h"
 
 namespace PyMesh {
 
@@ -107,6 +109,12 @@ class ParameterManager {
         VectorF get_dofs() const;
         void set_dofs(const VectorF& values);
         std::vector<MatrixFr> compute_shape_velocity(Mesh::Ptr mesh);
+        /**
+         * Same as compute_shape_velocity() but each velocity field only
+         * contains the indices and values of the vertices that move.
+         */
+        std::vector<std::pair<VectorI, MatrixFr> >
+            compute_sparse_shape_velocity(Mesh::Ptr mesh);
         MatrixFr compute_wire_gradient(size_t i) const;
         VectorI get_thickness_dof_map() const;
         MatrixIr get_offset_dof_map() const;
@@ -143,6 +151,10 @@ class ParameterManager {
                 const std::string& formula, Float value,
                 const VectorF& dof_dir);
 
+    private:
+        std::vector<ParameterDerivative::Ptr> create_derivatives(
+                Mesh::Ptr mesh);
+
     private:
         WireNetwork::Ptr m_wire_network;
         ThicknessParameters m_thickness_params;
@@ -5,13 +5,14 @@
 
 using namespace PyMesh;
 
-void PatternParameter::evaluate_formula(
-        const PatternParameter::Variables& vars) {
+Float PatternParameter::evaluate_value(
+        const PatternParameter::Variables& vars) const {
+    if (m_formula == "") return m_value;
     Variables::const_iterator itr = vars.find(m_formula);
     if (itr == vars.end()) {
         std::stringstream err_msg;
         err_msg << "Cannot apply formula: " << m_formula;
         throw RuntimeError(err_msg.str());
     }
-    m_value = itr->second;
+    return itr->second;
 }
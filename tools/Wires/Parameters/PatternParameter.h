@@ -61,7 +61,11 @@ class PatternParameter {
     protected:
         virtual void process_roi() {};
 
-        void evaluate_formula(const Variables& vars);
+        /**
+         * Parameter value, looked up from vars if a formula is set.  Does
+         * not modify the parameter, so cells can be evaluated concurrently.
+         */
+        Float evaluate_value(const Variables& vars) const;
 
     protected:
         WireNetwork::Ptr m_wire_network;
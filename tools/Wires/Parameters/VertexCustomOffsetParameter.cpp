@@ -15,12 +15,12 @@ void VertexCustomOffsetParameter::apply(
     const size_t roi_size = m_roi.size();
     assert(results.size() == dim * num_vertices);
 
-    if (m_formula != "") evaluate_formula(vars);
+    const Float value = evaluate_value(vars);
 
     for (size_t i=0; i<roi_size; i++) {
         size_t v_idx = m_roi[i];
         assert(v_idx < num_vertices);
-        results.segment(v_idx*dim, dim) += m_derivative.row(v_idx) * m_value;
+        results.segment(v_idx*dim, dim) += m_derivative.row(v_idx) * value;
     }
 }
 
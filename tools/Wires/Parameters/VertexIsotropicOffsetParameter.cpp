@@ -20,13 +20,13 @@ void VertexIsotropicOffsetParameter::apply(VectorF& results,
     assert(results.size() == dim * num_vertices);
     assert(roi_size == m_transforms.size());
 
-    if (m_formula != "") evaluate_formula(vars);
+    const Float value = evaluate_value(vars);
 
     const MatrixFr& vertices = m_wire_network->get_vertices();
     size_t seed_vertex_index = m_roi.minCoeff();
     VectorF seed_vertex = vertices.row(seed_vertex_index);
     VectorF seed_offset = VectorF::Zero(dim);
-    seed_offset = (bbox_max - center).cwiseProduct(m_dof_dir) * m_value;
+    seed_offset = (bbox_max - center).cwiseProduct(m_dof_dir) * value;
 
     for (size_t i=0; i<roi_size; i++) {
         size_t v_idx = m_roi[i];
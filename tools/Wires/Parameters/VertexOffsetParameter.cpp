@@ -23,7 +23,7 @@ void VertexOffsetParameter::apply(VectorF& results,
     assert(m_axis < dim);
     assert(results.size() == dim * num_vertices);
 
-    if (m_formula != "") evaluate_formula(vars);
+    const Float value = evaluate_value(vars);
 
     const MatrixFr& vertices = m_wire_network->get_vertices();
 
@@ -35,7 +35,7 @@ void VertexOffsetParameter::apply(VectorF& results,
         Float sign = v[m_axis] - center[m_axis] > 0.0 ? 1.0 : -1.0;
 
         results[v_idx * dim + m_axis] =
-            sign * half_bbox_size[m_axis] * m_value;
+            sign * half_bbox_size[m_axis] * value;
     }
 }
 
@@ -1,6 +1,8 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #include "VertexOffsetParameterDerivative.h"
 
+#include <algorithm>
+
 using namespace PyMesh;
 
 namespace VertexOffsetParameterDerivativeHelper {
@@ -14,56 +16,58 @@ namespace VertexOffsetParameterDerivativeHelper {
 
 using namespace VertexOffsetParameterDerivativeHelper;
 
-MatrixFr VertexOffsetParameterDerivative::compute() {
+void VertexOffsetParameterDerivative::initialize_roi() {
     WireNetwork::Ptr wire_network = m_parameter->get_wire_network();
+    m_in_roi = get_roi_mask(wire_network->get_num_vertices());
+}
 
-    const size_t dim = m_mesh->get_dim();
-    const size_t num_mesh_vertices = m_mesh->get_num_vertices();
-    const size_t num_mesh_faces = m_mesh->get_num_faces();
-    const size_t num_wire_vertices = wire_network->get_num_vertices();
+ParameterDerivative::SparseVelocity
+VertexOffsetParameterDerivative::compute_sparse() {
+    m_wire_derivative = m_parameter->compute_derivative();
+    return ParameterDerivative::compute_sparse();
+}
 
-    assert(dim == wire_network->get_dim());
+std::vector<int> VertexOffsetParameterDerivative::get_relevant_faces() const {
+    WireNetwork::Ptr wire_network = m_parameter->get_wire_network();
+    const size_t num_wire_vertices = wire_network->get_num_vertices();
+    const size_t num_wire_edges = wire_network->get_num_edges();
+    const MatrixIr& wire_edges = wire_network->get_edges();
 
-    VectorI roi = m_parameter->get_roi();
-    BoolVector in_roi(num_wire_vertices, false);
-    const size_t roi_size = roi.size();
-    for (size_t i=0; i<roi_size; i++) {
-        in_roi[roi[i]] = true;
+    // Faces generated by roi vertices and by edges adjacent to them.
+    std::vector<int> faces;
+    for (size_t i=0; i<num_wire_vertices; i++) {
+        if (m_in_roi[i]) append_vertex_faces(i, faces);
     }
-
-    VectorF weights = VectorF::Zero(num_mesh_vertices);
-    MatrixFr derivative_v = MatrixFr::Zero(num_mesh_vertices, dim);
-    MatrixFr wire_derivative = m_parameter->compute_derivative();
-
-    for (size_t i=0; i< num_mesh_faces; i++) {
-        int source = m_face_source[i];
-        if (source < 0) {
-            // Source is edge
-            size_t edge_idx = -source - 1;
-            compute_derivative_on_edge(
-                    edge_idx, i, in_roi, wire_derivative,
-                    derivative_v, weights);
-        } else if (source > 0) {
-            // Source is vertex
-            size_t vertex_idx = source - 1;
-            compute_derivative_on_vertex(
-                    vertex_idx, i, in_roi, wire_derivative,
-                    derivative_v, weights);
+    for (size_t i=0; i<num_wire_edges; i++) {
+        if (m_in_roi[wire_edges(i, 0)] || m_in_roi[wire_edges(i, 1)]) {
+            append_edge_faces(i, faces);
         }
     }
+    std::sort(faces.begin(), faces.end());
+    return faces;
+}
 
-    for (size_t i=0; i<num_mesh_vertices; i++) {
-        if (weights[i] > 0)
-            derivative_v.row(i) /= weights[i];
+void VertexOffsetParameterDerivative::accumulate(
+        size_t face_index, const Vector3I& local_face,
+        MatrixFr& derivative_v, VectorF& weights) {
+    int source = m_face_source[face_index];
+    if (source < 0) {
+        // Source is edge
+        size_t edge_idx = -source - 1;
+        compute_derivative_on_edge(
+                edge_idx, face_index, local_face, derivative_v, weights);
+    } else if (source > 0) {
+        // Source is vertex
+        size_t vertex_idx = source - 1;
+        compute_derivative_on_vertex(
+                vertex_idx, face_index, local_face, derivative_v, weights);
     }
-    return derivative_v;
 }
 
 void VertexOffsetParameterDerivative::compute_derivative_on_edge(
         size_t wire_edge_index,
         size_t face_index,
-        const BoolVector& in_roi,
-        const MatrixFr& wire_derivative,
+        const Vector3I& local_face,
         MatrixFr& derivative_v,
         VectorF& weights) {
     const Float eps = 1e-3;
@@ -93,46 +97,43 @@ void VertexOffsetParameterDerivative::compute_derivative_on_edge(
     Float w1 = m_face_voronoi_areas(face_index, 1);
     Float w2 = m_face_voronoi_areas(face_index, 2);
 
-    if (in_roi[edge[0]]) {
-        derivative_v.row(face[0]) += w0 * (1.0 - loc_0) * wire_derivative.row(edge[0]);
-        derivative_v.row(face[1]) += w1 * (1.0 - loc_1) * wire_derivative.row(edge[0]);
-        derivative_v.row(face[2]) += w2 * (1.0 - loc_2) * wire_derivative.row(edge[0]);
+    if (m_in_roi[edge[0]]) {
+        derivative_v.row(local_face[0]) += w0 * (1.0 - loc_0) * m_wire_derivative.row(edge[0]);
+        derivative_v.row(local_face[1]) += w1 * (1.0 - loc_1) * m_wire_derivative.row(edge[0]);
+        derivative_v.row(local_face[2]) += w2 * (1.0 - loc_2) * m_wire_derivative.row(edge[0]);
     }
 
-    if (in_roi[edge[1]]) {
-        derivative_v.row(face[0]) += w0 * loc_0 * wire_derivative.row(edge[1]);
-        derivative_v.row(face[1]) += w1 * loc_1 * wire_derivative.row(edge[1]);
-        derivative_v.row(face[2]) += w2 * loc_2 * wire_derivative.row(edge[1]);
+    if (m_in_roi[edge[1]]) {
+        derivative_v.row(local_face[0]) += w0 * loc_0 * m_wire_derivative.row(edge[1]);
+        derivative_v.row(local_face[1]) += w1 * loc_1 * m_wire_derivative.row(edge[1]);
+        derivative_v.row(local_face[2]) += w2 * loc_2 * m_wire_derivative.row(edge[1]);
     }
 
-    if (in_roi[edge[0]] || in_roi[edge[1]]) {
-        weights[face[0]] += w0;
-        weights[face[1]] += w1;
-        weights[face[2]] += w2;
+    if (m_in_roi[edge[0]] || m_in_roi[edge[1]]) {
+        weights[local_face[0]] += w0;
+        weights[local_face[1]] += w1;
+        weights[local_face[2]] += w2;
     }
 }
 
 void VertexOffsetParameterDerivative::compute_derivative_on_vertex(
         size_t wire_vertex_index,
         size_t face_index,
-        const BoolVector& in_roi,
-        const MatrixFr& wire_derivative,
+        const Vector3I& local_face,
         MatrixFr& derivative_v,
         VectorF& weights) {
-    if (!in_roi[wire_vertex_index]) return;
-
-    const VectorI face = m_mesh->get_face(face_index);
+    if (!m_in_roi[wire_vertex_index]) return;
 
     Float w0 = m_face_voronoi_areas(face_index, 0);
     Float w1 = m_face_voronoi_areas(face_index, 1);
     Float w2 = m_face_voronoi_areas(face_index, 2);
 
-    derivative_v.row(face[0]) = w0 * wire_derivative.row(wire_vertex_index);
-    derivative_v.row(face[1]) = w1 * wire_derivative.row(wire_vertex_index);
-    derivative_v.row(face[2]) = w2 * wire_derivative.row(wire_vertex_index);
+    derivative_v.row(local_face[0]) = w0 * m_wire_derivative.row(wire_vertex_index);
+    derivative_v.row(local_face[1]) = w1 * m_wire_derivative.row(wire_vertex_index);
+    derivative_v.row(local_face[2]) = w2 * m_wire_derivative.row(wire_vertex_index);
 
-    weights[face[0]] += w0;
-    weights[face[1]] += w1;
-    weights[face[2]] += w2;
+    weights[local_face[0]] += w0;
+    weights[local_face[1]] += w1;
+    weights[local_face[2]] += w2;
 }
 
@@ -10,30 +10,40 @@ class VertexOffsetParameterDerivative : public ParameterDerivative {
     public:
         VertexOffsetParameterDerivative(
                 Mesh::Ptr mesh, PatternParameter::Ptr param)
-            : ParameterDerivative(mesh, param) {}
+            : ParameterDerivative(mesh, param) { initialize_roi(); }
+        VertexOffsetParameterDerivative(
+                Mesh::Ptr mesh, PatternParameter::Ptr param,
+                MeshInfo::Ptr info)
+            : ParameterDerivative(mesh, param, info) { initialize_roi(); }
         virtual ~VertexOffsetParameterDerivative() {}
 
     public:
-        virtual MatrixFr compute();
+        virtual SparseVelocity compute_sparse();
 
     protected:
-        typedef std::vector<bool> BoolVector;
+        void initialize_roi();
+
+        virtual std::vector<int> get_relevant_faces() const;
+        virtual void accumulate(size_t face_index, const Vector3I& local_face,
+                MatrixFr& derivative_v, VectorF& weights);
 
         void compute_derivative_on_edge(
                 size_t wire_edge_index,
                 size_t face_index,
-                const BoolVector& in_roi,
-                const MatrixFr& wire_derivative,
+                const Vector3I& local_face,
                 MatrixFr& derivative_v,
                 VectorF& weights);
 
         void compute_derivative_on_vertex(
                 size_t wire_vertex_index,
                 size_t face_index,
-                const BoolVector& in_roi,
-                const MatrixFr& wire_derivative,
+                const Vector3I& local_face,
                 MatrixFr& derivative_v,
                 VectorF& weights);
+
+    protected:
+        BoolVector m_in_roi;
+        MatrixFr m_wire_derivative;
 };
 
 }
@@ -10,11 +10,11 @@ void VertexThicknessParameter::apply(VectorF& results,
     const size_t roi_size = m_roi.size();
     assert(results.size() == num_vertices);
 
-    if (m_formula != "") evaluate_formula(vars);
+    const Float value = evaluate_value(vars);
 
     for (size_t i=0; i<roi_size; i++) {
         assert(m_roi[i] < num_vertices);
-        results[m_roi[i]] = m_value;
+        results[m_roi[i]] = value;
     }
 }
 
@@ -10,29 +10,36 @@ class VertexThicknessParameterDerivative : public ParameterDerivative {
     public:
         VertexThicknessParameterDerivative(
                 Mesh::Ptr mesh, PatternParameter::Ptr param)
-            : ParameterDerivative(mesh, param) { }
+            : ParameterDerivative(mesh, param) { initialize_roi(); }
+        VertexThicknessParameterDerivative(
+                Mesh::Ptr mesh, PatternParameter::Ptr param,
+                MeshInfo::Ptr info)
+            : ParameterDerivative(mesh, param, info) { initialize_roi(); }
         virtual ~VertexThicknessParameterDerivative() {}
 
-    public:
-        virtual MatrixFr compute();
-
     protected:
-        typedef std::vector<bool> BoolVector;
+        void initialize_roi();
+
+        virtual std::vector<int> get_relevant_faces() const;
+        virtual void accumulate(size_t face_index, const Vector3I& local_face,
+                MatrixFr& derivative_v, VectorF& weights);
 
         void compute_derivative_on_edge(
                 size_t wire_edge_index,
                 size_t face_index,
-                const BoolVector& in_roi,
+                const Vector3I& local_face,
                 MatrixFr& derivative_v,
                 VectorF& weights);
 
         void compute_derivative_on_vertex(
                 size_t wire_edge_index,
                 size_t face_index,
-                const BoolVector& in_roi,
+                const Vector3I& local_face,
                 MatrixFr& derivative_v,
                 VectorF& weights);
 
+    protected:
+        BoolVector m_in_roi;
 };
 
 }
@@ -3,37 +3,70 @@
 
 #include <cassert>
 #include <iostream>
-#include <list>
+#include <sstream>
 
+#include <tbb/tbb.h>
+
+#include <Core/Exception.h>
 #include <Wires/Parameters/ParameterCommon.h>
 
 using namespace PyMesh;
 
 namespace AABBTilerHelper {
-    std::vector<VectorI> enumerate(const VectorI& repetitions) {
-        std::vector<VectorI> result;
+    // Lattice offsets of the cell corners in bilinear/trilinear order.
+    const int QUAD_CORNERS[4][2] = {{0,0}, {1,0}, {1,1}, {0,1}};
+    const int HEX_CORNERS[8][3] = {
+        {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0},
+        {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1}
+    };
+
+    /**
+     * Cells are ordered with the last axis varying fastest.
+     */
+    VectorI get_cell_index(size_t cell, const VectorI& repetitions) {
         const size_t dim = repetitions.size();
+        VectorI index(dim);
+        for (size_t i=dim; i>0; i--) {
+            index[i-1] = cell % repetitions[i-1];
+            cell /= repetitions[i-1];
+        }
+        return index;
+    }
+
+    /**
+     * Corner indices of each cell into the (repetitions+1) lattice nodes.
+     */
+    MatrixIr get_cells(const VectorI& repetitions) {
+        const size_t dim = repetitions.size();
+        const int* corner_offsets;
         if (dim == 2) {
-            for (size_t i=0; i<repetitions[0]; i++) {
-                for (size_t j=0; j<repetitions[1]; j++) {
-                    result.push_back(Vector2I(i,j));
-                }
-            }
+            corner_offsets = &QUAD_CORNERS[0][0];
         } else if (dim == 3) {
-            for (size_t i=0; i<repetitions[0]; i++) {
-                for (size_t j=0; j<repetitions[1]; j++) {
-                    for (size_t k=0; k<repetitions[2]; k++) {
-                        result.push_back(Vector3I(i,j,k));
-                    }
-                }
-            }
+            corner_offsets = &HEX_CORNERS[0][0];
         } else {
             std::stringstream err_msg;
             err_msg << "Unsupported dim: " << dim;
             throw NotImplementedError(err_msg.str());
         }
 
-        return result;
+        const size_t num_cells = repetitions.prod();
+        const size_t num_corners = 1 << dim;
+        MatrixIr cells(num_cells, num_corners);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_cells),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    for (size_t i=r.begin(); i!=r.end(); i++) {
+                        const VectorI index = get_cell_index(i, repetitions);
+                        for (size_t j=0; j<num_corners; j++) {
+                            int node = 0;
+                            for (size_t k=0; k<dim; k++) {
+                                node = node * (repetitions[k] + 1) +
+                                    index[k] + corner_offsets[j*dim+k];
+                            }
+                            cells(i, j) = node;
+                        }
+                    }
+                });
+        return cells;
     }
 
     template<typename T>
@@ -45,25 +78,6 @@ namespace AABBTilerHelper {
             throw RuntimeError(err_msg.str());
         }
     }
-
-    std::list<std::function<MatrixFr(const MatrixFr&)> > get_tiling_operators(
-            const VectorF& ref_pt,
-            const VectorF& cell_size,
-            const std::vector<VectorI>& indices) {
-
-        std::list<std::function<MatrixFr(const MatrixFr&)> > operators;
-        for (auto index : indices) {
-            VectorF cur_pt = cell_size.cwiseProduct(index.cast<Float>());
-            VectorF offset = cur_pt - ref_pt;
-            operators.push_back(
-                    [=] (const MatrixFr& vertices) {
-                        MatrixFr result(vertices);
-                        result.rowwise() += offset.transpose();
-                        return result;
-                    });
-        }
-        return operators;
-    }
 }
 
 using namespace AABBTilerHelper;
@@ -88,78 +102,18 @@ WireNetwork::Ptr AABBTiler::tile() {
             m_repetitions.cast<Float>());
     normalize_unit_wire(cell_size);
 
-    std::vector<VectorI> indices = enumerate(m_repetitions);
-    const size_t num_repetitions = indices.size();
-    auto transforms = get_tiling_operators(m_unit_wire_network->get_bbox_min(),
-            cell_size, indices);
-    MatrixFr tiled_vertices = tile_vertices(transforms);
-    MatrixIr tiled_edges = tile_edges(num_repetitions);
-
-    WireNetwork::Ptr tiled_network =
-        WireNetwork::create_raw(tiled_vertices, tiled_edges);
-    update_attributes(*tiled_network, num_repetitions);
-    evaluate_parameters(*tiled_network, transforms);
-    clean_up(*tiled_network, 1e-3);
-    return tiled_network;
-}
-
-void AABBTiler::evaluate_parameters(WireNetwork& wire_network,
-        const AABBTiler::FuncList& funcs) {
-    evaluate_thickness_parameters(wire_network, funcs);
-    evaluate_offset_parameters(wire_network, funcs);
-}
-
-void AABBTiler::evaluate_thickness_parameters(WireNetwork& wire_network,
-        const AABBTiler::FuncList& funcs) {
-    assert(m_params);
-    const size_t num_vertices = wire_network.get_num_vertices();
-    const size_t num_edges = wire_network.get_num_edges();
-    const size_t num_unit_vertices = m_unit_wire_network->get_num_vertices();
-    const size_t num_unit_edges = m_unit_wire_network->get_num_edges();
-
-    size_t num_thickness_entries, thickness_index_stride;
-    if (m_params->get_thickness_type() == ParameterCommon::VERTEX) {
-        thickness_index_stride = num_unit_vertices;
-        num_thickness_entries = num_vertices;
-        wire_network.add_attribute("thickness", true);
-    } else {
-        thickness_index_stride = num_unit_edges;
-        num_thickness_entries = num_edges;
-        wire_network.add_attribute("thickness", false);
-    }
-    MatrixFr thickness(num_thickness_entries, 1);
-
-    ParameterCommon::Variables vars;
-    size_t count=0;
-    for (auto f : funcs) {
-        VectorF local_thickness = m_params->evaluate_thickness(vars);
-        thickness.block(count * thickness_index_stride, 0,
-                thickness_index_stride, 1) = local_thickness;
-        count++;
-    }
-    wire_network.set_attribute("thickness", thickness);
-}
-
-void AABBTiler::evaluate_offset_parameters(WireNetwork& wire_network,
-        const AABBTiler::FuncList& funcs) {
-    const size_t dim = wire_network.get_dim();
-    const size_t num_vertices = wire_network.get_num_vertices();
-    const size_t num_unit_vertices = m_unit_wire_network->get_num_vertices();
-
-    wire_network.add_attribute("vertex_offset", true);
-    MatrixFr attr_value(num_vertices, dim);
-
-    ParameterCommon::Variables vars;
-    const MatrixFr& ori_vertices = m_unit_wire_network->get_vertices();
-    size_t count=0;
-    for (auto f : funcs) {
-        MatrixFr local_offseted_vertices = ori_vertices + m_params->evaluate_offset(vars);
-        attr_value.block(count * num_unit_vertices, 0,
-                num_unit_vertices, dim) = f(local_offseted_vertices);
-        count++;
-    }
+    const MatrixIr cells = get_cells(m_repetitions);
+    const VectorF ref_pt = m_unit_wire_network->get_bbox_min();
+    auto cell_func = [&](size_t i, const MatrixFr& vertices) {
+        VectorF cur_pt = cell_size.cwiseProduct(
+                get_cell_index(i, m_repetitions).cast<Float>());
+        VectorF offset = cur_pt - ref_pt;
+        MatrixFr result(vertices);
+        result.rowwise() += offset.transpose();
+        return result;
+    };
 
-    attr_value = attr_value - wire_network.get_vertices();
-    wire_network.set_attribute("vertex_offset", attr_value);
+    // Thickness and offset parameters are evaluated without variables.
+    std::vector<ParameterCommon::Variables> vars;
+    return tile_cells(cells, cell_func, vars, 1e-3 / cell_size.maxCoeff());
 }
-
@@ -16,14 +16,6 @@ class AABBTiler : public TilerEngine {
     public:
         virtual WireNetwork::Ptr tile();
 
-    protected:
-        void evaluate_parameters(
-                WireNetwork& wire_network, const FuncList& funcs);
-        void evaluate_thickness_parameters(
-                WireNetwork& wire_network, const FuncList& funcs);
-        void evaluate_offset_parameters(
-                WireNetwork& wire_network, const FuncList& funcs);
-
     private:
         VectorF m_bbox_min;
         VectorF m_bbox_max;
@@ -35,31 +35,37 @@ WireNetwork::Ptr MeshTiler::tile() {
 }
 
 WireNetwork::Ptr MeshTiler::tile_2D() {
-    const size_t num_cells = m_mesh->get_num_faces();
+    if (m_mesh->get_vertex_per_face() != 4) {
+        throw NotImplementedError("Only quad guide mesh is supported in 2D");
+    }
     scale_to_unit_box();
-    auto transforms = get_2D_tiling_operators(m_mesh);
-    MatrixFr tiled_vertices = tile_vertices(transforms);
-    MatrixIr tiled_edges = tile_edges(num_cells);
 
-    WireNetwork::Ptr tiled_network = WireNetwork::create_raw(tiled_vertices, tiled_edges);
-    update_attributes(*tiled_network, num_cells);
-    evaluate_parameters(*tiled_network, transforms);
-    clean_up(*tiled_network);
-    return tiled_network;
+    const MatrixIr cells = m_mesh->get_face_matrix();
+    auto cell_func = [&](size_t i, const MatrixFr& vertices) {
+        BilinearInterpolation interpolator(
+                get_cell_corners(m_mesh, cells.row(i).transpose()));
+        return interpolator.interpolate_batch(vertices);
+    };
+    // Guide meshes may have hanging nodes or duplicated corners.
+    return tile_cells(cells, cell_func, extract_attributes(m_mesh), 1e-6,
+            false);
 }
 
 WireNetwork::Ptr MeshTiler::tile_3D() {
-    const size_t num_cells = m_mesh->get_num_voxels();
+    if (m_mesh->get_vertex_per_voxel() != 8) {
+        throw NotImplementedError("Only hex guide mesh is supported in 3D");
+    }
     scale_to_unit_box();
-    auto transforms = get_3D_tiling_operators(m_mesh);
-    MatrixFr tiled_vertices = tile_vertices(transforms);
-    MatrixIr tiled_edges = tile_edges(num_cells);
 
-    WireNetwork::Ptr tiled_network = WireNetwork::create_raw(tiled_vertices, tiled_edges);
-    update_attributes(*tiled_network, num_cells);
-    evaluate_parameters(*tiled_network, transforms);
-    clean_up(*tiled_network);
-    return tiled_network;
+    const MatrixIr cells = m_mesh->get_voxel_matrix();
+    auto cell_func = [&](size_t i, const MatrixFr& vertices) {
+        TrilinearInterpolation interpolator(
+                get_cell_corners(m_mesh, cells.row(i).transpose()));
+        return interpolator.interpolate_batch(vertices);
+    };
+    // Guide meshes may have hanging nodes or duplicated corners.
+    return tile_cells(cells, cell_func, extract_attributes(m_mesh), 1e-6,
+            false);
 }
 
 void MeshTiler::scale_to_unit_box() {
@@ -69,71 +75,3 @@ void MeshTiler::scale_to_unit_box() {
     normalize_unit_wire(cell_size);
     m_unit_wire_network->translate(center);
 }
-
-void MeshTiler::evaluate_parameters(WireNetwork& wire_network,
-        const MeshTiler::FuncList& funcs) {
-    evaluate_thickness_parameters(wire_network, funcs);
-    evaluate_offset_parameters(wire_network, funcs);
-}
-
-void MeshTiler::evaluate_thickness_parameters(WireNetwork& wire_network,
-        const MeshTiler::FuncList& funcs) {
-    const size_t num_vertices = wire_network.get_num_vertices();
-    const size_t num_edges = wire_network.get_num_edges();
-    const size_t num_unit_vertices = m_unit_wire_network->get_num_vertices();
-    const size_t num_unit_edges = m_unit_wire_network->get_num_edges();
-
-    size_t num_thickness_entries, thickness_index_stride;
-    if (m_params->get_thickness_type() == ParameterCommon::VERTEX) {
-        thickness_index_stride = num_unit_vertices;
-        num_thickness_entries = num_vertices;
-        wire_network.add_attribute("thickness", true);
-    } else {
-        thickness_index_stride = num_unit_edges;
-        num_thickness_entries = num_edges;
-        wire_network.add_attribute("thickness", false);
-    }
-    MatrixFr thickness(num_thickness_entries, 1);
-
-    auto vars_array = extract_attributes(m_mesh);
-    assert(vars_array.size() == funcs.size());
-    size_t count=0;
-    auto vars_itr = vars_array.begin();
-    for (auto f : funcs) {
-        assert(vars_itr != vars_array.end());
-        VectorF local_thickness = m_params->evaluate_thickness(*vars_itr);
-        thickness.block(count * thickness_index_stride, 0,
-                thickness_index_stride, 1) = local_thickness;
-        count++;
-        vars_itr++;
-    }
-    wire_network.set_attribute("thickness", thickness);
-}
-
-void MeshTiler::evaluate_offset_parameters(WireNetwork& wire_network,
-        const MeshTiler::FuncList& funcs) {
-    const size_t dim = wire_network.get_dim();
-    const size_t num_vertices = wire_network.get_num_vertices();
-    const size_t num_unit_vertices = m_unit_wire_network->get_num_vertices();
-
-    wire_network.add_attribute("vertex_offset", true);
-    MatrixFr attr_value(num_vertices, dim);
-
-    auto vars_array = extract_attributes(m_mesh);
-    const MatrixFr& ori_vertices = m_unit_wire_network->get_vertices();
-    size_t count=0;
-    auto vars_itr = vars_array.begin();
-    for (auto f : funcs) {
-        assert(vars_itr != vars_array.end());
-        MatrixFr local_offseted_vertices = ori_vertices +
-            m_params->evaluate_offset(*vars_itr);
-        attr_value.block(count * num_unit_vertices, 0,
-                num_unit_vertices, dim) = f(local_offseted_vertices);
-        count++;
-        vars_itr++;
-    }
-
-    attr_value = attr_value - wire_network.get_vertices();
-    wire_network.set_attribute("vertex_offset", attr_value);
-}
-
@@ -9,6 +9,16 @@
 
 using namespace PyMesh;
 
+MatrixFr MeshTilerHelper::get_cell_corners(Mesh::Ptr mesh, const VectorI& cell) {
+    const size_t dim = mesh->get_dim();
+    const size_t num_corners = cell.size();
+    MatrixFr corners(num_corners, dim);
+    for (size_t i=0; i<num_corners; i++) {
+        corners.row(i) = mesh->get_vertex(cell[i]).transpose();
+    }
+    return corners;
+}
+
 TilerEngine::FuncList MeshTilerHelper::get_2D_tiling_operators(Mesh::Ptr mesh) {
     const size_t num_cells = mesh->get_num_faces();
     const size_t num_vertex_per_cell = mesh->get_vertex_per_face();
@@ -18,11 +28,7 @@ TilerEngine::FuncList MeshTilerHelper::get_2D_tiling_operators(Mesh::Ptr mesh) {
 
     TilerEngine::FuncList operators;
     for (size_t i=0; i<num_cells; i++) {
-        const VectorI face = mesh->get_face(i);
-        MatrixFr corners(num_vertex_per_cell, 2);
-        for (size_t j=0; j<num_vertex_per_cell; j++) {
-            corners.row(j) = mesh->get_vertex(face[j]).transpose();
-        }
+        MatrixFr corners = get_cell_corners(mesh, mesh->get_face(i));
 
         operators.push_back(
                 [=](const MatrixFr& vertices) {
@@ -42,11 +48,7 @@ TilerEngine::FuncList MeshTilerHelper::get_3D_tiling_operators(Mesh::Ptr mesh) {
 
     TilerEngine::FuncList operators;
     for (size_t i=0; i<num_cells; i++) {
-        const VectorI voxel = mesh->get_voxel(i);
-        MatrixFr corners(num_vertex_per_cell, 3);
-        for (size_t j=0; j<num_vertex_per_cell; j++) {
-            corners.row(j) = mesh->get_vertex(voxel[j]).transpose();
-        }
+        MatrixFr corners = get_cell_corners(mesh, mesh->get_voxel(i));
 
         operators.push_back(
                 [=](const MatrixFr& vertices) {
@@ -66,10 +68,9 @@ std::vector<ParameterCommon::Variables> MeshTilerHelper::extract_face_attributes
     for (size_t i=0; i<num_faces; i++) {
         ParameterCommon::Variables vars;
         for (const auto& name : attr_names) {
-            const MatrixFr& attr = mesh->get_attribute(name);
-            if (attr.rows() != num_faces) continue;
-            if (attr.cols() != 1) continue;
-            vars[name] = attr(i, 0);
+            const auto attr = mesh->get_attribute_view(name);
+            if (attr.size() != num_faces) continue;
+            vars[name] = attr[i];
         }
         vars_array.push_back(vars);
     }
@@ -85,10 +86,9 @@ std::vector<ParameterCommon::Variables> MeshTilerHelper::extract_voxel_attribute
     for (size_t i=0; i<num_voxels; i++) {
         ParameterCommon::Variables vars;
         for (const auto& name : attr_names) {
-            const MatrixFr& attr = mesh->get_attribute(name);
-            if (attr.rows() != num_voxels) continue;
-            if (attr.cols() != 1) continue;
-            vars[name] = attr(i, 0);
+            const auto attr = mesh->get_attribute_view(name);
+            if (attr.size() != num_voxels) continue;
+            vars[name] = attr[i];
         }
         vars_array.push_back(vars);
     }
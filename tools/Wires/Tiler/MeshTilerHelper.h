@@ -9,6 +9,8 @@
 
 namespace PyMesh {
 namespace MeshTilerHelper {
+    MatrixFr get_cell_corners(Mesh::Ptr mesh, const VectorI& cell);
+
     TilerEngine::FuncList get_2D_tiling_operators(Mesh::Ptr mesh);
 
     TilerEngine::FuncList get_3D_tiling_operators(Mesh::Ptr mesh);
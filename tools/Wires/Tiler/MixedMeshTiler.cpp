@@ -16,12 +16,17 @@ MixedMeshTiler::MixedMeshTiler(
         MixedMeshTiler::DofType dof_type)
 : TilerEngine(NULL), m_mesh(mesh), m_unit_wires(unit_wires),
 m_target_type(target_type), m_dof_type(dof_type) {
+    // Parameters created per cell add attributes to the active wire.
+    for (auto& wire_network : m_unit_wires) {
+        wire_network = copy_wire_network(*wire_network);
+    }
+
     if (!m_mesh->has_attribute("pattern_id")) {
         throw RuntimeError(
                 "Mesh attribute \"pattern_id\" is required by mixed mesh tiler");
     }
 
-    VectorI pattern_id = m_mesh->get_attribute("pattern_id").cast<int>();
+    VectorI pattern_id = m_mesh->get_attribute_view("pattern_id").cast<int>();
     if (pattern_id.maxCoeff() >= m_unit_wires.size()) {
         std::stringstream err_msg;
         err_msg << "Too few unit patterns supplied: expecting "
@@ -35,7 +40,7 @@ WireNetwork::Ptr MixedMeshTiler::tile() {
     const size_t num_cells = get_num_cells();
     auto transforms = get_tiling_operators();
     auto vars_array = extract_attributes(m_mesh);
-    VectorI pattern_id = m_mesh->get_attribute("pattern_id").cast<int>();
+    VectorI pattern_id = m_mesh->get_attribute_view("pattern_id").cast<int>();
     assert(pattern_id.size() == num_cells);
 
     m_tiled_vertices.clear();
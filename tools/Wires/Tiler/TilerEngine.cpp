@@ -1,15 +1,22 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #include "TilerEngine.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 #include <unordered_set>
 #include <vector>
 
+#include <tbb/tbb.h>
+
 #include <Core/Exception.h>
 #include <MeshUtils/DuplicatedVertexRemoval.h>
 #include <Misc/Multiplet.h>
+#include <Misc/Profiler.h>
 
 using namespace PyMesh;
 
@@ -58,6 +65,254 @@ namespace TilerEngineHelper {
 
         return result;
     }
+
+    const size_t MAX_SEAM_CORNERS = 4;
+    const int64_t QUANTIZATION = 1 << 20;
+
+    /**
+     * A cell boundary vertex is the weighted sum of at most 4 cell corners
+     * (a face in 3D).  The corners and integer weights, sorted by corner
+     * index, are the same in every cell sharing that boundary.
+     */
+    struct SeamKey {
+        int corners[MAX_SEAM_CORNERS];
+        int64_t weights[MAX_SEAM_CORNERS];
+
+        bool operator==(const SeamKey& other) const {
+            return std::equal(corners, corners+MAX_SEAM_CORNERS,
+                    other.corners) &&
+                std::equal(weights, weights+MAX_SEAM_CORNERS,
+                        other.weights);
+        }
+
+        bool operator<(const SeamKey& other) const {
+            for (size_t i=0; i<MAX_SEAM_CORNERS; i++) {
+                if (corners[i] != other.corners[i])
+                    return corners[i] < other.corners[i];
+            }
+            for (size_t i=0; i<MAX_SEAM_CORNERS; i++) {
+                if (weights[i] != other.weights[i])
+                    return weights[i] < other.weights[i];
+            }
+            return false;
+        }
+    };
+
+    /**
+     * index is cell * num_seam_vertices + seam rank, so entries with equal
+     * keys sort in the order the copies were tiled.
+     */
+    struct SeamEntry {
+        SeamKey key;
+        size_t index;
+
+        bool operator<(const SeamEntry& other) const {
+            if (key == other.key) return index < other.index;
+            return key < other.key;
+        }
+    };
+
+    /**
+     * A cell facet, keyed by its sorted corner indices.
+     */
+    struct Facet {
+        int corners[MAX_SEAM_CORNERS];
+
+        bool operator==(const Facet& other) const {
+            return std::equal(corners, corners+MAX_SEAM_CORNERS,
+                    other.corners);
+        }
+    };
+
+    struct SeamEdge {
+        int v0;
+        int v1;
+        size_t index;
+
+        bool same_edge(const SeamEdge& other) const {
+            return v0 == other.v0 && v1 == other.v1;
+        }
+
+        bool operator<(const SeamEdge& other) const {
+            if (v0 != other.v0) return v0 < other.v0;
+            if (v1 != other.v1) return v1 < other.v1;
+            return index < other.index;
+        }
+    };
+
+    /**
+     * Whether corner is on the max side of axis.  Corners follow the
+     * BilinearInterpolation and TrilinearInterpolation order.
+     */
+    bool is_max_corner(size_t corner, size_t axis) {
+        switch (axis) {
+            case 0:
+                return corner % 4 == 1 || corner % 4 == 2;
+            case 1:
+                return corner % 4 >= 2;
+            default:
+                return corner >= 4;
+        }
+    }
+
+    /**
+     * Quantize unit box coordinates onto [0, QUANTIZATION].  Values within
+     * tol of each other are clustered first, together with their mirrored
+     * values 1-x, so that patterns written with limited precision still
+     * match up across cells of any orientation.
+     */
+    std::vector<int64_t> quantize(const std::vector<Float>& coords, Float tol) {
+        std::vector<Float> values(coords);
+        for (auto x : coords) values.push_back(1.0 - x);
+        std::sort(values.begin(), values.end());
+
+        const size_t num_values = values.size();
+        std::vector<int64_t> quantized_values(num_values);
+        size_t cluster_begin = 0;
+        for (size_t i=1; i<=num_values; i++) {
+            if (i < num_values && values[i] - values[i-1] <= tol) continue;
+            const Float mean = std::accumulate(values.begin() + cluster_begin,
+                    values.begin() + i, 0.0) / (i - cluster_begin);
+            std::fill(quantized_values.begin() + cluster_begin,
+                    quantized_values.begin() + i,
+                    int64_t(std::round(mean * QUANTIZATION)));
+            cluster_begin = i;
+        }
+
+        std::vector<int64_t> result(coords.size());
+        for (size_t i=0; i<coords.size(); i++) {
+            size_t j = std::lower_bound(values.begin(), values.end(),
+                    coords[i]) - values.begin();
+            result[i] = quantized_values[j];
+        }
+        return result;
+    }
+
+    /**
+     * Average rows merged by index_map, weighted by the number of copies
+     * each row stands for.
+     */
+    MatrixFr merge_rows(const MatrixFr& values, const std::vector<int>& index_map,
+            const VectorF& weights, size_t num_rows) {
+        MatrixFr result = MatrixFr::Zero(num_rows, values.cols());
+        VectorF total_weights = VectorF::Zero(num_rows);
+        for (size_t i=0; i<index_map.size(); i++) {
+            result.row(index_map[i]) += weights[i] * values.row(i);
+            total_weights[index_map[i]] += weights[i];
+        }
+        for (size_t i=0; i<num_rows; i++) {
+            result.row(i) /= total_weights[i];
+        }
+        return result;
+    }
+
+    /**
+     * Running sum of counts, so that offsets[i] is where entry i starts.
+     */
+    std::vector<size_t> compute_offsets(const std::vector<size_t>& counts) {
+        std::vector<size_t> offsets(counts.size() + 1, 0);
+        std::partial_sum(counts.begin(), counts.end(), offsets.begin()+1);
+        return offsets;
+    }
+
+    /**
+     * Flag cell facets that are not shared by exactly two cells.  Facet
+     * axis*2 + side of cell i is at i * 2 * dim + axis*2 + side.
+     */
+    std::vector<char> find_open_facets(const MatrixIr& cells, size_t dim) {
+        const size_t num_cells = cells.rows();
+        const size_t num_corners = cells.cols();
+        const size_t num_facets = 2 * dim;
+        std::vector<std::vector<size_t> > facet_corners(num_facets);
+        for (size_t k=0; k<dim; k++) {
+            for (size_t j=0; j<num_corners; j++) {
+                facet_corners[k*2 + (is_max_corner(j, k) ? 1 : 0)].push_back(j);
+            }
+        }
+
+        std::vector<Facet> facets(num_cells * num_facets);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_cells),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    for (size_t i=r.begin(); i!=r.end(); i++) {
+                        for (size_t j=0; j<num_facets; j++) {
+                            const auto& corners = facet_corners[j];
+                            Facet& facet = facets[i*num_facets+j];
+                            std::fill(facet.corners,
+                                    facet.corners+MAX_SEAM_CORNERS, -1);
+                            for (size_t k=0; k<corners.size(); k++) {
+                                facet.corners[k] = cells(i, corners[k]);
+                            }
+                            std::sort(facet.corners,
+                                    facet.corners+corners.size());
+                        }
+                    }
+                });
+
+        // Facets are bucketed by their smallest corner.
+        const size_t num_vertices = num_cells > 0 ? cells.maxCoeff() + 1 : 0;
+        std::vector<size_t> bucket_counts(num_vertices, 0);
+        for (const auto& facet : facets) bucket_counts[facet.corners[0]]++;
+        const std::vector<size_t> offsets = compute_offsets(bucket_counts);
+        std::vector<size_t> counter(offsets.begin(), offsets.end()-1);
+        std::vector<size_t> buckets(facets.size());
+        for (size_t i=0; i<facets.size(); i++) {
+            buckets[counter[facets[i].corners[0]]++] = i;
+        }
+
+        std::vector<char> open_facets(facets.size(), 0);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_vertices),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    for (size_t i=r.begin(); i!=r.end(); i++) {
+                        for (size_t j=offsets[i]; j<offsets[i+1]; j++) {
+                            const Facet& facet = facets[buckets[j]];
+                            size_t count = 0;
+                            for (size_t k=offsets[i]; k<offsets[i+1]; k++) {
+                                if (facets[buckets[k]] == facet) count++;
+                            }
+                            open_facets[buckets[j]] = count != 2;
+                        }
+                    }
+                });
+        return open_facets;
+    }
+
+    /**
+     * Merge flagged vertices within tol of each other.  Returns the output
+     * index of every vertex, where each merged vertex takes the place of its
+     * first copy and the rest are renumbered in order.
+     */
+    std::vector<int> merge_open_vertices(const MatrixFr& vertices,
+            const std::vector<char>& open_vertices, Float tol) {
+        const size_t num_vertices = vertices.rows();
+        std::vector<int> open_ids;
+        for (size_t i=0; i<num_vertices; i++) {
+            if (open_vertices[i]) open_ids.push_back(i);
+        }
+        MatrixFr open_pts(open_ids.size(), vertices.cols());
+        for (size_t i=0; i<open_ids.size(); i++) {
+            open_pts.row(i) = vertices.row(open_ids[i]);
+        }
+        DuplicatedVertexRemoval remover(open_pts, MatrixIr(0, 2));
+        remover.run(tol);
+        const VectorI open_map = remover.get_index_map();
+
+        std::vector<int> first_copy(remover.get_vertices().rows(), -1);
+        std::vector<int> first_ids(num_vertices);
+        std::iota(first_ids.begin(), first_ids.end(), 0);
+        for (size_t i=0; i<open_ids.size(); i++) {
+            int& first = first_copy[open_map[i]];
+            if (first < 0) first = open_ids[i];
+            first_ids[open_ids[i]] = first;
+        }
+
+        std::vector<int> index_map(num_vertices);
+        int count = 0;
+        for (size_t i=0; i<num_vertices; i++) {
+            index_map[i] = (first_ids[i] == int(i)) ?
+                count++ : index_map[first_ids[i]];
+        }
+        return index_map;
+    }
 }
 
 using namespace TilerEngineHelper;
@@ -68,36 +323,448 @@ void TilerEngine::with_parameters(ParameterManager::Ptr params) {
     m_params->set_wire_network(m_unit_wire_network);
 }
 
-MatrixFr TilerEngine::tile_vertices(const TilerEngine::FuncList& funcs) {
-    const size_t num_copies = funcs.size();
+WireNetwork::Ptr TilerEngine::tile_cells(const MatrixIr& cells,
+        const TilerEngine::CellFunc& cell_func,
+        const std::vector<ParameterManager::Variables>& vars,
+        Float tol, bool conforming) {
+    PYMESH_PROFILE_ZONE("TilerEngine::tile_cells");
     const size_t dim = m_unit_wire_network->get_dim();
-    const size_t num_vertices = m_unit_wire_network->get_num_vertices();
-    const MatrixFr& vertices = m_unit_wire_network->get_vertices();
+    const size_t num_cells = cells.rows();
+    const size_t num_corners = cells.cols();
+    const size_t num_unit_vertices = m_unit_wire_network->get_num_vertices();
+    const size_t num_unit_edges = m_unit_wire_network->get_num_edges();
+    const MatrixFr& unit_vertices = m_unit_wire_network->get_vertices();
+    const MatrixIr& unit_edges = m_unit_wire_network->get_edges();
+    if (num_corners != size_t(1 << dim)) {
+        std::stringstream err_msg;
+        err_msg << "Expect " << (1 << dim) << " corners per cell, got "
+            << num_corners;
+        throw RuntimeError(err_msg.str());
+    }
 
-    MatrixFr tiled_vertices(num_copies * num_vertices, dim);
+    // Unit wire vertices on the unit box boundary are the seam vertices.
+    // Their weights on the cell corners do not depend on the cell.
+    const VectorF bbox_min = m_unit_wire_network->get_bbox_min();
+    const VectorF bbox_size = m_unit_wire_network->get_bbox_max() - bbox_min;
+    std::vector<int> seam_rank(num_unit_vertices, -1);
+    std::vector<size_t> seam_vertices;
+    std::vector<Float> seam_coords;
+    for (size_t i=0; i<num_unit_vertices; i++) {
+        VectorF u = (unit_vertices.row(i).transpose() - bbox_min)
+            .cwiseQuotient(bbox_size);
+        bool on_boundary = false;
+        for (size_t j=0; j<dim; j++) {
+            // Same comparison as the clustering in quantize().
+            if (u[j] <= tol) u[j] = 0.0;
+            else if (u[j] >= 1.0 - tol) u[j] = 1.0;
+            on_boundary |= u[j] == 0.0 || u[j] == 1.0;
+        }
+        if (!on_boundary) continue;
 
-    size_t vertex_count = 0;
-    for (auto f : funcs) {
-        tiled_vertices.block(vertex_count, 0, num_vertices, dim) = f(vertices);
-        vertex_count += num_vertices;
+        seam_rank[i] = seam_vertices.size();
+        seam_vertices.push_back(i);
+        seam_coords.insert(seam_coords.end(), u.data(), u.data() + dim);
+    }
+    const size_t num_seam_vertices = seam_vertices.size();
+
+    const std::vector<int64_t> quantized_coords = quantize(seam_coords, tol);
+    std::vector<std::vector<std::pair<size_t, int64_t> > > seam_weights(
+            num_seam_vertices);
+    for (size_t i=0; i<num_seam_vertices; i++) {
+        const int64_t* coords = quantized_coords.data() + i*dim;
+        for (size_t j=0; j<num_corners; j++) {
+            int64_t w = 1;
+            for (size_t k=0; k<dim; k++) {
+                w *= is_max_corner(j, k) ?
+                    coords[k] : QUANTIZATION - coords[k];
+            }
+            if (w != 0) seam_weights[i].emplace_back(j, w);
+        }
+        if (seam_weights[i].size() > MAX_SEAM_CORNERS) {
+            // Clustering moved the vertex off the unit box boundary.
+            std::stringstream err_msg;
+            err_msg << "Seam vertex " << seam_vertices[i]
+                << " of the unit wire is off the cell boundary after"
+                << " snapping, try a smaller tolerance than " << tol;
+            throw RuntimeError(err_msg.str());
+        }
     }
 
-    return tiled_vertices;
-}
+    // Edges between two seam vertices may be shared with neighbouring
+    // cells.  Other edges can only be duplicated within the unit wire.
+    std::vector<int> seam_edge_rank(num_unit_edges, -1);
+    std::vector<size_t> seam_edges;
+    std::vector<bool> inner_duplicates(num_unit_edges, false);
+    std::unordered_set<Duplet, hash> inner_edges;
+    for (size_t i=0; i<num_unit_edges; i++) {
+        if (seam_rank[unit_edges(i,0)] >= 0 &&
+                seam_rank[unit_edges(i,1)] >= 0) {
+            seam_edge_rank[i] = seam_edges.size();
+            seam_edges.push_back(i);
+        } else {
+            Duplet key(unit_edges(i,0), unit_edges(i,1));
+            inner_duplicates[i] = !inner_edges.insert(key).second;
+        }
+    }
+    const size_t num_seam_edges = seam_edges.size();
+    const size_t num_inner_edges = num_unit_edges - num_seam_edges
+        - std::count(inner_duplicates.begin(), inner_duplicates.end(), true);
+
+    // Group copies of the same seam vertex.  The first copy owns the group.
+    std::vector<SeamEntry> seam_entries(num_cells * num_seam_vertices);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_cells),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    for (size_t j=0; j<num_seam_vertices; j++) {
+                        SeamEntry& entry = seam_entries[i*num_seam_vertices+j];
+                        entry.index = i*num_seam_vertices + j;
+                        const auto& weights = seam_weights[j];
+                        std::pair<int, int64_t> key[MAX_SEAM_CORNERS];
+                        std::fill(key, key+MAX_SEAM_CORNERS,
+                                std::make_pair(-1, int64_t(0)));
+                        for (size_t k=0; k<weights.size(); k++) {
+                            key[k].first = cells(i, weights[k].first);
+                            key[k].second = weights[k].second;
+                        }
+                        std::sort(key, key+weights.size());
+                        for (size_t k=0; k<MAX_SEAM_CORNERS; k++) {
+                            entry.key.corners[k] = key[k].first;
+                            entry.key.weights[k] = key[k].second;
+                        }
+                    }
+                }
+            });
+    tbb::parallel_sort(seam_entries.begin(), seam_entries.end());
+
+    const size_t num_seam_entries = seam_entries.size();
+    std::vector<size_t> seam_owner(num_seam_entries);
+    std::vector<size_t> group_starts;
+    for (size_t i=0; i<num_seam_entries; i++) {
+        if (i == 0 || !(seam_entries[i-1].key == seam_entries[i].key)) {
+            group_starts.push_back(i);
+        }
+    }
+    group_starts.push_back(num_seam_entries);
+    const size_t num_groups = group_starts.size() - 1;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_groups),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const size_t owner = seam_entries[group_starts[i]].index;
+                    for (size_t j=group_starts[i]; j<group_starts[i+1]; j++) {
+                        seam_owner[seam_entries[j].index] = owner;
+                    }
+                }
+            });
+
+    // Output vertices are numbered by cell, skipping copies that are not
+    // owned.
+    std::vector<size_t> vertex_counts(num_cells);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_cells),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    size_t count = num_unit_vertices - num_seam_vertices;
+                    for (size_t j=0; j<num_seam_vertices; j++) {
+                        const size_t index = i*num_seam_vertices + j;
+                        if (seam_owner[index] == index) count++;
+                    }
+                    vertex_counts[i] = count;
+                }
+            });
+    const std::vector<size_t> vertex_offsets = compute_offsets(vertex_counts);
+    const size_t num_vertices = vertex_offsets.back();
+
+    std::vector<int> seam_index(num_seam_entries);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_cells),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    size_t count = vertex_offsets[i];
+                    for (size_t j=0; j<num_unit_vertices; j++) {
+                        if (seam_rank[j] < 0) { count++; continue; }
+                        const size_t index = i*num_seam_vertices + seam_rank[j];
+                        if (seam_owner[index] == index) {
+                            seam_index[index] = count;
+                            count++;
+                        }
+                    }
+                }
+            });
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_seam_entries),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    seam_index[i] = seam_index[seam_owner[i]];
+                }
+            });
+
+    auto map_cell_vertices = [&](size_t cell, std::vector<int>& index_map) {
+        size_t count = vertex_offsets[cell];
+        for (size_t j=0; j<num_unit_vertices; j++) {
+            if (seam_rank[j] < 0) {
+                index_map[j] = count;
+                count++;
+            } else {
+                const size_t index = cell*num_seam_vertices + seam_rank[j];
+                index_map[j] = seam_index[index];
+                if (seam_owner[index] == index) count++;
+            }
+        }
+    };
+
+    // Seam edges are kept on their first copy.
+    std::vector<SeamEdge> seam_edge_entries(num_cells * num_seam_edges);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_cells),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    for (size_t j=0; j<num_seam_edges; j++) {
+                        const size_t e = seam_edges[j];
+                        int v0 = seam_index[i*num_seam_vertices +
+                            seam_rank[unit_edges(e,0)]];
+                        int v1 = seam_index[i*num_seam_vertices +
+                            seam_rank[unit_edges(e,1)]];
+                        SeamEdge& entry = seam_edge_entries[i*num_seam_edges+j];
+                        entry.v0 = std::min(v0, v1);
+                        entry.v1 = std::max(v0, v1);
+                        entry.index = i*num_seam_edges + j;
+                    }
+                }
+            });
+    tbb::parallel_sort(seam_edge_entries.begin(), seam_edge_entries.end());
+
+    std::vector<char> seam_edge_kept(seam_edge_entries.size(), 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, seam_edge_entries.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    if (i == 0 || !seam_edge_entries[i-1].same_edge(
+                                seam_edge_entries[i])) {
+                        seam_edge_kept[seam_edge_entries[i].index] = 1;
+                    }
+                }
+            });
+
+    std::vector<size_t> edge_counts(num_cells);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_cells),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    edge_counts[i] = num_inner_edges + std::count(
+                            seam_edge_kept.begin() + i*num_seam_edges,
+                            seam_edge_kept.begin() + (i+1)*num_seam_edges, 1);
+                }
+            });
+    const std::vector<size_t> edge_offsets = compute_offsets(edge_counts);
+    const size_t num_edges = edge_offsets.back();
+
+    // Parameters without formula are the same for every cell.
+    const bool uniform_params = std::all_of(vars.begin(), vars.end(),
+            [](const ParameterManager::Variables& v) { return v.empty(); });
+    assert(uniform_params || vars.size() == num_cells);
+    const bool vertex_thickness =
+        m_params->get_thickness_type() == ParameterCommon::VERTEX;
+    VectorF uniform_thickness;
+    MatrixFr uniform_offset;
+    if (uniform_params) {
+        ParameterManager::Variables no_vars;
+        uniform_thickness = m_params->evaluate_thickness(no_vars);
+        uniform_offset = m_params->evaluate_offset(no_vars);
+    }
 
-MatrixIr TilerEngine::tile_edges(size_t num_repetitions) {
-    const size_t num_vertices = m_unit_wire_network->get_num_vertices();
-    const size_t num_edges    = m_unit_wire_network->get_num_edges();
+    const std::vector<std::string> attr_names =
+        m_unit_wire_network->get_attribute_names();
+    const size_t num_attrs = attr_names.size();
+    std::vector<const MatrixFr*> unit_attr_values(num_attrs);
+    std::vector<bool> attr_vertex_wise(num_attrs);
+    std::vector<MatrixFr> attr_values(num_attrs);
+    for (size_t i=0; i<num_attrs; i++) {
+        unit_attr_values[i] =
+            &m_unit_wire_network->get_attribute(attr_names[i]);
+        attr_vertex_wise[i] =
+            m_unit_wire_network->is_vertex_attribute(attr_names[i]);
+        attr_values[i].resize(attr_vertex_wise[i] ? num_vertices : num_edges,
+                unit_attr_values[i]->cols());
+    }
+
+    // Every seam copy keeps its per cell values so that merged vertices
+    // can be averaged afterwards.
+    MatrixFr vertices(num_vertices, dim);
+    MatrixIr edges(num_edges, 2);
+    MatrixFr thickness(vertex_thickness ? num_vertices : num_edges, 1);
+    MatrixFr vertex_offset(num_vertices, dim);
+    VectorF seam_thickness(vertex_thickness ? num_seam_entries : 0);
+    MatrixFr seam_offset(num_seam_entries, dim);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_cells),
+            [&](const tbb::blocked_range<size_t>& r) {
+                std::vector<int> index_map(num_unit_vertices);
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    map_cell_vertices(i, index_map);
+                    const VectorF cell_thickness = uniform_params ?
+                        uniform_thickness : m_params->evaluate_thickness(vars[i]);
+                    const MatrixFr cell_vertices = cell_func(i, unit_vertices);
+                    const MatrixFr cell_offset = cell_func(i, unit_vertices +
+                            (uniform_params ? uniform_offset :
+                             m_params->evaluate_offset(vars[i])))
+                        - cell_vertices;
+
+                    for (size_t j=0; j<num_unit_vertices; j++) {
+                        if (seam_rank[j] >= 0) {
+                            const size_t index =
+                                i*num_seam_vertices + seam_rank[j];
+                            seam_offset.row(index) = cell_offset.row(j);
+                            if (vertex_thickness)
+                                seam_thickness[index] = cell_thickness[j];
+                            if (seam_owner[index] != index) continue;
+                        }
+
+                        const size_t v = index_map[j];
+                        vertices.row(v) = cell_vertices.row(j);
+                        vertex_offset.row(v) = cell_offset.row(j);
+                        if (vertex_thickness)
+                            thickness(v, 0) = cell_thickness[j];
+                        for (size_t k=0; k<num_attrs; k++) {
+                            if (!attr_vertex_wise[k]) continue;
+                            attr_values[k].row(v) =
+                                unit_attr_values[k]->row(j);
+                        }
+                    }
+
+                    size_t count = edge_offsets[i];
+                    for (size_t j=0; j<num_unit_edges; j++) {
+                        const int seam = seam_edge_rank[j];
+                        if (seam < 0 ? inner_duplicates[j] :
+                                !seam_edge_kept[i*num_seam_edges + seam]) {
+                            continue;
+                        }
+                        edges(count, 0) = index_map[unit_edges(j, 0)];
+                        edges(count, 1) = index_map[unit_edges(j, 1)];
+                        if (!vertex_thickness)
+                            thickness(count, 0) = cell_thickness[j];
+                        for (size_t k=0; k<num_attrs; k++) {
+                            if (attr_vertex_wise[k]) continue;
+                            attr_values[k].row(count) =
+                                unit_attr_values[k]->row(j);
+                        }
+                        count++;
+                    }
+                    assert(count == edge_offsets[i+1]);
+                }
+            });
+
+    // Merged vertices take the average of their copies, summed in tiling
+    // order.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_groups),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const size_t begin = group_starts[i];
+                    const size_t end = group_starts[i+1];
+                    if (end - begin < 2) continue;
+                    const Float count = end - begin;
+                    const size_t v = seam_index[seam_entries[begin].index];
+
+                    VectorF offset_sum = VectorF::Zero(dim);
+                    Float thickness_sum = 0.0;
+                    for (size_t j=begin; j<end; j++) {
+                        const size_t index = seam_entries[j].index;
+                        offset_sum += seam_offset.row(index).transpose();
+                        if (vertex_thickness)
+                            thickness_sum += seam_thickness[index];
+                    }
+                    vertex_offset.row(v) = offset_sum.transpose() / count;
+                    if (vertex_thickness) thickness(v, 0) = thickness_sum / count;
+
+                    for (size_t k=0; k<num_attrs; k++) {
+                        if (!attr_vertex_wise[k]) continue;
+                        const MatrixFr& unit_values = *unit_attr_values[k];
+                        VectorF sum = VectorF::Zero(unit_values.cols());
+                        for (size_t j=begin; j<end; j++) {
+                            const size_t seam =
+                                seam_entries[j].index % num_seam_vertices;
+                            sum += unit_values.row(seam_vertices[seam]).transpose();
+                        }
+                        attr_values[k].row(v) = sum.transpose() / count;
+                    }
+                }
+            });
+
+    // Facets shared by two cells are merged by the seam keys above.  Guide
+    // meshes that are not conforming, e.g. with hanging nodes or duplicated
+    // corners, also have facets used by a single cell inside the domain, so
+    // coincident vertices on such open facets are merged geometrically.
+    if (!conforming) {
+        const size_t num_facets = 2 * dim;
+        const std::vector<char> open_facets = find_open_facets(cells, dim);
+        std::vector<std::vector<size_t> > seam_facets(num_seam_vertices);
+        for (size_t i=0; i<num_seam_vertices; i++) {
+            for (size_t k=0; k<dim; k++) {
+                const int64_t coord = quantized_coords[i*dim+k];
+                if (coord == 0) seam_facets[i].push_back(k*2);
+                if (coord == QUANTIZATION) seam_facets[i].push_back(k*2+1);
+            }
+        }
+
+        std::vector<char> open_vertices(num_vertices, 0);
+        VectorF num_copies = VectorF::Ones(num_vertices);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_groups),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    for (size_t i=r.begin(); i!=r.end(); i++) {
+                        const size_t begin = group_starts[i];
+                        const size_t end = group_starts[i+1];
+                        const size_t v = seam_index[seam_entries[begin].index];
+                        num_copies[v] = end - begin;
+                        for (size_t j=begin; j<end; j++) {
+                            const size_t index = seam_entries[j].index;
+                            const size_t cell = index / num_seam_vertices;
+                            const size_t seam = index % num_seam_vertices;
+                            for (auto f : seam_facets[seam]) {
+                                if (open_facets[cell*num_facets + f])
+                                    open_vertices[v] = 1;
+                            }
+                        }
+                    }
+                });
+
+        const std::vector<int> index_map =
+            merge_open_vertices(vertices, open_vertices, tol);
+        const size_t num_merged_vertices = index_map.empty() ? 0 :
+            *std::max_element(index_map.begin(), index_map.end()) + 1;
+        if (num_merged_vertices < num_vertices) {
+            MatrixFr merged_vertices(num_merged_vertices, dim);
+            for (size_t i=num_vertices; i>0; i--) {
+                merged_vertices.row(index_map[i-1]) = vertices.row(i-1);
+            }
+            vertices.swap(merged_vertices);
+            vertex_offset = merge_rows(vertex_offset, index_map, num_copies,
+                    num_merged_vertices);
+            if (vertex_thickness) {
+                thickness = merge_rows(thickness, index_map, num_copies,
+                        num_merged_vertices);
+            }
+            for (size_t i=0; i<num_attrs; i++) {
+                if (!attr_vertex_wise[i]) continue;
+                attr_values[i] = merge_rows(attr_values[i], index_map,
+                        num_copies, num_merged_vertices);
+            }
 
-    MatrixIr tiled_edges(num_edges * num_repetitions, 2);
+            for (size_t i=0; i<num_edges; i++) {
+                edges(i, 0) = index_map[edges(i, 0)];
+                edges(i, 1) = index_map[edges(i, 1)];
+            }
+            const std::vector<bool> mask = create_duplication_mask(edges);
+            edges = filter(edges, mask);
+            if (!vertex_thickness) thickness = filter(thickness, mask);
+            for (size_t i=0; i<num_attrs; i++) {
+                if (attr_vertex_wise[i]) continue;
+                attr_values[i] = filter(attr_values[i], mask);
+            }
+        }
+    }
 
-    size_t vertex_count = 0;
-    for (size_t i=0; i<num_repetitions; i++) {
-        tiled_edges.block(num_edges * i, 0, num_edges, 2) =
-            m_unit_wire_network->get_edges().array() + vertex_count;
-        vertex_count += num_vertices;
+    WireNetwork::Ptr tiled_network = WireNetwork::create_raw(vertices, edges);
+    for (size_t i=0; i<num_attrs; i++) {
+        tiled_network->add_attribute(attr_names[i], attr_vertex_wise[i], false);
+        tiled_network->set_attribute(attr_names[i], attr_values[i]);
     }
-    return tiled_edges;
+    tiled_network->add_attribute("thickness", vertex_thickness);
+    tiled_network->set_attribute("thickness", thickness);
+    tiled_network->add_attribute("vertex_offset", true);
+    tiled_network->set_attribute("vertex_offset", vertex_offset);
+    return tiled_network;
 }
 
 void TilerEngine::normalize_unit_wire(const VectorF& cell_size) {
@@ -113,28 +780,27 @@ void TilerEngine::normalize_unit_wire(const VectorF& cell_size) {
 
     VectorF factors = cell_size.cwiseQuotient(
             m_unit_wire_network->get_bbox_max() - m_unit_wire_network->get_bbox_min());
+    m_unit_wire_network = copy_wire_network(*m_unit_wire_network);
     m_unit_wire_network->center_at_origin();
     m_unit_wire_network->scale(factors);
+    m_params->set_wire_network(m_unit_wire_network);
 }
 
-void TilerEngine::update_attributes(WireNetwork& wire_network, size_t num_repetitions) {
-    std::vector<std::string> attr_names = m_unit_wire_network->get_attribute_names();
-    for (auto itr : attr_names) {
-        const std::string& name = itr;
-        wire_network.add_attribute(name,
-                m_unit_wire_network->is_vertex_attribute(name), false);
-
-        const MatrixFr& values = m_unit_wire_network->get_attribute(name);
-        const size_t rows = values.rows();
-        const size_t cols = values.cols();
-        MatrixFr tiled_values(rows * num_repetitions, cols);
-
-        for (size_t i=0; i<num_repetitions; i++) {
-            tiled_values.block(i*rows, 0, rows, cols) = values;
+WireNetwork::Ptr TilerEngine::copy_wire_network(
+        const WireNetwork& wire_network) {
+    WireNetwork::Ptr copy = WireNetwork::create_raw(
+            wire_network.get_vertices(), wire_network.get_edges());
+    for (const auto& name : wire_network.get_attribute_names()) {
+        const MatrixFr& values = wire_network.get_attribute(name);
+        copy->add_attribute(name, wire_network.is_vertex_attribute(name), false);
+        if (values.rows() > 0) {
+            copy->set_attribute(name, values);
         }
-
-        wire_network.set_attribute(name, tiled_values);
     }
+    if (wire_network.with_connectivity()) {
+        copy->compute_connectivity();
+    }
+    return copy;
 }
 
 void TilerEngine::clean_up(WireNetwork& wire_network, Float tol) {
@@ -1,7 +1,9 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #pragma once
 
+#include <functional>
 #include <list>
+#include <vector>
 #include <Wires/WireNetwork/WireNetwork.h>
 #include <Wires/Parameters/ParameterManager.h>
 
@@ -28,11 +30,48 @@ class TilerEngine {
         void with_parameters(ParameterManager::Ptr params);
 
     protected:
-        MatrixFr tile_vertices(const FuncList& funcs);
-        MatrixIr tile_edges(size_t num_repetitions);
+        /**
+         * Maps the unit wire vertices into the given cell.
+         */
+        typedef std::function<MatrixFr(size_t, const MatrixFr&)> CellFunc;
 
+        /**
+         * Tile the unit wire network into all cells in parallel.
+         *
+         * Each row of cells lists the corner indices of a cell in bilinear
+         * (2D) or trilinear (3D) interpolation order.  Unit wire vertices on
+         * the cell boundary are keyed by the corners they interpolate and
+         * their quantized weights (tol is in unit box coordinates), so
+         * vertices shared by neighbouring cells are merged while tiling
+         * instead of by a geometric search afterwards.  vars holds the
+         * formula variables per cell and may be empty.
+         *
+         * Cells that are not conforming, e.g. guide meshes with hanging
+         * nodes or duplicated corners, must pass conforming=false.  Vertices
+         * on cell facets not shared by exactly two cells are then also
+         * merged geometrically, within tol in output coordinates.
+         *
+         * Output is numbered in cell order as if each cell were appended and
+         * duplicates removed, keeping the first copy.  Vertex attributes are
+         * averaged over merged copies.
+         */
+        WireNetwork::Ptr tile_cells(const MatrixIr& cells,
+                const CellFunc& cell_func,
+                const std::vector<ParameterManager::Variables>& vars,
+                Float tol=1e-6, bool conforming=true);
+
+        /**
+         * Replace m_unit_wire_network by a copy centered at the origin and
+         * scaled to cell_size, and bind m_params to it.  The caller's wire
+         * network is left untouched.
+         */
         void normalize_unit_wire(const VectorF& cell_size);
-        void update_attributes(WireNetwork& wire_network, size_t num_repetitions);
+
+        /**
+         * Deep copy of vertices, edges, attributes and connectivity.
+         */
+        static WireNetwork::Ptr copy_wire_network(
+                const WireNetwork& wire_network);
 
         void clean_up(WireNetwork& wire_network, Float tol=1e-6);
         void remove_duplicated_vertices(WireNetwork& wire_network, Float tol);
@@ -0,0 +1,47 @@
+/* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
+#pragma once
+
+#include <cstdint>
+
+namespace PyMesh {
+
+/**
+ * Layout of .wireb files, all values little endian:
+ *
+ *   Header
+ *   vertices    num_vertices x dim float64, row major
+ *   edges       num_edges x 2 int32, row major, 0-based
+ *   attributes  num_attributes times:
+ *                   AttributeHeader
+ *                   name        name_length chars, not null terminated
+ *                   values      num_rows x num_cols float64, row major
+ *
+ * Vertex and edge sections are stored exactly as they are laid out in
+ * MatrixFr and MatrixIr, so they are read straight into place.
+ */
+namespace WireBinaryFormat {
+    const char MAGIC[8] = {'P', 'Y', 'W', 'I', 'R', 'E', 'B', '\0'};
+    const uint32_t VERSION = 1;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t dim;
+        uint64_t num_vertices;
+        uint64_t num_edges;
+        uint64_t num_attributes;
+    };
+
+    struct AttributeHeader {
+        uint32_t name_length;
+        uint32_t vertex_wise;
+        uint64_t num_rows;
+        uint64_t num_cols;
+    };
+
+    static_assert(sizeof(Header) == 40, "Unexpected wireb header padding");
+    static_assert(sizeof(AttributeHeader) == 24,
+            "Unexpected wireb attribute header padding");
+}
+
+}
@@ -58,6 +58,7 @@ WireNetwork::WireNetwork() : m_dim(0) {
 
 WireNetwork::WireNetwork(const std::string& wire_file) {
     const auto ext = IOUtils::get_extention(wire_file);
+    WireParser::Attributes attributes;
     if (ext == ".svg") {
         SVGParser parser;
         parser.parse(wire_file);
@@ -74,19 +75,18 @@ WireNetwork::WireNetwork(const std::string& wire_file) {
     } else {
         WireParser parser;
         parser.parse(wire_file);
-
-        size_t num_vertices = parser.get_num_vertices();
-        size_t num_edges = parser.get_num_edges();
         m_dim = parser.get_dim();
-
-        m_vertices.resize(num_vertices, m_dim);
-        m_edges.resize(num_edges, 2);
-
-        parser.export_vertices(m_vertices.data());
-        parser.export_edges(m_edges.data());
+        parser.extract(m_vertices, m_edges, attributes);
     }
 
     initialize();
+
+    for (const auto& attr : attributes) {
+        add_attribute(attr.name, attr.vertex_wise, false);
+        if (attr.values.rows() > 0) {
+            set_attribute(attr.name, attr.values);
+        }
+    }
 }
 
 WireNetwork::WireNetwork(const MatrixFr& vertices, const MatrixIr& edges)
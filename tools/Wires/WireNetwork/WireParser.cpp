@@ -3,112 +3,315 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 
+#include <tbb/tbb.h>
+
 #include <Core/Exception.h>
+#include <IO/IOUtils.h>
+#include <Misc/Profiler.h>
+
+#include "WireBinaryFormat.h"
 
 using namespace PyMesh;
 
-WireParser::WireParser() : m_dim(0) { }
+namespace WireParserHelper {
+    const size_t CHUNK_SIZE = 1 << 20;
 
-void WireParser::parse(const std::string& filename) {
-    reset();
-    std::ifstream fin(filename.c_str());
-    if (!fin.is_open()) {
+    struct Chunk {
+        size_t dim = 0;
+        size_t num_normals = 0;
+        std::vector<Float> vertices;
+        std::vector<int> edges;
+        const char* first_vertex_line = nullptr;
+        const char* error_line = nullptr;
+    };
+
+    const char* skip_token(const char* p) {
+        while (*p != '\0' && !std::isspace(*p)) p++;
+        return p;
+    }
+
+    bool parse_vertex_line(const char* line, Chunk& chunk) {
+        const char* p = skip_token(line);
+        const size_t header_size = p - line;
+
+        Float data[4];
+        size_t n = 0;
+        while (n < 4) {
+            char* end;
+            data[n] = std::strtod(p, &end);
+            if (end == p) break;
+            p = end;
+            n++;
+        }
+        if (n < 2) return false;
+
+        // Check to handle homogeneous coordinates.
+        if (n == 4) {
+            data[0] /= data[3];
+            data[1] /= data[3];
+            data[2] /= data[3];
+            n -= 1;
+        }
+        if (chunk.dim == 0) {
+            chunk.dim = n;
+            chunk.first_vertex_line = line;
+        } else if (chunk.dim != n) {
+            return false;
+        }
+
+        if (header_size == 1) {
+            chunk.vertices.insert(chunk.vertices.end(), data, data + n);
+        } else if (header_size == 2 && line[1] == 'n') {
+            chunk.num_normals++;
+        }
+        return true;
+    }
+
+    bool parse_edge_line(const char* line, Chunk& chunk) {
+        const char* p = skip_token(line);
+        int data[2];
+        for (size_t i=0; i<2; i++) {
+            char* end;
+            data[i] = int(std::strtol(p, &end, 10)) - 1;
+            if (end == p) return false;
+            p = end;
+        }
+        chunk.edges.push_back(data[0]);
+        chunk.edges.push_back(data[1]);
+        return true;
+    }
+
+    /**
+     * Parse the lines in [begin, end).  Line breaks are replaced by null
+     * characters, so end must follow a line break or the end of the buffer.
+     */
+    void parse_chunk(char* begin, char* end, Chunk& chunk) {
+        char* line = begin;
+        while (line < end) {
+            char* line_end = std::find(line, end, '\n');
+            *line_end = '\0';
+
+            bool success;
+            switch (line[0]) {
+                case 'v':
+                    success = parse_vertex_line(line, chunk);
+                    break;
+                case 'l':
+                    success = parse_edge_line(line, chunk);
+                    break;
+                default:
+                    // Ignore other lines by default.
+                    success = true;
+                    break;
+            }
+            if (!success) {
+                chunk.error_line = line;
+                return;
+            }
+            line = line_end + 1;
+        }
+    }
+
+    void throw_parse_error(const char* line) {
         std::stringstream err_msg;
-        err_msg << "Failed to open " << filename;
+        err_msg << "Error parsing line: \"" << line << "\"";
         throw IOError(err_msg.str());
     }
 
-    const size_t LINE_SIZE = 256;
-    char line[LINE_SIZE];
-    bool success;
-
-    while (!fin.eof()) {
-        fin.getline(line, LINE_SIZE);
-        switch (line[0]) {
-            case 'v':
-                success = parse_vertex_line(line);
-                break;
-            case 'l':
-                success = parse_edge_line(line);
-                break;
-            default:
-                // Ignore other lines by default.
-                success = true;
-                break;
-        }
-        if (!success) {
-            std::stringstream err_msg;
-            err_msg << "Error parsing line: \"" << line << "\"";
-            throw IOError(err_msg.str());
+    void throw_truncated_error(const std::string& filename) {
+        std::stringstream err_msg;
+        err_msg << "Unexpected end of file " << filename;
+        throw IOError(err_msg.str());
+    }
+
+    void read_data(std::ifstream& fin, void* data, size_t num_bytes,
+            const std::string& filename) {
+        fin.read(static_cast<char*>(data), num_bytes);
+        if (!fin) throw_truncated_error(filename);
+    }
+
+    /**
+     * Resize matrix and read its data, after checking the file holds that
+     * much data, so that corrupted sizes fail cleanly.
+     */
+    template<typename Derived>
+    void read_matrix(std::ifstream& fin, size_t file_size,
+            size_t num_rows, size_t num_cols, Derived& matrix,
+            const std::string& filename) {
+        const size_t entry_size = sizeof(typename Derived::Scalar);
+        const size_t remaining = file_size - size_t(fin.tellg());
+        if (num_cols > 0 && num_rows > remaining / (num_cols * entry_size)) {
+            throw_truncated_error(filename);
         }
+        matrix.resize(num_rows, num_cols);
+        read_data(fin, matrix.data(), matrix.size() * entry_size, filename);
     }
-    fin.close();
 }
 
-void WireParser::export_vertices(Float* buffer) const {
-    size_t i=0;
-    for (auto v : m_vertices) {
-        assert(v.size() == m_dim);
-        std::copy(v.data(), v.data() + m_dim, buffer + i*m_dim);
-        i++;
+using namespace WireParserHelper;
+
+WireParser::WireParser() : m_dim(0) { }
+
+void WireParser::parse(const std::string& filename) {
+    PYMESH_PROFILE_ZONE("WireParser::parse");
+    reset();
+    if (IOUtils::get_extention(filename) == ".wireb") {
+        parse_binary(filename);
+    } else {
+        parse_text(filename);
     }
 }
 
+void WireParser::export_vertices(Float* buffer) const {
+    std::copy(m_vertices.data(), m_vertices.data() + m_vertices.size(),
+            buffer);
+}
+
 void WireParser::export_edges(int* buffer) const {
-    size_t i=0;
-    for (auto e : m_edges) {
-        assert(e.size() == 2);
-        std::copy(e.data(), e.data() + 2, buffer + i*2);
-        i++;
-    }
+    std::copy(m_edges.data(), m_edges.data() + m_edges.size(), buffer);
+}
+
+void WireParser::extract(MatrixFr& vertices, MatrixIr& edges,
+        Attributes& attributes) {
+    vertices.swap(m_vertices);
+    edges.swap(m_edges);
+    attributes.swap(m_attributes);
+    reset();
 }
 
 void WireParser::reset() {
     m_dim = 0;
-    m_vertices.clear();
-    m_edges.clear();
+    m_vertices.resize(0, 0);
+    m_edges.resize(0, 2);
+    m_attributes.clear();
 }
 
-bool WireParser::parse_vertex_line(char* line) {
-    char header[8];
-    Float data[4];
-    size_t n = sscanf(line, "%s %lf %lf %lf %lf", header,
-            &data[0], &data[1], &data[2], &data[3]);
-    if (n < 3) return false;
-
-    // Check to handle homogeneous coordinates.
-    if (n == 5) {
-        data[0] /= data[3];
-        data[1] /= data[3];
-        data[2] /= data[3];
-        n -= 1;
-    }
-    if (m_dim == 0) { m_dim = n-1; }
-    else if (m_dim != n-1) { return false; }
-
-    Eigen::Map<VectorF> coord(data, m_dim);
-    if (header[1] == '\0')
-        m_vertices.push_back(coord);
-    else if (header[1] == 'n') {
-        // Not supported.
+void WireParser::parse_text(const std::string& filename) {
+    std::ifstream fin(filename.c_str(), std::ios::binary);
+    if (!fin.is_open()) {
+        std::stringstream err_msg;
+        err_msg << "Failed to open " << filename;
+        throw IOError(err_msg.str());
+    }
+    fin.seekg(0, std::ios::end);
+    const size_t file_size = fin.tellg();
+    fin.seekg(0, std::ios::beg);
+    std::vector<char> content(file_size + 1, '\0');
+    read_data(fin, content.data(), file_size, filename);
+    fin.close();
+
+    // Chunks always end after a line break or at the end of file.
+    std::vector<size_t> chunk_bounds(1, 0);
+    while (chunk_bounds.back() < file_size) {
+        size_t end = std::min(chunk_bounds.back() + CHUNK_SIZE, file_size);
+        while (end < file_size && content[end-1] != '\n') end++;
+        chunk_bounds.push_back(end);
+    }
+
+    const size_t num_chunks = chunk_bounds.size() - 1;
+    std::vector<Chunk> chunks(num_chunks);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_chunks, 1),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    parse_chunk(content.data() + chunk_bounds[i],
+                            content.data() + chunk_bounds[i+1], chunks[i]);
+                }
+            });
+
+    // Errors are reported for the first offending chunk in file order.
+    size_t num_normals = 0;
+    std::vector<size_t> vertex_offsets(num_chunks+1, 0);
+    std::vector<size_t> edge_offsets(num_chunks+1, 0);
+    for (size_t i=0; i<num_chunks; i++) {
+        const Chunk& chunk = chunks[i];
+        if (chunk.error_line != nullptr) {
+            throw_parse_error(chunk.error_line);
+        }
+        if (chunk.dim != 0) {
+            if (m_dim == 0) { m_dim = chunk.dim; }
+            else if (m_dim != chunk.dim) {
+                throw_parse_error(chunk.first_vertex_line);
+            }
+        }
+        const size_t num_chunk_vertices =
+            chunk.dim == 0 ? 0 : chunk.vertices.size() / chunk.dim;
+        vertex_offsets[i+1] = vertex_offsets[i] + num_chunk_vertices;
+        edge_offsets[i+1] = edge_offsets[i] + chunk.edges.size() / 2;
+        num_normals += chunk.num_normals;
+    }
+    if (num_normals > 0) {
         std::cerr << "vertex normal is not supported" << std::endl;
     }
-    return true;
+
+    m_vertices.resize(vertex_offsets.back(), m_dim);
+    m_edges.resize(edge_offsets.back(), 2);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_chunks, 1),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i=r.begin(); i!=r.end(); i++) {
+                    const Chunk& chunk = chunks[i];
+                    std::copy(chunk.vertices.begin(), chunk.vertices.end(),
+                            m_vertices.data() + vertex_offsets[i] * m_dim);
+                    std::copy(chunk.edges.begin(), chunk.edges.end(),
+                            m_edges.data() + edge_offsets[i] * 2);
+                }
+            });
 }
 
-bool WireParser::parse_edge_line(char* line) {
-    char header[8];
-    int data[2];
-    size_t n = sscanf(line, "%s %i %i", header, &data[0], &data[1]);
-    if (n != 3) { return false; }
+void WireParser::parse_binary(const std::string& filename) {
+    std::ifstream fin(filename.c_str(), std::ios::binary);
+    if (!fin.is_open()) {
+        std::stringstream err_msg;
+        err_msg << "Failed to open " << filename;
+        throw IOError(err_msg.str());
+    }
+    fin.seekg(0, std::ios::end);
+    const size_t file_size = fin.tellg();
+    fin.seekg(0, std::ios::beg);
 
-    Eigen::Map<VectorI> edge(data, 2);
-    edge.array() -= 1;
-    m_edges.push_back(edge);
-    return true;
-}
+    WireBinaryFormat::Header header;
+    read_data(fin, &header, sizeof(header), filename);
+    if (!std::equal(header.magic, header.magic + 8,
+                WireBinaryFormat::MAGIC)) {
+        std::stringstream err_msg;
+        err_msg << filename << " is not a binary wire file";
+        throw IOError(err_msg.str());
+    }
+    if (header.version != WireBinaryFormat::VERSION) {
+        std::stringstream err_msg;
+        err_msg << "Unsupported wireb version " << header.version
+            << " in " << filename;
+        throw IOError(err_msg.str());
+    }
+    if (header.dim != 2 && header.dim != 3) {
+        std::stringstream err_msg;
+        err_msg << "Invalid dimension " << header.dim << " in " << filename;
+        throw IOError(err_msg.str());
+    }
 
+    m_dim = header.dim;
+    read_matrix(fin, file_size, header.num_vertices, m_dim, m_vertices,
+            filename);
+    read_matrix(fin, file_size, header.num_edges, 2, m_edges, filename);
+
+    for (size_t i=0; i<header.num_attributes; i++) {
+        WireBinaryFormat::AttributeHeader attr_header;
+        read_data(fin, &attr_header, sizeof(attr_header), filename);
+        if (attr_header.name_length > file_size) {
+            throw_truncated_error(filename);
+        }
+
+        Attribute attr;
+        attr.name.resize(attr_header.name_length);
+        read_data(fin, &attr.name[0], attr_header.name_length, filename);
+        attr.vertex_wise = attr_header.vertex_wise != 0;
+        read_matrix(fin, file_size, attr_header.num_rows,
+                attr_header.num_cols, attr.values, filename);
+        m_attributes.push_back(std::move(attr));
+    }
+}
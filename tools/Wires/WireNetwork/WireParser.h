@@ -1,38 +1,58 @@
 /* This file is part of PyMesh. Copyright (c) 2015 by Qingnan Zhou */
 #pragma once
 
-#include <list>
 #include <string>
+#include <vector>
 
 #include <Core/EigenTypedef.h>
 
 namespace PyMesh {
 
+/**
+ * Parse wire networks from .wire (OBJ-like text) or .wireb (binary) files.
+ *
+ * Text files are read into memory and parsed in parallel chunks of whole
+ * lines.  Binary files are read section by section directly into the
+ * vertex, edge and attribute matrices.
+ */
 class WireParser {
+    public:
+        struct Attribute {
+            std::string name;
+            bool vertex_wise;
+            MatrixFr values;
+        };
+        typedef std::vector<Attribute> Attributes;
+
     public:
         WireParser();
 
         void parse(const std::string& filename);
 
         size_t get_dim() const { return m_dim; }
-        size_t get_num_vertices() const { return m_vertices.size(); }
-        size_t get_num_edges() const { return m_edges.size(); }
+        size_t get_num_vertices() const { return m_vertices.rows(); }
+        size_t get_num_edges() const { return m_edges.rows(); }
 
         void export_vertices(Float* buffer) const;
         void export_edges(int* buffer) const;
 
+        /**
+         * Move the parsed data out of the parser without copying.
+         * Attributes are only stored in .wireb files.
+         */
+        void extract(MatrixFr& vertices, MatrixIr& edges,
+                Attributes& attributes);
+
     private:
         void reset();
-        bool parse_vertex_line(char* line);
-        bool parse_edge_line(char* line);
+        void parse_text(const std::string& filename);
+        void parse_binary(const std::string& filename);
 
     private:
-        typedef std::list<VectorF> VertexList;
-        typedef std::list<VectorI> EdgeList;
-
         size_t m_dim;
-        VertexList m_vertices;
-        EdgeList   m_edges;
+        MatrixFr m_vertices;
+        MatrixIr m_edges;
+        Attributes m_attributes;
 };
 
 }
@@ -2,21 +2,48 @@
 #include "WireWriter.h"
 
 #include <Core/Exception.h>
+#include <IO/IOUtils.h>
 
 #include <cassert>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 
+#include "WireBinaryFormat.h"
+
 using namespace PyMesh;
 
+namespace WireWriterHelper {
+    void throw_open_error(const std::string& filename) {
+        std::stringstream err_msg;
+        err_msg << "Unable to open file \"" << filename << "\" for writing";
+        throw IOError(err_msg.str());
+    }
+
+    void write_data(std::ofstream& fout, const void* data, size_t num_bytes) {
+        fout.write(static_cast<const char*>(data), num_bytes);
+    }
+}
+
+using namespace WireWriterHelper;
+
 void WireWriter::write(const std::string& filename, const WireNetwork& wires) {
     const MatrixFr& vertices = wires.get_vertices();
     const MatrixIr& edges = wires.get_edges();
-    write_raw(filename, vertices, edges);
+    if (IOUtils::get_extention(filename) == ".wireb") {
+        write_binary(filename, vertices, edges, &wires);
+    } else {
+        write_raw(filename, vertices, edges);
+    }
 }
 
 void WireWriter::write_raw(const std::string& filename,
         const MatrixFr& vertices, const MatrixIr& edges) {
+    if (IOUtils::get_extention(filename) == ".wireb") {
+        write_binary(filename, vertices, edges, nullptr);
+        return;
+    }
+
     const size_t num_vertices = vertices.rows();
     const size_t dim = vertices.cols();
     const size_t num_edges = edges.rows();
@@ -24,22 +51,66 @@ void WireWriter::write_raw(const std::string& filename,
 
     std::ofstream fout(filename.c_str());
     if (!fout.is_open()) {
-        std::stringstream err_msg;
-        err_msg << "Unable to open file \"" << filename << "\" for writing";
-        throw IOError(err_msg.str());
+        throw_open_error(filename);
     }
 
+    fout << std::fixed;
     for (size_t i=0; i<num_vertices; i++) {
         fout << "v";
         for (size_t j=0; j<dim; j++) {
-            fout << " " << std::fixed << vertices(i,j);
+            fout << " " << vertices(i,j);
         }
-        fout << std::endl;
+        fout << "\n";
     }
 
     for (size_t i=0; i<num_edges; i++) {
-        fout << "l " << edges(i, 0)+1 << " " << edges(i, 1)+1 << std::endl;
+        fout << "l " << edges(i, 0)+1 << " " << edges(i, 1)+1 << "\n";
+    }
+
+    fout.close();
+}
+
+void WireWriter::write_binary(const std::string& filename,
+        const MatrixFr& vertices, const MatrixIr& edges,
+        const WireNetwork* wires) {
+    assert(edges.cols() == 2 || edges.rows() == 0);
+    std::ofstream fout(filename.c_str(), std::ios::binary);
+    if (!fout.is_open()) {
+        throw_open_error(filename);
     }
 
+    std::vector<std::string> attr_names;
+    if (wires != nullptr) {
+        attr_names = wires->get_attribute_names();
+    }
+
+    WireBinaryFormat::Header header;
+    std::memcpy(header.magic, WireBinaryFormat::MAGIC, 8);
+    header.version = WireBinaryFormat::VERSION;
+    header.dim = vertices.cols();
+    header.num_vertices = vertices.rows();
+    header.num_edges = edges.rows();
+    header.num_attributes = attr_names.size();
+    write_data(fout, &header, sizeof(header));
+    write_data(fout, vertices.data(), sizeof(Float) * vertices.size());
+    write_data(fout, edges.data(), sizeof(int) * edges.size());
+
+    for (const auto& name : attr_names) {
+        const MatrixFr& values = wires->get_attribute(name);
+        WireBinaryFormat::AttributeHeader attr_header;
+        attr_header.name_length = name.size();
+        attr_header.vertex_wise = wires->is_vertex_attribute(name) ? 1 : 0;
+        attr_header.num_rows = values.rows();
+        attr_header.num_cols = values.cols();
+        write_data(fout, &attr_header, sizeof(attr_header));
+        write_data(fout, name.data(), name.size());
+        write_data(fout, values.data(), sizeof(Float) * values.size());
+    }
+
+    if (!fout) {
+        std::stringstream err_msg;
+        err_msg << "Failed to write " << filename;
+        throw IOError(err_msg.str());
+    }
     fout.close();
 }
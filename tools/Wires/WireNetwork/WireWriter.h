@@ -7,6 +7,10 @@
 
 namespace PyMesh {
 
+/**
+ * Write wire networks as .wire text, or as .wireb binary when the filename
+ * has that extension.  Only the binary format keeps attributes.
+ */
 class WireWriter {
     public:
         WireWriter() {}
@@ -16,6 +20,12 @@ class WireWriter {
         void write_raw(const std::string& filename,
                 const MatrixFr& vertices,
                 const MatrixIr& edges);
+
+    private:
+        void write_binary(const std::string& filename,
+                const MatrixFr& vertices,
+                const MatrixIr& edges,
+                const WireNetwork* wires);
 };
 
 }